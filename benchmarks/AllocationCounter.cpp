@@ -0,0 +1,62 @@
+#include "AllocationCounter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+/// Number of calls to the global operator new
+std::atomic<uint64_t> gAllocationCount{0};
+} // namespace
+
+void* operator new(const std::size_t size)
+{
+    gAllocationCount.fetch_add(1, std::memory_order_relaxed);
+
+    if (auto* const memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](const std::size_t size)
+{
+    return ::operator new(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+namespace Benchmarks {
+
+uint64_t getAllocationCount()
+{
+    return gAllocationCount.load(std::memory_order_relaxed);
+}
+
+void reportAllocationsPerOperation(benchmark::State& state, const uint64_t initialAllocationCount)
+{
+    state.counters["allocs/op"] = benchmark::Counter(
+          static_cast<double>(getAllocationCount() - initialAllocationCount),
+          benchmark::Counter::kAvgIterations);
+}
+
+} // namespace Benchmarks
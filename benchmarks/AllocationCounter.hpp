@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+
+#include "benchmark/benchmark.h"
+
+namespace Benchmarks {
+
+/**
+ * @brief Retrieves the amount of heap allocations performed by the process so far
+ *
+ * Every benchmark executable replaces the global allocation functions in order to count them
+ *
+ * @return Number of calls to the global operator new
+ */
+[[nodiscard]] uint64_t getAllocationCount();
+
+/**
+ * @brief Reports the average amount of heap allocations per benchmark iteration
+ *
+ * @param[in,out] state Benchmark state to report the "allocs/op" counter to
+ * @param[in] initialAllocationCount Allocation count retrieved right before the benchmark loop
+ */
+void reportAllocationsPerOperation(benchmark::State& state, uint64_t initialAllocationCount);
+
+} // namespace Benchmarks
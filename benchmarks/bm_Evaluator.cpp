@@ -0,0 +1,240 @@
+#include "benchmark/benchmark.h"
+
+#include <array>
+#include <cctype>
+
+#include "AllocationCounter.hpp"
+#include "bytecode/Compiler.hpp"
+#include "evaluator/ColumnarEvaluator.hpp"
+#include "evaluator/Evaluator.hpp"
+#include "evaluator/VirtualMachine.hpp"
+
+namespace {
+/// Values of the variables used by the benchmarked expressions (two operands holding 1)
+const std::vector<Symbols::ValueSlot> cValueSlots{{1, true}, {1, true}};
+
+/// Leaf values cycled through when generating expressions (letters are variables)
+constexpr std::array cLeafValues{'1', 'a', '2', 'b'};
+
+/// Operators cycled through when generating expressions
+constexpr std::array cOperators{'+', '-', '*', '/'};
+
+/**
+ * @brief Appends a leaf node to an AST
+ *
+ * @param[in,out] ast AST to append the node to
+ * @param[in] leafIndex Position of the leaf value to use (cycling through the leaf values)
+ *
+ * @return Index of the new node
+ */
+AST::NodeIndex addLeaf(AST::Tree& ast, const std::size_t leafIndex)
+{
+    const auto leafValue = cLeafValues[leafIndex % cLeafValues.size()];
+
+    return std::isdigit(leafValue)
+                 ? ast.addConstant(leafValue - '0')
+                 : ast.addVariable(static_cast<Symbols::SymbolId>(leafValue - 'a'));
+}
+
+/**
+ * @brief Generates a left-leaning AST (e.g. "((1+a)-2)*b")
+ *
+ * @param[in] operatorCount Number of operator nodes of the AST
+ *
+ * @return Generated AST (its depth equals the number of operators)
+ */
+AST::Tree buildDeepAST(const std::size_t operatorCount)
+{
+    AST::Tree ast(2 * operatorCount + 1);
+
+    auto rootNode = addLeaf(ast, 0);
+    for (std::size_t index = 0; index < operatorCount; ++index) {
+        const auto leafNode = addLeaf(ast, index + 1);
+        rootNode = ast.addOperator(cOperators[index % cOperators.size()], rootNode, leafNode);
+    }
+
+    return ast;
+}
+
+/**
+ * @brief Generates a balanced AST (e.g. "(1+a)-(2+b)")
+ *
+ * Only additions and subtractions are used so that values stay bounded
+ *
+ * @param[in] leafCount Number of leaf nodes of the AST (rounded to a power of two)
+ *
+ * @return Generated AST (its depth is logarithmic in the number of leaves)
+ */
+AST::Tree buildWideAST(const std::size_t leafCount)
+{
+    AST::Tree ast(2 * leafCount);
+
+    std::vector<AST::NodeIndex> levelNodes;
+    for (std::size_t index = 0; index < leafCount; ++index) {
+        levelNodes.push_back(addLeaf(ast, index));
+    }
+
+    while (levelNodes.size() > 1) {
+        std::vector<AST::NodeIndex> parentNodes;
+        for (std::size_t index = 0; index + 1 < levelNodes.size(); index += 2) {
+            parentNodes.push_back(ast.addOperator(
+                  cOperators[(index / 2) % 2], levelNodes[index], levelNodes[index + 1]));
+        }
+        levelNodes.swap(parentNodes);
+    }
+
+    return ast;
+}
+
+/**
+ * @brief Benchmarks the recursive tree-walk Evaluator
+ *
+ * @param[in] state Benchmark state (its range holds the size of the generated AST)
+ * @param[in] buildAST Method used to generate the AST
+ */
+void treeWalk(benchmark::State& state, AST::Tree (*buildAST)(std::size_t))
+{
+    const auto ast = buildAST(static_cast<std::size_t>(state.range(0)));
+    const auto allocationCount = Benchmarks::getAllocationCount();
+
+    for ([[maybe_unused]] auto _ : state) {
+        Evaluator evaluator(ast, cValueSlots);
+        benchmark::DoNotOptimize(evaluator.execute());
+    }
+
+    Benchmarks::reportAllocationsPerOperation(state, allocationCount);
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(ast.size()));
+}
+
+/**
+ * @brief Benchmarks the stack VirtualMachine on the program compiled from the same AST
+ *
+ * @param[in] state Benchmark state (its range holds the size of the generated AST)
+ * @param[in] buildAST Method used to generate the AST
+ */
+void virtualMachine(benchmark::State& state, AST::Tree (*buildAST)(std::size_t))
+{
+    const auto ast = buildAST(static_cast<std::size_t>(state.range(0)));
+    const auto program = Bytecode::compile(ast);
+    const auto allocationCount = Benchmarks::getAllocationCount();
+
+    for ([[maybe_unused]] auto _ : state) {
+        VirtualMachine virtualMachine(program, cValueSlots);
+        benchmark::DoNotOptimize(virtualMachine.execute());
+    }
+
+    Benchmarks::reportAllocationsPerOperation(state, allocationCount);
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(ast.size()));
+}
+
+/**
+ * @brief Benchmarks the Evaluator on an AST whose variables all hold a value
+ *
+ * @param[in] state Benchmark state (its range holds the size of the generated AST)
+ */
+void evaluatorResolved(benchmark::State& state)
+{
+    treeWalk(state, buildWideAST);
+}
+
+/**
+ * @brief Benchmarks the Evaluator on an AST whose variables do not hold any value
+ *
+ * The evaluation outputs the unmet dependencies instead of a value
+ *
+ * @param[in] state Benchmark state (its range holds the size of the generated AST)
+ */
+void evaluatorUnresolved(benchmark::State& state)
+{
+    const auto ast = buildWideAST(static_cast<std::size_t>(state.range(0)));
+    const auto allocationCount = Benchmarks::getAllocationCount();
+
+    for ([[maybe_unused]] auto _ : state) {
+        Evaluator evaluator(ast, {});
+        benchmark::DoNotOptimize(evaluator.execute());
+    }
+
+    Benchmarks::reportAllocationsPerOperation(state, allocationCount);
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(ast.size()));
+}
+
+/**
+ * @brief Benchmarks the VirtualMachine evaluating a wide expression once per row of inputs
+ *
+ * @param[in] state Benchmark state (its range holds the number of rows)
+ */
+void virtualMachineRows(benchmark::State& state)
+{
+    const auto rowCount = static_cast<std::size_t>(state.range(0));
+    const auto program = Bytecode::compile(buildWideAST(16));
+    std::vector<int32_t> output(rowCount);
+    std::vector<Symbols::ValueSlot> valueSlots{cValueSlots};
+
+    for ([[maybe_unused]] auto _ : state) {
+        for (std::size_t row = 0; row < rowCount; ++row) {
+            valueSlots[0].value = static_cast<int32_t>(row);
+            VirtualMachine virtualMachine(program, valueSlots);
+            output[row] = std::get<int>(virtualMachine.execute());
+        }
+        benchmark::DoNotOptimize(output.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/**
+ * @brief Benchmarks the ColumnarEvaluator evaluating the same expression over columns of inputs
+ *
+ * @param[in] state Benchmark state (its range holds the number of rows)
+ * @param[in] instructionSet Instruction set used by the kernels
+ */
+void columnarEvaluator(benchmark::State& state,
+                       const ColumnarEvaluator::InstructionSet instructionSet)
+{
+    const auto rowCount = static_cast<std::size_t>(state.range(0));
+    const auto program = Bytecode::compile(buildWideAST(16));
+    std::vector<int32_t> output(rowCount);
+
+    std::vector<int32_t> firstValues(rowCount);
+    for (std::size_t row = 0; row < rowCount; ++row) {
+        firstValues[row] = static_cast<int32_t>(row);
+    }
+    const std::vector<int32_t> secondValues(rowCount, 1);
+    const std::vector<ColumnarEvaluator::Column> columns{firstValues, secondValues};
+
+    const ColumnarEvaluator evaluator(program, instructionSet);
+    if (evaluator.getInstructionSet() != instructionSet) {
+        state.SkipWithError("Instruction set not supported");
+        return;
+    }
+
+    const auto allocationCount = Benchmarks::getAllocationCount();
+
+    for ([[maybe_unused]] auto _ : state) {
+        benchmark::DoNotOptimize(evaluator.execute(columns, output));
+        benchmark::DoNotOptimize(output.data());
+    }
+
+    Benchmarks::reportAllocationsPerOperation(state, allocationCount);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+} // namespace
+
+BENCHMARK(evaluatorResolved)->RangeMultiplier(8)->Range(8, 512);
+BENCHMARK(evaluatorUnresolved)->RangeMultiplier(8)->Range(8, 512);
+
+BENCHMARK_CAPTURE(treeWalk, deep, buildDeepAST)->RangeMultiplier(8)->Range(8, 4096);
+BENCHMARK_CAPTURE(virtualMachine, deep, buildDeepAST)->RangeMultiplier(8)->Range(8, 4096);
+BENCHMARK_CAPTURE(treeWalk, wide, buildWideAST)->RangeMultiplier(8)->Range(8, 4096);
+BENCHMARK_CAPTURE(virtualMachine, wide, buildWideAST)->RangeMultiplier(8)->Range(8, 4096);
+
+BENCHMARK(virtualMachineRows)->RangeMultiplier(16)->Range(1 << 10, 1 << 20);
+BENCHMARK_CAPTURE(columnarEvaluator, scalar, ColumnarEvaluator::InstructionSet::SCALAR)
+      ->RangeMultiplier(16)
+      ->Range(1 << 10, 1 << 20);
+BENCHMARK_CAPTURE(columnarEvaluator, sse2, ColumnarEvaluator::InstructionSet::SSE2)
+      ->RangeMultiplier(16)
+      ->Range(1 << 10, 1 << 20);
+BENCHMARK_CAPTURE(columnarEvaluator, avx2, ColumnarEvaluator::InstructionSet::AVX2)
+      ->RangeMultiplier(16)
+      ->Range(1 << 10, 1 << 20);
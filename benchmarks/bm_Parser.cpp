@@ -0,0 +1,77 @@
+#include "benchmark/benchmark.h"
+
+#include <array>
+#include <string>
+
+#include "AllocationCounter.hpp"
+#include "parser/Parser.hpp"
+
+namespace {
+/// Operators cycled through when generating expressions
+constexpr std::array cOperators{'+', '-', '*', '/'};
+
+/**
+ * @brief Generates an instruction whose RHS is made of parenthesized terms (e.g. "x=(v0+1)*(v1+2)")
+ *
+ * @param[in] termCount Number of terms of the RHS
+ *
+ * @return Generated instruction
+ */
+std::string generateInstruction(const std::size_t termCount)
+{
+    std::string instruction{"x="};
+
+    for (std::size_t term = 0; term < termCount; ++term) {
+        if (term > 0) {
+            instruction.push_back(cOperators[term % cOperators.size()]);
+        }
+
+        instruction.append("(v" + std::to_string(term) + "+" + std::to_string(term % 9 + 1) + ")");
+    }
+
+    return instruction;
+}
+
+/**
+ * @brief Benchmarks Parser::execute on a given instruction
+ *
+ * @param[in] state Benchmark state
+ * @param[in] instruction Instruction to parse
+ */
+void parseInstruction(benchmark::State& state, const std::string& instruction)
+{
+    Symbols::SymbolTable symbolTable;
+    const auto allocationCount = Benchmarks::getAllocationCount();
+
+    for ([[maybe_unused]] auto _ : state) {
+        Parser parser(instruction, symbolTable);
+        benchmark::DoNotOptimize(parser.execute());
+    }
+
+    Benchmarks::reportAllocationsPerOperation(state, allocationCount);
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(instruction.size()));
+}
+
+/**
+ * @brief Benchmarks Parser::execute on a short instruction
+ *
+ * @param[in] state Benchmark state
+ */
+void parserShortExpression(benchmark::State& state)
+{
+    parseInstruction(state, "a = 1+2*b");
+}
+
+/**
+ * @brief Benchmarks Parser::execute on long instructions
+ *
+ * @param[in] state Benchmark state (its range holds the number of terms of the RHS)
+ */
+void parserLongExpression(benchmark::State& state)
+{
+    parseInstruction(state, generateInstruction(static_cast<std::size_t>(state.range(0))));
+}
+} // namespace
+
+BENCHMARK(parserShortExpression);
+BENCHMARK(parserLongExpression)->RangeMultiplier(8)->Range(8, 512);
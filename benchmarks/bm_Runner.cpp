@@ -0,0 +1,200 @@
+#include "benchmark/benchmark.h"
+
+#include <array>
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "AllocationCounter.hpp"
+#include "calculator/Runner.hpp"
+
+namespace {
+/**
+ * @brief Benchmarks Runner::processInstruction on a given instruction
+ *
+ * @param[in] state Benchmark state
+ * @param[in] setupInstructions Instructions processed once before measuring
+ * @param[in] instruction Instruction to process on every iteration
+ * @param[in] expressionCacheCapacity Capacity of the expression cache of the Runner
+ */
+void processInstruction(
+      benchmark::State& state,
+      const std::vector<std::string>& setupInstructions,
+      const std::string& instruction,
+      const std::size_t expressionCacheCapacity = Calculator::cDefaultExpressionCacheCapacity)
+{
+    Calculator::Runner calculator(expressionCacheCapacity);
+    for (const auto& setupInstruction : setupInstructions) {
+        benchmark::DoNotOptimize(calculator.processInstruction(setupInstruction));
+    }
+
+    const auto allocationCount = Benchmarks::getAllocationCount();
+
+    for ([[maybe_unused]] auto _ : state) {
+        benchmark::DoNotOptimize(calculator.processInstruction(instruction));
+    }
+
+    Benchmarks::reportAllocationsPerOperation(state, allocationCount);
+}
+
+/**
+ * @brief Benchmarks Runner::processInstruction on a given instruction, its results being
+ * appended to a reused output buffer instead of being returned
+ *
+ * @param[in] state Benchmark state
+ * @param[in] setupInstructions Instructions processed once before measuring
+ * @param[in] instruction Instruction to process on every iteration
+ */
+void processInstructionIntoBuffer(benchmark::State& state,
+                                  const std::vector<std::string>& setupInstructions,
+                                  const std::string& instruction)
+{
+    Calculator::Runner calculator;
+    std::string output;
+
+    const auto appendResult = [&output](const std::string_view result) {
+        output.append(result);
+        output.push_back('\n');
+    };
+
+    for (const auto& setupInstruction : setupInstructions) {
+        [[maybe_unused]] const auto setupResult
+              = calculator.processInstruction(setupInstruction, appendResult);
+    }
+
+    const auto allocationCount = Benchmarks::getAllocationCount();
+
+    for ([[maybe_unused]] auto _ : state) {
+        output.clear();
+        [[maybe_unused]] const auto instructionResult
+              = calculator.processInstruction(instruction, appendResult);
+        benchmark::DoNotOptimize(output.data());
+    }
+
+    Benchmarks::reportAllocationsPerOperation(state, allocationCount);
+}
+
+/**
+ * @brief Benchmarks an assignment that does not affect any other operand
+ *
+ * @param[in] state Benchmark state
+ */
+void runnerAssignment(benchmark::State& state)
+{
+    processInstruction(state, {"a = 1"}, "b = a * 2 + 3");
+}
+
+/**
+ * @brief Benchmarks an assignment that is parsed every time (the expression cache is disabled)
+ *
+ * @param[in] state Benchmark state
+ */
+void runnerUncachedAssignment(benchmark::State& state)
+{
+    processInstruction(state, {"a = 1"}, "b = a * 2 + 3", 0);
+}
+
+/**
+ * @brief Benchmarks an assignment whose new value cascades through dependent operands
+ *
+ * @param[in] state Benchmark state
+ */
+void runnerCascade(benchmark::State& state)
+{
+    processInstruction(state, {"b = a + 1", "c = b * 2", "d = b + c", "e = d - a"}, "a = 5");
+}
+
+/**
+ * @brief Benchmarks the command retrieving the result of the last fulfilled operation
+ *
+ * @param[in] state Benchmark state
+ */
+void runnerResultCommand(benchmark::State& state)
+{
+    processInstruction(state, {"a = 1", "b = a + 2"}, "result");
+}
+
+/**
+ * @brief Benchmarks a cascading assignment whose results are appended to an output buffer
+ *
+ * @param[in] state Benchmark state
+ */
+void runnerCascadeIntoBuffer(benchmark::State& state)
+{
+    processInstructionIntoBuffer(
+          state, {"b = a + 1", "c = b * 2", "d = b + c", "e = d - a"}, "a = 5");
+}
+
+/**
+ * @brief Benchmarks the result command, its result being appended to an output buffer
+ *
+ * @param[in] state Benchmark state
+ */
+void runnerResultCommandIntoBuffer(benchmark::State& state)
+{
+    processInstructionIntoBuffer(state, {"a = 1", "b = a + 2"}, "result");
+}
+
+/**
+ * @brief Benchmarks a cascading assignment while threads keep reading snapshots of the values
+ *
+ * Reports the throughput of the writer (items per second, in real time), which should not drop
+ * noticeably as readers are added as long as every thread gets a core of its own
+ *
+ * @param[in] state Benchmark state (its argument is the number of reader threads)
+ */
+void runnerCascadeWithConcurrentReaders(benchmark::State& state)
+{
+    Calculator::Runner calculator;
+    for (const auto& setupInstruction : {"b = a + 1", "c = b * 2", "d = b + c", "e = d - a"}) {
+        benchmark::DoNotOptimize(calculator.processInstruction(setupInstruction));
+    }
+
+    const auto values = calculator.enableConcurrentReads();
+    std::atomic<bool> isReading{true};
+    std::atomic<uint64_t> snapshotCount{0};
+    std::vector<std::thread> readers;
+
+    for (int64_t readerIndex = 0; readerIndex < state.range(0); ++readerIndex) {
+        readers.emplace_back([&] {
+            auto reader = Calculator::ConcurrentValues::Reader::attach(values);
+            Calculator::ConcurrentValues::Snapshot snapshot;
+
+            while (isReading.load(std::memory_order_relaxed)) {
+                reader->read(snapshot);
+                snapshotCount.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    // Alternate between values so that every instruction changes the cascade
+    const std::array<std::string, 2> instructions{"a = 5", "a = 6"};
+    std::size_t instructionIndex{0};
+    const auto allocationCount = Benchmarks::getAllocationCount();
+
+    for ([[maybe_unused]] auto _ : state) {
+        benchmark::DoNotOptimize(calculator.processInstruction(instructions[instructionIndex]));
+        instructionIndex ^= 1;
+    }
+
+    Benchmarks::reportAllocationsPerOperation(state, allocationCount);
+
+    isReading = false;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    state.counters["snapshots"] = benchmark::Counter(static_cast<double>(snapshotCount.load()),
+                                                     benchmark::Counter::kIsRate);
+}
+} // namespace
+
+BENCHMARK(runnerAssignment);
+BENCHMARK(runnerUncachedAssignment);
+BENCHMARK(runnerCascade);
+BENCHMARK(runnerResultCommand);
+BENCHMARK(runnerCascadeIntoBuffer);
+BENCHMARK(runnerResultCommandIntoBuffer);
+BENCHMARK(runnerCascadeWithConcurrentReaders)->Arg(0)->Arg(1)->Arg(16)->UseRealTime();
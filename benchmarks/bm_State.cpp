@@ -0,0 +1,168 @@
+#include "benchmark/benchmark.h"
+
+#include <string>
+#include <variant>
+
+#include "AllocationCounter.hpp"
+#include "calculator/State.hpp"
+#include "evaluator/VirtualMachine.hpp"
+#include "parser/Parser.hpp"
+
+namespace {
+/**
+ * @brief Registers an expression whose operands do not hold any value yet into a state
+ *
+ * @param[in,out] calculatorState State to register the expression into
+ * @param[in] instruction Instruction to register (e.g. "b = a + 1")
+ */
+void storeExpression(Calculator::State& calculatorState, const std::string& instruction)
+{
+    Parser parser(instruction, calculatorState.getSymbolTable());
+    if (!parser.execute()) {
+        return;
+    }
+
+    VirtualMachine virtualMachine(parser.getProgramOfRHS(), calculatorState.getOperandValues());
+    const auto result = virtualMachine.execute();
+
+    if (const auto* dependencies = std::get_if<Evaluator::Dependencies>(&result)) {
+        [[maybe_unused]] const auto isStored = calculatorState.storeExpressionDependencies(
+              parser.getOperandOfLHS(), parser.extractProgramOfRHS(), *dependencies);
+    }
+}
+
+/**
+ * @brief Builds a chain of dependencies (v1 = v0 + 1, v2 = v1 + 1, ...)
+ *
+ * @param[in,out] calculatorState State to register the expressions into
+ * @param[in] operandCount Number of dependent operands
+ */
+void buildChain(Calculator::State& calculatorState, const std::size_t operandCount)
+{
+    for (std::size_t operand = 1; operand <= operandCount; ++operand) {
+        storeExpression(calculatorState,
+                        "v" + std::to_string(operand) + " = v" + std::to_string(operand - 1)
+                              + " + 1");
+    }
+}
+
+/**
+ * @brief Builds operands that all directly depend on the same one (v1 = v0 + 1, v2 = v0 + 2, ...)
+ *
+ * @param[in,out] calculatorState State to register the expressions into
+ * @param[in] operandCount Number of dependent operands
+ */
+void buildFanOut(Calculator::State& calculatorState, const std::size_t operandCount)
+{
+    for (std::size_t operand = 1; operand <= operandCount; ++operand) {
+        storeExpression(calculatorState,
+                        "v" + std::to_string(operand) + " = v0 + " + std::to_string(operand % 9));
+    }
+}
+
+/**
+ * @brief Builds stacked diamonds of dependencies (l0 = v0 + 1, r0 = v0 - 1, v1 = (l0 + r0) / 2...)
+ *
+ * @param[in,out] calculatorState State to register the expressions into
+ * @param[in] operandCount Number of dependent operands
+ */
+void buildDiamonds(Calculator::State& calculatorState, const std::size_t operandCount)
+{
+    for (std::size_t diamond = 0; 3 * diamond < operandCount; ++diamond) {
+        const auto index = std::to_string(diamond);
+        const auto nextIndex = std::to_string(diamond + 1);
+
+        storeExpression(calculatorState, "l" + index + " = v" + index + " + 1");
+        storeExpression(calculatorState, "r" + index + " = v" + index + " - 1");
+        storeExpression(calculatorState,
+                        "v" + nextIndex + " = (l" + index + " + r" + index + ") / 2");
+    }
+}
+
+/**
+ * @brief Builds the same stacked diamonds as buildDiamonds, defining the formulas before their
+ * inputs (top-down: the last diamond first, "v0" never defined)
+ *
+ * @param[in,out] calculatorState State to register the expressions into
+ * @param[in] operandCount Number of dependent operands
+ */
+void buildDiamondsTopDown(Calculator::State& calculatorState, const std::size_t operandCount)
+{
+    for (auto diamond = (operandCount + 2) / 3; diamond > 0; --diamond) {
+        const auto index = std::to_string(diamond - 1);
+        const auto nextIndex = std::to_string(diamond);
+
+        storeExpression(calculatorState, "l" + index + " = v" + index + " + 1");
+        storeExpression(calculatorState, "r" + index + " = v" + index + " - 1");
+        storeExpression(calculatorState,
+                        "v" + nextIndex + " = (l" + index + " + r" + index + ") / 2");
+    }
+}
+
+/**
+ * @brief Benchmarks State::storeExpressionDependencies while building a dependency graph
+ *
+ * Every iteration builds the whole graph into a new state (the cost of keeping the dependency
+ * order must grow linearly with the number of operands, whatever the definition order)
+ *
+ * @param[in] state Benchmark state (its range holds the number of dependent operands)
+ * @param[in] buildGraph Method used to build the dependency graph
+ */
+void storeDependencies(benchmark::State& state,
+                       void (*buildGraph)(Calculator::State&, std::size_t))
+{
+    for ([[maybe_unused]] auto _ : state) {
+        Calculator::State calculatorState;
+        buildGraph(calculatorState, static_cast<std::size_t>(state.range(0)));
+        benchmark::DoNotOptimize(calculatorState);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/**
+ * @brief Benchmarks State::storeExpressionValue on the root of a dependency graph
+ *
+ * Every iteration assigns a new value to "v0" and re-evaluates all of its dependents
+ *
+ * @param[in] state Benchmark state (its ranges hold the number of dependent operands
+ * and the number of threads of the parallel propagation)
+ * @param[in] buildGraph Method used to build the dependency graph
+ */
+void storeValue(benchmark::State& state, void (*buildGraph)(Calculator::State&, std::size_t))
+{
+    Calculator::State calculatorState;
+    if (state.range(1) > 1) {
+        calculatorState.enableParallelPropagation(static_cast<std::size_t>(state.range(1)));
+    }
+
+    const auto rootOperand = calculatorState.getSymbolTable().intern("v0");
+    buildGraph(calculatorState, static_cast<std::size_t>(state.range(0)));
+
+    int value{0};
+    const auto allocationCount = Benchmarks::getAllocationCount();
+
+    for ([[maybe_unused]] auto _ : state) {
+        benchmark::DoNotOptimize(calculatorState.storeExpressionValue(rootOperand, ++value % 9));
+    }
+
+    Benchmarks::reportAllocationsPerOperation(state, allocationCount);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+} // namespace
+
+BENCHMARK_CAPTURE(storeValue, chain, buildChain)
+      ->ArgsProduct({benchmark::CreateRange(8, 4096, 8), {1}});
+BENCHMARK_CAPTURE(storeValue, fanOut, buildFanOut)
+      ->ArgsProduct({benchmark::CreateRange(8, 65536, 8), {1, 4}});
+BENCHMARK_CAPTURE(storeValue, diamonds, buildDiamonds)
+      ->ArgsProduct({benchmark::CreateRange(8, 4096, 8), {1}});
+BENCHMARK_CAPTURE(storeValue, diamondsTopDown, buildDiamondsTopDown)
+      ->ArgsProduct({benchmark::CreateRange(8, 4096, 8), {1}});
+
+BENCHMARK_CAPTURE(storeDependencies, diamonds, buildDiamonds)
+      ->RangeMultiplier(4)
+      ->Range(1024, 65536);
+BENCHMARK_CAPTURE(storeDependencies, diamondsTopDown, buildDiamondsTopDown)
+      ->RangeMultiplier(4)
+      ->Range(1024, 65536);
@@ -0,0 +1,291 @@
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "server/Endpoint.hpp"
+
+/**
+ * Load generator of the calculator server
+ *
+ * Opens many concurrent sessions, each one sending the same script of instructions with
+ * a given number of requests in flight, then reports the throughput and the latency
+ * percentiles of the requests (from sending a request to receiving its response line).
+ *
+ * Usage: lg_Server endpoint [sessions] [requests per session] [pipeline depth]
+ */
+
+namespace {
+/// Default number of concurrent sessions
+constexpr std::size_t cDefaultSessionCount{10'000};
+/// Default number of requests sent by each session
+constexpr std::size_t cDefaultRequestCount{100};
+/// Default number of requests of a session in flight at once
+constexpr std::size_t cDefaultPipelineDepth{1};
+/// Size of the buffer receiving the responses
+constexpr std::size_t cReadBufferSize{1 << 16};
+/// Maximum number of events handled per wait
+constexpr int cMaxEventCount{256};
+
+/// Script of every session (one request per line, cycled through)
+constexpr std::array<std::string_view, 8> cScript{"a = 1\n",
+                                                  "b = a + 2\n",
+                                                  "c = b * d\n",
+                                                  "d = 4\n",
+                                                  "result\n",
+                                                  "e = c - a\n",
+                                                  "undo 2\n",
+                                                  "a = a + 1\n"};
+
+/// Alias representing the clock timing the requests
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Session of the load generator
+ */
+struct Session
+{
+    /// Socket of the session
+    int socketDescriptor{-1};
+    /// Number of requests sent
+    std::size_t sentCount{0};
+    /// Number of responses received
+    std::size_t receivedCount{0};
+    /// Requests not written to the socket yet
+    std::string output;
+    /// Sending time of the requests in flight (indexed by request modulo the pipeline depth)
+    std::vector<Clock::time_point> sendTimes;
+    /// Events the socket is watched for
+    uint32_t watchedEvents{EPOLLIN};
+};
+
+/**
+ * @brief Parses a positive count given on the command line
+ *
+ * @param[in] text Count to parse
+ * @param[out] count Parsed count
+ *
+ * @return True if the count is valid
+ */
+bool parseCount(const std::string_view text, std::size_t& count)
+{
+    const auto* const textEnd = text.data() + text.size();
+    const auto [end, error] = std::from_chars(text.data(), textEnd, count);
+    return error == std::errc{} && end == textEnd && count > 0;
+}
+
+/**
+ * @brief Queues the next requests of a session, up to the pipeline depth
+ *
+ * @param[in,out] session Session sending the requests
+ * @param[in] requestCount Number of requests sent by each session
+ * @param[in] pipelineDepth Number of requests of a session in flight at once
+ */
+void queueRequests(Session& session,
+                   const std::size_t requestCount,
+                   const std::size_t pipelineDepth)
+{
+    const auto now = Clock::now();
+
+    while (session.sentCount < requestCount
+           && session.sentCount - session.receivedCount < pipelineDepth) {
+        session.output.append(cScript[session.sentCount % cScript.size()]);
+        session.sendTimes[session.sentCount % pipelineDepth] = now;
+        ++session.sentCount;
+    }
+}
+
+/**
+ * @brief Writes as many queued requests as the socket of a session accepts
+ *
+ * @param[in,out] session Session writing its requests
+ *
+ * @return False if the socket failed
+ */
+bool writeRequests(Session& session)
+{
+    while (!session.output.empty()) {
+        const auto bytesWritten = send(
+              session.socketDescriptor, session.output.data(), session.output.size(), MSG_NOSIGNAL);
+        if (bytesWritten < 0) {
+            return errno == EAGAIN || errno == EINTR;
+        }
+
+        session.output.erase(0, static_cast<std::size_t>(bytesWritten));
+    }
+
+    return true;
+}
+
+/**
+ * @brief Retrieves a percentile of the latencies
+ *
+ * @param[in,out] latencies Latencies of every request (reordered)
+ * @param[in] percentile Percentile to retrieve (between 0 and 100)
+ *
+ * @return Latency in microseconds
+ */
+double getPercentile(std::vector<Clock::duration>& latencies, const double percentile)
+{
+    const auto index = std::min(
+          latencies.size() - 1,
+          static_cast<std::size_t>(percentile / 100. * static_cast<double>(latencies.size())));
+    std::ranges::nth_element(latencies, latencies.begin() + static_cast<std::ptrdiff_t>(index));
+
+    return std::chrono::duration<double, std::micro>(latencies[index]).count();
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    std::size_t sessionCount{cDefaultSessionCount};
+    std::size_t requestCount{cDefaultRequestCount};
+    std::size_t pipelineDepth{cDefaultPipelineDepth};
+
+    const auto endpoint = argc >= 2 ? Server::Endpoint::parse(argv[1]) : std::nullopt;
+    if (!endpoint || argc > 5 || (argc >= 3 && !parseCount(argv[2], sessionCount))
+        || (argc >= 4 && !parseCount(argv[3], requestCount))
+        || (argc >= 5 && !parseCount(argv[4], pipelineDepth))) {
+        std::cerr << "Usage: " << argv[0]
+                  << " endpoint [sessions] [requests per session] [pipeline depth]\n";
+        return 1;
+    }
+
+    if (Server::raiseFileDescriptorLimit() < sessionCount + 16) {
+        std::cerr << "Not enough file descriptors for " << sessionCount << " sessions\n";
+        return 1;
+    }
+
+    const auto epollDescriptor = epoll_create1(EPOLL_CLOEXEC);
+    std::vector<Session> sessions(sessionCount);
+
+    for (std::size_t sessionIndex = 0; sessionIndex < sessionCount; ++sessionIndex) {
+        auto& session = sessions[sessionIndex];
+        session.sendTimes.resize(pipelineDepth);
+
+        session.socketDescriptor = Server::connectTo(*endpoint);
+        if (session.socketDescriptor < 0) {
+            std::perror("Failed to connect");
+            return 1;
+        }
+
+        fcntl(session.socketDescriptor,
+              F_SETFL,
+              fcntl(session.socketDescriptor, F_GETFL) | O_NONBLOCK);
+
+        epoll_event event{};
+        event.events = session.watchedEvents;
+        event.data.u64 = sessionIndex;
+        epoll_ctl(epollDescriptor, EPOLL_CTL_ADD, session.socketDescriptor, &event);
+    }
+
+    std::vector<Clock::duration> latencies;
+    latencies.reserve(sessionCount * requestCount);
+    std::vector<char> readBuffer(cReadBufferSize);
+    std::array<epoll_event, cMaxEventCount> events{};
+    std::size_t completedSessionCount{0};
+
+    const auto startTime = Clock::now();
+
+    for (auto& session : sessions) {
+        queueRequests(session, requestCount, pipelineDepth);
+        if (!writeRequests(session)) {
+            std::perror("Failed to send requests");
+            return 1;
+        }
+    }
+
+    while (completedSessionCount < sessionCount) {
+        const auto eventCount = epoll_wait(epollDescriptor, events.data(), cMaxEventCount, -1);
+        if (eventCount < 0 && errno != EINTR) {
+            std::perror("Failed to wait for events");
+            return 1;
+        }
+
+        const auto readyEvents
+              = std::span{events}.first(static_cast<std::size_t>(std::max(eventCount, 0)));
+        for (const auto& event : readyEvents) {
+            auto& session = sessions[event.data.u64];
+
+            if ((event.events & (EPOLLIN | EPOLLHUP | EPOLLERR)) != 0) {
+                const auto bytesRead = recv(
+                      session.socketDescriptor, readBuffer.data(), readBuffer.size(), 0);
+                if (bytesRead == 0 || (bytesRead < 0 && errno != EAGAIN && errno != EINTR)) {
+                    std::cerr << "Session " << event.data.u64 << " was closed by the server\n";
+                    return 1;
+                }
+
+                // Every response is a line: match them with the requests in order
+                const auto receivedTime = Clock::now();
+                const auto receivedSize = static_cast<std::size_t>(std::max<ssize_t>(bytesRead, 0));
+                for (const auto character : std::span{readBuffer}.first(receivedSize)) {
+                    if (character == '\n') {
+                        latencies.push_back(
+                              receivedTime
+                              - session.sendTimes[session.receivedCount % pipelineDepth]);
+                        ++session.receivedCount;
+                    }
+                }
+
+                if (session.receivedCount == requestCount) {
+                    ++completedSessionCount;
+                }
+                queueRequests(session, requestCount, pipelineDepth);
+            }
+
+            if (!writeRequests(session)) {
+                std::perror("Failed to send requests");
+                return 1;
+            }
+
+            uint32_t watchedEvents{EPOLLIN};
+            if (!session.output.empty()) {
+                watchedEvents |= EPOLLOUT;
+            }
+
+            if (watchedEvents != session.watchedEvents) {
+                session.watchedEvents = watchedEvents;
+
+                epoll_event watchedEvent{};
+                watchedEvent.events = watchedEvents;
+                watchedEvent.data.u64 = event.data.u64;
+                epoll_ctl(epollDescriptor, EPOLL_CTL_MOD, session.socketDescriptor, &watchedEvent);
+            }
+        }
+    }
+
+    const std::chrono::duration<double> elapsedTime = Clock::now() - startTime;
+
+    for (const auto& session : sessions) {
+        close(session.socketDescriptor);
+    }
+    close(epollDescriptor);
+
+    const auto elapsedSeconds = elapsedTime.count();
+    std::printf("Sessions: %zu, requests: %zu, pipeline depth: %zu\n",
+                sessionCount,
+                latencies.size(),
+                pipelineDepth);
+    std::printf("Elapsed: %.3f s, throughput: %.0f requests/s\n",
+                elapsedSeconds,
+                static_cast<double>(latencies.size()) / elapsedSeconds);
+    std::printf("Latency: p50 %.1f us, p99 %.1f us, max %.1f us\n",
+                getPercentile(latencies, 50.),
+                getPercentile(latencies, 99.),
+                getPercentile(latencies, 100.));
+
+    return 0;
+}
@@ -0,0 +1,142 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <sys/resource.h>
+
+#include "calculator/Profiler.hpp"
+#include "calculator/Runner.hpp"
+
+/**
+ * Workload driver of the calculator
+ *
+ * Feeds a script of instructions (e.g. written by wg_Workload) through the calculator, one line
+ * per instruction, then reports the throughput, the peak resident memory of the process and the
+ * time spent in each method of the state.
+ *
+ * Usage: wd_Workload script (or "-" to read the script from the standard input)
+ */
+
+namespace {
+/// Alias representing the clock timing the script
+using Clock = std::chrono::steady_clock;
+/// Alias representing the profiled methods of the state
+using Method = Calculator::Profiler::Method;
+
+/**
+ * @brief Reads a whole script
+ *
+ * @param[in] path Path of the script ("-" for the standard input)
+ * @param[out] script Content of the script
+ *
+ * @return True if the script could be read
+ */
+bool readScript(const std::string_view path, std::string& script)
+{
+    std::ostringstream content;
+
+    if (path == "-") {
+        content << std::cin.rdbuf();
+    } else {
+        std::ifstream file{std::string{path}};
+        if (!file) {
+            return false;
+        }
+        content << file.rdbuf();
+    }
+
+    script = std::move(content).str();
+    return true;
+}
+
+/**
+ * @brief Retrieves the peak resident memory of the process
+ *
+ * @return Peak resident set size, in kilobytes
+ */
+long getPeakResidentMemory()
+{
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    std::string script;
+    if (argc != 2 || !readScript(argv[1], script)) {
+        std::cerr << "Usage: " << argv[0] << " script (\"-\" for the standard input)\n";
+        return 1;
+    }
+
+    Calculator::Profiler profiler;
+    Calculator::Runner calculator;
+    calculator.setProfiler(&profiler);
+
+    uint64_t instructionCount{0};
+    uint64_t rejectedCount{0};
+    uint64_t resultCount{0};
+    const Calculator::Runner::ResultHandler countResult = [&](std::string_view) { ++resultCount; };
+
+    const auto startTime = Clock::now();
+
+    for (std::size_t lineStart = 0; lineStart < script.size();) {
+        auto lineEnd = script.find('\n', lineStart);
+        if (lineEnd == std::string::npos) {
+            lineEnd = script.size();
+        }
+
+        const auto instruction = std::string_view{script}.substr(lineStart, lineEnd - lineStart);
+        lineStart = lineEnd + 1;
+        if (instruction.empty()) {
+            continue;
+        }
+
+        ++instructionCount;
+        if (!calculator.processInstruction(instruction, countResult)) {
+            ++rejectedCount;
+        }
+    }
+
+    const std::chrono::duration<double> elapsedTime = Clock::now() - startTime;
+    const auto elapsedSeconds = elapsedTime.count();
+
+    std::printf("Instructions: %llu (%llu rejected), results: %llu\n",
+                static_cast<unsigned long long>(instructionCount),
+                static_cast<unsigned long long>(rejectedCount),
+                static_cast<unsigned long long>(resultCount));
+    std::printf("Elapsed: %.3f s, throughput: %.0f instructions/s\n",
+                elapsedSeconds,
+                static_cast<double>(instructionCount) / elapsedSeconds);
+    std::printf("Peak resident memory: %ld KB\n\n", getPeakResidentMemory());
+
+    std::printf("%-30s %12s %12s %8s %12s\n",
+                "State method",
+                "calls",
+                "total (ms)",
+                "share",
+                "mean (ns)");
+    for (std::size_t index = 0; index < static_cast<std::size_t>(Method::COUNT); ++index) {
+        const auto method = static_cast<Method>(index);
+        const auto& totals = profiler.getTotals(method);
+        const std::chrono::duration<double> methodTime = totals.time;
+        const auto callCount = static_cast<double>(std::max<uint64_t>(totals.calls, 1));
+
+        std::printf("%-30s %12llu %12.3f %7.1f%% %12.0f\n",
+                    Calculator::Profiler::getMethodName(method),
+                    static_cast<unsigned long long>(totals.calls),
+                    methodTime.count() * 1e3,
+                    100.0 * methodTime.count() / elapsedSeconds,
+                    methodTime.count() * 1e9 / callCount);
+    }
+
+    return 0;
+}
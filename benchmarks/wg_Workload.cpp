@@ -0,0 +1,279 @@
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Workload generator of the calculator
+ *
+ * Writes to the standard output a script of instructions shaped after a dependency graph,
+ * meant to be fed to the workload driver (wd_Workload) or to the calculator itself:
+ * - chain: every operand depends on the previous one, updates cascade through all of them
+ * - fanout: every operand depends on the same source, updates cascade through a single level
+ * - diamond: stacked diamonds, every level depending twice on the one before
+ * - random: random DAG defined in a shuffled order, so that most operands resolve late
+ * - undo: random assignments interleaved with undo commands
+ * - pending: operands all pending until their few sources are defined at the end
+ *
+ * The same shape, size and seed always produce the same script.
+ *
+ * Usage: wg_Workload shape size [seed] [updates]
+ */
+
+namespace {
+/// Default seed of the random shapes
+constexpr uint64_t cDefaultSeed{42};
+/// Default number of updates of the sources once a shape is defined
+constexpr std::size_t cDefaultUpdateCount{10};
+/// Maximum number of dependencies of an operand of the random DAG
+constexpr std::size_t cMaxRandomDependencyCount{3};
+/// Number of assignments per undo command of the undo churn
+constexpr std::size_t cAssignmentsPerUndo{4};
+/// Number of sources the pending operands depend on
+constexpr std::size_t cPendingSourceCount{16};
+
+/// Alias representing the random generator of the scripts
+using RandomGenerator = std::mt19937_64;
+
+/**
+ * @brief Parses a positive count given on the command line
+ *
+ * @param[in] text Count to parse
+ * @param[out] count Parsed count
+ *
+ * @return True if the count is valid
+ */
+bool parseCount(const std::string_view text, std::size_t& count)
+{
+    const auto* const textEnd = text.data() + text.size();
+    const auto [end, error] = std::from_chars(text.data(), textEnd, count);
+    return error == std::errc{} && end == textEnd && count > 0;
+}
+
+/**
+ * @brief Draws a random index
+ *
+ * @param[in,out] generator Random generator
+ * @param[in] count Number of indexes to draw from (strictly positive)
+ *
+ * @return Index in [0, count)
+ */
+std::size_t drawIndex(RandomGenerator& generator, const std::size_t count)
+{
+    return std::uniform_int_distribution<std::size_t>{0, count - 1}(generator);
+}
+
+/**
+ * @brief Writes every operand of a chain, then updates its head
+ *
+ * Operands are defined from the tail, so that they stay pending (and keep their dependencies)
+ * until the head is defined: every update of the head then cascades through the whole chain
+ *
+ * @param[in] size Number of operands
+ * @param[in] updateCount Number of updates of the head
+ * @param[out] script Script being written
+ */
+void writeChain(const std::size_t size, const std::size_t updateCount, std::string& script)
+{
+    for (std::size_t index = size - 1; index > 0; --index) {
+        script += "c" + std::to_string(index) + " = c" + std::to_string(index - 1) + " + 1\n";
+    }
+    script += "c0 = 1\n";
+
+    for (std::size_t update = 0; update < updateCount; ++update) {
+        script += "c0 = " + std::to_string(update + 2) + "\nresult\n";
+    }
+}
+
+/**
+ * @brief Writes every operand depending on a single source, then updates the source
+ *
+ * The source is defined last, so that every update of it cascades through all the operands
+ *
+ * @param[in] size Number of dependant operands
+ * @param[in] updateCount Number of updates of the source
+ * @param[out] script Script being written
+ */
+void writeFanOut(const std::size_t size, const std::size_t updateCount, std::string& script)
+{
+    for (std::size_t index = 0; index < size; ++index) {
+        script += "f" + std::to_string(index) + " = s + " + std::to_string(index) + "\n";
+    }
+    script += "s = 1\n";
+
+    for (std::size_t update = 0; update < updateCount; ++update) {
+        script += "s = " + std::to_string(update + 2) + "\nresult\n";
+    }
+}
+
+/**
+ * @brief Writes stacked diamonds (two operands depending on the previous level, joined by the
+ * next one), then updates the bottom level
+ *
+ * Levels are defined from the top, the bottom one last. Values stay bounded whatever the depth:
+ * every level is about as large as the previous one
+ *
+ * @param[in] size Number of diamonds
+ * @param[in] updateCount Number of updates of the bottom level
+ * @param[out] script Script being written
+ */
+void writeDiamond(const std::size_t size, const std::size_t updateCount, std::string& script)
+{
+    for (std::size_t index = size; index > 0; --index) {
+        const auto level = std::to_string(index);
+        const auto previousLevel = std::to_string(index - 1);
+        script += "a" + level + " = x" + previousLevel + " + 1\n";
+        script += "b" + level + " = x" + previousLevel + " * 2\n";
+        script += "x" + level + " = (a" + level + " + b" + level + ") / 3\n";
+    }
+    script += "x0 = 1\n";
+
+    for (std::size_t update = 0; update < updateCount; ++update) {
+        script += "x0 = " + std::to_string(update + 2) + "\nresult\n";
+    }
+}
+
+/**
+ * @brief Writes a random DAG in a shuffled order, then updates random operands
+ *
+ * Every operand depends on up to 3 operands of lower indexes, so the graph has no cycle, but
+ * the definitions are shuffled: most operands stay pending until their dependencies are defined
+ *
+ * @param[in] size Number of operands
+ * @param[in] updateCount Number of updates of random operands
+ * @param[in,out] generator Random generator
+ * @param[out] script Script being written
+ */
+void writeRandomDag(const std::size_t size,
+                    const std::size_t updateCount,
+                    RandomGenerator& generator,
+                    std::string& script)
+{
+    std::vector<std::string> definitions(size);
+    definitions[0] = "r0 = 1\n";
+
+    for (std::size_t index = 1; index < size; ++index) {
+        const auto dependencyCount
+              = 1 + drawIndex(generator, std::min(index, cMaxRandomDependencyCount));
+
+        std::string expression{"("};
+        for (std::size_t dependency = 0; dependency < dependencyCount; ++dependency) {
+            expression += dependency == 0 ? "r" : " + r";
+            expression += std::to_string(drawIndex(generator, index));
+        }
+        expression += ") / " + std::to_string(dependencyCount) + " + " + std::to_string(index % 7);
+
+        definitions[index] = "r" + std::to_string(index) + " = " + expression + "\n";
+    }
+
+    std::ranges::shuffle(definitions, generator);
+    for (const auto& definition : definitions) {
+        script += definition;
+    }
+
+    for (std::size_t update = 0; update < updateCount; ++update) {
+        script += "r" + std::to_string(drawIndex(generator, size)) + " = "
+                  + std::to_string(update + 2) + "\nresult\n";
+    }
+}
+
+/**
+ * @brief Writes random assignments interleaved with undo commands
+ *
+ * @param[in] size Number of assignments
+ * @param[in,out] generator Random generator
+ * @param[out] script Script being written
+ */
+void writeUndoChurn(const std::size_t size, RandomGenerator& generator, std::string& script)
+{
+    // Operands are drawn among a small pool, so that assignments keep overriding each other
+    const auto operandCount = std::max<std::size_t>(size / 8, 2);
+
+    for (std::size_t index = 0; index < size; ++index) {
+        const auto operand = "u" + std::to_string(drawIndex(generator, operandCount));
+        if (index % 3 == 0) {
+            script += operand + " = " + std::to_string(index % 100) + "\n";
+        } else {
+            script += operand + " = u" + std::to_string(drawIndex(generator, operandCount))
+                      + " + " + std::to_string(index % 10) + "\n";
+        }
+
+        if (index % cAssignmentsPerUndo == cAssignmentsPerUndo - 1) {
+            const auto undoneCount = 1 + drawIndex(generator, cAssignmentsPerUndo);
+            script += "undo " + std::to_string(undoneCount) + "\n";
+        }
+    }
+    script += "result\n";
+}
+
+/**
+ * @brief Writes operands all pending on a few sources, then defines the sources
+ *
+ * @param[in] size Number of pending operands
+ * @param[in] updateCount Number of updates of the sources once defined
+ * @param[out] script Script being written
+ */
+void writePending(const std::size_t size, const std::size_t updateCount, std::string& script)
+{
+    const auto sourceCount = std::min(size, cPendingSourceCount);
+
+    for (std::size_t index = 0; index < size; ++index) {
+        script += "p" + std::to_string(index) + " = s" + std::to_string(index % sourceCount)
+                  + " + " + std::to_string(index) + "\n";
+    }
+
+    for (std::size_t index = 0; index < sourceCount; ++index) {
+        script += "s" + std::to_string(index) + " = " + std::to_string(index) + "\n";
+    }
+
+    for (std::size_t update = 0; update < updateCount; ++update) {
+        script += "s" + std::to_string(update % sourceCount) + " = "
+                  + std::to_string(update + sourceCount) + "\nresult\n";
+    }
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    std::size_t size{0};
+    std::size_t seed{cDefaultSeed};
+    std::size_t updateCount{cDefaultUpdateCount};
+
+    const std::unordered_map<std::string_view, std::function<void(std::string&)>> shapes{
+          {"chain", [&](std::string& script) { writeChain(size, updateCount, script); }},
+          {"fanout", [&](std::string& script) { writeFanOut(size, updateCount, script); }},
+          {"diamond", [&](std::string& script) { writeDiamond(size, updateCount, script); }},
+          {"random",
+           [&](std::string& script) {
+               RandomGenerator generator{seed};
+               writeRandomDag(size, updateCount, generator, script);
+           }},
+          {"undo",
+           [&](std::string& script) {
+               RandomGenerator generator{seed};
+               writeUndoChurn(size, generator, script);
+           }},
+          {"pending", [&](std::string& script) { writePending(size, updateCount, script); }}};
+
+    const auto shape = argc >= 2 ? shapes.find(argv[1]) : shapes.end();
+    if (shape == shapes.end() || argc < 3 || argc > 5 || !parseCount(argv[2], size)
+        || (argc >= 4 && !parseCount(argv[3], seed))
+        || (argc >= 5 && !parseCount(argv[4], updateCount))) {
+        std::cerr << "Usage: " << argv[0]
+                  << " <chain|fanout|diamond|random|undo|pending> size [seed] [updates]\n";
+        return 1;
+    }
+
+    std::string script;
+    shape->second(script);
+    std::fwrite(script.data(), 1, script.size(), stdout);
+
+    return 0;
+}
@@ -1,11 +1,37 @@
 #pragma once
 
-#include <iostream>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "symbols/SymbolTable.hpp"
 
 namespace AST {
 
+/// Index of a node inside the node pool of an AST
+using NodeIndex = uint32_t;
+
+/// Sentinel index used to represent a missing child node
+inline constexpr NodeIndex cNullNodeIndex{std::numeric_limits<NodeIndex>::max()};
+
+/**
+ * @brief Kinds of nodes an AST is made of
+ */
+enum class NodeType : uint8_t {
+
+    CONSTANT = 0, // Integer literal (leaf)
+    VARIABLE = 1, // Operand referenced through its symbol identifier (leaf)
+    OPERATOR = 2  // Binary arithmetic operator (inner node)
+};
+
 /**
  * @brief Implementation of an AST Node
+ *
+ * Nodes do not own their children: they are stored in the node pool of an AST::Tree
+ * and reference their children through indices into that same pool
  */
 class Node
 {
@@ -13,35 +39,69 @@ public:
     /**
      * @brief Class constructor
      *
-     * @param[in] nodeValue char representing the value that the node will hold
-     * @param[in] leftNode Left child node
-     * @param[in] rightNode Right child node
+     * @param[in] nodeType Kind of the node
+     * @param[in] nodeValue Value held by the node: an integer literal, a symbol identifier
+     * or an operator character (depending on the node type)
+     * @param[in] leftNode Index of the left child node
+     * @param[in] rightNode Index of the right child node
+     */
+    constexpr Node(NodeType nodeType,
+                   uint32_t nodeValue,
+                   NodeIndex leftNode = cNullNodeIndex,
+                   NodeIndex rightNode = cNullNodeIndex)
+        : mNodeType{nodeType}
+        , mNodeValue{nodeValue}
+        , mLeftNode{leftNode}
+        , mRightNode{rightNode}
+    {
+    }
+
+    /**
+     * @brief Getter for the kind of the node
+     *
+     * @return Node type
+     */
+    [[nodiscard]] constexpr NodeType getNodeType() const
+    {
+        return mNodeType;
+    }
+
+    /**
+     * @brief Getter for the integer literal held by a CONSTANT node
+     *
+     * @return Constant value
      */
-    explicit Node(char nodeValue,
-                  std::unique_ptr<Node> leftNode = nullptr,
-                  std::unique_ptr<Node> rightNode = nullptr)
-        : mNodeValue{nodeValue}
-        , mLeftNode{std::move(leftNode)}
-        , mRightNode{std::move(rightNode)}
+    [[nodiscard]] constexpr int32_t getConstant() const
     {
+        return static_cast<int32_t>(mNodeValue);
     }
 
     /**
-     * @brief Getter for the value currently being held by the node
+     * @brief Getter for the operand referenced by a VARIABLE node
      *
-     * @return Node value
+     * @return Symbol identifier of the operand
      */
-    [[nodiscard]] char getNodeValue() const
+    [[nodiscard]] constexpr Symbols::SymbolId getSymbolId() const
     {
         return mNodeValue;
     }
 
+    /**
+     * @brief Getter for the operator held by an OPERATOR node
+     *
+     * @return Operator character
+     */
+    [[nodiscard]] constexpr char getOperator() const
+    {
+        return static_cast<char>(mNodeValue);
+    }
+
     /**
      * @brief Getter for the left child node
      *
-     * @return Reference to the left child node pointer
+     * @return Index of the left child node (cNullNodeIndex if there is none)
      */
-    [[nodiscard]] const std::unique_ptr<Node>& getReferenceToLeftNodePointer() const
+    [[nodiscard]] constexpr NodeIndex getLeftNodeIndex() const
     {
         return mLeftNode;
     }
@@ -49,42 +109,213 @@ public:
     /**
      * @brief Getter for the right child node
      *
-     * @return Reference to the right child node pointer
+     * @return Index of the right child node (cNullNodeIndex if there is none)
      */
-    [[nodiscard]] const std::unique_ptr<Node>& getReferenceToRightNodePointer() const
+    [[nodiscard]] constexpr NodeIndex getRightNodeIndex() const
     {
         return mRightNode;
     }
 
 private:
-    /// Value being held by the node
-    char mNodeValue{};
-    /// Left child node
-    std::unique_ptr<Node> mLeftNode{nullptr};
-    /// Right child node
-    std::unique_ptr<Node> mRightNode{nullptr};
+    /// Kind of the node
+    NodeType mNodeType{};
+    /// Value being held by the node (interpreted according to its type)
+    uint32_t mNodeValue{};
+    /// Index of the left child node
+    NodeIndex mLeftNode{cNullNodeIndex};
+    /// Index of the right child node
+    NodeIndex mRightNode{cNullNodeIndex};
+};
+
+/**
+ * @brief Implementation of an AST stored in a single contiguous node pool
+ *
+ * Nodes are stored in post-order: children are always added before their parent,
+ * which means that the root node is the last node of the pool.
+ * The whole tree therefore costs a single allocation when its capacity is reserved upfront.
+ */
+class Tree
+{
+public:
+    /**
+     * @brief Class' default constructor
+     */
+    Tree() = default;
+
+    /**
+     * @brief Class constructor
+     *
+     * @param[in] nodeCapacity Number of nodes to reserve space for
+     */
+    explicit Tree(const std::size_t nodeCapacity)
+    {
+        mNodes.reserve(nodeCapacity);
+    }
+
+    /**
+     * @brief Appends a new integer literal node to the node pool
+     *
+     * @param[in] value Integer literal that the node will hold
+     *
+     * @return Index of the newly added node
+     */
+    NodeIndex addConstant(const int32_t value)
+    {
+        mNodes.emplace_back(NodeType::CONSTANT, static_cast<uint32_t>(value));
+        return static_cast<NodeIndex>(mNodes.size() - 1);
+    }
+
+    /**
+     * @brief Appends a new variable node to the node pool
+     *
+     * @param[in] symbolId Symbol identifier of the operand that the node will reference
+     *
+     * @return Index of the newly added node
+     */
+    NodeIndex addVariable(const Symbols::SymbolId symbolId)
+    {
+        mNodes.emplace_back(NodeType::VARIABLE, symbolId);
+        return static_cast<NodeIndex>(mNodes.size() - 1);
+    }
+
+    /**
+     * @brief Appends a new operator node to the node pool
+     *
+     * Children must already be part of the pool (post-order insertion)
+     *
+     * @param[in] operation Operator character that the node will hold
+     * @param[in] leftNode Index of the left child node
+     * @param[in] rightNode Index of the right child node
+     *
+     * @return Index of the newly added node
+     */
+    NodeIndex addOperator(const char operation, const NodeIndex leftNode, const NodeIndex rightNode)
+    {
+        assert(leftNode < mNodes.size() && rightNode < mNodes.size());
+
+        mNodes.emplace_back(
+              NodeType::OPERATOR, static_cast<uint32_t>(operation), leftNode, rightNode);
+        return static_cast<NodeIndex>(mNodes.size() - 1);
+    }
+
+    /**
+     * @brief Getter for a node of the pool
+     *
+     * @param[in] nodeIndex Index of the node to retrieve
+     *
+     * @return Reference to the requested node
+     */
+    [[nodiscard]] const Node& getNode(const NodeIndex nodeIndex) const
+    {
+        assert(nodeIndex < mNodes.size());
+        return mNodes[nodeIndex];
+    }
+
+    /**
+     * @brief Getter for the index of the root node
+     *
+     * @return Index of the root node (cNullNodeIndex if the tree is empty)
+     */
+    [[nodiscard]] NodeIndex getRootNodeIndex() const
+    {
+        return mNodes.empty() ? cNullNodeIndex : static_cast<NodeIndex>(mNodes.size() - 1);
+    }
+
+    /**
+     * @brief Getter for the whole node pool (in post-order)
+     *
+     * @return View over the nodes of the tree
+     */
+    [[nodiscard]] std::span<const Node> getNodes() const
+    {
+        return mNodes;
+    }
+
+    /**
+     * @brief Checks if the tree has any nodes
+     *
+     * @return True if the tree is empty (false otherwise)
+     */
+    [[nodiscard]] bool empty() const
+    {
+        return mNodes.empty();
+    }
+
+    /**
+     * @brief Getter for the number of nodes of the tree
+     *
+     * @return Number of nodes
+     */
+    [[nodiscard]] std::size_t size() const
+    {
+        return mNodes.size();
+    }
+
+private:
+    /// Node pool, in post-order
+    std::vector<Node> mNodes;
 };
 
 /**
- * @brief Helper method used to print (horizontally) the contents of an AST
+ * @brief Helper method used to format (horizontally) the contents of an AST
  *
- * Recursive calls are made in order to print the content of every node's value.
+ * Recursive calls are made in order to format the content of every node's value.
  *
  * Preorder traversal is being used:
  * 1. Visit root node;
  * 2. Traverse left node (maintaining preorder traversal);
  * 2. Traverse right node (maintaining preorder traversal);
  *
- * @param[in] rootNode Reference to the root node of the AST
+ * @param[in] tree AST to format
+ * @param[in] symbolTable Symbol table used to retrieve the names of variables
+ * @param[in] nodeIndex Index of the node to start formatting from
+ * @param[out] output String the nodes are appended to, one per line
  * @param[in] prefix Helper string used to beautify the outputted data
  */
-inline void printAST(const std::unique_ptr<Node>& rootNode, std::string&& prefix = "")
+inline void formatAST(const Tree& tree,
+                      const Symbols::SymbolTable& symbolTable,
+                      const NodeIndex nodeIndex,
+                      std::string& output,
+                      const std::string& prefix = "")
 {
-    if (rootNode) {
-        std::cout << prefix << rootNode->getNodeValue() << "\n";
-        printAST(rootNode->getReferenceToLeftNodePointer(), prefix + "    ");
-        printAST(rootNode->getReferenceToRightNodePointer(), prefix + "    ");
+    if (nodeIndex == cNullNodeIndex) {
+        return;
+    }
+
+    const auto& node = tree.getNode(nodeIndex);
+    output += prefix;
+    switch (node.getNodeType()) {
+    case NodeType::CONSTANT:
+        output += std::to_string(node.getConstant());
+        break;
+    case NodeType::VARIABLE:
+        output += symbolTable.getName(node.getSymbolId());
+        break;
+    case NodeType::OPERATOR:
+        output += node.getOperator();
+        break;
     }
+    output += "\n";
+
+    formatAST(tree, symbolTable, node.getLeftNodeIndex(), output, prefix + "    ");
+    formatAST(tree, symbolTable, node.getRightNodeIndex(), output, prefix + "    ");
+}
+
+/**
+ * @brief Helper method used to format (horizontally) the contents of a whole AST
+ *
+ * Nothing is printed: the core library does no I/O, dumping the AST is left to the caller
+ *
+ * @param[in] tree AST to format
+ * @param[in] symbolTable Symbol table used to retrieve the names of variables
+ *
+ * @return One line per node, children indented below their parent
+ */
+inline std::string formatAST(const Tree& tree, const Symbols::SymbolTable& symbolTable)
+{
+    std::string output;
+    formatAST(tree, symbolTable, tree.getRootNodeIndex(), output);
+    return output;
 }
 
 } // namespace AST
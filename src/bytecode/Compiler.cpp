@@ -0,0 +1,81 @@
+#include "Compiler.hpp"
+
+#include <utility>
+#include <vector>
+
+#include "utils/Constants.hpp"
+
+namespace {
+/**
+ * @brief Maps an operator character to its arithmetic operation code
+ *
+ * @param[in] character Operator character
+ *
+ * @return Corresponding operation code
+ */
+constexpr Bytecode::OpCode toOpCode(const char character)
+{
+    using namespace Utils::Constants;
+    using Bytecode::OpCode;
+
+    switch (character) {
+    case cSubOp:
+        return OpCode::SUB;
+    case cMultOp:
+        return OpCode::MUL;
+    case cDivOp:
+        return OpCode::DIV;
+    case cAddOp:
+    default:
+        return OpCode::ADD;
+    }
+}
+} // namespace
+
+namespace Bytecode {
+
+Program compile(const AST::Tree& ast)
+{
+    Program program;
+    if (ast.empty()) {
+        return program;
+    }
+
+    program.reserve(ast.size());
+
+    // Iterative post-order traversal: every node is visited twice,
+    // first to schedule its children and then to emit its own instruction
+    std::vector<std::pair<AST::NodeIndex, bool>> pendingNodes;
+    pendingNodes.reserve(ast.size());
+    pendingNodes.emplace_back(ast.getRootNodeIndex(), false);
+
+    while (!pendingNodes.empty()) {
+        const auto [nodeIndex, childrenEmitted] = pendingNodes.back();
+        pendingNodes.pop_back();
+
+        const auto& node = ast.getNode(nodeIndex);
+
+        switch (node.getNodeType()) {
+        case AST::NodeType::CONSTANT:
+            program.emitConstant(static_cast<float>(node.getConstant()));
+            break;
+        case AST::NodeType::VARIABLE:
+            program.emitVariable(node.getSymbolId());
+            break;
+        case AST::NodeType::OPERATOR:
+            if (childrenEmitted) {
+                program.emitOperation(toOpCode(node.getOperator()));
+            } else {
+                // The left child must be emitted first, so it is pushed last
+                pendingNodes.emplace_back(nodeIndex, true);
+                pendingNodes.emplace_back(node.getRightNodeIndex(), false);
+                pendingNodes.emplace_back(node.getLeftNodeIndex(), false);
+            }
+            break;
+        }
+    }
+
+    return program;
+}
+
+} // namespace Bytecode
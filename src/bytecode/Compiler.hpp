@@ -0,0 +1,20 @@
+#pragma once
+
+#include "ast/Node.hpp"
+#include "bytecode/Program.hpp"
+
+namespace Bytecode {
+
+/**
+ * @brief Compiles an AST into a linear postfix program
+ *
+ * Constants become pushes, variables become loads and every operator node becomes
+ * an arithmetic instruction emitted after the instructions of both of its children
+ *
+ * @param[in] ast AST to compile
+ *
+ * @return Compiled program (empty if the AST is empty)
+ */
+[[nodiscard]] Program compile(const AST::Tree& ast);
+
+} // namespace Bytecode
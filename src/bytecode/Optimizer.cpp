@@ -0,0 +1,283 @@
+#include "Optimizer.hpp"
+
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "utils/Constants.hpp"
+
+namespace {
+using namespace Utils::Constants;
+
+/**
+ * @brief Outcome of the simplification of an AST node
+ */
+struct Simplification
+{
+    /// Folded value of the node (empty if the node could not be folded)
+    std::optional<int32_t> constant;
+    /// Index of the node (in the original AST) the simplified node is made of
+    /// (either a variable or an operator whose children are simplified as well)
+    AST::NodeIndex nodeIndex{AST::cNullNodeIndex};
+    /// Whether the node is only made of additions, subtractions and leaves,
+    /// in which case its value is guaranteed to be finite
+    bool isFinite{true};
+};
+
+/**
+ * @brief Applies an arithmetic operator the way the virtual machine does (in single precision)
+ *
+ * @param[in] operation Operator character
+ * @param[in] leftValue Left operand
+ * @param[in] rightValue Right operand
+ *
+ * @return Result of the operation
+ */
+float applyOperator(const char operation, const float leftValue, const float rightValue)
+{
+    switch (operation) {
+    case cAddOp:
+        return leftValue + rightValue;
+    case cSubOp:
+        return leftValue - rightValue;
+    case cMultOp:
+        return leftValue * rightValue;
+    case cDivOp:
+    default:
+        return leftValue / rightValue;
+    }
+}
+
+/**
+ * @brief Converts the result of a folded operation to an integer literal
+ *
+ * @param[in] value Result of the operation
+ *
+ * @return Integer literal holding the exact same value (empty if there is none)
+ */
+std::optional<int32_t> toConstant(const float value)
+{
+    constexpr auto cLowestValue = static_cast<float>(std::numeric_limits<int32_t>::min());
+
+    // Infinities and NaNs (e.g. divisions by zero) are rejected by the range comparisons,
+    // fractional values are the ones changed by a truncation
+    if (!(value >= cLowestValue && value < -cLowestValue)
+        || std::bit_cast<uint32_t>(std::trunc(value)) != std::bit_cast<uint32_t>(value)) {
+        return std::nullopt;
+    }
+
+    return static_cast<int32_t>(value);
+}
+
+/**
+ * @brief Checks if a simplified node is a given constant
+ *
+ * @param[in] simplification Simplified node
+ * @param[in] value Constant to compare with
+ *
+ * @return True if the node was folded into the given constant (false otherwise)
+ */
+bool isConstant(const Simplification& simplification, const int32_t value)
+{
+    return simplification.constant == value;
+}
+
+/**
+ * @brief Checks if two simplified nodes are structurally identical
+ *
+ * @param[in] ast Original AST
+ * @param[in] simplifications Simplification of every node of the original AST
+ * @param[in] left First simplified node
+ * @param[in] right Second simplified node
+ *
+ * @return True if both nodes always evaluate to the same value (false otherwise)
+ */
+bool areIdentical(const AST::Tree& ast,
+                  const std::vector<Simplification>& simplifications,
+                  const Simplification& left,
+                  const Simplification& right)
+{
+    std::vector<std::pair<const Simplification*, const Simplification*>> pendingPairs{
+          {&left, &right}};
+
+    while (!pendingPairs.empty()) {
+        const auto [leftNode, rightNode] = pendingPairs.back();
+        pendingPairs.pop_back();
+
+        if (leftNode->constant || rightNode->constant) {
+            if (leftNode->constant != rightNode->constant) {
+                return false;
+            }
+            continue;
+        }
+
+        const auto& leftASTNode = ast.getNode(leftNode->nodeIndex);
+        const auto& rightASTNode = ast.getNode(rightNode->nodeIndex);
+
+        if (leftASTNode.getNodeType() != rightASTNode.getNodeType()) {
+            return false;
+        }
+
+        if (leftASTNode.getNodeType() == AST::NodeType::VARIABLE) {
+            if (leftASTNode.getSymbolId() != rightASTNode.getSymbolId()) {
+                return false;
+            }
+            continue;
+        }
+
+        if (leftASTNode.getOperator() != rightASTNode.getOperator()) {
+            return false;
+        }
+
+        pendingPairs.emplace_back(&simplifications[leftASTNode.getLeftNodeIndex()],
+                                  &simplifications[rightASTNode.getLeftNodeIndex()]);
+        pendingPairs.emplace_back(&simplifications[leftASTNode.getRightNodeIndex()],
+                                  &simplifications[rightASTNode.getRightNodeIndex()]);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Simplifies an operator node whose children are already simplified
+ *
+ * @param[in] ast Original AST
+ * @param[in] simplifications Simplification of every node preceding the operator node
+ * @param[in] nodeIndex Index of the operator node
+ *
+ * @return Simplification of the operator node
+ */
+Simplification simplifyOperator(const AST::Tree& ast,
+                                const std::vector<Simplification>& simplifications,
+                                const AST::NodeIndex nodeIndex)
+{
+    const auto& node = ast.getNode(nodeIndex);
+    const auto operation = node.getOperator();
+    const auto& left = simplifications[node.getLeftNodeIndex()];
+    const auto& right = simplifications[node.getRightNodeIndex()];
+
+    // Fold constant sub-expressions
+    if (left.constant && right.constant) {
+        const auto value = applyOperator(
+              operation, static_cast<float>(*left.constant), static_cast<float>(*right.constant));
+
+        if (const auto constant = toConstant(value)) {
+            return {constant, AST::cNullNodeIndex, true};
+        }
+    }
+
+    switch (operation) {
+    case cAddOp:
+        if (isConstant(left, 0)) {
+            return right;
+        }
+        if (isConstant(right, 0)) {
+            return left;
+        }
+        break;
+    case cSubOp:
+        if (isConstant(right, 0)) {
+            return left;
+        }
+        if (left.isFinite && right.isFinite && areIdentical(ast, simplifications, left, right)) {
+            return {0, AST::cNullNodeIndex, true};
+        }
+        break;
+    case cMultOp:
+        if (isConstant(left, 1)) {
+            return right;
+        }
+        if (isConstant(right, 1)) {
+            return left;
+        }
+        if ((isConstant(left, 0) && right.isFinite) || (isConstant(right, 0) && left.isFinite)) {
+            return {0, AST::cNullNodeIndex, true};
+        }
+        break;
+    case cDivOp:
+        if (isConstant(right, 1)) {
+            return left;
+        }
+        break;
+    default:
+        break;
+    }
+
+    const auto isFinite
+          = (operation == cAddOp || operation == cSubOp) && left.isFinite && right.isFinite;
+    return {std::nullopt, nodeIndex, isFinite};
+}
+} // namespace
+
+namespace Bytecode {
+
+AST::Tree simplify(const AST::Tree& ast)
+{
+    if (ast.empty()) {
+        return {};
+    }
+
+    // Nodes are stored in post-order: children are always simplified before their parent
+    std::vector<Simplification> simplifications;
+    simplifications.reserve(ast.size());
+
+    const auto nodes = ast.getNodes();
+    for (AST::NodeIndex nodeIndex = 0; nodeIndex < nodes.size(); ++nodeIndex) {
+        switch (nodes[nodeIndex].getNodeType()) {
+        case AST::NodeType::CONSTANT:
+            simplifications.push_back({nodes[nodeIndex].getConstant(), nodeIndex, true});
+            break;
+        case AST::NodeType::VARIABLE:
+            simplifications.push_back({std::nullopt, nodeIndex, true});
+            break;
+        case AST::NodeType::OPERATOR:
+            simplifications.push_back(simplifyOperator(ast, simplifications, nodeIndex));
+            break;
+        }
+    }
+
+    // Rebuild the AST from the simplified root, skipping the discarded sub-expressions.
+    // Iterative post-order traversal: every operator is visited twice,
+    // first to schedule its children and then to add its own node
+    AST::Tree simplifiedAST(ast.size());
+    std::vector<AST::NodeIndex> valueStack;
+    std::vector<std::pair<const Simplification*, bool>> pendingNodes{
+          {&simplifications.back(), false}};
+
+    while (!pendingNodes.empty()) {
+        const auto [simplification, childrenAdded] = pendingNodes.back();
+        pendingNodes.pop_back();
+
+        if (simplification->constant) {
+            valueStack.push_back(simplifiedAST.addConstant(*simplification->constant));
+            continue;
+        }
+
+        const auto& node = ast.getNode(simplification->nodeIndex);
+        if (node.getNodeType() == AST::NodeType::VARIABLE) {
+            valueStack.push_back(simplifiedAST.addVariable(node.getSymbolId()));
+            continue;
+        }
+
+        if (!childrenAdded) {
+            // The left child must be added first, so it is pushed last
+            pendingNodes.emplace_back(simplification, true);
+            pendingNodes.emplace_back(&simplifications[node.getRightNodeIndex()], false);
+            pendingNodes.emplace_back(&simplifications[node.getLeftNodeIndex()], false);
+            continue;
+        }
+
+        const auto rightNode = valueStack.back();
+        valueStack.pop_back();
+        const auto leftNode = valueStack.back();
+        valueStack.pop_back();
+        valueStack.push_back(simplifiedAST.addOperator(node.getOperator(), leftNode, rightNode));
+    }
+
+    return simplifiedAST;
+}
+
+} // namespace Bytecode
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "ast/Node.hpp"
+
+namespace Bytecode {
+
+/**
+ * @brief Simplifies an AST before it is compiled
+ *
+ * The simplified AST evaluates to the same value as the original one:
+ * - constant sub-expressions are folded, as long as their value is an integer
+ *   (e.g. "(2+3)*x" becomes "5*x", while "7/2" is kept as is);
+ * - divisions by a constant zero are never folded, they keep failing at evaluation time;
+ * - "x*1", "1*x", "x/1", "x+0", "0+x" and "x-0" are replaced by "x";
+ * - "x*0", "0*x" and "x-x" are replaced by "0", but only when "x" is made of additions and
+ *   subtractions (its value is then always finite, whereas "(1/0)*0" must remain undefined).
+ *
+ * Variables only referenced by discarded sub-expressions do not appear in the simplified AST,
+ * so they are no longer dependencies of the expression.
+ *
+ * @param[in] ast AST to simplify
+ *
+ * @return Simplified AST (empty if the AST is empty)
+ */
+[[nodiscard]] AST::Tree simplify(const AST::Tree& ast);
+
+} // namespace Bytecode
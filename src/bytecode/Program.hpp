@@ -0,0 +1,166 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "symbols/SymbolTable.hpp"
+
+namespace Bytecode {
+
+/**
+ * @brief Operation codes supported by the stack virtual machine
+ */
+enum class OpCode : uint8_t {
+
+    PUSH_CONST = 0, // Push a constant onto the stack
+    LOAD_VAR = 1,   // Push the value of a variable slot onto the stack
+    ADD = 2,        // Pop two values and push their sum
+    SUB = 3,        // Pop two values and push their difference
+    MUL = 4,        // Pop two values and push their product
+    DIV = 5         // Pop two values and push their quotient
+};
+
+/**
+ * @brief Single instruction of a compiled program
+ *
+ * The operand holds either the bit pattern of a constant (PUSH_CONST)
+ * or the symbol identifier of a variable, which directly indexes its value slot (LOAD_VAR).
+ * Arithmetic instructions ignore it.
+ */
+struct Instruction
+{
+    /// Operation to perform
+    OpCode opCode{};
+    /// Operation argument
+    uint32_t operand{};
+
+    bool operator==(const Instruction&) const = default;
+};
+
+/**
+ * @brief Compiled representation of an arithmetic expression
+ *
+ * Holds a postfix instruction stream together with the set of variables it reads from.
+ */
+class Program
+{
+public:
+    /**
+     * @brief Appends an instruction that pushes a constant onto the stack
+     *
+     * @param[in] value Constant to push
+     */
+    void emitConstant(const float value)
+    {
+        emit({OpCode::PUSH_CONST, std::bit_cast<uint32_t>(value)}, +1);
+    }
+
+    /**
+     * @brief Appends an instruction that pushes the value of a variable onto the stack
+     *
+     * The variable is registered in the variables set the first time it is referenced
+     *
+     * @param[in] symbolId Symbol identifier of the variable to load
+     */
+    void emitVariable(const Symbols::SymbolId symbolId)
+    {
+        if (std::ranges::find(mVariables, symbolId) == mVariables.cend()) {
+            mVariables.push_back(symbolId);
+        }
+
+        emit({OpCode::LOAD_VAR, symbolId}, +1);
+    }
+
+    /**
+     * @brief Appends a binary arithmetic instruction
+     *
+     * @param[in] opCode Arithmetic operation to perform
+     */
+    void emitOperation(const OpCode opCode)
+    {
+        emit({opCode, 0}, -1);
+    }
+
+    /**
+     * @brief Getter for the instruction stream
+     *
+     * @return View over the instructions of the program (in execution order)
+     */
+    [[nodiscard]] std::span<const Instruction> getInstructions() const
+    {
+        return mInstructions;
+    }
+
+    /**
+     * @brief Getter for the variables set
+     *
+     * @return View over the distinct variables read by the program (in order of appearance)
+     */
+    [[nodiscard]] std::span<const Symbols::SymbolId> getVariables() const
+    {
+        return mVariables;
+    }
+
+    /**
+     * @brief Getter for the maximum amount of values held by the stack during execution
+     *
+     * @return Maximum stack depth
+     */
+    [[nodiscard]] uint32_t getMaxStackDepth() const
+    {
+        return mMaxStackDepth;
+    }
+
+    /**
+     * @brief Checks if the program has any instructions
+     *
+     * @return True if the program is empty (false otherwise)
+     */
+    [[nodiscard]] bool empty() const
+    {
+        return mInstructions.empty();
+    }
+
+    /**
+     * @brief Reserves space for a given amount of instructions
+     *
+     * @param[in] instructionCount Number of instructions to reserve space for
+     */
+    void reserve(const std::size_t instructionCount)
+    {
+        mInstructions.reserve(instructionCount);
+    }
+
+private:
+    /**
+     * @brief Appends an instruction and keeps track of the resulting stack depth
+     *
+     * @param[in] instruction Instruction to append
+     * @param[in] stackEffect Change in stack depth caused by the instruction
+     */
+    void emit(const Instruction& instruction, const int32_t stackEffect)
+    {
+        mInstructions.push_back(instruction);
+
+        mStackDepth = static_cast<uint32_t>(static_cast<int32_t>(mStackDepth) + stackEffect);
+        mMaxStackDepth = std::max(mMaxStackDepth, mStackDepth);
+    }
+
+private:
+    /// Postfix instruction stream
+    std::vector<Instruction> mInstructions;
+
+    /// Distinct variables read by the program
+    std::vector<Symbols::SymbolId> mVariables;
+
+    /// Stack depth after the last emitted instruction
+    uint32_t mStackDepth{0};
+
+    /// Maximum stack depth reached by the program
+    uint32_t mMaxStackDepth{0};
+};
+
+} // namespace Bytecode
@@ -0,0 +1,292 @@
+#include "ProgramImage.hpp"
+
+#include <cstring>
+#include <limits>
+#include <string>
+
+namespace {
+/// Magic number at the beginning of every image
+constexpr std::array<char, 8> cMagic{'C', 'A', 'L', 'C', 'P', 'R', 'O', 'G'};
+
+/**
+ * @brief Appends the bytes of a trivially copyable value to an image
+ *
+ * @param[in] value Value to append
+ * @param[in,out] image Image the value is appended to
+ */
+template <typename ValueType>
+void appendBytes(const ValueType& value, std::vector<std::byte>& image)
+{
+    const auto offset = image.size();
+    image.resize(offset + sizeof(ValueType));
+    std::memcpy(image.data() + offset, &value, sizeof(ValueType));
+}
+
+/**
+ * @brief Views a section of an image as an array of records
+ *
+ * @param[in] image Bytes of the image
+ * @param[in,out] offset Offset of the section, moved past it
+ * @param[in] count Number of records of the section
+ *
+ * @return View over the records, in place
+ */
+template <typename RecordType>
+std::span<const RecordType> viewSection(const std::span<const std::byte> image,
+                                        std::size_t& offset,
+                                        const std::size_t count)
+{
+    const auto* const records = reinterpret_cast<const RecordType*>(image.data() + offset);
+    offset += count * sizeof(RecordType);
+    return {records, count};
+}
+} // namespace
+
+namespace Bytecode {
+
+std::vector<std::byte> ProgramImage::write(const std::span<const Formula> formulas,
+                                           const Symbols::SymbolTable& symbolTable)
+{
+    // Symbols are numbered in order of appearance
+    constexpr auto cUnnumbered = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> symbolIndexes(symbolTable.size(), cUnnumbered);
+    std::vector<SymbolRecord> symbols;
+    std::string names;
+
+    const auto numberSymbol = [&](const Symbols::SymbolId symbolId) {
+        if (symbolIndexes[symbolId] == cUnnumbered) {
+            const auto& name = symbolTable.getName(symbolId);
+            symbolIndexes[symbolId] = static_cast<uint32_t>(symbols.size());
+            symbols.push_back({static_cast<uint32_t>(names.size()),
+                               static_cast<uint32_t>(name.size())});
+            names.append(name);
+        }
+        return symbolIndexes[symbolId];
+    };
+
+    std::vector<FormulaRecord> formulaRecords;
+    std::vector<std::byte> instructions;
+    std::vector<uint32_t> variables;
+    uint32_t instructionCount{0};
+
+    for (const auto& [target, program] : formulas) {
+        formulaRecords.push_back({numberSymbol(target),
+                                  instructionCount,
+                                  static_cast<uint32_t>(program->getInstructions().size()),
+                                  static_cast<uint32_t>(variables.size()),
+                                  static_cast<uint32_t>(program->getVariables().size()),
+                                  program->getMaxStackDepth()});
+
+        for (const auto variable : program->getVariables()) {
+            variables.push_back(numberSymbol(variable));
+        }
+
+        // Instructions are written field by field, so that their padding is zeroed
+        for (const auto& instruction : program->getInstructions()) {
+            const auto operand = instruction.opCode == OpCode::LOAD_VAR
+                                       ? symbolIndexes[instruction.operand]
+                                       : instruction.operand;
+
+            appendBytes(instruction.opCode, instructions);
+            instructions.resize(instructions.size() + offsetof(Instruction, operand) - 1);
+            appendBytes(operand, instructions);
+            ++instructionCount;
+        }
+    }
+
+    Header header{cMagic,
+                  cProgramImageVersion,
+                  static_cast<uint32_t>(symbols.size()),
+                  static_cast<uint32_t>(formulaRecords.size()),
+                  instructionCount,
+                  static_cast<uint32_t>(variables.size()),
+                  static_cast<uint32_t>(names.size())};
+
+    std::vector<std::byte> image;
+    image.reserve(sizeof(Header) + symbols.size() * sizeof(SymbolRecord)
+                  + formulaRecords.size() * sizeof(FormulaRecord) + instructions.size()
+                  + variables.size() * sizeof(uint32_t) + names.size());
+
+    appendBytes(header, image);
+    for (const auto& symbol : symbols) {
+        appendBytes(symbol, image);
+    }
+    for (const auto& formulaRecord : formulaRecords) {
+        appendBytes(formulaRecord, image);
+    }
+    image.insert(image.end(), instructions.begin(), instructions.end());
+    for (const auto variable : variables) {
+        appendBytes(variable, image);
+    }
+    const auto nameBytes = std::as_bytes(std::span{names});
+    image.insert(image.end(), nameBytes.begin(), nameBytes.end());
+
+    return image;
+}
+
+std::optional<ProgramImage> ProgramImage::open(const std::span<const std::byte> image)
+{
+    if (image.size() < sizeof(Header)
+        || reinterpret_cast<std::uintptr_t>(image.data()) % alignof(Header) != 0) {
+        return std::nullopt;
+    }
+
+    Header header;
+    std::memcpy(&header, image.data(), sizeof(Header));
+
+    if (header.magic != cMagic || header.version != cProgramImageVersion) {
+        return std::nullopt;
+    }
+
+    // Section sizes are computed on 64 bits: 32 bits counts cannot overflow them
+    const auto expectedSize = uint64_t{sizeof(Header)}
+                              + uint64_t{header.symbolCount} * sizeof(SymbolRecord)
+                              + uint64_t{header.formulaCount} * sizeof(FormulaRecord)
+                              + uint64_t{header.instructionCount} * sizeof(Instruction)
+                              + uint64_t{header.variableCount} * sizeof(uint32_t)
+                              + header.nameSize;
+    if (expectedSize != image.size()) {
+        return std::nullopt;
+    }
+
+    ProgramImage programImage{image};
+    if (!programImage.validate()) {
+        return std::nullopt;
+    }
+
+    return programImage;
+}
+
+ProgramImage::ProgramImage(const std::span<const std::byte> image)
+{
+    Header header;
+    std::memcpy(&header, image.data(), sizeof(Header));
+
+    auto offset = sizeof(Header);
+    mSymbols = viewSection<SymbolRecord>(image, offset, header.symbolCount);
+    mFormulas = viewSection<FormulaRecord>(image, offset, header.formulaCount);
+    mInstructions = viewSection<Instruction>(image, offset, header.instructionCount);
+    mVariables = viewSection<uint32_t>(image, offset, header.variableCount);
+    mNames = {reinterpret_cast<const char*>(image.data() + offset), header.nameSize};
+}
+
+bool ProgramImage::validate() const
+{
+    for (const auto& symbol : mSymbols) {
+        if (uint64_t{symbol.nameOffset} + symbol.nameSize > mNames.size()) {
+            return false;
+        }
+    }
+
+    // Loads must only read declared variables: those are the only ones checked before running
+    constexpr auto cUndeclared = std::numeric_limits<std::size_t>::max();
+    std::vector<std::size_t> declaringFormulas(mSymbols.size(), cUndeclared);
+
+    for (std::size_t formulaIndex = 0; formulaIndex < mFormulas.size(); ++formulaIndex) {
+        const auto& formula = mFormulas[formulaIndex];
+
+        if (formula.target >= mSymbols.size() || formula.instructionCount == 0
+            || uint64_t{formula.firstInstruction} + formula.instructionCount > mInstructions.size()
+            || uint64_t{formula.firstVariable} + formula.variableCount > mVariables.size()) {
+            return false;
+        }
+
+        const auto variables = mVariables.subspan(formula.firstVariable, formula.variableCount);
+        for (const auto variable : variables) {
+            if (variable >= mSymbols.size()) {
+                return false;
+            }
+            declaringFormulas[variable] = formulaIndex;
+        }
+
+        uint32_t stackDepth{0};
+        for (const auto& instruction :
+             mInstructions.subspan(formula.firstInstruction, formula.instructionCount)) {
+            switch (instruction.opCode) {
+            case OpCode::LOAD_VAR:
+                if (instruction.operand >= mSymbols.size()
+                    || declaringFormulas[instruction.operand] != formulaIndex) {
+                    return false;
+                }
+                [[fallthrough]];
+            case OpCode::PUSH_CONST:
+                ++stackDepth;
+                break;
+            case OpCode::ADD:
+            case OpCode::SUB:
+            case OpCode::MUL:
+            case OpCode::DIV:
+                if (stackDepth < 2) {
+                    return false;
+                }
+                --stackDepth;
+                break;
+            default:
+                return false;
+            }
+
+            if (stackDepth > formula.maxStackDepth) {
+                return false;
+            }
+        }
+
+        if (stackDepth != 1) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+std::size_t ProgramImage::getSymbolCount() const
+{
+    return mSymbols.size();
+}
+
+std::string_view ProgramImage::getSymbolName(const std::size_t symbolIndex) const
+{
+    const auto& symbol = mSymbols[symbolIndex];
+    return mNames.substr(symbol.nameOffset, symbol.nameSize);
+}
+
+std::size_t ProgramImage::getFormulaCount() const
+{
+    return mFormulas.size();
+}
+
+ImageFormula ProgramImage::getFormula(const std::size_t formulaIndex) const
+{
+    const auto& formula = mFormulas[formulaIndex];
+    return {formula.target,
+            mInstructions.subspan(formula.firstInstruction, formula.instructionCount),
+            mVariables.subspan(formula.firstVariable, formula.variableCount),
+            formula.maxStackDepth};
+}
+
+Program ProgramImage::bind(const ImageFormula& formula,
+                           const std::span<const Symbols::SymbolId> symbolBindings)
+{
+    Program program;
+    program.reserve(formula.instructions.size());
+
+    for (const auto& instruction : formula.instructions) {
+        switch (instruction.opCode) {
+        case OpCode::PUSH_CONST:
+            program.emitConstant(std::bit_cast<float>(instruction.operand));
+            break;
+        case OpCode::LOAD_VAR:
+            program.emitVariable(symbolBindings[instruction.operand]);
+            break;
+        case OpCode::ADD:
+        case OpCode::SUB:
+        case OpCode::MUL:
+        case OpCode::DIV:
+            program.emitOperation(instruction.opCode);
+            break;
+        }
+    }
+
+    return program;
+}
+
+} // namespace Bytecode
@@ -0,0 +1,218 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "bytecode/Program.hpp"
+#include "symbols/SymbolTable.hpp"
+
+namespace Bytecode {
+
+/// Version of the layout of program images
+inline constexpr uint32_t cProgramImageVersion{1};
+
+/**
+ * @brief Formula of a program image, viewed in place
+ *
+ * Variables are referenced by their index in the symbols of the image: they are bound
+ * to the symbols of a symbol table when the image is loaded
+ */
+struct ImageFormula
+{
+    /// Index (in the image) of the operand the formula is assigned to
+    uint32_t target{0};
+    /// Postfix instruction stream (LOAD_VAR operands are image symbol indexes)
+    std::span<const Instruction> instructions;
+    /// Distinct variables read by the formula (image symbol indexes, in order of appearance)
+    std::span<const uint32_t> variables;
+    /// Maximum stack depth reached by the formula
+    uint32_t maxStackDepth{0};
+};
+
+/**
+ * @brief Compiled formulas stored in a versioned, position-independent binary image
+ *
+ * An image is made of a fixed size header followed by five sections laid out back to back:
+ * symbols (offset and size of their name), formulas, instructions, variables and names.
+ * Sections only refer to each other through indexes, every field is a little endian
+ * integer aligned on its size, and instructions share the layout of Bytecode::Instruction:
+ * a memory mapped image is used in place, without any deserialization.
+ *
+ * Images are validated once when opened, so that formulas can then be executed safely
+ * (known operation codes, indexes within their sections, balanced stack).
+ */
+class ProgramImage
+{
+public:
+    /**
+     * @brief Formula to write into an image
+     */
+    struct Formula
+    {
+        /// Operand the formula is assigned to
+        Symbols::SymbolId target{0};
+        /// Compiled program of the formula
+        const Program* program{nullptr};
+    };
+
+    /**
+     * @brief Writes formulas into a new image
+     *
+     * Only the symbols referenced by the formulas are written, in order of appearance
+     *
+     * @param[in] formulas Formulas to write
+     * @param[in] symbolTable Symbol table the formulas were compiled with
+     *
+     * @return Image of the formulas
+     */
+    [[nodiscard]] static std::vector<std::byte> write(std::span<const Formula> formulas,
+                                                      const Symbols::SymbolTable& symbolTable);
+
+    /**
+     * @brief Opens an image held in memory (e.g. a mapped file), after validating it
+     *
+     * @param[in] image Bytes of the image (aligned on 4 bytes), which must outlive the view
+     *
+     * @return View over the image (empty if the image is malformed or of another version)
+     */
+    [[nodiscard]] static std::optional<ProgramImage> open(std::span<const std::byte> image);
+
+    /**
+     * @brief Getter for the number of symbols of the image
+     *
+     * @return Number of symbols
+     */
+    [[nodiscard]] std::size_t getSymbolCount() const;
+
+    /**
+     * @brief Retrieves the name of a symbol of the image
+     *
+     * @param[in] symbolIndex Index of the symbol in the image
+     *
+     * @return View over the name, in the image
+     */
+    [[nodiscard]] std::string_view getSymbolName(std::size_t symbolIndex) const;
+
+    /**
+     * @brief Getter for the number of formulas of the image
+     *
+     * @return Number of formulas
+     */
+    [[nodiscard]] std::size_t getFormulaCount() const;
+
+    /**
+     * @brief Retrieves a formula of the image
+     *
+     * @param[in] formulaIndex Index of the formula in the image
+     *
+     * @return View over the formula, in the image
+     */
+    [[nodiscard]] ImageFormula getFormula(std::size_t formulaIndex) const;
+
+    /**
+     * @brief Builds a program from a formula, bound to the symbols of a symbol table
+     *
+     * @param[in] formula Formula of the image
+     * @param[in] symbolBindings Symbol identifiers of the symbols of the image
+     *
+     * @return Program of the formula
+     */
+    [[nodiscard]] static Program bind(const ImageFormula& formula,
+                                      std::span<const Symbols::SymbolId> symbolBindings);
+
+private:
+    /**
+     * @brief Header of an image
+     */
+    struct Header
+    {
+        /// Magic number identifying images
+        std::array<char, 8> magic{};
+        /// Version of the layout of the image
+        uint32_t version{0};
+        /// Number of symbols
+        uint32_t symbolCount{0};
+        /// Number of formulas
+        uint32_t formulaCount{0};
+        /// Number of instructions of all formulas
+        uint32_t instructionCount{0};
+        /// Number of variables of all formulas
+        uint32_t variableCount{0};
+        /// Size of the names of all symbols
+        uint32_t nameSize{0};
+    };
+
+    /**
+     * @brief Symbol record of an image
+     */
+    struct SymbolRecord
+    {
+        /// Offset of the name in the names section
+        uint32_t nameOffset{0};
+        /// Size of the name
+        uint32_t nameSize{0};
+    };
+
+    /**
+     * @brief Formula record of an image
+     */
+    struct FormulaRecord
+    {
+        /// Index of the operand the formula is assigned to
+        uint32_t target{0};
+        /// Index of the first instruction of the formula in the instructions section
+        uint32_t firstInstruction{0};
+        /// Number of instructions of the formula
+        uint32_t instructionCount{0};
+        /// Index of the first variable of the formula in the variables section
+        uint32_t firstVariable{0};
+        /// Number of variables of the formula
+        uint32_t variableCount{0};
+        /// Maximum stack depth reached by the formula
+        uint32_t maxStackDepth{0};
+    };
+
+    static_assert(std::endian::native == std::endian::little,
+                  "Program images are little endian and read in place");
+    static_assert(sizeof(Instruction) == 8 && offsetof(Instruction, operand) == 4);
+    static_assert(sizeof(Header) == 32 && sizeof(SymbolRecord) == 8
+                  && sizeof(FormulaRecord) == 24);
+
+    /**
+     * @brief Class constructor
+     *
+     * @param[in] image Bytes of a validated image
+     */
+    explicit ProgramImage(std::span<const std::byte> image);
+
+    /**
+     * @brief Checks that the formulas of the image can be executed safely
+     *
+     * @return True if every formula is valid (false otherwise)
+     */
+    [[nodiscard]] bool validate() const;
+
+private:
+    /// Symbol records of the image
+    std::span<const SymbolRecord> mSymbols;
+
+    /// Formula records of the image
+    std::span<const FormulaRecord> mFormulas;
+
+    /// Instructions of all formulas
+    std::span<const Instruction> mInstructions;
+
+    /// Variables of all formulas
+    std::span<const uint32_t> mVariables;
+
+    /// Names of all symbols
+    std::string_view mNames;
+};
+
+} // namespace Bytecode
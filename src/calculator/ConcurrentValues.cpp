@@ -0,0 +1,255 @@
+#include "ConcurrentValues.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace {
+/// Version pinned by readers which are not reading
+constexpr uint64_t cNotPinned{UINT64_MAX};
+/// Number of nodes allocated at once by the writer
+constexpr std::size_t cNodeBlockSize{1024};
+/// Number of commits between two updates of the horizon (reading the pins of every reader
+/// on each commit would slow the writer down as readers come and go)
+constexpr uint64_t cHorizonUpdateInterval{64};
+
+/**
+ * @brief Locates the slot of an operand in the chunks of slots
+ *
+ * @param[in] operand Operand to locate
+ * @param[in] firstChunkSize Number of slots of the first chunk
+ *
+ * @return Index of the chunk holding the slot and index of the slot in the chunk
+ */
+std::pair<std::size_t, std::size_t> locateSlot(const Symbols::SymbolId operand,
+                                               const std::size_t firstChunkSize)
+{
+    // Chunk k holds the operands [firstChunkSize * (2^k - 1), firstChunkSize * (2^(k+1) - 1))
+    const auto chunkIndex
+          = static_cast<std::size_t>(std::bit_width(operand / firstChunkSize + 1)) - 1;
+    const auto chunkBegin = firstChunkSize * ((std::size_t{1} << chunkIndex) - 1);
+
+    return {chunkIndex, operand - chunkBegin};
+}
+} // namespace
+
+namespace Calculator {
+
+std::optional<ConcurrentValues::Reader> ConcurrentValues::Reader::attach(
+      std::shared_ptr<ConcurrentValues> values)
+{
+    for (std::size_t readerIndex = 0; readerIndex < values->mReaders.size(); ++readerIndex) {
+        bool isAttached{false};
+        if (values->mReaders[readerIndex].isAttached.compare_exchange_strong(isAttached, true)) {
+            // The slot is counted before the reader pins any version
+            auto usedReaderCount = values->mUsedReaderCount.load();
+            while (usedReaderCount <= readerIndex
+                   && !values->mUsedReaderCount.compare_exchange_weak(usedReaderCount,
+                                                                      readerIndex + 1)) {
+            }
+
+            return Reader{std::move(values), readerIndex};
+        }
+    }
+
+    return std::nullopt;
+}
+
+ConcurrentValues::Reader::Reader(std::shared_ptr<ConcurrentValues> values,
+                                 const std::size_t readerIndex)
+    : mValues{std::move(values)}
+    , mReaderIndex{readerIndex}
+{
+}
+
+ConcurrentValues::Reader::Reader(Reader&& other) noexcept
+    : mValues{std::move(other.mValues)}
+    , mReaderIndex{other.mReaderIndex}
+{
+}
+
+ConcurrentValues::Reader& ConcurrentValues::Reader::operator=(Reader&& other) noexcept
+{
+    if (this != &other) {
+        detach();
+        mValues = std::move(other.mValues);
+        mReaderIndex = other.mReaderIndex;
+    }
+
+    return *this;
+}
+
+ConcurrentValues::Reader::~Reader()
+{
+    detach();
+}
+
+void ConcurrentValues::Reader::read(Snapshot& snapshot)
+{
+    mValues->readSnapshot(mReaderIndex, snapshot);
+}
+
+void ConcurrentValues::Reader::detach()
+{
+    if (mValues) {
+        mValues->mReaders[mReaderIndex].isAttached.store(false, std::memory_order_release);
+        mValues.reset();
+    }
+}
+
+ConcurrentValues::ConcurrentValues() = default;
+
+ConcurrentValues::~ConcurrentValues() = default;
+
+void ConcurrentValues::write(const Symbols::SymbolId operand, const Symbols::ValueSlot value)
+{
+    auto& slot = getWritableSlot(operand);
+    const auto version = mCommittedVersion.load(std::memory_order_relaxed) + 1;
+    auto* const latest = slot.latest.load(std::memory_order_relaxed);
+
+    // Readers never look at the value of an uncommitted node: it can be overwritten in place
+    if (latest && latest->version == version) {
+        latest->value = value;
+        return;
+    }
+
+    auto* const node = allocateNode();
+    node->version = version;
+    node->value = value;
+    node->previous.store(latest, std::memory_order_relaxed);
+    slot.latest.store(node, std::memory_order_release);
+
+    pruneHistory(slot);
+}
+
+void ConcurrentValues::commit(const Symbols::SymbolTable& symbolTable)
+{
+    const auto publishedCount = mPublishedCount.load(std::memory_order_relaxed);
+    for (auto operand = publishedCount; operand < symbolTable.size(); ++operand) {
+        getWritableSlot(static_cast<Symbols::SymbolId>(operand)).name
+              = symbolTable.getName(static_cast<Symbols::SymbolId>(operand));
+    }
+
+    mPublishedCount.store(std::max(publishedCount, symbolTable.size()), std::memory_order_release);
+    mCommittedVersion.store(mCommittedVersion.load(std::memory_order_relaxed) + 1,
+                            std::memory_order_release);
+
+    if (++mCommitsSinceHorizonUpdate >= cHorizonUpdateInterval) {
+        mCommitsSinceHorizonUpdate = 0;
+        updateHorizon();
+    }
+}
+
+uint64_t ConcurrentValues::getVersion() const
+{
+    return mCommittedVersion.load(std::memory_order_acquire);
+}
+
+ConcurrentValues::Slot& ConcurrentValues::getWritableSlot(const Symbols::SymbolId operand)
+{
+    const auto [chunkIndex, slotIndex] = locateSlot(operand, cFirstChunkSize);
+
+    auto& chunk = mChunkStorage[chunkIndex];
+    if (!chunk) {
+        chunk = std::make_unique<Slot[]>(cFirstChunkSize << chunkIndex);
+        mChunks[chunkIndex].store(chunk.get(), std::memory_order_release);
+    }
+
+    return chunk[slotIndex];
+}
+
+const ConcurrentValues::Slot& ConcurrentValues::getSlot(const Symbols::SymbolId operand) const
+{
+    const auto [chunkIndex, slotIndex] = locateSlot(operand, cFirstChunkSize);
+    return mChunks[chunkIndex].load(std::memory_order_acquire)[slotIndex];
+}
+
+ConcurrentValues::Node* ConcurrentValues::allocateNode()
+{
+    if (mFreeNodes.empty()) {
+        auto& block = mNodeBlocks.emplace_back(std::make_unique<Node[]>(cNodeBlockSize));
+        for (std::size_t index = 0; index < cNodeBlockSize; ++index) {
+            mFreeNodes.push_back(&block[index]);
+        }
+    }
+
+    auto* const node = mFreeNodes.back();
+    mFreeNodes.pop_back();
+    return node;
+}
+
+void ConcurrentValues::pruneHistory(Slot& slot)
+{
+    // Nothing more can be recycled until the prune version moves
+    if (slot.prunedVersion == mPruneVersion) {
+        return;
+    }
+    slot.prunedVersion = mPruneVersion;
+
+    // Every reader stops at the newest node not newer than the prune version at the latest:
+    // the nodes after it are unreachable
+    auto* node = slot.latest.load(std::memory_order_relaxed);
+    while (node && node->version > mPruneVersion) {
+        node = node->previous.load(std::memory_order_relaxed);
+    }
+
+    if (!node) {
+        return;
+    }
+
+    auto* unreachable = node->previous.load(std::memory_order_relaxed);
+    node->previous.store(nullptr, std::memory_order_relaxed);
+
+    while (unreachable) {
+        mFreeNodes.push_back(unreachable);
+        unreachable = unreachable->previous.load(std::memory_order_relaxed);
+    }
+}
+
+void ConcurrentValues::updateHorizon()
+{
+    // The horizon is published before reading the pins: a reader pinning an older version
+    // concurrently either has its pin seen here or sees the new horizon and pins again
+    auto pruneVersion = mCommittedVersion.load(std::memory_order_relaxed);
+    mHorizon.store(pruneVersion, std::memory_order_seq_cst);
+
+    const auto usedReaderCount = mUsedReaderCount.load(std::memory_order_seq_cst);
+    for (std::size_t readerIndex = 0; readerIndex < usedReaderCount; ++readerIndex) {
+        pruneVersion = std::min(pruneVersion,
+                                mReaders[readerIndex].pinnedVersion.load(std::memory_order_seq_cst));
+    }
+
+    mPruneVersion = pruneVersion;
+}
+
+void ConcurrentValues::readSnapshot(const std::size_t readerIndex, Snapshot& snapshot)
+{
+    auto& pinnedVersion = mReaders[readerIndex].pinnedVersion;
+
+    uint64_t version{};
+    do {
+        version = mCommittedVersion.load(std::memory_order_acquire);
+        pinnedVersion.store(version, std::memory_order_seq_cst);
+    } while (mHorizon.load(std::memory_order_seq_cst) > version);
+
+    const auto operandCount = mPublishedCount.load(std::memory_order_acquire);
+    snapshot.version = version;
+    snapshot.names.resize(operandCount);
+    snapshot.values.resize(operandCount);
+
+    for (std::size_t operand = 0; operand < operandCount; ++operand) {
+        const auto& slot = getSlot(static_cast<Symbols::SymbolId>(operand));
+
+        // Operands without any value as of the pinned version are reported undefined
+        const auto* node = slot.latest.load(std::memory_order_acquire);
+        while (node && node->version > version) {
+            node = node->previous.load(std::memory_order_acquire);
+        }
+
+        snapshot.names[operand] = slot.name;
+        snapshot.values[operand] = node ? node->value : Symbols::ValueSlot{};
+    }
+
+    pinnedVersion.store(cNotPinned, std::memory_order_release);
+}
+
+} // namespace Calculator
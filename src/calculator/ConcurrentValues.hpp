@@ -0,0 +1,259 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "symbols/SymbolTable.hpp"
+#include "symbols/ValueSlot.hpp"
+
+namespace Calculator {
+
+/// Maximum number of readers attached at once to the values shared by a state
+inline constexpr std::size_t cMaxConcurrentReaderCount{64};
+
+/**
+ * @brief Values of the operands shared by a single writer with any number of reader threads
+ *
+ * The writer (the thread updating the state) writes values and commits them as a whole:
+ * readers take consistent snapshots of every value as of a committed version, without locks
+ * and without ever making the writer wait.
+ *
+ * Every write pushes an immutable (version, value) node in front of the history of its operand.
+ * A reader pins the last committed version and, for each operand, walks back its history to the
+ * latest node not newer than that version. The writer recycles the nodes older than every
+ * pinned version (the horizon), so histories stay short. The horizon is published before the
+ * pins are read and readers check it after pinning: either the writer sees the pin or the reader
+ * sees the new horizon and pins again, so a reader never walks into a recycled node.
+ */
+class ConcurrentValues
+{
+public:
+    /**
+     * @brief Consistent copy of the values of every operand
+     */
+    struct Snapshot
+    {
+        /// Number of commits the snapshot reflects
+        uint64_t version{0};
+        /// Names of the operands, indexed by symbol identifier (valid while the values are shared)
+        std::vector<std::string_view> names;
+        /// Values of the operands, indexed by symbol identifier
+        std::vector<Symbols::ValueSlot> values;
+    };
+
+    /**
+     * @brief Handle of a thread reading the shared values
+     */
+    class Reader
+    {
+    public:
+        /**
+         * @brief Attaches a reader to shared values
+         *
+         * @param[in] values Values to read
+         *
+         * @return Attached reader (empty if too many readers are attached already)
+         */
+        [[nodiscard]] static std::optional<Reader> attach(std::shared_ptr<ConcurrentValues> values);
+
+        Reader(Reader&& other) noexcept;
+        Reader& operator=(Reader&& other) noexcept;
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        /**
+         * @brief Class destructor, detaches the reader
+         */
+        ~Reader();
+
+        /**
+         * @brief Takes a snapshot of the last committed values (never blocks the writer)
+         *
+         * @param[out] snapshot Snapshot to fill (its buffers are reused)
+         */
+        void read(Snapshot& snapshot);
+
+    private:
+        /**
+         * @brief Class constructor
+         *
+         * @param[in] values Values to read
+         * @param[in] readerIndex Index of the slot holding the pinned version of the reader
+         */
+        Reader(std::shared_ptr<ConcurrentValues> values, std::size_t readerIndex);
+
+        /**
+         * @brief Releases the slot of the reader
+         */
+        void detach();
+
+    private:
+        /// Values read by the reader (null once moved from)
+        std::shared_ptr<ConcurrentValues> mValues;
+
+        /// Index of the slot holding the pinned version of the reader
+        std::size_t mReaderIndex;
+    };
+
+    ConcurrentValues();
+
+    ConcurrentValues(const ConcurrentValues&) = delete;
+    ConcurrentValues& operator=(const ConcurrentValues&) = delete;
+
+    ~ConcurrentValues();
+
+    /**
+     * @brief Writes the value of an operand, visible to the readers once committed (writer only)
+     *
+     * @param[in] operand Operand to update
+     * @param[in] value New value slot of the operand
+     */
+    void write(Symbols::SymbolId operand, Symbols::ValueSlot value);
+
+    /**
+     * @brief Makes every value written since the last commit visible at once (writer only)
+     *
+     * @param[in] symbolTable Symbol table whose new names are shared along with the values
+     */
+    void commit(const Symbols::SymbolTable& symbolTable);
+
+    /**
+     * @brief Getter for the number of commits
+     *
+     * @return Last committed version
+     */
+    [[nodiscard]] uint64_t getVersion() const;
+
+private:
+    /**
+     * @brief Value of an operand from a given version on
+     */
+    struct Node
+    {
+        /// Version the value was written in
+        uint64_t version{0};
+        /// Value of the operand
+        Symbols::ValueSlot value{};
+        /// Previous value of the operand (cut once no reader needs it anymore)
+        std::atomic<Node*> previous{nullptr};
+    };
+
+    /**
+     * @brief Shared state of an operand
+     */
+    struct Slot
+    {
+        /// Latest value of the operand (null if it was never written)
+        std::atomic<Node*> latest{nullptr};
+        /// Name of the operand (set before the operand is published)
+        std::string name;
+        /// Prune version the history was last pruned with (writer only)
+        uint64_t prunedVersion{0};
+    };
+
+    /**
+     * @brief Version pinned by an attached reader (on its own cache line)
+     */
+    struct alignas(64) ReaderSlot
+    {
+        /// Whether a reader is attached to the slot
+        std::atomic<bool> isAttached{false};
+        /// Version the reader is reading (maximum when it is not reading)
+        std::atomic<uint64_t> pinnedVersion{UINT64_MAX};
+    };
+
+    /**
+     * @brief Retrieves the slot of an operand, allocating its chunk if needed (writer only)
+     *
+     * @param[in] operand Operand whose slot is to be retrieved
+     *
+     * @return Reference to the slot
+     */
+    Slot& getWritableSlot(Symbols::SymbolId operand);
+
+    /**
+     * @brief Retrieves the slot of a published operand
+     *
+     * @param[in] operand Operand whose slot is to be retrieved
+     *
+     * @return Reference to the slot
+     */
+    [[nodiscard]] const Slot& getSlot(Symbols::SymbolId operand) const;
+
+    /**
+     * @brief Takes a node from the pool of free nodes (writer only)
+     *
+     * @return Free node
+     */
+    Node* allocateNode();
+
+    /**
+     * @brief Recycles the history of an operand older than the newest node every reader
+     * can still see, once per update of the horizon (writer only)
+     *
+     * @param[in,out] slot Slot of the operand
+     */
+    void pruneHistory(Slot& slot);
+
+    /**
+     * @brief Publishes a new horizon and computes the version below which the histories
+     * can be pruned (writer only)
+     */
+    void updateHorizon();
+
+    /**
+     * @brief Takes a snapshot of the last committed values
+     *
+     * @param[in] readerIndex Index of the slot of the reader
+     * @param[out] snapshot Snapshot to fill
+     */
+    void readSnapshot(std::size_t readerIndex, Snapshot& snapshot);
+
+private:
+    /// Number of slots of the first chunk (each chunk is twice as large as the previous one)
+    static constexpr std::size_t cFirstChunkSize{1024};
+
+    /// Maximum number of chunks of slots
+    static constexpr std::size_t cMaxChunkCount{32};
+
+    /// Chunks of slots, never moved once allocated so that readers can follow them
+    std::array<std::atomic<Slot*>, cMaxChunkCount> mChunks{};
+
+    /// Storage of the chunks of slots (writer only)
+    std::array<std::unique_ptr<Slot[]>, cMaxChunkCount> mChunkStorage;
+
+    /// Number of operands whose name is published
+    std::atomic<std::size_t> mPublishedCount{0};
+
+    /// Last committed version
+    std::atomic<uint64_t> mCommittedVersion{0};
+
+    /// Version readers must pin at least (the writer may prune anything older)
+    std::atomic<uint64_t> mHorizon{0};
+
+    /// Versions pinned by the attached readers
+    std::array<ReaderSlot, cMaxConcurrentReaderCount> mReaders;
+
+    /// Number of reader slots ever used (the others are not scanned by the writer)
+    std::atomic<std::size_t> mUsedReaderCount{0};
+
+    /// Version below which the writer prunes the histories (writer only)
+    uint64_t mPruneVersion{0};
+
+    /// Number of commits since the horizon was last updated (writer only)
+    uint64_t mCommitsSinceHorizonUpdate{0};
+
+    /// Blocks of nodes, released along with the values (writer only)
+    std::vector<std::unique_ptr<Node[]>> mNodeBlocks;
+
+    /// Nodes ready to be reused (writer only)
+    std::vector<Node*> mFreeNodes;
+};
+
+} // namespace Calculator
@@ -0,0 +1,195 @@
+#include "DependencyOrder.hpp"
+
+#include <algorithm>
+
+namespace Calculator {
+
+std::span<const Symbols::SymbolId>
+      DependencyOrder::insertDependencies(const Symbols::SymbolId operand,
+                                          const std::span<const Symbols::SymbolId> dependencies,
+                                          const PropagationEngine::DependencyGraph& dependencyGraph,
+                                          const DependencyLookup& dependencyLookup)
+{
+    reserve(dependencyGraph.size());
+    mCycle.clear();
+
+    // An operand which neither depends on anything nor is depended on yet can be placed before
+    // every other operand, as long as its dependencies are placed before it as well: when they
+    // do not depend on anything either (e.g. formulas defined before their inputs), they are
+    // then moved to the front one by one below. Left where it was created (after every operand),
+    // a later dependency on it from an operand placed earlier would reorder everything in between
+    if (dependencyGraph[operand].empty() && dependencyLookup(operand).empty()
+        && std::ranges::all_of(dependencies, [&](const Symbols::SymbolId dependency) {
+               return dependency != operand && dependencyLookup(dependency).empty();
+           })) {
+        mPositions[operand] = --mFirstPosition;
+    }
+
+    for (const auto dependency : dependencies) {
+        if (dependency == operand) {
+            mCycle.assign({operand, operand});
+            return mCycle;
+        }
+
+        // The order already agrees with the new dependency
+        if (mPositions[dependency] < mPositions[operand]) {
+            continue;
+        }
+
+        // A dependency without dependencies of its own can simply be placed before every other
+        // operand (positions only have to be distinct, not consecutive)
+        if (dependencyLookup(dependency).empty()) {
+            mPositions[dependency] = --mFirstPosition;
+            continue;
+        }
+
+        // Only the operands placed between the two ends of the dependency may have to move:
+        // the dependants of the operand placed before the dependency...
+        beginSearch();
+        if (collectDependants(operand, dependency, dependencyGraph)) {
+            // The dependency depends on the operand: walk back to the operand
+            mCycle.push_back(operand);
+            for (auto cycleOperand = dependency; cycleOperand != operand;
+                 cycleOperand = mParents[cycleOperand]) {
+                mCycle.push_back(cycleOperand);
+            }
+            mCycle.push_back(operand);
+            return mCycle;
+        }
+
+        // ...and the dependencies of the dependency placed after the operand
+        collectDependencies(dependency, mPositions[operand], dependencyLookup);
+        reorder();
+    }
+
+    return mCycle;
+}
+
+int64_t DependencyOrder::getPosition(const Symbols::SymbolId operand) const
+{
+    return operand < mPositions.size() ? mPositions[operand] : static_cast<int64_t>(operand);
+}
+
+int64_t DependencyOrder::getFirstPosition() const
+{
+    return mFirstPosition;
+}
+
+void DependencyOrder::restore(const std::span<const int64_t> positions,
+                              const int64_t firstPosition)
+{
+    mPositions.assign(positions.begin(), positions.end());
+    mFirstPosition = firstPosition;
+}
+
+void DependencyOrder::reserve(const std::size_t operandCount)
+{
+    // New operands do not have any dependency yet: they are placed last
+    for (auto operand = mPositions.size(); operand < operandCount; ++operand) {
+        mPositions.push_back(static_cast<int64_t>(operand));
+    }
+
+    if (mVisitStamps.size() < operandCount) {
+        mVisitStamps.resize(operandCount, 0);
+        mParents.resize(operandCount, 0);
+    }
+}
+
+void DependencyOrder::beginSearch()
+{
+    // Stamps are only cleared when the search counter wraps around
+    if (++mSearchStamp == 0) {
+        std::ranges::fill(mVisitStamps, 0);
+        mSearchStamp = 1;
+    }
+}
+
+bool DependencyOrder::collectDependants(const Symbols::SymbolId operand,
+                                        const Symbols::SymbolId dependency,
+                                        const PropagationEngine::DependencyGraph& dependencyGraph)
+{
+    const auto upperBound = mPositions[dependency];
+
+    mDependants.assign(1, operand);
+    mVisitStamps[operand] = mSearchStamp;
+    mOperandsToVisit.assign(1, operand);
+
+    while (!mOperandsToVisit.empty()) {
+        const auto visitedOperand = mOperandsToVisit.back();
+        mOperandsToVisit.pop_back();
+
+        for (const auto dependantOperand : dependencyGraph[visitedOperand]) {
+            if (mVisitStamps[dependantOperand] == mSearchStamp
+                || mPositions[dependantOperand] > upperBound) {
+                continue;
+            }
+
+            mVisitStamps[dependantOperand] = mSearchStamp;
+            mParents[dependantOperand] = visitedOperand;
+
+            if (dependantOperand == dependency) {
+                mOperandsToVisit.clear();
+                return true;
+            }
+
+            mDependants.push_back(dependantOperand);
+            mOperandsToVisit.push_back(dependantOperand);
+        }
+    }
+
+    return false;
+}
+
+void DependencyOrder::collectDependencies(const Symbols::SymbolId dependency,
+                                          const int64_t lowerBound,
+                                          const DependencyLookup& dependencyLookup)
+{
+    // Operands collected as dependants were stamped by the same search: since the dependency
+    // does not depend on the operand, none of them can be reached again from here
+    mDependencies.assign(1, dependency);
+    mVisitStamps[dependency] = mSearchStamp;
+    mOperandsToVisit.assign(1, dependency);
+
+    while (!mOperandsToVisit.empty()) {
+        const auto visitedOperand = mOperandsToVisit.back();
+        mOperandsToVisit.pop_back();
+
+        for (const auto dependencyOperand : dependencyLookup(visitedOperand)) {
+            if (mVisitStamps[dependencyOperand] == mSearchStamp
+                || mPositions[dependencyOperand] <= lowerBound) {
+                continue;
+            }
+
+            mVisitStamps[dependencyOperand] = mSearchStamp;
+            mDependencies.push_back(dependencyOperand);
+            mOperandsToVisit.push_back(dependencyOperand);
+        }
+    }
+}
+
+void DependencyOrder::reorder()
+{
+    const auto byPosition = [this](const auto operand) { return mPositions[operand]; };
+
+    // Both sets keep their relative order, dependencies take the lowest freed positions
+    std::ranges::sort(mDependencies, {}, byPosition);
+    std::ranges::sort(mDependants, {}, byPosition);
+
+    mFreedPositions.clear();
+    for (const auto operand : mDependencies) {
+        mFreedPositions.push_back(mPositions[operand]);
+    }
+    for (const auto operand : mDependants) {
+        mFreedPositions.push_back(mPositions[operand]);
+    }
+    std::ranges::sort(mFreedPositions);
+
+    auto freedPosition = mFreedPositions.cbegin();
+    for (const auto& movedOperands : {std::span{mDependencies}, std::span{mDependants}}) {
+        for (const auto operand : movedOperands) {
+            mPositions[operand] = *freedPosition++;
+        }
+    }
+}
+
+} // namespace Calculator
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+#include "PropagationEngine.hpp"
+#include "symbols/SymbolTable.hpp"
+
+namespace Calculator {
+
+/**
+ * @brief Topological order of the dependency graph, maintained as dependencies are added
+ *
+ * Every operand comes after all of its dependencies. When new dependencies contradict the
+ * order, only the operands between the two ends of each offending dependency are searched and
+ * moved (Pearce-Kelly dynamic topological sort): the cost depends on the size of the affected
+ * region, not on the size of the graph. A search reaching back to the new dependency reveals
+ * a cycle. Dependencies which do not depend on anything are moved to the front instead, and so
+ * are new operands whose dependencies do not depend on anything (followed by these dependencies),
+ * so that defining formulas before their inputs (top-down) never reorders the existing graph.
+ *
+ * Removing dependencies never invalidates the order, so it does not have to be notified.
+ */
+class DependencyOrder
+{
+public:
+    /// Alias representing a lookup of the dependencies of an operand
+    using DependencyLookup = std::function<std::span<const Symbols::SymbolId>(Symbols::SymbolId)>;
+
+    /**
+     * @brief Reorders operands so that an operand comes after its new dependencies,
+     * unless they would introduce a cycle
+     *
+     * Dependencies processed before a cycle is found keep their place in the order,
+     * which remains valid whether they are added to the graph or not.
+     *
+     * @param[in] operand Operand whose dependencies are added
+     * @param[in] dependencies New dependencies of the operand
+     * @param[in] dependencyGraph Operands depending on each operand (without the new ones)
+     * @param[in] dependencyLookup Dependencies of each operand (without the new ones)
+     *
+     * @return Cycle introduced by the new dependencies, each operand depending on the next one
+     * and the first one repeated at the end (empty if there is none, valid until the next call)
+     */
+    [[nodiscard]] std::span<const Symbols::SymbolId>
+          insertDependencies(Symbols::SymbolId operand,
+                             std::span<const Symbols::SymbolId> dependencies,
+                             const PropagationEngine::DependencyGraph& dependencyGraph,
+                             const DependencyLookup& dependencyLookup);
+
+    /**
+     * @brief Getter for the position of an operand in the order
+     *
+     * @param[in] operand Operand of the dependency graph
+     *
+     * @return Position of the operand (operands never seen come last, by identifier)
+     */
+    [[nodiscard]] int64_t getPosition(Symbols::SymbolId operand) const;
+
+    /**
+     * @brief Getter for the lowest position given so far
+     *
+     * @return Position below which operands are moved to the front
+     */
+    [[nodiscard]] int64_t getFirstPosition() const;
+
+    /**
+     * @brief Replaces the order by a saved one (e.g. when restoring a snapshot of a state)
+     *
+     * @param[in] positions Position of each operand, indexed by symbol identifier
+     * @param[in] firstPosition Lowest position given so far
+     */
+    void restore(std::span<const int64_t> positions, int64_t firstPosition);
+
+private:
+    /**
+     * @brief Gives a position to every operand of the dependency graph
+     *
+     * @param[in] operandCount Number of operands of the dependency graph
+     */
+    void reserve(std::size_t operandCount);
+
+    /**
+     * @brief Starts a new search: invalidates the visit stamps
+     */
+    void beginSearch();
+
+    /**
+     * @brief Collects the operands depending on an operand, placed up to a given position
+     *
+     * @param[in] operand Operand to start from
+     * @param[in] dependency Operand to look for
+     * @param[in] dependencyGraph Operands depending on each operand
+     *
+     * @return True if the dependency depends on the operand (a cycle was found)
+     */
+    [[nodiscard]] bool collectDependants(Symbols::SymbolId operand,
+                                         Symbols::SymbolId dependency,
+                                         const PropagationEngine::DependencyGraph& dependencyGraph);
+
+    /**
+     * @brief Collects the dependencies of an operand, placed after a given position
+     *
+     * @param[in] dependency Operand to start from
+     * @param[in] lowerBound Position of the operands which are not collected anymore
+     * @param[in] dependencyLookup Dependencies of each operand
+     */
+    void collectDependencies(Symbols::SymbolId dependency,
+                             int64_t lowerBound,
+                             const DependencyLookup& dependencyLookup);
+
+    /**
+     * @brief Moves the collected dependencies before the collected dependants,
+     * reusing the positions they occupied
+     */
+    void reorder();
+
+private:
+    /// Position of each operand, indexed by symbol identifier
+    std::vector<int64_t> mPositions;
+
+    /// Lowest position given so far (operands moved to the front go below it)
+    int64_t mFirstPosition{0};
+
+    /// Identifier of the current search (used to lazily invalidate the visit stamps)
+    uint32_t mSearchStamp{0};
+
+    /// Search in which each operand was last visited
+    std::vector<uint32_t> mVisitStamps;
+
+    /// Operand each operand was reached from during the search of dependants
+    std::vector<Symbols::SymbolId> mParents;
+
+    /// Operands left to explore
+    std::vector<Symbols::SymbolId> mOperandsToVisit;
+
+    /// Dependants collected (to be moved after the dependencies)
+    std::vector<Symbols::SymbolId> mDependants;
+
+    /// Dependencies collected (to be moved before the dependants)
+    std::vector<Symbols::SymbolId> mDependencies;
+
+    /// Positions freed by the moved operands
+    std::vector<int64_t> mFreedPositions;
+
+    /// Last cycle found
+    std::vector<Symbols::SymbolId> mCycle;
+};
+
+} // namespace Calculator
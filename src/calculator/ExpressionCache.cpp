@@ -0,0 +1,121 @@
+#include "ExpressionCache.hpp"
+
+#include <cctype>
+#include <iterator>
+
+namespace {
+/**
+ * @brief Checks if the provided character can be part of an operand name or of a literal
+ *
+ * @param[in] character Character to evaluate
+ *
+ * @return True if the character belongs to a word (false otherwise)
+ */
+bool isWordCharacter(const char character)
+{
+    return std::isalnum(static_cast<unsigned char>(character)) || character == '_';
+}
+} // namespace
+
+namespace Calculator {
+
+ExpressionCache::ExpressionCache(const std::size_t capacity)
+    : mCapacity{capacity}
+{
+    mEntryPositions.reserve(capacity);
+}
+
+ExpressionCache::CompiledExpression ExpressionCache::find(const std::string_view expression)
+{
+    if (mCapacity == 0) {
+        return {};
+    }
+
+    const auto entryPosition = mEntryPositions.find(normalize(expression));
+    if (entryPosition == mEntryPositions.end()) {
+        ++mMissCount;
+        return {};
+    }
+
+    ++mHitCount;
+
+    // Move the entry to the front of the recency list (iterators remain valid)
+    mEntries.splice(mEntries.begin(), mEntries, entryPosition->second);
+    return entryPosition->second->program;
+}
+
+void ExpressionCache::insert(const std::string_view expression, CompiledExpression program)
+{
+    if (mCapacity == 0) {
+        return;
+    }
+
+    const auto key = normalize(expression);
+    if (const auto entryPosition = mEntryPositions.find(key);
+        entryPosition != mEntryPositions.end()) {
+
+        entryPosition->second->program = std::move(program);
+        mEntries.splice(mEntries.begin(), mEntries, entryPosition->second);
+        return;
+    }
+
+    // Evict the least recently used entry, reusing its node for the new one
+    if (mEntries.size() == mCapacity) {
+        mEntryPositions.erase(mEntries.back().expression);
+        mEntries.splice(mEntries.begin(), mEntries, std::prev(mEntries.end()));
+
+        mEntries.front().expression.assign(key);
+        mEntries.front().program = std::move(program);
+    } else {
+        mEntries.push_front({std::string(key), std::move(program)});
+    }
+
+    mEntryPositions.emplace(mEntries.front().expression, mEntries.begin());
+}
+
+std::size_t ExpressionCache::getCapacity() const
+{
+    return mCapacity;
+}
+
+std::size_t ExpressionCache::size() const
+{
+    return mEntries.size();
+}
+
+uint64_t ExpressionCache::getHitCount() const
+{
+    return mHitCount;
+}
+
+uint64_t ExpressionCache::getMissCount() const
+{
+    return mMissCount;
+}
+
+std::string_view ExpressionCache::normalize(const std::string_view expression)
+{
+    mKeyBuffer.clear();
+
+    // White spaces are only kept where they separate two words (e.g. "1 2" must not become "12")
+    bool isAfterWhiteSpace{false};
+    for (const auto character : expression) {
+
+        if (std::isspace(static_cast<unsigned char>(character))) {
+            isAfterWhiteSpace = true;
+            continue;
+        }
+
+        if (isAfterWhiteSpace && !mKeyBuffer.empty() && isWordCharacter(mKeyBuffer.back())
+            && isWordCharacter(character)) {
+            mKeyBuffer.push_back(' ');
+        }
+
+        isAfterWhiteSpace = false;
+        mKeyBuffer.push_back(character);
+    }
+
+    return mKeyBuffer;
+}
+
+} // namespace Calculator
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "bytecode/Program.hpp"
+
+namespace Calculator {
+
+/**
+ * @brief Bounded LRU (Least Recently Used) cache of compiled arithmetic expressions
+ *
+ * Expressions are keyed by their normalized text: white spaces are dropped,
+ * except for a single one between two adjacent operand names or literals.
+ * The free variables of a cached expression are the variables of its program,
+ * so they are available without parsing the expression again.
+ *
+ * Once the cache is full, inserting a new expression evicts the least recently used one.
+ */
+class ExpressionCache
+{
+public:
+    /// Alias representing a compiled expression shared between the cache and its users
+    using CompiledExpression = std::shared_ptr<const Bytecode::Program>;
+
+    /**
+     * @brief Class constructor
+     *
+     * @param[in] capacity Maximum number of cached expressions (0 disables the cache)
+     */
+    explicit ExpressionCache(std::size_t capacity);
+
+    /**
+     * @brief Looks up the compiled program of an expression
+     *
+     * On a hit, the expression becomes the most recently used one
+     *
+     * @param[in] expression Text of the expression
+     *
+     * @return Compiled program of the expression (empty if the expression is not cached)
+     */
+    [[nodiscard]] CompiledExpression find(std::string_view expression);
+
+    /**
+     * @brief Caches the compiled program of an expression
+     *
+     * @param[in] expression Text of the expression
+     * @param[in] program Compiled program of the expression
+     */
+    void insert(std::string_view expression, CompiledExpression program);
+
+    /**
+     * @brief Getter for the maximum number of cached expressions
+     *
+     * @return Capacity of the cache
+     */
+    [[nodiscard]] std::size_t getCapacity() const;
+
+    /**
+     * @brief Getter for the number of cached expressions
+     *
+     * @return Number of cached expressions
+     */
+    [[nodiscard]] std::size_t size() const;
+
+    /**
+     * @brief Getter for the number of lookups that found their expression
+     *
+     * @return Number of cache hits
+     */
+    [[nodiscard]] uint64_t getHitCount() const;
+
+    /**
+     * @brief Getter for the number of lookups that did not find their expression
+     *
+     * @return Number of cache misses
+     */
+    [[nodiscard]] uint64_t getMissCount() const;
+
+private:
+    /**
+     * @brief Normalizes the text of an expression into the key buffer
+     *
+     * @param[in] expression Text of the expression
+     *
+     * @return View over the normalized text (valid until the next normalization)
+     */
+    std::string_view normalize(std::string_view expression);
+
+    /**
+     * @brief Cached expression along with its key
+     */
+    struct Entry
+    {
+        /// Normalized text of the expression
+        std::string expression;
+        /// Compiled program of the expression
+        CompiledExpression program;
+    };
+
+    /// Alias representing the recency list (most recently used entry first)
+    using EntryList = std::list<Entry>;
+
+private:
+    /// Maximum number of cached expressions
+    std::size_t mCapacity{};
+
+    /// Cached expressions, from the most to the least recently used one
+    EntryList mEntries;
+
+    /// Position of each cached expression in the recency list, keyed by its normalized text
+    /// (keys view the texts owned by the entries, which never move within the list)
+    std::unordered_map<std::string_view, EntryList::iterator> mEntryPositions;
+
+    /// Buffer holding the normalized text of the last looked up expression
+    std::string mKeyBuffer;
+
+    /// Number of lookups that found their expression
+    uint64_t mHitCount{0};
+
+    /// Number of lookups that did not find their expression
+    uint64_t mMissCount{0};
+};
+
+} // namespace Calculator
@@ -0,0 +1,367 @@
+#include "ExpressionDAG.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <functional>
+
+namespace Calculator {
+
+std::size_t ExpressionDAG::NodeHash::operator()(const Node& node) const
+{
+    // Combine the fields of the node (boost::hash_combine style)
+    std::size_t hash{std::hash<uint32_t>{}(static_cast<uint32_t>(node.instruction.opCode))};
+    for (const auto field : {node.instruction.operand, node.leftNode, node.rightNode}) {
+        hash ^= std::hash<uint32_t>{}(field) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    }
+
+    return hash;
+}
+
+ExpressionDAG::NodeId ExpressionDAG::insert(const Bytecode::Program& program)
+{
+    using Bytecode::OpCode;
+
+    mValueStack.clear();
+
+    for (const auto& instruction : program.getInstructions()) {
+        switch (instruction.opCode) {
+        case OpCode::PUSH_CONST:
+        case OpCode::LOAD_VAR:
+            mValueStack.push_back(acquire({instruction}));
+            break;
+        case OpCode::ADD:
+        case OpCode::SUB:
+        case OpCode::MUL:
+        case OpCode::DIV: {
+            auto rightNode = mValueStack.back();
+            mValueStack.pop_back();
+            auto leftNode = mValueStack.back();
+            mValueStack.pop_back();
+
+            // Commutative operations get a canonical operand order
+            const auto isCommutative
+                  = instruction.opCode == OpCode::ADD || instruction.opCode == OpCode::MUL;
+            if (isCommutative && rightNode < leftNode) {
+                std::swap(leftNode, rightNode);
+            }
+
+            const auto nodeId = acquire({{instruction.opCode, 0}, leftNode, rightNode});
+
+            // The new node holds its own references on its operands if it was just created,
+            // the references taken while building it are not needed anymore
+            release(leftNode);
+            release(rightNode);
+
+            mValueStack.push_back(nodeId);
+            break;
+        }
+        }
+    }
+
+    return mValueStack.empty() ? cNullNodeId : mValueStack.back();
+}
+
+void ExpressionDAG::release(const NodeId rootNode)
+{
+    if (rootNode == cNullNodeId) {
+        return;
+    }
+
+    std::vector<NodeId> releasedNodes{rootNode};
+
+    while (!releasedNodes.empty()) {
+        const auto nodeId = releasedNodes.back();
+        releasedNodes.pop_back();
+
+        if (--mReferenceCounts[nodeId] > 0) {
+            continue;
+        }
+
+        // The node is no longer used: remove it and give back the references it held
+        const auto node = mNodes[nodeId];
+        mNodeIds.erase(node);
+        mFreeNodes.push_back(nodeId);
+
+        if (node.leftNode != cNullNodeId) {
+            std::erase(mParentNodes[node.leftNode], nodeId);
+            std::erase(mParentNodes[node.rightNode], nodeId);
+            releasedNodes.push_back(node.leftNode);
+            releasedNodes.push_back(node.rightNode);
+        } else if (node.instruction.opCode == Bytecode::OpCode::LOAD_VAR) {
+            mVariableNodes[node.instruction.operand] = cNullNodeId;
+        }
+    }
+}
+
+void ExpressionDAG::beginPropagation()
+{
+    // Memoized values are tagged with their propagation: moving on to the next one is enough
+    // to invalidate all of them (they only have to be cleared when the counter wraps around)
+    if (++mPropagation == 0) {
+        std::ranges::fill(mMemoizedValues, MemoizedValue{});
+        mPropagation = 1;
+    }
+}
+
+void ExpressionDAG::invalidate(const Symbols::SymbolId operand)
+{
+    if (operand >= mVariableNodes.size() || mVariableNodes[operand] == cNullNodeId) {
+        return;
+    }
+
+    // A node can only have been computed during this propagation if its operands were as well:
+    // the search stops at the nodes which were not
+    mInvalidatedNodes.assign(1, mVariableNodes[operand]);
+
+    while (!mInvalidatedNodes.empty()) {
+        const auto nodeId = mInvalidatedNodes.back();
+        mInvalidatedNodes.pop_back();
+
+        auto& memoizedValue = mMemoizedValues[nodeId];
+        if (memoizedValue.propagation != mPropagation) {
+            continue;
+        }
+
+        memoizedValue.propagation = 0;
+        mInvalidatedNodes.insert(
+              mInvalidatedNodes.end(), mParentNodes[nodeId].begin(), mParentNodes[nodeId].end());
+    }
+}
+
+std::optional<int32_t> ExpressionDAG::evaluate(const NodeId rootNode,
+                                               const Symbols::ValueSlots valueSlots)
+{
+    using Bytecode::OpCode;
+
+    if (rootNode == cNullNodeId) {
+        return std::nullopt;
+    }
+
+    // Iterative post-order traversal: every operation is visited twice,
+    // first to schedule its operands and then to compute its own value.
+    // Nodes whose value was already computed during this propagation are not visited again.
+    mPendingNodes.clear();
+    mPendingNodes.emplace_back(rootNode, false);
+
+    while (!mPendingNodes.empty()) {
+        const auto [nodeId, operandsComputed] = mPendingNodes.back();
+        auto& memoizedValue = mMemoizedValues[nodeId];
+
+        if (memoizedValue.propagation == mPropagation) {
+            mPendingNodes.pop_back();
+            continue;
+        }
+
+        const auto& node = mNodes[nodeId];
+
+        if (node.leftNode != cNullNodeId && !operandsComputed) {
+            mPendingNodes.back().second = true;
+            mPendingNodes.emplace_back(node.rightNode, false);
+            mPendingNodes.emplace_back(node.leftNode, false);
+            continue;
+        }
+
+        mPendingNodes.pop_back();
+        memoizedValue.propagation = mPropagation;
+
+        if (node.leftNode == cNullNodeId) {
+            if (node.instruction.opCode == OpCode::PUSH_CONST) {
+                memoizedValue.value = std::bit_cast<float>(node.instruction.operand);
+                memoizedValue.isDefined = true;
+            } else {
+                memoizedValue.isDefined = Symbols::isDefined(valueSlots, node.instruction.operand);
+                memoizedValue.value = memoizedValue.isDefined
+                                            ? static_cast<float>(
+                                                    valueSlots[node.instruction.operand].value)
+                                            : 0.f;
+            }
+            continue;
+        }
+
+        const auto& leftValue = mMemoizedValues[node.leftNode];
+        const auto& rightValue = mMemoizedValues[node.rightNode];
+
+        memoizedValue.isDefined = leftValue.isDefined && rightValue.isDefined;
+        if (!memoizedValue.isDefined) {
+            continue;
+        }
+
+        switch (node.instruction.opCode) {
+        case OpCode::ADD:
+            memoizedValue.value = leftValue.value + rightValue.value;
+            break;
+        case OpCode::SUB:
+            memoizedValue.value = leftValue.value - rightValue.value;
+            break;
+        case OpCode::MUL:
+            memoizedValue.value = leftValue.value * rightValue.value;
+            break;
+        case OpCode::DIV:
+            memoizedValue.value = leftValue.value / rightValue.value;
+            break;
+        case OpCode::PUSH_CONST:
+        case OpCode::LOAD_VAR:
+            break;
+        }
+    }
+
+    const auto& rootValue = mMemoizedValues[rootNode];
+    if (!rootValue.isDefined) {
+        return std::nullopt;
+    }
+
+    return static_cast<int32_t>(rootValue.value);
+}
+
+int32_t ExpressionDAG::evaluateConcurrently(const NodeId rootNode,
+                                            const Symbols::ValueSlots valueSlots) const
+{
+    using Bytecode::OpCode;
+
+    // Scratch stacks of the calling thread
+    thread_local std::vector<std::pair<NodeId, bool>> pendingNodes;
+    thread_local std::vector<float> values;
+
+    pendingNodes.assign(1, {rootNode, false});
+    values.clear();
+
+    while (!pendingNodes.empty()) {
+        const auto [nodeId, operandsComputed] = pendingNodes.back();
+        const auto& node = mNodes[nodeId];
+
+        if (node.leftNode != cNullNodeId && !operandsComputed) {
+            pendingNodes.back().second = true;
+            pendingNodes.emplace_back(node.rightNode, false);
+            pendingNodes.emplace_back(node.leftNode, false);
+            continue;
+        }
+
+        pendingNodes.pop_back();
+
+        if (node.leftNode == cNullNodeId) {
+            const auto operand = node.instruction.operand;
+            values.push_back(node.instruction.opCode == OpCode::PUSH_CONST
+                                   ? std::bit_cast<float>(operand)
+                                   : static_cast<float>(valueSlots[operand].value));
+            continue;
+        }
+
+        const auto rightValue = values.back();
+        values.pop_back();
+        auto& leftValue = values.back();
+
+        switch (node.instruction.opCode) {
+        case OpCode::ADD:
+            leftValue += rightValue;
+            break;
+        case OpCode::SUB:
+            leftValue -= rightValue;
+            break;
+        case OpCode::MUL:
+            leftValue *= rightValue;
+            break;
+        case OpCode::DIV:
+            leftValue /= rightValue;
+            break;
+        case OpCode::PUSH_CONST:
+        case OpCode::LOAD_VAR:
+            break;
+        }
+    }
+
+    return static_cast<int32_t>(values.back());
+}
+
+Bytecode::Program ExpressionDAG::extractProgram(const NodeId rootNode) const
+{
+    using Bytecode::OpCode;
+
+    Bytecode::Program program;
+    if (rootNode == cNullNodeId) {
+        return program;
+    }
+
+    // Same post-order traversal as the evaluation, without memoization
+    std::vector<std::pair<NodeId, bool>> pendingNodes{{rootNode, false}};
+
+    while (!pendingNodes.empty()) {
+        const auto [nodeId, operandsEmitted] = pendingNodes.back();
+        const auto& node = mNodes[nodeId];
+
+        if (node.leftNode != cNullNodeId && !operandsEmitted) {
+            pendingNodes.back().second = true;
+            pendingNodes.emplace_back(node.rightNode, false);
+            pendingNodes.emplace_back(node.leftNode, false);
+            continue;
+        }
+
+        pendingNodes.pop_back();
+
+        switch (node.instruction.opCode) {
+        case OpCode::PUSH_CONST:
+            program.emitConstant(std::bit_cast<float>(node.instruction.operand));
+            break;
+        case OpCode::LOAD_VAR:
+            program.emitVariable(node.instruction.operand);
+            break;
+        case OpCode::ADD:
+        case OpCode::SUB:
+        case OpCode::MUL:
+        case OpCode::DIV:
+            program.emitOperation(node.instruction.opCode);
+            break;
+        }
+    }
+
+    return program;
+}
+
+std::size_t ExpressionDAG::size() const
+{
+    return mNodeIds.size();
+}
+
+ExpressionDAG::NodeId ExpressionDAG::acquire(const Node& node)
+{
+    if (const auto nodeEntry = mNodeIds.find(node); nodeEntry != mNodeIds.end()) {
+        ++mReferenceCounts[nodeEntry->second];
+        return nodeEntry->second;
+    }
+
+    NodeId nodeId{};
+    if (!mFreeNodes.empty()) {
+        nodeId = mFreeNodes.back();
+        mFreeNodes.pop_back();
+
+        mNodes[nodeId] = node;
+        mReferenceCounts[nodeId] = 1;
+        mMemoizedValues[nodeId] = {};
+    } else {
+        nodeId = static_cast<NodeId>(mNodes.size());
+
+        mNodes.push_back(node);
+        mReferenceCounts.push_back(1);
+        mParentNodes.emplace_back();
+        mMemoizedValues.emplace_back();
+    }
+
+    // New node: it holds a reference on each of its operands
+    if (node.leftNode != cNullNodeId) {
+        ++mReferenceCounts[node.leftNode];
+        ++mReferenceCounts[node.rightNode];
+        mParentNodes[node.leftNode].push_back(nodeId);
+        if (node.rightNode != node.leftNode) {
+            mParentNodes[node.rightNode].push_back(nodeId);
+        }
+    } else if (node.instruction.opCode == Bytecode::OpCode::LOAD_VAR) {
+        if (mVariableNodes.size() <= node.instruction.operand) {
+            mVariableNodes.resize(node.instruction.operand + 1, cNullNodeId);
+        }
+        mVariableNodes[node.instruction.operand] = nodeId;
+    }
+
+    mNodeIds.emplace(node, nodeId);
+    return nodeId;
+}
+
+} // namespace Calculator
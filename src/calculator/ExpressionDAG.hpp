@@ -0,0 +1,201 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "bytecode/Program.hpp"
+#include "symbols/ValueSlot.hpp"
+
+namespace Calculator {
+
+/**
+ * @brief Directed acyclic graph holding the sub-expressions of every stored expression
+ *
+ * Sub-expressions are hash-consed: structurally identical sub-expressions (e.g. "b*c+d" found in
+ * several expressions) are stored once and shared by every expression that contains them.
+ * Additions and multiplications are commutative in floating point arithmetic, so their operands
+ * are ordered canonically and "b*c" is shared with "c*b" as well.
+ *
+ * Values are memoized per propagation: within a propagation, a shared node is computed once
+ * and its value is reused by every expression that reads it, until one of the operands it reads
+ * is written (see invalidate).
+ */
+class ExpressionDAG
+{
+public:
+    /// Identifier of a node of the graph
+    using NodeId = uint32_t;
+
+    /// Sentinel identifier used to represent a missing node
+    static constexpr NodeId cNullNodeId{std::numeric_limits<NodeId>::max()};
+
+    /**
+     * @brief Adds the sub-expressions of a compiled expression to the graph
+     *
+     * The returned root holds a reference that must be given back through release()
+     *
+     * @param[in] program Compiled expression to add
+     *
+     * @return Identifier of the root node of the expression
+     */
+    [[nodiscard]] NodeId insert(const Bytecode::Program& program);
+
+    /**
+     * @brief Releases the reference held on the root node of an expression
+     *
+     * Nodes that are no longer referenced by any expression are removed from the graph
+     *
+     * @param[in] rootNode Identifier of the root node of the expression
+     */
+    void release(NodeId rootNode);
+
+    /**
+     * @brief Starts a new propagation, discarding the values memoized by the previous one
+     *
+     * Must be called whenever operand values changed since the last evaluation
+     */
+    void beginPropagation();
+
+    /**
+     * @brief Discards the values memoized during the current propagation that read an operand
+     *
+     * Must be called whenever the operand is written during a propagation: only the nodes
+     * reading it (directly or through their operands) are computed again
+     *
+     * @param[in] operand Operand whose value changed
+     */
+    void invalidate(Symbols::SymbolId operand);
+
+    /**
+     * @brief Evaluates an expression, reusing the values memoized during the current propagation
+     *
+     * Arithmetic is performed exactly like the virtual machine does (in single precision,
+     * truncating the final result), so both always agree on the value of an expression
+     *
+     * @param[in] rootNode Identifier of the root node of the expression
+     * @param[in] valueSlots Values of the operands, indexed by symbol identifier
+     *
+     * @return Value of the expression (empty if any of its operands has no value)
+     */
+    [[nodiscard]] std::optional<int32_t> evaluate(NodeId rootNode, Symbols::ValueSlots valueSlots);
+
+    /**
+     * @brief Evaluates an expression without memoizing any value
+     *
+     * Can be called from several threads at once, as long as the graph is not modified.
+     * Every operand read by the expression must hold a value
+     *
+     * @param[in] rootNode Identifier of the root node of the expression (must not be missing)
+     * @param[in] valueSlots Values of the operands, indexed by symbol identifier
+     *
+     * @return Value of the expression
+     */
+    [[nodiscard]] int32_t evaluateConcurrently(NodeId rootNode,
+                                               Symbols::ValueSlots valueSlots) const;
+
+    /**
+     * @brief Rebuilds a compiled program from the nodes of an expression
+     *
+     * Shared sub-expressions are expanded, so the program computes the expression on its own
+     *
+     * @param[in] rootNode Identifier of the root node of the expression
+     *
+     * @return Compiled program of the expression (empty if the root node is missing)
+     */
+    [[nodiscard]] Bytecode::Program extractProgram(NodeId rootNode) const;
+
+    /**
+     * @brief Getter for the number of nodes in the graph
+     *
+     * @return Number of distinct sub-expressions currently stored
+     */
+    [[nodiscard]] std::size_t size() const;
+
+private:
+    /**
+     * @brief Node of the graph: a constant, a variable or an arithmetic operation
+     */
+    struct Node
+    {
+        /// Instruction performed by the node (same meaning as in a compiled program)
+        Bytecode::Instruction instruction;
+        /// Left operand of an arithmetic operation
+        NodeId leftNode{cNullNodeId};
+        /// Right operand of an arithmetic operation
+        NodeId rightNode{cNullNodeId};
+
+        bool operator==(const Node&) const = default;
+    };
+
+    /**
+     * @brief Hash of the structure of a node
+     */
+    struct NodeHash
+    {
+        std::size_t operator()(const Node& node) const;
+    };
+
+    /**
+     * @brief Value of a node memoized during a propagation
+     */
+    struct MemoizedValue
+    {
+        /// Value of the node (only meaningful if the node is defined)
+        float value{};
+        /// Propagation during which the value was computed
+        uint32_t propagation{0};
+        /// Whether every operand read by the node has a value
+        bool isDefined{false};
+    };
+
+    /**
+     * @brief Retrieves the node matching a structure, creating it if it does not exist yet
+     *
+     * A reference is taken on the returned node
+     *
+     * @param[in] node Structure of the node
+     *
+     * @return Identifier of the node
+     */
+    NodeId acquire(const Node& node);
+
+private:
+    /// Nodes of the graph, indexed by identifier (released nodes are recycled)
+    std::vector<Node> mNodes;
+
+    /// Number of references held on each node (by parent nodes and by expressions)
+    std::vector<uint32_t> mReferenceCounts;
+
+    /// Identifiers of the released nodes, available for reuse
+    std::vector<NodeId> mFreeNodes;
+
+    /// Identifier of every node, keyed by its structure
+    std::unordered_map<Node, NodeId, NodeHash> mNodeIds;
+
+    /// Operations using each node as an operand, indexed by identifier
+    std::vector<std::vector<NodeId>> mParentNodes;
+
+    /// Node reading each operand, indexed by symbol identifier (variables are hash-consed too)
+    std::vector<NodeId> mVariableNodes;
+
+    /// Values memoized for each node
+    std::vector<MemoizedValue> mMemoizedValues;
+
+    /// Current propagation (memoized values computed during other propagations are stale)
+    uint32_t mPropagation{1};
+
+    /// Scratch stack used to traverse the graph
+    std::vector<std::pair<NodeId, bool>> mPendingNodes;
+
+    /// Scratch stack used to build the graph from a compiled program
+    std::vector<NodeId> mValueStack;
+
+    /// Scratch stack used to discard memoized values
+    std::vector<NodeId> mInvalidatedNodes;
+};
+
+} // namespace Calculator
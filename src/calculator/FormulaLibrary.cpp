@@ -0,0 +1,137 @@
+#include "FormulaLibrary.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "parser/Parser.hpp"
+
+namespace Calculator {
+
+Utils::Expected<std::vector<std::byte>> FormulaLibrary::compile(const std::string_view source)
+{
+    Symbols::SymbolTable symbolTable;
+    std::vector<Bytecode::Program> programs;
+    std::vector<Symbols::SymbolId> targets;
+    std::size_t lineOffset{0};
+
+    while (lineOffset < source.size()) {
+        const auto lineEnd = std::min(source.find('\n', lineOffset), source.size());
+        const auto line = source.substr(lineOffset, lineEnd - lineOffset);
+        const auto nextLineOffset = lineEnd + 1;
+
+        const auto lineStart = line.find_first_not_of(" \t\r");
+        if (lineStart == std::string_view::npos || line[lineStart] == '#') {
+            lineOffset = nextLineOffset;
+            continue;
+        }
+
+        Parser parser(line, symbolTable);
+        const auto parsingResult = parser.execute();
+        if (!parsingResult) {
+            return Utils::Error{parsingResult.getError().code,
+                                lineOffset + parsingResult.getError().offset};
+        }
+        if (parser.getInstructionType() != Parser::InstructionType::ASSIGNMENT) {
+            return Utils::Error{Utils::ErrorCode::INVALID_INSTRUCTION, lineOffset + lineStart};
+        }
+
+        targets.push_back(parser.getOperandOfLHS());
+        programs.push_back(parser.extractProgramOfRHS());
+        lineOffset = nextLineOffset;
+    }
+
+    std::vector<Bytecode::ProgramImage::Formula> formulas;
+    formulas.reserve(programs.size());
+    for (std::size_t formulaIndex = 0; formulaIndex < programs.size(); ++formulaIndex) {
+        formulas.push_back({targets[formulaIndex], &programs[formulaIndex]});
+    }
+
+    return Bytecode::ProgramImage::write(formulas, symbolTable);
+}
+
+std::optional<FormulaLibrary> FormulaLibrary::open(const std::string& path)
+{
+    const auto fileDescriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fileDescriptor < 0) {
+        return std::nullopt;
+    }
+
+    struct stat fileStatus{};
+    if (fstat(fileDescriptor, &fileStatus) != 0) {
+        close(fileDescriptor);
+        return std::nullopt;
+    }
+
+    const auto fileSize = static_cast<std::size_t>(fileStatus.st_size);
+    auto* const mapping = fileSize > 0
+                                ? mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fileDescriptor, 0)
+                                : MAP_FAILED;
+    close(fileDescriptor);
+
+    if (mapping == MAP_FAILED) {
+        if (fileSize == 0) {
+            errno = EINVAL;
+        }
+        return std::nullopt;
+    }
+
+    const std::span<const std::byte> mappedBytes{static_cast<const std::byte*>(mapping), fileSize};
+    const auto image = Bytecode::ProgramImage::open(mappedBytes);
+    if (!image) {
+        munmap(mapping, fileSize);
+        errno = EINVAL;
+        return std::nullopt;
+    }
+
+    return FormulaLibrary{mappedBytes, *image};
+}
+
+FormulaLibrary::FormulaLibrary(const std::span<const std::byte> mapping,
+                               Bytecode::ProgramImage image)
+    : mMapping{mapping}
+    , mImage{image}
+{
+}
+
+FormulaLibrary::FormulaLibrary(FormulaLibrary&& other) noexcept
+    : mMapping{std::exchange(other.mMapping, {})}
+    , mImage{other.mImage}
+{
+}
+
+FormulaLibrary& FormulaLibrary::operator=(FormulaLibrary&& other) noexcept
+{
+    if (this != &other) {
+        unmap();
+        mMapping = std::exchange(other.mMapping, {});
+        mImage = other.mImage;
+    }
+
+    return *this;
+}
+
+FormulaLibrary::~FormulaLibrary()
+{
+    unmap();
+}
+
+const Bytecode::ProgramImage& FormulaLibrary::getImage() const
+{
+    return mImage;
+}
+
+void FormulaLibrary::unmap()
+{
+    if (!mMapping.empty()) {
+        munmap(const_cast<std::byte*>(mMapping.data()), mMapping.size());
+        mMapping = {};
+    }
+}
+
+} // namespace Calculator
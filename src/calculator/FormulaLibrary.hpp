@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Runner.hpp"
+#include "bytecode/ProgramImage.hpp"
+#include "utils/Error.hpp"
+
+namespace Calculator {
+
+/**
+ * @brief Library of formulas compiled ahead of time into a program image file
+ *
+ * Formula files hold one assignment per line (e.g. "total = price * quantity"), empty lines
+ * and lines starting with '#' being ignored. Compiled libraries are memory mapped and
+ * used in place: opening one only validates it, and registering its formulas with a Runner
+ * does not parse anything.
+ */
+class FormulaLibrary
+{
+public:
+    /**
+     * @brief Compiles the formulas of a formula file into a program image
+     *
+     * @param[in] source Content of the formula file
+     *
+     * @return Image of the formulas, or the error of the first line that is not a valid assignment
+     * (its offset being relative to the whole source)
+     */
+    [[nodiscard]] static Utils::Expected<std::vector<std::byte>> compile(std::string_view source);
+
+    /**
+     * @brief Maps a compiled library
+     *
+     * @param[in] path Path of the program image file
+     *
+     * @return Mapped library (empty if the file cannot be mapped or is not a valid image,
+     * errno is set)
+     */
+    [[nodiscard]] static std::optional<FormulaLibrary> open(const std::string& path);
+
+    FormulaLibrary(FormulaLibrary&& other) noexcept;
+    FormulaLibrary& operator=(FormulaLibrary&& other) noexcept;
+    FormulaLibrary(const FormulaLibrary&) = delete;
+    FormulaLibrary& operator=(const FormulaLibrary&) = delete;
+
+    /**
+     * @brief Class destructor, unmaps the file
+     */
+    ~FormulaLibrary();
+
+    /**
+     * @brief Getter for the program image of the library
+     *
+     * @return Reference to the image, valid as long as the library is mapped
+     */
+    [[nodiscard]] const Bytecode::ProgramImage& getImage() const;
+
+private:
+    /**
+     * @brief Class constructor
+     *
+     * @param[in] mapping Mapping of the whole file
+     * @param[in] image View over the image held by the mapping
+     */
+    FormulaLibrary(std::span<const std::byte> mapping, Bytecode::ProgramImage image);
+
+    /**
+     * @brief Unmaps the file
+     */
+    void unmap();
+
+private:
+    /// Mapping of the whole file (empty once moved from)
+    std::span<const std::byte> mMapping;
+
+    /// View over the image held by the mapping
+    Bytecode::ProgramImage mImage;
+};
+
+} // namespace Calculator
@@ -0,0 +1,138 @@
+#include "OperationHistory.hpp"
+
+namespace Calculator {
+
+OperationHistory::OperationHistory(const std::size_t maxDepth)
+    : mMaxDepth{maxDepth}
+{
+    mEntries.resize(mMaxDepth);
+}
+
+void OperationHistory::push(const Symbols::SymbolId operand, const Symbols::ValueSlots valueSlots)
+{
+    if (operand >= mLatestOccurrences.size()) {
+        mLatestOccurrences.resize(operand + 1, cNoEntry);
+    }
+
+    // Forget the oldest entry once the bound is reached
+    if (mMaxDepth > 0 && size() == mMaxDepth) {
+        if (mLastFulfilledEntry == mBegin) {
+            mLastFulfilledEntry = cNoEntry;
+        }
+
+        ++mBegin;
+    }
+
+    const Entry entry{operand, mLatestOccurrences[operand]};
+
+    if (mMaxDepth > 0) {
+        getEntry(mEnd) = entry;
+    } else {
+        mEntries.push_back(entry);
+    }
+
+    mLatestOccurrences[operand] = mEnd;
+    if (Symbols::isDefined(valueSlots, operand)) {
+        mLastFulfilledEntry = mEnd;
+    }
+
+    ++mEnd;
+}
+
+Symbols::SymbolId OperationHistory::pop(const Symbols::ValueSlots valueSlots)
+{
+    --mEnd;
+    const auto entry = getEntry(mEnd);
+
+    if (mMaxDepth == 0) {
+        mEntries.pop_back();
+    }
+
+    mLatestOccurrences[entry.operand] = entry.previousOccurrence;
+    if (mLastFulfilledEntry == mEnd) {
+        findLastFulfilledEntry(mEnd, valueSlots);
+    }
+
+    return entry.operand;
+}
+
+Symbols::SymbolId OperationHistory::top() const
+{
+    return getEntry(mEnd - 1).operand;
+}
+
+void OperationHistory::updateValue(const Symbols::SymbolId operand,
+                                   const Symbols::ValueSlots valueSlots)
+{
+    // Operands whose entries were all removed or forgotten are not part of the history
+    if (operand >= mLatestOccurrences.size() || mLatestOccurrences[operand] == cNoEntry
+        || mLatestOccurrences[operand] < mBegin) {
+        return;
+    }
+
+    // A newly fulfilled operation can only move the last fulfilled one up
+    if (Symbols::isDefined(valueSlots, operand)) {
+        const auto latestOccurrence = mLatestOccurrences[operand];
+        if (mLastFulfilledEntry == cNoEntry || latestOccurrence > mLastFulfilledEntry) {
+            mLastFulfilledEntry = latestOccurrence;
+        }
+        return;
+    }
+
+    // Only the loss of the value of the last fulfilled operation requires a search
+    if (mLastFulfilledEntry != cNoEntry && getEntry(mLastFulfilledEntry).operand == operand) {
+        findLastFulfilledEntry(mLastFulfilledEntry, valueSlots);
+    }
+}
+
+std::optional<Symbols::SymbolId> OperationHistory::getLastFulfilledOperand() const
+{
+    if (mLastFulfilledEntry == cNoEntry) {
+        return std::nullopt;
+    }
+
+    return getEntry(mLastFulfilledEntry).operand;
+}
+
+std::size_t OperationHistory::size() const
+{
+    return static_cast<std::size_t>(mEnd - mBegin);
+}
+
+std::vector<Symbols::SymbolId> OperationHistory::getOperands() const
+{
+    std::vector<Symbols::SymbolId> operands;
+    operands.reserve(size());
+
+    for (auto index = mBegin; index < mEnd; ++index) {
+        operands.push_back(getEntry(index).operand);
+    }
+
+    return operands;
+}
+
+OperationHistory::Entry& OperationHistory::getEntry(const EntryIndex index)
+{
+    return mEntries[static_cast<std::size_t>(mMaxDepth > 0 ? index % mMaxDepth : index)];
+}
+
+const OperationHistory::Entry& OperationHistory::getEntry(const EntryIndex index) const
+{
+    return mEntries[static_cast<std::size_t>(mMaxDepth > 0 ? index % mMaxDepth : index)];
+}
+
+void OperationHistory::findLastFulfilledEntry(const EntryIndex lastCandidate,
+                                              const Symbols::ValueSlots valueSlots)
+{
+    // Entries above the candidate are known not to be fulfilled
+    for (auto index = lastCandidate; index > mBegin; --index) {
+        if (Symbols::isDefined(valueSlots, getEntry(index - 1).operand)) {
+            mLastFulfilledEntry = index - 1;
+            return;
+        }
+    }
+
+    mLastFulfilledEntry = cNoEntry;
+}
+
+} // namespace Calculator
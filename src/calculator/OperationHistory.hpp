@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include "symbols/SymbolTable.hpp"
+#include "symbols/ValueSlot.hpp"
+
+namespace Calculator {
+
+/**
+ * @brief Log of the operands of every registered operation, in order
+ *
+ * Entries are kept in a ring buffer of symbol identifiers: once the optional depth bound is
+ * reached, registering an operation forgets the oldest one.
+ *
+ * The latest entry whose operand holds a value (the last fulfilled operation) is maintained
+ * as values change, so retrieving it takes constant time. It only has to be searched again,
+ * downwards, when its operand loses its value or when its entry is removed.
+ */
+class OperationHistory
+{
+public:
+    /**
+     * @brief Class constructor
+     *
+     * @param[in] maxDepth Maximum number of entries kept (0 for no bound)
+     */
+    explicit OperationHistory(std::size_t maxDepth = 0);
+
+    /**
+     * @brief Registers an operation on top of the history
+     *
+     * @param[in] operand Operand of the operation
+     * @param[in] valueSlots Current values of the operands
+     */
+    void push(Symbols::SymbolId operand, Symbols::ValueSlots valueSlots);
+
+    /**
+     * @brief Removes the latest operation of the history (which must not be empty)
+     *
+     * @param[in] valueSlots Current values of the operands
+     *
+     * @return Operand of the removed operation
+     */
+    Symbols::SymbolId pop(Symbols::ValueSlots valueSlots);
+
+    /**
+     * @brief Getter for the operand of the latest operation (the history must not be empty)
+     *
+     * @return Operand of the latest operation
+     */
+    [[nodiscard]] Symbols::SymbolId top() const;
+
+    /**
+     * @brief Keeps track of the last fulfilled operation when the value of an operand changed
+     *
+     * @param[in] operand Operand whose value slot changed
+     * @param[in] valueSlots Current values of the operands
+     */
+    void updateValue(Symbols::SymbolId operand, Symbols::ValueSlots valueSlots);
+
+    /**
+     * @brief Retrieves the operand of the latest operation whose operand holds a value
+     *
+     * @return Operand of the last fulfilled operation (empty if there is none)
+     */
+    [[nodiscard]] std::optional<Symbols::SymbolId> getLastFulfilledOperand() const;
+
+    /**
+     * @brief Getter for the number of operations in the history
+     *
+     * @return Number of entries kept
+     */
+    [[nodiscard]] std::size_t size() const;
+
+    /**
+     * @brief Retrieves the operands of every operation kept in the history
+     *
+     * @return Operands of the operations, oldest first
+     */
+    [[nodiscard]] std::vector<Symbols::SymbolId> getOperands() const;
+
+private:
+    /// Position of an entry since the creation of the history (never reused)
+    using EntryIndex = uint64_t;
+
+    /// Sentinel index used to represent a missing entry
+    static constexpr EntryIndex cNoEntry{std::numeric_limits<EntryIndex>::max()};
+
+    /**
+     * @brief Operation of the history
+     */
+    struct Entry
+    {
+        /// Operand of the operation
+        Symbols::SymbolId operand{};
+        /// Previous entry of the same operand (possibly forgotten since)
+        EntryIndex previousOccurrence{cNoEntry};
+    };
+
+    /**
+     * @brief Retrieves the entry at a given position
+     *
+     * @param[in] index Position of the entry (must be kept)
+     *
+     * @return Reference to the entry
+     */
+    [[nodiscard]] Entry& getEntry(EntryIndex index);
+
+    /**
+     * @brief Retrieves the entry at a given position
+     *
+     * @param[in] index Position of the entry (must be kept)
+     *
+     * @return Const reference to the entry
+     */
+    [[nodiscard]] const Entry& getEntry(EntryIndex index) const;
+
+    /**
+     * @brief Searches the last fulfilled operation downwards, starting from an entry
+     *
+     * @param[in] lastCandidate Position of the first entry to check (excluded if missing)
+     * @param[in] valueSlots Current values of the operands
+     */
+    void findLastFulfilledEntry(EntryIndex lastCandidate, Symbols::ValueSlots valueSlots);
+
+private:
+    /// Maximum number of entries kept (0 for no bound)
+    std::size_t mMaxDepth;
+
+    /// Entries (a ring buffer when bounded)
+    std::vector<Entry> mEntries;
+
+    /// Position of the oldest entry kept
+    EntryIndex mBegin{0};
+
+    /// Position following the latest entry
+    EntryIndex mEnd{0};
+
+    /// Position of the latest entry of each operand (possibly forgotten),
+    /// indexed by symbol identifier
+    std::vector<EntryIndex> mLatestOccurrences;
+
+    /// Position of the last fulfilled operation
+    EntryIndex mLastFulfilledEntry{cNoEntry};
+};
+
+} // namespace Calculator
@@ -0,0 +1,38 @@
+#include "Profiler.hpp"
+
+namespace {
+/// Names of the profiled methods, in the order of Profiler::Method
+constexpr std::array<const char*, 7> cMethodNames{"updateOperationOrder",
+                                                  "storeExpressionValue",
+                                                  "storeExpressionDependencies",
+                                                  "getLastFulfilledOperation",
+                                                  "undoLastRegisteredOperations",
+                                                  "createCheckpoint",
+                                                  "restoreCheckpoint"};
+} // namespace
+
+namespace Calculator {
+
+void Profiler::record(const Method method, const Clock::duration duration)
+{
+    auto& totals = mTotals[static_cast<std::size_t>(method)];
+    ++totals.calls;
+    totals.time += duration;
+}
+
+const Profiler::MethodTotals& Profiler::getTotals(const Method method) const
+{
+    return mTotals[static_cast<std::size_t>(method)];
+}
+
+const char* Profiler::getMethodName(const Method method)
+{
+    return cMethodNames[static_cast<std::size_t>(method)];
+}
+
+void Profiler::reset()
+{
+    mTotals = {};
+}
+
+} // namespace Calculator
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace Calculator {
+
+/**
+ * @brief Accumulates the number of calls and the time spent in each public method of the State
+ *
+ * Meant for workload drivers sizing the calculator: unlike the Statistics, every call is timed.
+ * Methods are timed by the thread processing the instructions only (the re-evaluations of a
+ * parallel propagation are part of the method that started it)
+ */
+class Profiler
+{
+public:
+    /// Clock timing the methods
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Profiled methods of the State
+     */
+    enum class Method : uint8_t {
+
+        UPDATE_OPERATION_ORDER = 0,        // State::updateOperationOrder
+        STORE_EXPRESSION_VALUE = 1,        // State::storeExpressionValue (and its propagation)
+        STORE_EXPRESSION_DEPENDENCIES = 2, // State::storeExpressionDependencies
+        GET_LAST_FULFILLED_OPERATION = 3,  // State::getLastFulfilledOperation
+        UNDO_LAST_OPERATIONS = 4,          // State::undoLastRegisteredOperations
+        CREATE_CHECKPOINT = 5,             // State::createCheckpoint
+        RESTORE_CHECKPOINT = 6,            // State::restoreCheckpoint
+        COUNT = 7                          // Number of profiled methods
+    };
+
+    /**
+     * @brief Calls and time accumulated by a method
+     */
+    struct MethodTotals
+    {
+        /// Number of calls
+        uint64_t calls{0};
+        /// Time spent in the calls
+        Clock::duration time{};
+    };
+
+    /**
+     * @brief Call being timed, accumulated once it returns
+     *
+     * Calls profiled by a null profiler are not timed, so that profiling costs a single branch
+     * when disabled
+     */
+    class Scope
+    {
+    public:
+        /**
+         * @brief Class constructor, starts timing the call
+         *
+         * @param[in] profiler Profiler accumulating the call (null if profiling is disabled)
+         * @param[in] method Method being called
+         */
+        Scope(Profiler* const profiler, const Method method)
+            : mProfiler{profiler}
+            , mMethod{method}
+            , mStartTime{profiler ? Clock::now() : Clock::time_point{}}
+        {
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        /**
+         * @brief Class destructor, accumulates the call
+         */
+        ~Scope()
+        {
+            if (mProfiler) {
+                mProfiler->record(mMethod, Clock::now() - mStartTime);
+            }
+        }
+
+    private:
+        /// Profiler accumulating the call
+        Profiler* mProfiler;
+
+        /// Method being called
+        Method mMethod;
+
+        /// Start time of the call
+        Clock::time_point mStartTime;
+    };
+
+    /**
+     * @brief Accumulates a call of a method
+     *
+     * @param[in] method Method called
+     * @param[in] duration Time spent in the call
+     */
+    void record(Method method, Clock::duration duration);
+
+    /**
+     * @brief Getter for the calls and time accumulated by a method
+     *
+     * @param[in] method Profiled method
+     *
+     * @return Totals of the method
+     */
+    [[nodiscard]] const MethodTotals& getTotals(Method method) const;
+
+    /**
+     * @brief Retrieves the name of a method
+     *
+     * @param[in] method Profiled method
+     *
+     * @return Name of the method (e.g. "storeExpressionValue")
+     */
+    [[nodiscard]] static const char* getMethodName(Method method);
+
+    /**
+     * @brief Forgets every accumulated call
+     */
+    void reset();
+
+private:
+    /// Totals of every method, indexed by Method
+    std::array<MethodTotals, static_cast<std::size_t>(Method::COUNT)> mTotals{};
+};
+
+} // namespace Calculator
@@ -0,0 +1,115 @@
+#include "PropagationEngine.hpp"
+
+#include <algorithm>
+
+namespace Calculator {
+
+std::span<const PropagationEngine::ScheduledOperand>
+      PropagationEngine::schedule(const Symbols::SymbolId changedOperand,
+                                  const DependencyGraph& dependencyGraph)
+{
+    resetScratchBuffers(dependencyGraph.size());
+    mSchedule.clear();
+
+    // 1. Collect the affected operands and count, for each one of them,
+    // how many of its dependencies are affected as well
+    mDiscoveryStamps[changedOperand] = mPropagationStamp;
+    mOperandsToVisit.assign(1, changedOperand);
+
+    while (!mOperandsToVisit.empty()) {
+        const auto operand = mOperandsToVisit.back();
+        mOperandsToVisit.pop_back();
+
+        for (const auto dependantOperand : dependencyGraph[operand]) {
+            if (dependantOperand == changedOperand) {
+                continue;
+            }
+
+            if (mDiscoveryStamps[dependantOperand] != mPropagationStamp) {
+                mDiscoveryStamps[dependantOperand] = mPropagationStamp;
+                mPendingDependencyCounts[dependantOperand] = 0;
+                mLevels[dependantOperand] = 0;
+                mOperandsToVisit.push_back(dependantOperand);
+            }
+
+            ++mPendingDependencyCounts[dependantOperand];
+        }
+    }
+
+    // 2. Order them topologically (Kahn's algorithm): an operand is scheduled once all of its
+    // affected dependencies are. Operands that are part of a cycle are never scheduled.
+    mLevels[changedOperand] = 0;
+    mOperandsToVisit.assign(1, changedOperand);
+
+    for (std::size_t next = 0; next < mOperandsToVisit.size(); ++next) {
+        const auto operand = mOperandsToVisit[next];
+
+        for (const auto dependantOperand : dependencyGraph[operand]) {
+            if (dependantOperand == changedOperand) {
+                continue;
+            }
+
+            mLevels[dependantOperand] = std::max(mLevels[dependantOperand], mLevels[operand] + 1);
+
+            if (--mPendingDependencyCounts[dependantOperand] == 0) {
+                mOperandsToVisit.push_back(dependantOperand);
+                mSchedule.push_back({dependantOperand, 0});
+            }
+        }
+    }
+    mOperandsToVisit.clear();
+
+    // 3. Group the schedule by level (keeping the topological order within each level), with
+    // a counting sort into reused buffers: a stable sort would allocate a temporary buffer
+    mLevelOffsets.assign(1, 0);
+    for (auto& scheduledOperand : mSchedule) {
+        scheduledOperand.level = mLevels[scheduledOperand.operand];
+        if (scheduledOperand.level + 1 >= mLevelOffsets.size()) {
+            mLevelOffsets.resize(scheduledOperand.level + 2, 0);
+        }
+        ++mLevelOffsets[scheduledOperand.level + 1];
+    }
+
+    for (std::size_t level = 1; level < mLevelOffsets.size(); ++level) {
+        mLevelOffsets[level] += mLevelOffsets[level - 1];
+    }
+
+    mSortedSchedule.resize(mSchedule.size());
+    for (const auto& scheduledOperand : mSchedule) {
+        mSortedSchedule[mLevelOffsets[scheduledOperand.level]++] = scheduledOperand;
+    }
+
+    return mSortedSchedule;
+}
+
+void PropagationEngine::markUpdated(const Symbols::SymbolId updatedOperand,
+                                    const DependencyGraph& dependencyGraph)
+{
+    for (const auto dependantOperand : dependencyGraph[updatedOperand]) {
+        mOutdatedStamps[dependantOperand] = mPropagationStamp;
+    }
+}
+
+bool PropagationEngine::isOutdated(const Symbols::SymbolId operand) const
+{
+    return mOutdatedStamps[operand] == mPropagationStamp;
+}
+
+void PropagationEngine::resetScratchBuffers(const std::size_t operandCount)
+{
+    if (mDiscoveryStamps.size() < operandCount) {
+        mDiscoveryStamps.resize(operandCount, 0);
+        mOutdatedStamps.resize(operandCount, 0);
+        mPendingDependencyCounts.resize(operandCount, 0);
+        mLevels.resize(operandCount, 0);
+    }
+
+    // Stamps are only cleared when the propagation counter wraps around
+    if (++mPropagationStamp == 0) {
+        std::ranges::fill(mDiscoveryStamps, 0);
+        std::ranges::fill(mOutdatedStamps, 0);
+        mPropagationStamp = 1;
+    }
+}
+
+} // namespace Calculator
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "symbols/SymbolTable.hpp"
+
+namespace Calculator {
+
+/**
+ * @brief Schedules the re-evaluation of the operands affected by a change of value
+ *
+ * The schedule is computed iteratively over the dependency graph: the operands downstream of
+ * the changed one are collected, ordered topologically and grouped by level, so that every
+ * operand comes after all of the affected operands it depends on and is evaluated exactly once.
+ *
+ * Scratch buffers are kept between calls, so scheduling does not allocate once they are warm.
+ */
+class PropagationEngine
+{
+public:
+    /// Alias representing the dependency graph: the operands depending on each operand
+    using DependencyGraph = std::vector<std::vector<Symbols::SymbolId>>;
+
+    /**
+     * @brief Operand scheduled for re-evaluation
+     */
+    struct ScheduledOperand
+    {
+        /// Operand to re-evaluate
+        Symbols::SymbolId operand{};
+        /// Length of the longest dependency path from the changed operand
+        uint32_t level{};
+    };
+
+    /**
+     * @brief Computes the re-evaluation schedule of the operands downstream of a changed operand
+     *
+     * Operands are sorted by level and, within a level, by the order in which all of their
+     * affected dependencies got scheduled, which makes the schedule deterministic.
+     * The changed operand itself is never scheduled and operands that are part of a cycle
+     * (which can never be resolved) are left out.
+     *
+     * @param[in] changedOperand Operand whose value changed
+     * @param[in] dependencyGraph Operands depending on each operand
+     *
+     * @return View over the schedule (valid until the next call)
+     */
+    [[nodiscard]] std::span<const ScheduledOperand>
+          schedule(Symbols::SymbolId changedOperand, const DependencyGraph& dependencyGraph);
+
+    /**
+     * @brief Flags the dependents of an operand whose value was updated during propagation
+     *
+     * @param[in] updatedOperand Operand whose value was updated
+     * @param[in] dependencyGraph Operands depending on each operand
+     */
+    void markUpdated(Symbols::SymbolId updatedOperand, const DependencyGraph& dependencyGraph);
+
+    /**
+     * @brief Checks if a scheduled operand has to be re-evaluated
+     *
+     * Only operands with at least one dependency updated during the current propagation
+     * need to be re-evaluated
+     *
+     * @param[in] operand Scheduled operand
+     *
+     * @return True if any dependency of the operand was updated (false otherwise)
+     */
+    [[nodiscard]] bool isOutdated(Symbols::SymbolId operand) const;
+
+private:
+    /**
+     * @brief Starts a new propagation: grows the scratch buffers and invalidates their contents
+     *
+     * @param[in] operandCount Number of operands of the dependency graph
+     */
+    void resetScratchBuffers(std::size_t operandCount);
+
+private:
+    /// Identifier of the current propagation (used to lazily invalidate the scratch buffers)
+    uint32_t mPropagationStamp{0};
+
+    /// Propagation in which each operand was last discovered
+    std::vector<uint32_t> mDiscoveryStamps;
+
+    /// Propagation in which each operand last had one of its dependencies updated
+    std::vector<uint32_t> mOutdatedStamps;
+
+    /// Amount of affected dependencies of each operand not scheduled yet
+    std::vector<uint32_t> mPendingDependencyCounts;
+
+    /// Level of each scheduled operand
+    std::vector<uint32_t> mLevels;
+
+    /// Operands left to explore while collecting the affected operands
+    std::vector<Symbols::SymbolId> mOperandsToVisit;
+
+    /// Re-evaluation schedule, in topological order
+    std::vector<ScheduledOperand> mSchedule;
+
+    /// Re-evaluation schedule, grouped by level
+    std::vector<ScheduledOperand> mSortedSchedule;
+
+    /// Position of the first operand of each level in the grouped schedule
+    std::vector<std::size_t> mLevelOffsets;
+};
+
+} // namespace Calculator
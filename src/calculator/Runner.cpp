@@ -1,162 +1,404 @@
 #include "Runner.hpp"
 
+#include <array>
+#include <charconv>
+
 #include "evaluator/Evaluator.hpp"
+#include "evaluator/VirtualMachine.hpp"
 #include "parser/Parser.hpp"
 #include "utils/Constants.hpp"
-#include "utils/Methods.hpp"
 
 namespace {
-/// Supported string for the undo command
-constexpr auto cUndoCommand{"undo"};
-/// Supported string for the result command
-constexpr auto cResultCommand{"result"};
+/// White space characters surrounding the tokens of an instruction
+constexpr std::string_view cWhiteSpaces{" \t\n\v\f\r"};
 
 /**
- * @brief Enum representing operations supported by the calculator
+ * @brief Removes the leading and trailing white spaces of a string
+ *
+ * @param[in] text String to trim
+ *
+ * @return View over the trimmed string
  */
-enum class SupportedOperation : uint8_t {
+std::string_view trimWhiteSpaces(std::string_view text)
+{
+    const auto textStart = text.find_first_not_of(cWhiteSpaces);
+    if (textStart == std::string_view::npos) {
+        return {};
+    }
 
-    RESULT = 0, // Present result of last fulfilled operation
-    UNDO = 1,   // Undo a certain amount of operation
-    OTHER = 2   // Most probably an arithmetic expression (needs further evaluation)
-};
+    text.remove_prefix(textStart);
+    text.remove_suffix(text.size() - 1 - text.find_last_not_of(cWhiteSpaces));
+    return text;
+}
 
 /**
- * @brief Parses an input string to determine the type of operation that is being requested
+ * @brief Retrieves the position of a token in the instruction it was read from
  *
- * @param[in] input The input string to parse
+ * @param[in] input Instruction
+ * @param[in] token View over a part of the instruction
  *
- * @return A pair consisting of the type of operation and an optional integer argument
+ * @return Offset of the first byte of the token in the instruction
  */
-std::pair<SupportedOperation, std::optional<int>> getOperationRequest(const std::string& input)
+std::size_t getOffset(const std::string_view input, const std::string_view token)
 {
-    const auto inputStringTokens
-          = Utils::Methods::splitString(input, Utils::Constants::cWhiteSpace);
+    return static_cast<std::size_t>(token.data() - input.data());
+}
 
-    if (inputStringTokens.size() == 1 && inputStringTokens.back() == cResultCommand) {
-        return {SupportedOperation::RESULT, {}};
-    } else if (inputStringTokens.size() == 2 && inputStringTokens.front() == cUndoCommand) {
+/**
+ * @brief Appends the decimal representation of a value to a string, without allocating
+ * (once the string has enough capacity)
+ *
+ * @param[in] value Value to append
+ * @param[in,out] text String the value is appended to
+ */
+void appendNumber(const int value, std::string& text)
+{
+    std::array<char, 16> digits{};
+    const auto [digitsEnd, errorCode] = std::to_chars(digits.begin(), digits.end(), value);
+    text.append(digits.begin(), digitsEnd);
+}
+} // namespace
 
-        int result{};
-        try {
-            result = std::stoi(inputStringTokens.back());
-        }
-        catch (const std::exception& e) {
-            result = -1;
-        }
+namespace Calculator {
 
-        return {SupportedOperation::UNDO, result};
-    }
+Runner::Runner(const std::size_t expressionCacheCapacity)
+    : mExpressionCache{expressionCacheCapacity}
+{
+}
+
+std::vector<std::string> Runner::processInstruction(const std::string_view input)
+{
+    std::vector<std::string> results;
+    [[maybe_unused]] const auto instructionResult
+          = processInstruction(input, [&results](const std::string_view result) {
+                results.emplace_back(result);
+            });
 
-    return {SupportedOperation::OTHER, {}};
+    return results;
 }
 
-} // namespace
+Utils::Expected<> Runner::processInstruction(const std::string_view input,
+                                             const ResultHandler& handleResult)
+{
+    mStatistics.beginInstruction();
+    auto instructionResult = executeInstruction(input, handleResult);
+    mStatistics.endInstruction();
 
-namespace Calculator {
+    return instructionResult;
+}
 
-std::vector<std::string> Runner::processInstruction(const std::string& input)
+Utils::Expected<> Runner::executeInstruction(const std::string_view input,
+                                             const ResultHandler& handleResult)
 {
-    std::vector<std::string> results;
+    auto& counters = mStatistics.getCounters();
 
-    // Handle situations where the user provided a supported instructions
-    // instead of an arithmetic expression.
-    {
-        const auto operationRequest = getOperationRequest(input);
-
-        switch (operationRequest.first) {
-        case SupportedOperation::RESULT: {
-            const auto lastOperation = mState.getLastFulfilledOperation();
-
-            if (lastOperation == decltype(lastOperation)()) {
-                std::cerr << "There is no result available yet\n";
-            } else {
-                results.emplace_back("return " + lastOperation.first + " = "
-                                     + std::to_string(lastOperation.second));
+    // Arithmetic expressions that were already compiled are served from the cache,
+    // which skips parsing entirely
+    const auto assignmentPosition = input.find(Utils::Constants::cAssignOp);
+    const auto expressionText = assignmentPosition == std::string_view::npos
+                                      ? std::string_view{}
+                                      : input.substr(assignmentPosition + 1);
+
+    if (assignmentPosition != std::string_view::npos) {
+        const auto operandName = trimWhiteSpaces(input.substr(0, assignmentPosition));
+
+        if (Parser::isOperandName(operandName)) {
+            if (const auto expressionProgram = mExpressionCache.find(expressionText)) {
+                ++counters.cachedExpressions;
+                mStatistics.endPhase(Statistics::Phase::DETECTION);
+                return processExpression(mState.getSymbolTable().intern(operandName),
+                                         *expressionProgram,
+                                         getOffset(input, operandName),
+                                         handleResult);
             }
+        }
+    }
+
+    mStatistics.endPhase(Statistics::Phase::DETECTION);
+
+    // Try to parse the provided instruction
+    const Tracer::Span parsingSpan(mTracer, "parse");
+    Parser instructionParser(input, mState.getSymbolTable());
+    const auto parsingResult = instructionParser.execute();
+    mStatistics.endPhase(Statistics::Phase::PARSING);
+
+    const auto isAssignment
+          = parsingResult
+            && instructionParser.getInstructionType() == Parser::InstructionType::ASSIGNMENT;
+    parsingSpan.end(isAssignment ? getOperandName(instructionParser.getOperandOfLHS())
+                                 : std::string_view{});
 
-            return results;
+    if (!parsingResult) {
+        ++counters.rejectedInstructions;
+        return parsingResult;
+    }
+
+    // Handle situations where the user provided a supported command
+    // instead of an arithmetic expression.
+    const auto instructionStart = input.find_first_not_of(cWhiteSpaces);
+    Utils::Expected<> commandResult;
+
+    switch (instructionParser.getInstructionType()) {
+    case Parser::InstructionType::RESULT: {
+        const auto lastOperation = mState.getLastFulfilledOperation();
+
+        if (!lastOperation) {
+            commandResult = Utils::Error{Utils::ErrorCode::NO_RESULT_AVAILABLE, instructionStart};
+        } else {
+            mResultText.assign("return ");
+            mResultText.append(getOperandName(lastOperation->first));
+            mResultText.append(" = ");
+            appendNumber(lastOperation->second, mResultText);
+            handleResult(mResultText);
         }
-        case SupportedOperation::UNDO: {
-            const auto undoneOperations = mState.undoLastRegisteredOperations(
-                  operationRequest.second.value_or(/*default*/ 0));
-
-            if (undoneOperations.empty()) {
-                std::cout << "No operations were undone\n";
-            } else {
-                for (const auto& undoneOperation : undoneOperations) {
-                    results.emplace_back("delete " + undoneOperation);
-                }
-            }
 
-            return results;
+        break;
+    }
+    case Parser::InstructionType::UNDO: {
+        const auto undoneOperations
+              = mState.undoLastRegisteredOperations(instructionParser.getUndoCount());
+
+        if (undoneOperations.empty()) {
+            commandResult = Utils::Error{Utils::ErrorCode::NOTHING_TO_UNDO, instructionStart};
+        } else {
+            for (const auto& undoneOperation : undoneOperations) {
+                mResultText.assign("delete ");
+                mResultText.append(getOperandName(undoneOperation));
+                handleResult(mResultText);
+            }
         }
-        case SupportedOperation::OTHER:
-        default:
-            break;
+
+        break;
+    }
+    case Parser::InstructionType::CHECKPOINT:
+        mState.createCheckpoint(instructionParser.getCheckpointName());
+        break;
+    case Parser::InstructionType::RESTORE:
+        if (!mState.restoreCheckpoint(instructionParser.getCheckpointName())) {
+            commandResult = Utils::Error{Utils::ErrorCode::UNKNOWN_CHECKPOINT,
+                                         getOffset(input, instructionParser.getCheckpointName())};
         }
+
+        break;
+    case Parser::InstructionType::STATS:
+        reportStatistics(instructionParser.isMachineReadable(), handleResult);
+        break;
+    case Parser::InstructionType::ASSIGNMENT:
+        break;
     }
 
-    // Try to parse the provided arithmetic expression
-    Parser expressionParser(input);
-    if (!expressionParser.execute()) {
-        std::cout << "\nInvalid arithmetic expression provided.";
-        return results;
+    if (!isAssignment) {
+        mStatistics.endPhase(Statistics::Phase::COMMAND);
+        return commandResult;
     }
 
+    // Retrieve the RHS of the parsed arithmetic expression (a program compiled from its AST)
+    // and cache it for the next time the same expression is provided
+    const auto expressionProgram = std::make_shared<const Bytecode::Program>(
+          instructionParser.extractProgramOfRHS());
+    mExpressionCache.insert(expressionText, expressionProgram);
+    ++counters.parsedExpressions;
+
     // Retrieve the LHS of the parsed arithmetic expression (an operand).
-    const auto expressionOperand = expressionParser.getOperandOfLHS();
-    // Retrieve the RHS of the parsed arithmetic expression (an AST).
-    const auto expressionAST = expressionParser.getASTOfRHS();
+    return processExpression(instructionParser.getOperandOfLHS(),
+                             *expressionProgram,
+                             instructionStart,
+                             handleResult);
+}
+
+std::vector<std::string> Runner::registerFormulas(const Bytecode::ProgramImage& image)
+{
+    std::vector<Symbols::SymbolId> symbolBindings;
+    symbolBindings.reserve(image.getSymbolCount());
+    for (std::size_t symbolIndex = 0; symbolIndex < image.getSymbolCount(); ++symbolIndex) {
+        symbolBindings.push_back(mState.getSymbolTable().intern(image.getSymbolName(symbolIndex)));
+    }
+
+    std::vector<std::string> results;
+
+    for (std::size_t formulaIndex = 0; formulaIndex < image.getFormulaCount(); ++formulaIndex) {
+        const auto formula = image.getFormula(formulaIndex);
+
+        // Formulas are evaluated in place: a program is only built for the ones left pending
+        VirtualMachine virtualMachine(formula, symbolBindings, mState.getOperandValues());
+        const auto evaluationResult = virtualMachine.execute();
+        mStatistics.getCounters().assignedExpressionNodes += formula.instructions.size();
 
-    // Try to evaluate the AST to check if we can obtain
+        const auto isPending = std::holds_alternative<Evaluator::Dependencies>(evaluationResult);
+        const auto formulaProgram = isPending
+                                          ? Bytecode::ProgramImage::bind(formula, symbolBindings)
+                                          : Bytecode::Program{};
+
+        // Formulas closing a cycle of dependencies are rejected, as they would be by assignments
+        [[maybe_unused]] const auto formulaResult = storeEvaluationResult(
+              symbolBindings[formula.target],
+              evaluationResult,
+              formulaProgram,
+              0,
+              [&results](const std::string_view result) { results.emplace_back(result); });
+    }
+
+    return results;
+}
+
+Utils::Expected<> Runner::processExpression(const Symbols::SymbolId expressionOperand,
+                                            const Bytecode::Program& expressionProgram,
+                                            const std::size_t operandOffset,
+                                            const ResultHandler& handleResult)
+{
+    // Try to execute the program to check if we can obtain
     // either a valid result or a list of unmet dependencies
-    Evaluator astEvaluator(expressionAST->top(),
-                           // the map with the current values of each operand is provided for
-                           // dependency lookup when evaluation the AST
-                           mState.getOperandValueMap());
+    const Tracer::Span evaluationSpan(mTracer, "evaluate");
+    VirtualMachine virtualMachine(expressionProgram,
+                                  // the current values of each operand are provided
+                                  // for dependency lookup when executing the program
+                                  mState.getOperandValues());
+    const auto evaluationResult = virtualMachine.execute();
+    evaluationSpan.end(getOperandName(expressionOperand));
+
+    mStatistics.getCounters().assignedExpressionNodes += expressionProgram.getInstructions().size();
+    mStatistics.endPhase(Statistics::Phase::EVALUATION);
 
+    return storeEvaluationResult(
+          expressionOperand, evaluationResult, expressionProgram, operandOffset, handleResult);
+}
+
+Utils::Expected<> Runner::storeEvaluationResult(const Symbols::SymbolId expressionOperand,
+                                                const Evaluator::Result& evaluationResult,
+                                                const Bytecode::Program& expressionProgram,
+                                                const std::size_t operandOffset,
+                                                const ResultHandler& handleResult)
+{
     // Get the result of the evaluation and process it according to its type
-    const auto evaluationResult = astEvaluator.execute();
-    std::visit(
-          [&](auto&& variantValue) {
-              // Expected types: int or unordered_set<std::string>
+    auto storageResult = std::visit(
+          [&](auto&& variantValue) -> Utils::Expected<> {
+              // Expected types: int or Evaluator::Dependencies
               using VariantType = std::decay_t<decltype(variantValue)>;
 
               // Did we get a value after the expression was evaluated?
               if constexpr (std::is_same_v<VariantType, int>) {
 
                   // Then, store it
-                  for (const auto& [operand, value] :
-                       mState.storeExpressionValue(expressionOperand, variantValue)) {
+                  const auto& affectedOperands
+                        = mState.storeExpressionValue(expressionOperand, variantValue);
+                  mStatistics.recordCascade(affectedOperands.size());
 
-                      results.emplace_back(operand + " = " + std::to_string(value));
+                  for (const auto& [operand, value] : affectedOperands) {
+                      mResultText.assign(getOperandName(operand));
+                      mResultText.append(" = ");
+                      appendNumber(value, mResultText);
+                      handleResult(mResultText);
                   }
 
                   mState.updateOperationOrder(expressionOperand);
+                  return {};
               }
               // Or did we get a list of unmet dependencies instead?
               else if constexpr (std::is_same_v<VariantType, Evaluator::Dependencies>) {
 
                   if (!variantValue.empty()) {
 
-                      // Then, update the state of the dependencies
+                      // Then, update the state of the dependencies (the cycle they would
+                      // close is kept for describeError)
                       if (!mState.storeExpressionDependencies(
-                                expressionOperand, expressionAST, variantValue)) {
-
-                          std::cerr << "Cyclic dependency found: \'" << expressionOperand
-                                    << "\' is already a dependency in another expression\n";
-                      } else {
-                          mState.updateOperationOrder(expressionOperand);
+                                expressionOperand, expressionProgram, variantValue)) {
+                          return Utils::Error{Utils::ErrorCode::CYCLIC_DEPENDENCY, operandOffset};
                       }
+
+                      mState.updateOperationOrder(expressionOperand);
                   }
-              } else {
-                  std::cerr << "Unknown result type returned\n";
+
+                  return {};
+              }
+              // Or did the evaluation fail?
+              else {
+                  return Utils::Error{variantValue.code, operandOffset};
               }
           },
           evaluationResult);
 
-    return results;
+    mStatistics.endPhase(Statistics::Phase::PROPAGATION);
+    return storageResult;
+}
+
+std::string Runner::describeError(const Utils::Error& error) const
+{
+    std::string description{Utils::getErrorMessage(error.code)};
+
+    // Each operand of the cycle depends on the next one
+    if (error.code == Utils::ErrorCode::CYCLIC_DEPENDENCY) {
+        const char* separator = ": ";
+        for (const auto operand : mState.getCyclicDependency()) {
+            description.append(separator).append("\'").append(getOperandName(operand));
+            description.push_back('\'');
+            separator = " -> ";
+        }
+    }
+
+    return description;
+}
+
+const ExpressionCache& Runner::getExpressionCache() const
+{
+    return mExpressionCache;
+}
+
+Statistics& Runner::getStatistics()
+{
+    return mStatistics;
+}
+
+void Runner::setTracer(Tracer* const tracer)
+{
+    mTracer = tracer;
+    mState.setTracer(tracer);
+}
+
+void Runner::setProfiler(Profiler* const profiler)
+{
+    mState.setProfiler(profiler);
+}
+
+std::shared_ptr<ConcurrentValues> Runner::enableConcurrentReads()
+{
+    return mState.enableConcurrentReads();
+}
+
+uint64_t Runner::getModificationCount() const
+{
+    return mState.getModificationCount();
+}
+
+void Runner::saveSnapshot(std::vector<std::byte>& image) const
+{
+    mState.saveSnapshot(image);
+}
+
+bool Runner::loadSnapshot(const std::span<const std::byte> image)
+{
+    return mState.loadSnapshot(image);
+}
+
+void Runner::reportStatistics(const bool isMachineReadable,
+                              const ResultHandler& handleResult) const
+{
+    const auto pendingExpressionCount = mState.getPendingExpressionCount();
+
+    if (isMachineReadable) {
+        handleResult(mStatistics.dumpJson(pendingExpressionCount));
+        return;
+    }
+
+    std::vector<std::string> entries;
+    mStatistics.describe(pendingExpressionCount, entries);
+    for (const auto& entry : entries) {
+        handleResult(entry);
+    }
+}
+
+const std::string& Runner::getOperandName(const Symbols::SymbolId operand) const
+{
+    return mState.getSymbolTable().getName(operand);
 }
 
 } // namespace Calculator
\ No newline at end of file
@@ -1,42 +1,247 @@
 #pragma once
 
+#include <cstddef>
+#include <functional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "ExpressionCache.hpp"
 #include "State.hpp"
+#include "Statistics.hpp"
+#include "bytecode/ProgramImage.hpp"
+#include "utils/Error.hpp"
 
 namespace Calculator {
 
+/// Default maximum number of compiled arithmetic expressions kept by a Runner
+inline constexpr std::size_t cDefaultExpressionCacheCapacity{1024};
+
 /**
  * @brief Class responsible for processing instructions and managing the state of the calculator
  *
  * This class handles various calculator operations including:
  * - evaluating arithmetic expressions;
  * - undoing previous operations;
+ * - recording checkpoints of the state and restoring them;
  * - fetching the result of the last completed operation;
  */
 class Runner
 {
 public:
+    /// Alias representing a callback invoked for every result of an instruction, in order
+    /// (the result is only valid during the call)
+    using ResultHandler = std::function<void(std::string_view result)>;
+
     /**
-     * @brief Class' default constructor
+     * @brief Class constructor
+     *
+     * @param[in] expressionCacheCapacity Maximum number of compiled arithmetic expressions
+     * to cache (0 disables the cache)
      */
-    Runner() = default;
+    explicit Runner(std::size_t expressionCacheCapacity = cDefaultExpressionCacheCapacity);
 
     /**
      * @brief Processes a given instruction and returns the corresponding results
      *
-     * Supported instructions are an arithmetic expression or commands like "undo 2" or "result"
+     * Supported instructions are an arithmetic expression or commands like "undo 2", "result",
+     * "checkpoint name", "restore name" or "stats" (optionally "stats json")
      *
      * @param[in] input Instruction to process
      *
      * @return A vector of strings containing the results of the instruction after being processed
+     * (empty if it was rejected: the overload taking a callback reports why)
+     */
+    std::vector<std::string> processInstruction(std::string_view input);
+
+    /**
+     * @brief Processes a given instruction and hands its results over to a callback
+     *
+     * Results are formatted into a buffer reused by every instruction: unlike the overload
+     * returning a vector, processing an instruction does not allocate anything for its results.
+     * Nothing is printed: failures are returned, to be reported (see describeError) or not
+     * by the caller
+     *
+     * @param[in] input Instruction to process
+     * @param[in] handleResult Callback invoked for every result (e.g. appending it to an output)
+     *
+     * @return Nothing if the instruction was processed, otherwise the reason why it was not
+     * (and the position in the input it applies to)
+     */
+    Utils::Expected<> processInstruction(std::string_view input,
+                                         const ResultHandler& handleResult);
+
+    /**
+     * @brief Describes an error returned by the last processed instruction
+     *
+     * @param[in] error Error to describe
+     *
+     * @return Human readable message (naming the operands of the cycle for cyclic dependencies)
+     */
+    [[nodiscard]] std::string describeError(const Utils::Error& error) const;
+
+    /**
+     * @brief Getter for the cache of compiled arithmetic expressions
+     *
+     * Allows the cache usage (hit and miss counters) to be inspected
+     *
+     * @return Const reference to the expression cache
+     */
+    [[nodiscard]] const ExpressionCache& getExpressionCache() const;
+
+    /**
+     * @brief Getter for the instrumentation of the instructions processed so far
+     *
+     * @return Reference to the statistics (e.g. to change their timing sample period)
+     */
+    [[nodiscard]] Statistics& getStatistics();
+
+    /**
+     * @brief Records the processing of the instructions into a trace: parsing, evaluation and
+     * propagation to every dependent operand (see Tracer)
+     *
+     * @param[in] tracer Tracer recording the spans, which must outlive the runner
+     * (null disables tracing)
+     */
+    void setTracer(Tracer* tracer);
+
+    /**
+     * @brief Accumulates the calls and the time spent in each public method of the state
+     * (see Profiler)
+     *
+     * @param[in] profiler Profiler accumulating the calls, which must outlive the runner
+     * (null disables profiling)
+     */
+    void setProfiler(Profiler* profiler);
+
+    /**
+     * @brief Shares the values of the operands with threads reading them while instructions
+     * are processed (see State::enableConcurrentReads)
+     *
+     * Readers see the values as they were after a whole instruction, never in between
+     *
+     * @return Values to attach readers to
+     */
+    [[nodiscard]] std::shared_ptr<ConcurrentValues> enableConcurrentReads();
+
+    /**
+     * @brief Registers the formulas of a program image, as if each of them was an assignment
+     * instruction processed in turn
+     *
+     * Formulas are evaluated in place, in the image: only those left pending (waiting for
+     * operands without a value) are copied into a program stored by the state
+     *
+     * @param[in] image Image holding the compiled formulas
+     *
+     * @return Operands and their respective values that were affected by the formulas
      */
-    std::vector<std::string> processInstruction(const std::string& input);
+    std::vector<std::string> registerFormulas(const Bytecode::ProgramImage& image);
+
+    /**
+     * @brief Getter for the number of operations that modified the state so far
+     *
+     * @return Number of modifying operations (unchanged by instructions without effect)
+     */
+    [[nodiscard]] uint64_t getModificationCount() const;
+
+    /**
+     * @brief Serializes the whole state into a compact binary image (see State::saveSnapshot)
+     *
+     * @param[in,out] image Buffer the image is appended to
+     */
+    void saveSnapshot(std::vector<std::byte>& image) const;
+
+    /**
+     * @brief Restores a state serialized by saveSnapshot, before any instruction is processed
+     *
+     * @param[in] image Binary image of a state
+     *
+     * @return False if the image is malformed or if instructions were already processed
+     */
+    [[nodiscard]] bool loadSnapshot(std::span<const std::byte> image);
+
+private:
+    /**
+     * @brief Processes a given instruction, once its instrumentation started
+     *
+     * @param[in] input Instruction to process
+     * @param[in] handleResult Callback invoked for every result
+     *
+     * @return Nothing if the instruction was processed, otherwise the reason why it was not
+     */
+    Utils::Expected<> executeInstruction(std::string_view input,
+                                         const ResultHandler& handleResult);
+
+    /**
+     * @brief Reports the statistics of the calculator
+     *
+     * @param[in] isMachineReadable Whether the statistics are dumped as a single JSON object
+     * @param[in] handleResult Callback invoked for every entry describing the statistics
+     * (a single one if they are machine readable)
+     */
+    void reportStatistics(bool isMachineReadable, const ResultHandler& handleResult) const;
+
+    /**
+     * @brief Evaluates a compiled arithmetic expression and assigns its result to an operand
+     *
+     * @param[in] expressionOperand Operand of the LHS of the expression
+     * @param[in] expressionProgram Compiled program of the RHS of the expression
+     * @param[in] operandOffset Position of the LHS operand in the instruction (errors of the
+     * assignment are reported there)
+     * @param[in] handleResult Callback invoked for every operand (and its value) that was
+     * affected by the assignment
+     *
+     * @return Nothing if the assignment was stored, otherwise the reason why it was not
+     */
+    Utils::Expected<> processExpression(Symbols::SymbolId expressionOperand,
+                                        const Bytecode::Program& expressionProgram,
+                                        std::size_t operandOffset,
+                                        const ResultHandler& handleResult);
+
+    /**
+     * @brief Stores the result of an evaluated arithmetic expression into the state
+     *
+     * @param[in] expressionOperand Operand of the LHS of the expression
+     * @param[in] evaluationResult Value of the RHS or the operands it is waiting for
+     * @param[in] expressionProgram Compiled program of the RHS (only used when it is pending)
+     * @param[in] operandOffset Position of the LHS operand in the instruction
+     * @param[in] handleResult Callback invoked for every operand (and its value) that was
+     * affected by the assignment
+     *
+     * @return Nothing if the result was stored, otherwise the reason why it was not (a failed
+     * evaluation or a cyclic dependency)
+     */
+    Utils::Expected<> storeEvaluationResult(Symbols::SymbolId expressionOperand,
+                                            const Evaluator::Result& evaluationResult,
+                                            const Bytecode::Program& expressionProgram,
+                                            std::size_t operandOffset,
+                                            const ResultHandler& handleResult);
+
+    /**
+     * @brief Retrieves the name of an operand
+     *
+     * @param[in] operand Symbol identifier of the operand
+     *
+     * @return Reference to the name of the operand
+     */
+    [[nodiscard]] const std::string& getOperandName(Symbols::SymbolId operand) const;
 
 private:
     /// State of the calculator (operand values and existing dependencies)
     State mState;
+
+    /// Compiled arithmetic expressions, keyed by the text of their RHS
+    ExpressionCache mExpressionCache;
+
+    /// Counters and latencies of the instructions processed
+    Statistics mStatistics;
+
+    /// Tracer recording the instructions (null if tracing is disabled)
+    Tracer* mTracer{nullptr};
+
+    /// Buffer the results are formatted into, reused by every instruction
+    std::string mResultText;
 };
 
 } // namespace Calculator
\ No newline at end of file
@@ -1,145 +1,600 @@
 #include "State.hpp"
 
-#include <functional>
+#include <algorithm>
 
-#include "utils/Methods.hpp"
+namespace {
+/// Number of consecutive operands of a level evaluated as a single task by the thread pool
+constexpr std::size_t cParallelPropagationChunkSize{64};
+} // namespace
 
 namespace Calculator {
 
-void State::updateOperationOrder(const std::string& operand)
+State::State(const uint32_t jitThreshold, const std::size_t operationHistoryDepth)
+    : mOperationHistory{operationHistoryDepth}
+    , mJitThreshold{jitThreshold}
 {
-    mOperandOrderStack.push(operand);
 }
 
-std::vector<std::pair<std::string, int>>
-      State::storeExpressionValue(const std::string& operand, const int value)
+Symbols::SymbolTable& State::getSymbolTable()
 {
-    std::vector<std::pair<std::string, int>> affectedValues;
+    return mSymbolTable;
+}
+
+const Symbols::SymbolTable& State::getSymbolTable() const
+{
+    return mSymbolTable;
+}
+
+void State::updateOperationOrder(const Symbols::SymbolId operand)
+{
+    const Profiler::Scope profilingScope(mProfiler, Profiler::Method::UPDATE_OPERATION_ORDER);
 
-    // Function used to handle the recursive logic of storing values and resolving dependencies
-    std::function<void(const std::string&, int)> storeValueAndCheckDependencies =
+    recordChange({.type = ChangeType::OPERATION_PUSHED, .operand = operand});
+    mOperationHistory.push(operand, mOperandValues);
+    ++mModificationCount;
+}
+
+const std::vector<State::OperandValue>& State::storeExpressionValue(
+      const Symbols::SymbolId operand,
+      const int value)
+{
+    const Profiler::Scope profilingScope(mProfiler, Profiler::Method::STORE_EXPRESSION_VALUE);
 
-          [&](const std::string& newOperand, int newValue) {
-              // Update the values map with the new value of the operand
-              mOperandValuesMap.insert_or_assign(newOperand, newValue);
-              affectedValues.emplace_back(newOperand, newValue);
+    reserveSymbolSlots();
+    ++mModificationCount;
 
-              // Check if there are any expressions that depend on the provided operand
-              // (whose value is now known) and if so, try to resolve them
-              const auto operandDependencyRange = mOperandDependenciesMap.equal_range(newOperand);
+    const Tracer::Span propagationSpan(mTracer, "propagate");
 
-              for (auto itr = operandDependencyRange.first; itr != operandDependencyRange.second;
-                   ++itr) {
+    // Update the value slot of the operand with its new value
+    setOperandValue(operand, {value, true});
+    mAffectedValues.assign(1, {operand, value});
 
-                  const auto dependantOperand = itr->second;
+    // Check if there are any expressions that depend on the provided operand
+    // (whose value is now known) and if so, try to resolve them in topological order
+    const auto schedule = mPropagationEngine.schedule(operand, mOperandDependencies);
+    mPropagationEngine.markUpdated(operand, mOperandDependencies);
+    mExpressionDAG.beginPropagation();
 
-                  // If the dependent operand has an associated expression, evaluate it
-                  if (mExpressionsWithDependenciesMap.contains(dependantOperand)) {
+    for (std::size_t levelBegin = 0; levelBegin < schedule.size();) {
 
-                      Evaluator evaluator(
-                            mExpressionsWithDependenciesMap.at(dependantOperand)->top(),
-                            mOperandValuesMap);
-                      const auto evaluatorResult = evaluator.execute();
+        // Operands of the same level never depend on each other
+        auto levelEnd = levelBegin + 1;
+        while (levelEnd < schedule.size()
+               && schedule[levelEnd].level == schedule[levelBegin].level) {
+            ++levelEnd;
+        }
+
+        const auto level = schedule.subspan(levelBegin, levelEnd - levelBegin);
+        levelBegin = levelEnd;
 
-                      // If the evaluation results in an integer value,
-                      // store it and check its dependencies
-                      if (const int* dependantOperandResult = std::get_if<int>(&evaluatorResult)) {
-                          storeValueAndCheckDependencies(dependantOperand, *dependantOperandResult);
-                      }
-                  }
-              }
-          };
+        if (mThreadPool && level.size() >= mParallelPropagationThreshold) {
+            evaluateLevelConcurrently(level, mAffectedValues);
+            continue;
+        }
 
-    // Bootstrap the the recursive dependencies checking
-    storeValueAndCheckDependencies(operand, value);
+        for (const auto& [dependantOperand, dependantLevel] : level) {
 
-    return affectedValues;
+            // Skip operands whose dependencies did not change during this propagation
+            if (!mPropagationEngine.isOutdated(dependantOperand)) {
+                continue;
+            }
+
+            const Tracer::Span evaluationSpan(mTracer, "reevaluate");
+            const auto dependantOperandResult
+                  = evaluatePendingExpression(*mExpressionsWithDependencies[dependantOperand]);
+            evaluationSpan.end(mSymbolTable.getName(dependantOperand));
+
+            // If the evaluation results in an integer value,
+            // store it and flag the operands depending on it
+            if (dependantOperandResult) {
+                setOperandValue(dependantOperand, {*dependantOperandResult, true});
+                mAffectedValues.emplace_back(dependantOperand, *dependantOperandResult);
+
+                mPropagationEngine.markUpdated(dependantOperand, mOperandDependencies);
+            }
+        }
+    }
+
+    commitConcurrentValues();
+    propagationSpan.end(mSymbolTable.getName(operand));
+
+    return mAffectedValues;
 }
 
-bool State::storeExpressionDependencies(const std::string& operand,
-                                        std::shared_ptr<Parser::ASTofRSH> expressionAST,
+bool State::storeExpressionDependencies(const Symbols::SymbolId operand,
+                                        const Bytecode::Program& expressionProgram,
                                         const Evaluator::Dependencies& dependencies)
 {
+    const Profiler::Scope profilingScope(mProfiler,
+                                         Profiler::Method::STORE_EXPRESSION_DEPENDENCIES);
 
-    // Check for cyclic dependencies (e.g.: a = c, b = a, c = b).
-    const auto operandDependencyRange = mOperandDependenciesMap.equal_range(operand);
-
-    for (auto itr = operandDependencyRange.first; itr != operandDependencyRange.second; ++itr) {
+    reserveSymbolSlots();
 
-        const auto dependantOperand = itr->second;
+    // Check for cyclic dependencies (e.g.: a = c, b = a, c = b), however long they are,
+    // while keeping the dependency graph topologically ordered
+    const auto cycle = insertDependencyOrder(operand, dependencies);
+    mCyclicDependency.assign(cycle.begin(), cycle.end());
 
-        if (dependencies.contains(dependantOperand)) {
-            // Cyclic dependency found.
-            return false;
-        }
+    if (!mCyclicDependency.empty()) {
+        // Cyclic dependency found.
+        return false;
     }
 
-    // Store the expression's AST of the provided operand
+    // Store the expression of the provided operand (replacing any previous one)
     // since it might be resolved later if the dependencies are met.
-    mExpressionsWithDependenciesMap.insert_or_assign(operand, std::move(expressionAST));
-
-    // Add the new dependencies to the operand dependencies map
-    for (const auto& dependency : dependencies) {
-        mOperandDependenciesMap.emplace(dependency, operand);
+    std::shared_ptr<const StoredExpression> storedExpression;
+    if (isRecordingChanges()) {
+        storedExpression = std::make_shared<const StoredExpression>(
+              StoredExpression{expressionProgram, dependencies});
+        recordChange({.type = ChangeType::EXPRESSION,
+                      .operand = operand,
+                      .previousExpression = getStoredExpression(operand),
+                      .newExpression = storedExpression});
     }
 
+    removeExpressionWithDependencies(operand);
+    insertExpressionWithDependencies(operand, expressionProgram, dependencies);
+    mExpressionsWithDependencies[operand]->storedExpression = std::move(storedExpression);
+
+    ++mModificationCount;
     return true;
 }
 
-const std::unordered_map<std::string, int>& State::getOperandValueMap() const
+std::span<const Symbols::SymbolId> State::getCyclicDependency() const
 {
-    return mOperandValuesMap;
+    return mCyclicDependency;
 }
 
-std::pair<std::string, int> State::getLastFulfilledOperation() const
+Symbols::ValueSlots State::getOperandValues() const
 {
-    // Go through the stack of operations history and check
-    // which operand already has a value available
-    auto operandOrderStack = mOperandOrderStack;
-    while (!operandOrderStack.empty()) {
-
-        if (mOperandValuesMap.contains(operandOrderStack.top())) {
+    return mOperandValues;
+}
 
-            return {operandOrderStack.top(), mOperandValuesMap.at(operandOrderStack.top())};
-        }
+std::optional<State::OperandValue> State::getLastFulfilledOperation() const
+{
+    const Profiler::Scope profilingScope(mProfiler, Profiler::Method::GET_LAST_FULFILLED_OPERATION);
 
-        operandOrderStack.pop();
+    // The operation history keeps track of the last fulfilled operation as values change
+    const auto operand = mOperationHistory.getLastFulfilledOperand();
+    if (!operand) {
+        return {};
     }
 
-    return {};
+    return OperandValue{*operand, mOperandValues[*operand].value};
 }
 
-std::vector<std::string> State::undoLastRegisteredOperations(const int undoCount)
+std::vector<Symbols::SymbolId> State::undoLastRegisteredOperations(const int undoCount)
 {
-    std::vector<std::string> deletedOperations;
+    const Profiler::Scope profilingScope(mProfiler, Profiler::Method::UNDO_LAST_OPERATIONS);
+
+    std::vector<Symbols::SymbolId> deletedOperations;
 
     // Check for either an invalid count value or if there are enough operations to undo
-    if (undoCount <= 0 || static_cast<int>(mOperandOrderStack.size()) < undoCount) {
+    if (undoCount <= 0 || static_cast<int>(mOperationHistory.size()) < undoCount) {
         return deletedOperations;
     }
 
+    ++mModificationCount;
     for (int deleteCounter = 0; deleteCounter < undoCount; ++deleteCounter) {
 
-        // Get the operand from the top of the stack
-        const auto operand = mOperandOrderStack.top();
+        // Get the operand of the latest operation
+        const auto operand = mOperationHistory.top();
 
-        // Try to remove the operand from the operand values map
-        if (mOperandValuesMap.contains(operand)) {
-            mOperandValuesMap.erase(operand);
-        }
+        // Remove the value of the operand
+        setOperandValue(operand, {});
 
-        // Tey to remove the operand from the expressions with dependencies map
-        if (mExpressionsWithDependenciesMap.contains(operand)) {
-            mExpressionsWithDependenciesMap.erase(operand);
+        // Remove the expression with dependencies of the operand
+        if (mExpressionsWithDependencies[operand]) {
+            recordChange({.type = ChangeType::EXPRESSION,
+                          .operand = operand,
+                          .previousExpression = getStoredExpression(operand)});
+            removeExpressionWithDependencies(operand);
         }
 
-        // Remove the operand from the operation order stack
-        mOperandOrderStack.pop();
+        // Remove the operation from the history
+        recordChange({.type = ChangeType::OPERATION_POPPED, .operand = operand});
+        mOperationHistory.pop(mOperandValues);
 
         deletedOperations.push_back(operand);
     }
 
+    commitConcurrentValues();
     return deletedOperations;
 }
 
-} // namespace Calculator
\ No newline at end of file
+void State::createCheckpoint(const std::string_view name)
+{
+    const Profiler::Scope profilingScope(mProfiler, Profiler::Method::CREATE_CHECKPOINT);
+
+    // Changes are only recorded once a checkpoint exists: the first one is the root of the
+    // version tree
+    if (!mCurrentVersion) {
+        mCurrentVersion = std::make_shared<Change>();
+    }
+
+    mCheckpoints.insert_or_assign(std::string(name), mCurrentVersion);
+    ++mModificationCount;
+}
+
+bool State::restoreCheckpoint(const std::string_view name)
+{
+    const Profiler::Scope profilingScope(mProfiler, Profiler::Method::RESTORE_CHECKPOINT);
+
+    const auto checkpoint = mCheckpoints.find(name);
+    if (checkpoint == mCheckpoints.end()) {
+        return false;
+    }
+
+    reserveSymbolSlots();
+
+    // Walk up from both versions to their closest common ancestor: changes on the way up from
+    // the current version are reverted, then changes on the way down to the checkpoint are
+    // applied again (in their original order)
+    const Change* currentChange = mCurrentVersion.get();
+    const Change* targetChange = checkpoint->second.get();
+    std::vector<const Change*> changesToApply;
+
+    while (targetChange->depth > currentChange->depth) {
+        changesToApply.push_back(targetChange);
+        targetChange = targetChange->parent.get();
+    }
+
+    while (currentChange != targetChange) {
+        if (currentChange->depth >= targetChange->depth) {
+            revertChange(*currentChange);
+            currentChange = currentChange->parent.get();
+        } else {
+            changesToApply.push_back(targetChange);
+            targetChange = targetChange->parent.get();
+        }
+    }
+
+    for (auto change = changesToApply.rbegin(); change != changesToApply.rend(); ++change) {
+        applyChange(**change);
+    }
+
+    mCurrentVersion = checkpoint->second;
+    commitConcurrentValues();
+
+    ++mModificationCount;
+    return true;
+}
+
+uint64_t State::getModificationCount() const
+{
+    return mModificationCount;
+}
+
+std::size_t State::getPendingExpressionCount() const
+{
+    // Expressions stay stored once resolved, to be re-evaluated when their operands change
+    std::size_t pendingExpressionCount{0};
+    for (std::size_t operand = 0; operand < mExpressionsWithDependencies.size(); ++operand) {
+        if (mExpressionsWithDependencies[operand]
+            && !Symbols::isDefined(mOperandValues, static_cast<Symbols::SymbolId>(operand))) {
+            ++pendingExpressionCount;
+        }
+    }
+
+    return pendingExpressionCount;
+}
+
+State::Change::~Change()
+{
+    // Release the chain of ancestors iteratively, a recursive release could exhaust the stack
+    auto ancestor = std::move(parent);
+    while (ancestor && ancestor.use_count() == 1) {
+        ancestor = std::move(ancestor->parent);
+    }
+}
+
+bool State::isRecordingChanges() const
+{
+    return mCurrentVersion != nullptr;
+}
+
+void State::recordChange(const Change& change)
+{
+    if (!isRecordingChanges()) {
+        return;
+    }
+
+    auto version = std::make_shared<Change>(change);
+    version->depth = mCurrentVersion->depth + 1;
+    version->parent = std::move(mCurrentVersion);
+    mCurrentVersion = std::move(version);
+}
+
+void State::setOperandValue(const Symbols::SymbolId operand, const Symbols::ValueSlot value)
+{
+    if (isRecordingChanges()) {
+        recordChange({.type = ChangeType::VALUE,
+                      .operand = operand,
+                      .previousValue = mOperandValues[operand],
+                      .newValue = value});
+    }
+
+    writeOperandValue(operand, value);
+}
+
+void State::writeOperandValue(const Symbols::SymbolId operand, const Symbols::ValueSlot value)
+{
+    mOperandValues[operand] = value;
+    mOperationHistory.updateValue(operand, mOperandValues);
+
+    // Values memoized during the current propagation may have read the previous value
+    mExpressionDAG.invalidate(operand);
+
+    if (mConcurrentValues) {
+        mConcurrentValues->write(operand, value);
+    }
+}
+
+void State::commitConcurrentValues()
+{
+    if (mConcurrentValues) {
+        mConcurrentValues->commit(mSymbolTable);
+    }
+}
+
+void State::popOperation()
+{
+    // Operations forgotten because of the depth bound of the history cannot be restored
+    if (mOperationHistory.size() > 0) {
+        mOperationHistory.pop(mOperandValues);
+    }
+}
+
+void State::revertChange(const Change& change)
+{
+    switch (change.type) {
+    case ChangeType::VALUE:
+        writeOperandValue(change.operand, change.previousValue);
+        break;
+    case ChangeType::EXPRESSION:
+        restoreExpression(change.operand, change.previousExpression);
+        break;
+    case ChangeType::OPERATION_PUSHED:
+        popOperation();
+        break;
+    case ChangeType::OPERATION_POPPED:
+        mOperationHistory.push(change.operand, mOperandValues);
+        break;
+    case ChangeType::ROOT:
+        break;
+    }
+}
+
+void State::applyChange(const Change& change)
+{
+    switch (change.type) {
+    case ChangeType::VALUE:
+        writeOperandValue(change.operand, change.newValue);
+        break;
+    case ChangeType::EXPRESSION:
+        restoreExpression(change.operand, change.newExpression);
+        break;
+    case ChangeType::OPERATION_PUSHED:
+        mOperationHistory.push(change.operand, mOperandValues);
+        break;
+    case ChangeType::OPERATION_POPPED:
+        popOperation();
+        break;
+    case ChangeType::ROOT:
+        break;
+    }
+}
+
+std::shared_ptr<const State::StoredExpression>
+      State::getStoredExpression(const Symbols::SymbolId operand)
+{
+    auto& expression = mExpressionsWithDependencies[operand];
+    if (!expression) {
+        return nullptr;
+    }
+
+    // Expressions stored before the first checkpoint are only kept in the expression graph
+    if (!expression->storedExpression) {
+        expression->storedExpression = std::make_shared<const StoredExpression>(StoredExpression{
+              mExpressionDAG.extractProgram(expression->rootNode), expression->dependencies});
+    }
+
+    return expression->storedExpression;
+}
+
+void State::restoreExpression(const Symbols::SymbolId operand,
+                              const std::shared_ptr<const StoredExpression>& storedExpression)
+{
+    removeExpressionWithDependencies(operand);
+
+    if (storedExpression) {
+        // Recorded versions never hold cycles: only the order has to be updated
+        [[maybe_unused]] const auto cycle
+              = insertDependencyOrder(operand, storedExpression->dependencies);
+        insertExpressionWithDependencies(
+              operand, storedExpression->program, storedExpression->dependencies);
+        mExpressionsWithDependencies[operand]->storedExpression = storedExpression;
+    }
+}
+
+std::span<const Symbols::SymbolId> State::insertDependencyOrder(
+      const Symbols::SymbolId operand,
+      const Evaluator::Dependencies& dependencies)
+{
+    return mDependencyOrder.insertDependencies(
+          operand, dependencies, mOperandDependencies, [this](const Symbols::SymbolId dependant) {
+              const auto& expression = mExpressionsWithDependencies[dependant];
+              return expression ? std::span<const Symbols::SymbolId>{expression->dependencies}
+                                : std::span<const Symbols::SymbolId>{};
+          });
+}
+
+void State::insertExpressionWithDependencies(const Symbols::SymbolId operand,
+                                             const Bytecode::Program& expressionProgram,
+                                             const Evaluator::Dependencies& dependencies)
+{
+    auto& expression = mExpressionsWithDependencies[operand].emplace();
+    expression.rootNode = mExpressionDAG.insert(expressionProgram);
+    expression.variables.assign(expressionProgram.getVariables().begin(),
+                                expressionProgram.getVariables().end());
+    expression.dependencies = dependencies;
+
+    // Add the new dependencies to the operand dependencies store
+    for (const auto dependency : dependencies) {
+        mOperandDependencies[dependency].push_back(operand);
+    }
+}
+
+void State::reserveSymbolSlots()
+{
+    const auto symbolCount = mSymbolTable.size();
+
+    if (mOperandValues.size() < symbolCount) {
+        mOperandValues.resize(symbolCount);
+        mOperandDependencies.resize(symbolCount);
+        mExpressionsWithDependencies.resize(symbolCount);
+    }
+}
+
+std::shared_ptr<ConcurrentValues> State::enableConcurrentReads()
+{
+    if (!mConcurrentValues) {
+        mConcurrentValues = std::make_shared<ConcurrentValues>();
+
+        for (std::size_t operand = 0; operand < mOperandValues.size(); ++operand) {
+            if (mOperandValues[operand].isDefined) {
+                mConcurrentValues->write(static_cast<Symbols::SymbolId>(operand),
+                                         mOperandValues[operand]);
+            }
+        }
+        mConcurrentValues->commit(mSymbolTable);
+    }
+
+    return mConcurrentValues;
+}
+
+void State::setTracer(Tracer* const tracer)
+{
+    mTracer = tracer;
+}
+
+void State::setProfiler(Profiler* const profiler)
+{
+    mProfiler = profiler;
+}
+
+void State::enableParallelPropagation(const std::size_t threadCount,
+                                      const std::size_t levelSizeThreshold)
+{
+    mThreadPool.reset();
+    if (threadCount > 1) {
+        mThreadPool = std::make_unique<ThreadPool>(threadCount);
+    }
+
+    mParallelPropagationThreshold = levelSizeThreshold;
+}
+
+void State::evaluateLevelConcurrently(
+      const std::span<const PropagationEngine::ScheduledOperand> level,
+      std::vector<OperandValue>& affectedValues)
+{
+    // Each worker only writes the results of its own operands
+    mLevelResults.assign(level.size(), std::nullopt);
+
+    const auto evaluateOperands = [this, level](const std::size_t begin, const std::size_t end) {
+        for (auto index = begin; index < end; ++index) {
+            const auto dependantOperand = level[index].operand;
+
+            if (mPropagationEngine.isOutdated(dependantOperand)) {
+                const Tracer::Span evaluationSpan(mTracer, "reevaluate");
+                mLevelResults[index] = evaluatePendingExpressionConcurrently(
+                      *mExpressionsWithDependencies[dependantOperand]);
+                evaluationSpan.end(mSymbolTable.getName(dependantOperand));
+            }
+        }
+    };
+
+    mThreadPool->parallelFor(level.size(), cParallelPropagationChunkSize, evaluateOperands);
+
+    // Merge the results back in schedule order, exactly like a sequential propagation would
+    for (std::size_t index = 0; index < level.size(); ++index) {
+        if (const auto& dependantOperandResult = mLevelResults[index]) {
+            const auto dependantOperand = level[index].operand;
+
+            setOperandValue(dependantOperand, {*dependantOperandResult, true});
+            affectedValues.emplace_back(dependantOperand, *dependantOperandResult);
+
+            mPropagationEngine.markUpdated(dependantOperand, mOperandDependencies);
+        }
+    }
+}
+
+bool State::areOperandsDefined(const PendingExpression& expression) const
+{
+    return std::ranges::all_of(expression.variables, [this](const auto variable) {
+        return Symbols::isDefined(mOperandValues, variable);
+    });
+}
+
+void State::countEvaluation(PendingExpression& expression) const
+{
+    // Hot expressions are translated once (if not supported, they keep using the graph)
+    if (mJitThreshold > 0 && ++expression.evaluationCount == mJitThreshold) {
+        expression.nativeExpression
+              = NativeExpression::compile(mExpressionDAG.extractProgram(expression.rootNode));
+    }
+}
+
+std::optional<int32_t> State::evaluatePendingExpression(PendingExpression& expression)
+{
+    if (expression.nativeExpression) {
+        // Machine code does not check its operands
+        if (!areOperandsDefined(expression)) {
+            return std::nullopt;
+        }
+
+        return expression.nativeExpression->execute(mOperandValues);
+    }
+
+    // Shared sub-expressions whose value was already computed during this propagation
+    // are not computed again
+    const auto result = mExpressionDAG.evaluate(expression.rootNode, mOperandValues);
+    countEvaluation(expression);
+
+    return result;
+}
+
+std::optional<int32_t> State::evaluatePendingExpressionConcurrently(
+      PendingExpression& expression) const
+{
+    if (!areOperandsDefined(expression)) {
+        return std::nullopt;
+    }
+
+    if (expression.nativeExpression) {
+        return expression.nativeExpression->execute(mOperandValues);
+    }
+
+    const auto result = mExpressionDAG.evaluateConcurrently(expression.rootNode, mOperandValues);
+    countEvaluation(expression);
+
+    return result;
+}
+
+void State::removeExpressionWithDependencies(const Symbols::SymbolId operand)
+{
+    auto& expression = mExpressionsWithDependencies[operand];
+    if (!expression) {
+        return;
+    }
+
+    // Every dependency registered by the expression is one of the variables it reads
+    for (const auto variable : expression->variables) {
+        std::erase(mOperandDependencies[variable], operand);
+    }
+
+    mExpressionDAG.release(expression->rootNode);
+    expression.reset();
+}
+
+} // namespace Calculator
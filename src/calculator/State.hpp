@@ -1,16 +1,36 @@
 #pragma once
 
-#include <stack>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <unordered_map>
-#include <unordered_set>
 
+#include "ConcurrentValues.hpp"
+#include "DependencyOrder.hpp"
+#include "ExpressionDAG.hpp"
+#include "OperationHistory.hpp"
+#include "Profiler.hpp"
+#include "PropagationEngine.hpp"
+#include "ThreadPool.hpp"
+#include "Tracer.hpp"
+#include "bytecode/Program.hpp"
 #include "evaluator/Evaluator.hpp"
-#include "parser/Parser.hpp"
+#include "evaluator/NativeExpression.hpp"
+#include "symbols/SymbolTable.hpp"
+#include "symbols/ValueSlot.hpp"
 
 namespace Calculator {
 
+/// Default number of evaluations after which a pending expression is translated to machine code
+inline constexpr uint32_t cDefaultJitThreshold{64};
+
+/// Default number of operands a propagation level needs to be evaluated in parallel
+inline constexpr std::size_t cDefaultParallelPropagationThreshold{1024};
+
 // TODO: Derive from an interface since it will facilitate the creating of new tests using
 // mocked interfaces and dependency injection into the Runner class
 
@@ -19,63 +39,158 @@ namespace Calculator {
  * - maintains the order of operations
  * - stores the results of evaluated expressions
  * - tracks dependencies between operands
+ *
+ * Operands are interned in a symbol table and every store is a dense array
+ * indexed by their symbol identifiers
+ *
+ * Once a checkpoint exists, every change is recorded in a version tree shared by all checkpoints,
+ * so that any of them can be restored later on.
+ *
+ * Pending expressions that keep being re-evaluated are translated to machine code
+ * (when supported by the system), which then replaces the shared expression graph for them
+ *
+ * The state itself is single threaded, but its values can be shared with reader threads:
+ * every operation updating values is then committed as a whole to the shared values
  */
 class State
 {
 public:
+    /// Alias representing an operand and its value
+    using OperandValue = std::pair<Symbols::SymbolId, int>;
+
+    /**
+     * @brief Class constructor
+     *
+     * @param[in] jitThreshold Number of evaluations after which a pending expression
+     * is translated to machine code (0 disables the JIT)
+     * @param[in] operationHistoryDepth Maximum number of operations kept in the history,
+     * older ones can no longer be undone (0 for no bound)
+     */
+    explicit State(uint32_t jitThreshold = cDefaultJitThreshold,
+                   std::size_t operationHistoryDepth = 0);
+
     /**
-     * @brief Class' default constructor
+     * @brief Enables the parallel propagation of value changes (disabled by default)
+     *
+     * Operands of the same propagation level do not depend on each other: levels holding
+     * enough operands are evaluated on a pool of threads. Results are reported in the same
+     * order as with a sequential propagation.
+     *
+     * @param[in] threadCount Number of threads evaluating a level (1 or less disables it)
+     * @param[in] levelSizeThreshold Number of operands below which a level is evaluated
+     * on the calling thread only
      */
-    State() = default;
+    void enableParallelPropagation(
+          std::size_t threadCount,
+          std::size_t levelSizeThreshold = cDefaultParallelPropagationThreshold);
+
+    /**
+     * @brief Shares the values of the operands with concurrent readers
+     *
+     * Values are committed after each operation updating them (storing a value, undoing
+     * operations, restoring a checkpoint), so readers only ever see complete operations.
+     * Calling it again returns the same shared values.
+     *
+     * @return Values to attach readers to (see ConcurrentValues::Reader::attach)
+     */
+    [[nodiscard]] std::shared_ptr<ConcurrentValues> enableConcurrentReads();
+
+    /**
+     * @brief Records the propagation of value changes into a trace: one span per propagation
+     * and one per re-evaluated dependent operand
+     *
+     * @param[in] tracer Tracer recording the spans, which must outlive the state
+     * (null disables tracing)
+     */
+    void setTracer(Tracer* tracer);
+
+    /**
+     * @brief Accumulates the calls and the time spent in each public method of the state
+     *
+     * @param[in] profiler Profiler accumulating the calls, which must outlive the state
+     * (null disables profiling)
+     */
+    void setProfiler(Profiler* profiler);
+
+    /**
+     * @brief Getter for the symbol table used to intern operand names
+     *
+     * @return Reference to the symbol table
+     */
+    [[nodiscard]] Symbols::SymbolTable& getSymbolTable();
+
+    /**
+     * @brief Getter for the symbol table used to intern operand names
+     *
+     * @return Const reference to the symbol table
+     */
+    [[nodiscard]] const Symbols::SymbolTable& getSymbolTable() const;
 
     /**
      * @brief Updates the operation order with the given operand.
      *
      * @param[in] operand The operand to update in the operation order.
      */
-    void updateOperationOrder(const std::string& operand);
+    void updateOperationOrder(Symbols::SymbolId operand);
 
     /**
-     * @brief Stores the value of a given operand and recursively resolves
+     * @brief Stores the value of a given operand and resolves
      * any dependencies that can be fulfilled with the new value
      *
+     * Affected operands are re-evaluated in topological order, each one of them at most once.
+     * They are reported level by level (operands directly depending on the given one first).
+     * Sub-expressions shared by several expressions are only computed once per call.
+     *
      * @param[in] operand Operand whose value is to be stored
      * @param[in] value Value of the operand
      *
      * @return Operands and their respective values that were affected by setting the new value
+     * (a buffer reused by every call: only valid until the next one)
      */
-    std::vector<std::pair<std::string, int>>
-          storeExpressionValue(const std::string& operand, const int value);
+    const std::vector<OperandValue>& storeExpressionValue(Symbols::SymbolId operand,
+                                                          const int value);
 
     /**
      * @brief Stores the dependencies of an expression
      *
-     * As a safeguard, cyclic dependencies are checked before storing new dependencies
+     * As a safeguard, cyclic dependencies are checked before storing new dependencies:
+     * the operands are kept in topological order, so only the operands placed between an
+     * operand and its new dependencies have to be searched.
+     * The sub-expressions of the expression are merged into the shared expression graph.
      *
      * @param[in] operand Operand whose dependencies are to be stored
-     * @param[in] expressionAST AST of the expression associated with the operand
+     * @param[in] expressionProgram Compiled program of the expression associated with the operand
      * @param[in] dependencies Set of operands that the given operand depends on
      *
      * @return True if the dependencies were stored successfully
      * @return False if a cyclic dependency was found
      */
-    [[nodiscard]] bool storeExpressionDependencies(const std::string& operand,
-                                                   std::shared_ptr<Parser::ASTofRSH> expressionAST,
+    [[nodiscard]] bool storeExpressionDependencies(Symbols::SymbolId operand,
+                                                   const Bytecode::Program& expressionProgram,
                                                    const Evaluator::Dependencies& dependencies);
 
     /**
-     * @brief Retrieves the map of operand values for lookup
+     * @brief Retrieves the cycle which made the last expression with dependencies be rejected
+     *
+     * @return Operands of the cycle, each one depending on the next one and the first one
+     * repeated at the end (empty if the last expression was stored)
+     */
+    [[nodiscard]] std::span<const Symbols::SymbolId> getCyclicDependency() const;
+
+    /**
+     * @brief Retrieves the values of all operands for lookup
      *
-     * @return A const reference to the map containing operand values
+     * @return View over the value slots, indexed by symbol identifier
      */
-    [[nodiscard]] const std::unordered_map<std::string, int>& getOperandValueMap() const;
+    [[nodiscard]] Symbols::ValueSlots getOperandValues() const;
 
     /**
      * @brief Retrieves the result of the last fulfilled operation
      *
      * @return Operand and value pair relative to the last fulfilled operation
+     * (empty if no operation was fulfilled yet)
      */
-    [[nodiscard]] std::pair<std::string, int> getLastFulfilledOperation() const;
+    [[nodiscard]] std::optional<OperandValue> getLastFulfilledOperation() const;
 
     /**
      * @brief Undoes the specified number of operations
@@ -85,24 +200,363 @@ public:
      *
      * @return Operands of the undone operations
      */
-    [[nodiscard]] std::vector<std::string> undoLastRegisteredOperations(const int undoCount);
+    [[nodiscard]] std::vector<Symbols::SymbolId> undoLastRegisteredOperations(const int undoCount);
+
+    /**
+     * @brief Records the current state under a name (replacing any previous checkpoint of that name)
+     *
+     * Nothing is copied: the checkpoint only refers to the current version of the state,
+     * which takes constant time whatever the number of operands
+     *
+     * @param[in] name Name of the checkpoint
+     */
+    void createCheckpoint(std::string_view name);
+
+    /**
+     * @brief Brings the state back to a checkpoint
+     *
+     * Only the changes made between the current version and the checkpoint are undone or redone,
+     * whatever the number of operands. Checkpoints are kept: any of them can be restored
+     * afterwards, including those created after the restored one.
+     *
+     * @param[in] name Name of the checkpoint
+     *
+     * @return False if there is no checkpoint of that name
+     */
+    [[nodiscard]] bool restoreCheckpoint(std::string_view name);
+
+    /**
+     * @brief Getter for the number of operations that modified the state so far
+     *
+     * Allows callers to tell whether an instruction changed anything (e.g. to log it)
+     *
+     * @return Number of modifying operations
+     */
+    [[nodiscard]] uint64_t getModificationCount() const;
+
+    /**
+     * @brief Counts the arithmetic expressions waiting for operands without a value
+     *
+     * @return Number of pending expressions
+     */
+    [[nodiscard]] std::size_t getPendingExpressionCount() const;
+
+    /**
+     * @brief Serializes the whole state into a compact binary image
+     *
+     * The image holds the operands, their values, the order of operations, the expressions
+     * with dependencies, the order of the dependency graph and every checkpoint (along with
+     * the version tree they share)
+     *
+     * @param[in,out] image Buffer the image is appended to
+     */
+    void saveSnapshot(std::vector<std::byte>& image) const;
+
+    /**
+     * @brief Restores a state serialized by saveSnapshot
+     *
+     * The image is fully validated before anything is restored
+     *
+     * @param[in] image Binary image of a state
+     *
+     * @return False if the image is malformed or if the state was already used
+     * (it is then left untouched)
+     */
+    [[nodiscard]] bool loadSnapshot(std::span<const std::byte> image);
 
 private:
-    /// LIFO stack to keep track of the order of operations by tracking operands of each expression
-    std::stack<std::string> mOperandOrderStack;
+    /**
+     * @brief Expression with dependencies as it was provided to the state
+     */
+    struct StoredExpression
+    {
+        /// Compiled program of the expression
+        Bytecode::Program program;
+        /// Operands the expression was registered as a dependent of
+        Evaluator::Dependencies dependencies;
+    };
+
+    /**
+     * @brief Kinds of changes recorded in the version tree
+     */
+    enum class ChangeType : uint8_t {
+
+        ROOT = 0,             // State when the first checkpoint was created
+        VALUE = 1,            // Value of an operand changed
+        EXPRESSION = 2,       // Expression with dependencies of an operand replaced or removed
+        OPERATION_PUSHED = 3, // Operand pushed onto the order of operations
+        OPERATION_POPPED = 4  // Operand popped from the order of operations
+    };
+
+    /**
+     * @brief Node of the version tree: a single change applied on top of its parent version
+     *
+     * Versions are shared by the checkpoints and the current version, so the tree only grows
+     * with the changes made since the first checkpoint
+     */
+    struct Change
+    {
+        ~Change();
+
+        /// Version the change was applied to
+        std::shared_ptr<Change> parent{};
+        /// Number of changes between the root and this version
+        uint32_t depth{0};
+        /// Kind of change
+        ChangeType type{ChangeType::ROOT};
+        /// Operand affected by the change
+        Symbols::SymbolId operand{};
+        /// Value of the operand before the change (VALUE)
+        Symbols::ValueSlot previousValue{};
+        /// Value of the operand after the change (VALUE)
+        Symbols::ValueSlot newValue{};
+        /// Expression of the operand before the change (EXPRESSION)
+        std::shared_ptr<const StoredExpression> previousExpression{};
+        /// Expression of the operand after the change (EXPRESSION)
+        std::shared_ptr<const StoredExpression> newExpression{};
+    };
+
+    /**
+     * @brief Expression of an operand waiting for some of its dependencies to have a value
+     */
+    struct PendingExpression
+    {
+        /// Root node of the expression in the shared expression graph
+        ExpressionDAG::NodeId rootNode{ExpressionDAG::cNullNodeId};
+        /// Operands read by the expression
+        std::vector<Symbols::SymbolId> variables;
+        /// Operands the expression is registered as a dependent of
+        Evaluator::Dependencies dependencies;
+        /// Expression as provided to the state (only kept once it is part of the version tree)
+        std::shared_ptr<const StoredExpression> storedExpression;
+        /// Number of times the expression was evaluated
+        uint32_t evaluationCount{0};
+        /// Machine code of the expression (once it became hot)
+        std::optional<NativeExpression> nativeExpression;
+    };
+
+    /**
+     * @brief Re-evaluates the outdated operands of a propagation level on the thread pool
+     *
+     * @param[in] level Scheduled operands of the level
+     * @param[in,out] affectedValues Operands (and their values) affected by the propagation
+     */
+    void evaluateLevelConcurrently(std::span<const PropagationEngine::ScheduledOperand> level,
+                                   std::vector<OperandValue>& affectedValues);
+
+    /**
+     * @brief Checks if every operand read by a pending expression holds a value
+     *
+     * @param[in] expression Pending expression
+     *
+     * @return True if the expression can be evaluated (false otherwise)
+     */
+    [[nodiscard]] bool areOperandsDefined(const PendingExpression& expression) const;
+
+    /**
+     * @brief Counts an evaluation of a pending expression, translating it to machine code
+     * once it reaches the JIT threshold
+     *
+     * @param[in,out] expression Evaluated expression
+     */
+    void countEvaluation(PendingExpression& expression) const;
+
+    /**
+     * @brief Evaluates a pending expression with the current operand values
+     *
+     * @param[in,out] expression Expression to evaluate
+     *
+     * @return Value of the expression (empty if any of its operands has no value)
+     */
+    [[nodiscard]] std::optional<int32_t> evaluatePendingExpression(PendingExpression& expression);
+
+    /**
+     * @brief Evaluates a pending expression with the current operand values,
+     * without memoizing the values of its sub-expressions
+     *
+     * Only the expression itself is modified: distinct expressions can be evaluated at once
+     *
+     * @param[in,out] expression Expression to evaluate
+     *
+     * @return Value of the expression (empty if any of its operands has no value)
+     */
+    [[nodiscard]] std::optional<int32_t>
+          evaluatePendingExpressionConcurrently(PendingExpression& expression) const;
+
+    /**
+     * @brief Checks if changes are recorded in the version tree (i.e. if a checkpoint exists)
+     *
+     * @return True if changes are recorded (false otherwise)
+     */
+    [[nodiscard]] bool isRecordingChanges() const;
+
+    /**
+     * @brief Appends a change to the current version (if changes are recorded)
+     *
+     * @param[in] change Change to record (its parent and depth are filled in)
+     */
+    void recordChange(const Change& change);
+
+    /**
+     * @brief Updates the value slot of an operand, recording the change
+     *
+     * @param[in] operand Operand to update
+     * @param[in] value New value slot of the operand
+     */
+    void setOperandValue(Symbols::SymbolId operand, Symbols::ValueSlot value);
+
+    /**
+     * @brief Updates the value slot of an operand, without recording the change
+     *
+     * @param[in] operand Operand to update
+     * @param[in] value New value slot of the operand
+     */
+    void writeOperandValue(Symbols::SymbolId operand, Symbols::ValueSlot value);
+
+    /**
+     * @brief Commits the values written by an operation to the concurrent readers (if any)
+     */
+    void commitConcurrentValues();
+
+    /**
+     * @brief Removes the latest operation of the history, without recording the change
+     */
+    void popOperation();
+
+    /**
+     * @brief Undoes a recorded change
+     *
+     * @param[in] change Change to undo
+     */
+    void revertChange(const Change& change);
+
+    /**
+     * @brief Applies a recorded change again
+     *
+     * @param[in] change Change to apply
+     */
+    void applyChange(const Change& change);
+
+    /**
+     * @brief Retrieves the expression with dependencies of an operand, as provided to the state
+     *
+     * @param[in] operand Operand whose expression is to be retrieved
+     *
+     * @return Expression of the operand (null if it has none)
+     */
+    [[nodiscard]] std::shared_ptr<const StoredExpression> getStoredExpression(
+          Symbols::SymbolId operand);
+
+    /**
+     * @brief Replaces the expression with dependencies of an operand by a recorded one
+     *
+     * @param[in] operand Operand whose expression is to be replaced
+     * @param[in] storedExpression Recorded expression (null to only remove the current one)
+     */
+    void restoreExpression(Symbols::SymbolId operand,
+                           const std::shared_ptr<const StoredExpression>& storedExpression);
+
+    /**
+     * @brief Moves an operand after its new dependencies in the topological order
+     *
+     * @param[in] operand Operand whose dependencies are added
+     * @param[in] dependencies New dependencies of the operand
+     *
+     * @return Cycle introduced by the new dependencies (empty if there is none)
+     */
+    [[nodiscard]] std::span<const Symbols::SymbolId> insertDependencyOrder(
+          Symbols::SymbolId operand,
+          const Evaluator::Dependencies& dependencies);
+
+    /**
+     * @brief Stores the expression with dependencies of an operand (which must not have any)
+     * and registers the operand as a dependent of its dependencies
+     *
+     * @param[in] operand Operand whose expression is to be stored
+     * @param[in] expressionProgram Compiled program of the expression
+     * @param[in] dependencies Operands the given operand depends on
+     */
+    void insertExpressionWithDependencies(Symbols::SymbolId operand,
+                                          const Bytecode::Program& expressionProgram,
+                                          const Evaluator::Dependencies& dependencies);
+
+    /**
+     * @brief Grows the dense stores so that every interned symbol has a slot
+     */
+    void reserveSymbolSlots();
+
+    /**
+     * @brief Removes the expression with dependencies of an operand (if any)
+     * along with the dependencies it registered
+     *
+     * @param[in] operand Operand whose expression is to be removed
+     */
+    void removeExpressionWithDependencies(Symbols::SymbolId operand);
+
+private:
+    /// Symbol table interning the names of every operand
+    Symbols::SymbolTable mSymbolTable;
+
+    /// History of the order of operations, tracking the operand of each expression
+    OperationHistory mOperationHistory;
+
+    /// Current value of each operand
+    std::vector<Symbols::ValueSlot> mOperandValues;
+
+    // Dependencies between operands.
+    // The index is an operand and the value lists the operands that depend on it.
+
+    /// Operands depending on each operand (one to many relationship).
+    /// Only operands with an expression with dependencies are registered as dependents.
+    PropagationEngine::DependencyGraph mOperandDependencies;
+
+    /// Topological order of the dependency graph (used to detect cycles)
+    DependencyOrder mDependencyOrder;
+
+    /// Cycle which made the last expression with dependencies be rejected
+    std::vector<Symbols::SymbolId> mCyclicDependency;
+
+    /// Arithmetic expressions of each operand that depend on the values of other operands
+    std::vector<std::optional<PendingExpression>> mExpressionsWithDependencies;
+
+    /// Graph holding the sub-expressions of every pending expression (shared between them)
+    ExpressionDAG mExpressionDAG;
+
+    /// Engine scheduling the re-evaluation of dependent operands
+    PropagationEngine mPropagationEngine;
+
+    /// Number of evaluations after which a pending expression is translated to machine code
+    uint32_t mJitThreshold;
+
+    /// Pool evaluating large propagation levels (only set when parallel propagation is enabled)
+    std::unique_ptr<ThreadPool> mThreadPool;
+
+    /// Number of operands a propagation level needs to be evaluated on the thread pool
+    std::size_t mParallelPropagationThreshold{cDefaultParallelPropagationThreshold};
+
+    /// Results of the operands of the level being evaluated on the thread pool
+    std::vector<std::optional<int32_t>> mLevelResults;
+
+    /// Operands affected by the last value stored (kept to reuse its allocation)
+    std::vector<OperandValue> mAffectedValues;
+
+    /// Tracer recording the propagations (null if tracing is disabled)
+    Tracer* mTracer{nullptr};
+
+    /// Profiler timing the public methods (null if profiling is disabled)
+    Profiler* mProfiler{nullptr};
 
-    /// Map holding the operands with their current values
-    std::unordered_map<std::string, int> mOperandValuesMap;
+    /// Number of operations that modified the state
+    uint64_t mModificationCount{0};
 
-    // Map used to keep track of the dependencies between operands.
-    // The key is an operand and the value is another operand that depends on the key.
+    /// Values shared with concurrent readers (only set once concurrent reads are enabled)
+    std::shared_ptr<ConcurrentValues> mConcurrentValues;
 
-    /// Multimap to track dependencies between operands (one to many relationship).
-    std::unordered_multimap<std::string, std::string> mOperandDependenciesMap;
+    /// Current version in the version tree (only set once a checkpoint exists)
+    std::shared_ptr<Change> mCurrentVersion;
 
-    /// Map to track arithmetic expressions that depend on the values of other operands
-    std::unordered_map<std::string, std::shared_ptr<Parser::ASTofRSH>>
-          mExpressionsWithDependenciesMap;
+    /// Version recorded by each checkpoint, keyed by name
+    std::map<std::string, std::shared_ptr<Change>, std::less<>> mCheckpoints;
 };
 
-} // namespace Calculator
\ No newline at end of file
+} // namespace Calculator
@@ -0,0 +1,508 @@
+#include "State.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <unordered_map>
+
+#include "utils/BinaryStream.hpp"
+
+namespace {
+/// Marker of the absence of an index (indexes are written shifted by one)
+constexpr uint64_t cNoIndex{0};
+
+/**
+ * @brief Writes the value slot of an operand
+ *
+ * @param[in,out] writer Writer of the image
+ * @param[in] value Value slot to write
+ */
+void writeValue(Utils::BinaryWriter& writer, const Symbols::ValueSlot value)
+{
+    writer.writeByte(value.isDefined ? 1 : 0);
+    if (value.isDefined) {
+        writer.writeSigned(value.value);
+    }
+}
+
+/**
+ * @brief Reads the value slot of an operand
+ *
+ * @param[in,out] reader Reader of the image
+ *
+ * @return Value slot read
+ */
+Symbols::ValueSlot readValue(Utils::BinaryReader& reader)
+{
+    const auto isDefined = reader.readByte();
+    if (isDefined == 0) {
+        return {};
+    }
+
+    const auto value = reader.readSigned();
+    if (isDefined != 1 || value < std::numeric_limits<int32_t>::min()
+        || value > std::numeric_limits<int32_t>::max()) {
+        reader.invalidate();
+        return {};
+    }
+
+    return {static_cast<int32_t>(value), true};
+}
+
+/**
+ * @brief Writes a list of operands
+ *
+ * @param[in,out] writer Writer of the image
+ * @param[in] operands Operands to write
+ */
+void writeOperands(Utils::BinaryWriter& writer, const std::span<const Symbols::SymbolId> operands)
+{
+    writer.writeUnsigned(operands.size());
+    for (const auto operand : operands) {
+        writer.writeUnsigned(operand);
+    }
+}
+
+/**
+ * @brief Reads an operand
+ *
+ * @param[in,out] reader Reader of the image
+ * @param[in] symbolCount Number of operands of the image
+ *
+ * @return Operand read
+ */
+Symbols::SymbolId readOperand(Utils::BinaryReader& reader, const std::size_t symbolCount)
+{
+    const auto operand = reader.readUnsigned();
+    if (operand >= symbolCount) {
+        reader.invalidate();
+        return 0;
+    }
+
+    return static_cast<Symbols::SymbolId>(operand);
+}
+
+/**
+ * @brief Reads a list of operands
+ *
+ * @param[in,out] reader Reader of the image
+ * @param[in] symbolCount Number of operands of the image
+ *
+ * @return Operands read
+ */
+std::vector<Symbols::SymbolId> readOperands(Utils::BinaryReader& reader,
+                                            const std::size_t symbolCount)
+{
+    std::vector<Symbols::SymbolId> operands(reader.readCount());
+    for (auto& operand : operands) {
+        operand = readOperand(reader, symbolCount);
+    }
+
+    return operands;
+}
+
+/**
+ * @brief Writes a compiled program
+ *
+ * @param[in,out] writer Writer of the image
+ * @param[in] program Program to write
+ */
+void writeProgram(Utils::BinaryWriter& writer, const Bytecode::Program& program)
+{
+    const auto instructions = program.getInstructions();
+    writer.writeUnsigned(instructions.size());
+
+    for (const auto& instruction : instructions) {
+        writer.writeByte(static_cast<uint8_t>(instruction.opCode));
+
+        if (instruction.opCode == Bytecode::OpCode::PUSH_CONST) {
+            writer.writeFixed32(instruction.operand);
+        } else if (instruction.opCode == Bytecode::OpCode::LOAD_VAR) {
+            writer.writeUnsigned(instruction.operand);
+        }
+    }
+}
+
+/**
+ * @brief Reads a compiled program, checking that it can be executed
+ *
+ * @param[in,out] reader Reader of the image
+ * @param[in] symbolCount Number of operands of the image
+ *
+ * @return Program read
+ */
+Bytecode::Program readProgram(Utils::BinaryReader& reader, const std::size_t symbolCount)
+{
+    Bytecode::Program program;
+    const auto instructionCount = reader.readCount();
+    program.reserve(instructionCount);
+
+    // Every program pushes its result only: the stack never underflows and holds one value
+    std::size_t stackDepth{0};
+
+    for (std::size_t index = 0; index < instructionCount && reader.isValid(); ++index) {
+        const auto opCode = static_cast<Bytecode::OpCode>(reader.readByte());
+
+        switch (opCode) {
+        case Bytecode::OpCode::PUSH_CONST:
+            program.emitConstant(std::bit_cast<float>(reader.readFixed32()));
+            ++stackDepth;
+            break;
+        case Bytecode::OpCode::LOAD_VAR:
+            program.emitVariable(readOperand(reader, symbolCount));
+            ++stackDepth;
+            break;
+        case Bytecode::OpCode::ADD:
+        case Bytecode::OpCode::SUB:
+        case Bytecode::OpCode::MUL:
+        case Bytecode::OpCode::DIV:
+            if (stackDepth < 2) {
+                reader.invalidate();
+                break;
+            }
+
+            program.emitOperation(opCode);
+            --stackDepth;
+            break;
+        default:
+            reader.invalidate();
+            break;
+        }
+    }
+
+    if (stackDepth != 1) {
+        reader.invalidate();
+    }
+
+    return program;
+}
+} // namespace
+
+namespace Calculator {
+
+void State::saveSnapshot(std::vector<std::byte>& image) const
+{
+    Utils::BinaryWriter writer{image};
+    const auto symbolCount = mSymbolTable.size();
+
+    // Operands, their values and their position in the order of the dependency graph
+    writer.writeUnsigned(symbolCount);
+    for (std::size_t operand = 0; operand < symbolCount; ++operand) {
+        const auto symbolId = static_cast<Symbols::SymbolId>(operand);
+
+        writer.writeString(mSymbolTable.getName(symbolId));
+        const auto isStored = operand < mOperandValues.size();
+        writeValue(writer, isStored ? mOperandValues[operand] : Symbols::ValueSlot{});
+        writer.writeSigned(mDependencyOrder.getPosition(symbolId));
+    }
+    writer.writeSigned(mDependencyOrder.getFirstPosition());
+
+    writeOperands(writer, mOperationHistory.getOperands());
+
+    // Versions reachable from the current one and from the checkpoints, parents first
+    std::vector<const Change*> changes;
+    std::unordered_map<const Change*, uint64_t> changeIndexes;
+
+    const auto collectChanges = [&](const Change* change) {
+        for (; change && !changeIndexes.contains(change); change = change->parent.get()) {
+            changeIndexes.emplace(change, 0);
+            changes.push_back(change);
+        }
+    };
+
+    collectChanges(mCurrentVersion.get());
+    for (const auto& [name, version] : mCheckpoints) {
+        collectChanges(version.get());
+    }
+
+    std::ranges::sort(changes, {}, &Change::depth);
+    for (std::size_t index = 0; index < changes.size(); ++index) {
+        changeIndexes[changes[index]] = index + 1;
+    }
+
+    // Expressions are shared by the pending expressions and the versions: each one is
+    // written once (expressions stored before the first checkpoint only live in the graph)
+    std::vector<std::shared_ptr<const StoredExpression>> expressions;
+    std::unordered_map<const StoredExpression*, uint64_t> expressionIndexes;
+
+    const auto indexExpression = [&](const std::shared_ptr<const StoredExpression>& expression) {
+        if (!expression) {
+            return cNoIndex;
+        }
+
+        const auto [itr, isInserted]
+              = expressionIndexes.emplace(expression.get(), expressions.size() + 1);
+        if (isInserted) {
+            expressions.push_back(expression);
+        }
+
+        return itr->second;
+    };
+
+    std::vector<std::pair<Symbols::SymbolId, uint64_t>> pendingExpressions;
+    for (std::size_t operand = 0; operand < mExpressionsWithDependencies.size(); ++operand) {
+        const auto& expression = mExpressionsWithDependencies[operand];
+        if (!expression) {
+            continue;
+        }
+
+        auto storedExpression = expression->storedExpression;
+        if (!storedExpression) {
+            storedExpression = std::make_shared<const StoredExpression>(StoredExpression{
+                  mExpressionDAG.extractProgram(expression->rootNode), expression->dependencies});
+        }
+
+        pendingExpressions.emplace_back(static_cast<Symbols::SymbolId>(operand),
+                                        indexExpression(storedExpression));
+    }
+
+    std::vector<std::pair<uint64_t, uint64_t>> changeExpressions;
+    for (const auto* change : changes) {
+        changeExpressions.emplace_back(indexExpression(change->previousExpression),
+                                       indexExpression(change->newExpression));
+    }
+
+    writer.writeUnsigned(expressions.size());
+    for (const auto& expression : expressions) {
+        writeProgram(writer, expression->program);
+        writeOperands(writer, expression->dependencies);
+    }
+
+    writer.writeUnsigned(pendingExpressions.size());
+    for (const auto& [operand, expressionIndex] : pendingExpressions) {
+        writer.writeUnsigned(operand);
+        writer.writeUnsigned(expressionIndex);
+    }
+
+    // Dependants are written in their registration order, which sets the order of propagation
+    std::size_t dependedOnCount{0};
+    for (const auto& dependants : mOperandDependencies) {
+        dependedOnCount += dependants.empty() ? 0U : 1U;
+    }
+
+    writer.writeUnsigned(dependedOnCount);
+    for (std::size_t operand = 0; operand < mOperandDependencies.size(); ++operand) {
+        if (!mOperandDependencies[operand].empty()) {
+            writer.writeUnsigned(operand);
+            writeOperands(writer, mOperandDependencies[operand]);
+        }
+    }
+
+    writer.writeUnsigned(changes.size());
+    for (std::size_t index = 0; index < changes.size(); ++index) {
+        const auto& change = *changes[index];
+
+        writer.writeUnsigned(change.parent ? changeIndexes[change.parent.get()] : cNoIndex);
+        writer.writeByte(static_cast<uint8_t>(change.type));
+        writer.writeUnsigned(change.operand);
+
+        if (change.type == ChangeType::VALUE) {
+            writeValue(writer, change.previousValue);
+            writeValue(writer, change.newValue);
+        } else if (change.type == ChangeType::EXPRESSION) {
+            writer.writeUnsigned(changeExpressions[index].first);
+            writer.writeUnsigned(changeExpressions[index].second);
+        }
+    }
+
+    writer.writeUnsigned(mCurrentVersion ? changeIndexes[mCurrentVersion.get()] : cNoIndex);
+    writer.writeUnsigned(mCheckpoints.size());
+    for (const auto& [name, version] : mCheckpoints) {
+        writer.writeString(name);
+        writer.writeUnsigned(changeIndexes[version.get()]);
+    }
+}
+
+bool State::loadSnapshot(const std::span<const std::byte> image)
+{
+    if (mSymbolTable.size() > 0 || mOperationHistory.size() > 0 || mCurrentVersion) {
+        return false;
+    }
+
+    Utils::BinaryReader reader{image};
+
+    // Everything is read and validated first, the state is only modified once it is complete
+    const auto symbolCount = reader.readCount();
+    std::vector<std::string_view> names(symbolCount);
+    std::vector<Symbols::ValueSlot> values(symbolCount);
+    std::vector<int64_t> positions(symbolCount);
+
+    for (std::size_t operand = 0; operand < symbolCount; ++operand) {
+        names[operand] = reader.readString();
+        values[operand] = readValue(reader);
+        positions[operand] = reader.readSigned();
+    }
+    const auto firstPosition = reader.readSigned();
+
+    const auto operationHistory = readOperands(reader, symbolCount);
+
+    std::vector<std::shared_ptr<const StoredExpression>> expressions(reader.readCount());
+    for (auto& expression : expressions) {
+        auto program = readProgram(reader, symbolCount);
+        auto dependencies = readOperands(reader, symbolCount);
+        expression = std::make_shared<const StoredExpression>(
+              StoredExpression{std::move(program), std::move(dependencies)});
+    }
+
+    const auto readExpressionIndex = [&]() -> std::shared_ptr<const StoredExpression> {
+        const auto index = reader.readUnsigned();
+        if (index > expressions.size()) {
+            reader.invalidate();
+            return nullptr;
+        }
+
+        return index == cNoIndex ? nullptr : expressions[index - 1];
+    };
+
+    std::vector<std::shared_ptr<const StoredExpression>> pendingExpressions(symbolCount);
+    const auto pendingExpressionCount = reader.readCount();
+    for (std::size_t index = 0; index < pendingExpressionCount && reader.isValid(); ++index) {
+        const auto operand = readOperand(reader, symbolCount);
+        pendingExpressions[operand] = readExpressionIndex();
+        if (!pendingExpressions[operand]) {
+            reader.invalidate();
+        }
+    }
+
+    PropagationEngine::DependencyGraph operandDependencies(symbolCount);
+    const auto dependedOnCount = reader.readCount();
+    for (std::size_t index = 0; index < dependedOnCount && reader.isValid(); ++index) {
+        const auto operand = readOperand(reader, symbolCount);
+        operandDependencies[operand] = readOperands(reader, symbolCount);
+    }
+
+    std::vector<std::shared_ptr<Change>> changes(reader.readCount());
+    for (std::size_t index = 0; index < changes.size() && reader.isValid(); ++index) {
+        auto change = std::make_shared<Change>();
+
+        // Parents always come first
+        const auto parentIndex = reader.readUnsigned();
+        if (parentIndex > index) {
+            reader.invalidate();
+            break;
+        }
+        if (parentIndex != cNoIndex) {
+            change->parent = changes[parentIndex - 1];
+            change->depth = change->parent->depth + 1;
+        }
+
+        // The root of the version tree is the only version without a parent
+        const auto type = reader.readByte();
+        if (type > static_cast<uint8_t>(ChangeType::OPERATION_POPPED)
+            || (type == static_cast<uint8_t>(ChangeType::ROOT)) != (parentIndex == cNoIndex)
+            || (index == 0) != (parentIndex == cNoIndex)) {
+            reader.invalidate();
+            break;
+        }
+        change->type = static_cast<ChangeType>(type);
+        change->operand = readOperand(reader, symbolCount);
+
+        if (change->type == ChangeType::VALUE) {
+            change->previousValue = readValue(reader);
+            change->newValue = readValue(reader);
+        } else if (change->type == ChangeType::EXPRESSION) {
+            change->previousExpression = readExpressionIndex();
+            change->newExpression = readExpressionIndex();
+        }
+
+        changes[index] = std::move(change);
+    }
+
+    const auto readVersion = [&]() -> std::shared_ptr<Change> {
+        const auto index = reader.readUnsigned();
+        if (index > changes.size()) {
+            reader.invalidate();
+            return nullptr;
+        }
+
+        return index == cNoIndex ? nullptr : changes[index - 1];
+    };
+
+    auto currentVersion = readVersion();
+    std::map<std::string, std::shared_ptr<Change>, std::less<>> checkpoints;
+
+    const auto checkpointCount = reader.readCount();
+    for (std::size_t index = 0; index < checkpointCount && reader.isValid(); ++index) {
+        auto name = std::string(reader.readString());
+        auto version = readVersion();
+        if (!version) {
+            reader.invalidate();
+        }
+
+        checkpoints.insert_or_assign(std::move(name), std::move(version));
+    }
+
+    // Checkpoints only exist along with a current version
+    if (!checkpoints.empty() && !currentVersion) {
+        reader.invalidate();
+    }
+
+    // Operands are registered as dependents of exactly the dependencies of their expression
+    std::size_t dependencyCount{0};
+    for (std::size_t operand = 0; operand < symbolCount; ++operand) {
+        if (const auto& expression = pendingExpressions[operand]) {
+            for (const auto dependency : expression->dependencies) {
+                if (std::ranges::find(operandDependencies[dependency], operand)
+                    == operandDependencies[dependency].end()) {
+                    reader.invalidate();
+                }
+            }
+            dependencyCount += expression->dependencies.size();
+        }
+    }
+
+    for (const auto& dependants : operandDependencies) {
+        dependencyCount -= std::min(dependencyCount, dependants.size());
+    }
+    if (dependencyCount != 0) {
+        reader.invalidate();
+    }
+
+    // Every operand must be interned exactly once
+    std::vector<std::string_view> sortedNames(names);
+    std::ranges::sort(sortedNames);
+    if (std::ranges::adjacent_find(sortedNames) != sortedNames.end()) {
+        reader.invalidate();
+    }
+
+    if (!reader.isValid() || !reader.isAtEnd()) {
+        return false;
+    }
+
+    // Restore the state
+    for (const auto name : names) {
+        mSymbolTable.intern(name);
+    }
+
+    reserveSymbolSlots();
+    for (std::size_t operand = 0; operand < symbolCount; ++operand) {
+        writeOperandValue(static_cast<Symbols::SymbolId>(operand), values[operand]);
+    }
+
+    for (const auto operand : operationHistory) {
+        mOperationHistory.push(operand, mOperandValues);
+    }
+
+    mDependencyOrder.restore(positions, firstPosition);
+    mCurrentVersion = std::move(currentVersion);
+    mCheckpoints = std::move(checkpoints);
+
+    for (std::size_t operand = 0; operand < symbolCount; ++operand) {
+        if (const auto& expression = pendingExpressions[operand]) {
+            insertExpressionWithDependencies(static_cast<Symbols::SymbolId>(operand),
+                                             expression->program,
+                                             expression->dependencies);
+
+            if (isRecordingChanges()) {
+                mExpressionsWithDependencies[operand]->storedExpression = expression;
+            }
+        }
+    }
+
+    mOperandDependencies = std::move(operandDependencies);
+
+    commitConcurrentValues();
+    return true;
+}
+
+} // namespace Calculator
@@ -0,0 +1,214 @@
+#include "Statistics.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace {
+/// Names of the phases of an instruction, in the order of Statistics::Phase
+constexpr std::array<const char*, 5> cPhaseNames{
+      "detection", "parsing", "evaluation", "propagation", "command"};
+
+/// Percentiles reported by the machine readable dump (fraction and JSON key)
+constexpr std::array<std::pair<double, const char*>, 4> cReportedPercentiles{
+      {{0.5, "p50"}, {0.9, "p90"}, {0.99, "p99"}, {0.999, "p999"}}};
+
+/**
+ * @brief Appends the human readable summary of a latency histogram
+ *
+ * @param[in] name Name of the measured phase
+ * @param[in] latencies Latencies of the phase (in nanoseconds)
+ * @param[out] entries Entries describing the statistics
+ */
+void describeLatencies(const std::string& name,
+                       const Calculator::Histogram& latencies,
+                       std::vector<std::string>& entries)
+{
+    if (latencies.getCount() == 0) {
+        return;
+    }
+
+    entries.push_back(name + " p50 = " + std::to_string(latencies.getPercentile(0.5)) + " ns");
+    entries.push_back(name + " p99 = " + std::to_string(latencies.getPercentile(0.99)) + " ns");
+    entries.push_back(name + " max = " + std::to_string(latencies.getMax()) + " ns");
+}
+
+/**
+ * @brief Appends a histogram summary to a JSON object being written
+ *
+ * @param[in] separator Separator written before the summary ("," unless it is the first member)
+ * @param[in] name Key of the summary
+ * @param[in] histogram Histogram to summarize
+ * @param[in,out] json JSON object being written
+ */
+void dumpHistogram(const char* separator,
+                   const char* name,
+                   const Calculator::Histogram& histogram,
+                   std::string& json)
+{
+    json.append(separator).append("\"").append(name).append("\":{\"count\":");
+    json.append(std::to_string(histogram.getCount()));
+    json.append(",\"mean\":").append(std::to_string(std::llround(histogram.getMean())));
+
+    for (const auto& [fraction, key] : cReportedPercentiles) {
+        json.append(",\"").append(key).append("\":");
+        json.append(std::to_string(histogram.getPercentile(fraction)));
+    }
+
+    json.append(",\"max\":").append(std::to_string(histogram.getMax())).append("}");
+}
+} // namespace
+
+namespace Calculator {
+
+void Histogram::record(const uint64_t value)
+{
+    ++mBuckets[getBucketIndex(value)];
+    ++mCount;
+    mSum += value;
+    mMax = std::max(mMax, value);
+}
+
+uint64_t Histogram::getCount() const
+{
+    return mCount;
+}
+
+uint64_t Histogram::getMax() const
+{
+    return mMax;
+}
+
+double Histogram::getMean() const
+{
+    return mCount == 0 ? 0. : static_cast<double>(mSum) / static_cast<double>(mCount);
+}
+
+uint64_t Histogram::getPercentile(const double fraction) const
+{
+    if (mCount == 0) {
+        return 0;
+    }
+
+    // Rank of the percentile among the values, from 1 to the number of values
+    const auto rank = std::clamp(
+          static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(mCount))),
+          uint64_t{1},
+          mCount);
+
+    uint64_t countedValues{0};
+    for (std::size_t bucketIndex = 0; bucketIndex < mBuckets.size(); ++bucketIndex) {
+        countedValues += mBuckets[bucketIndex];
+        if (countedValues >= rank) {
+            return std::min(getBucketUpperBound(bucketIndex), mMax);
+        }
+    }
+
+    return mMax;
+}
+
+std::size_t Histogram::getBucketIndex(const uint64_t value)
+{
+    // Values below twice the number of sub-buckets are counted exactly. Beyond, only
+    // the highest bits of the values are kept, the power of two range selecting
+    // the group of sub-buckets: the index is the shift followed by those bits
+    const auto shift = std::max<uint64_t>(std::bit_width(value), cSubBucketBits + 1)
+                       - (cSubBucketBits + 1);
+    return static_cast<std::size_t>(shift * cSubBucketCount + (value >> shift));
+}
+
+uint64_t Histogram::getBucketUpperBound(const std::size_t bucketIndex)
+{
+    const uint64_t shift
+          = bucketIndex < 2 * cSubBucketCount ? 0 : bucketIndex / cSubBucketCount - 1;
+    const auto highestBits = uint64_t{bucketIndex} - shift * cSubBucketCount;
+    return ((highestBits + 1) << shift) - 1;
+}
+
+Statistics::Statistics(const uint32_t timingSamplePeriod)
+    : mTimingSamplePeriod{std::max(timingSamplePeriod, uint32_t{1})}
+{
+}
+
+void Statistics::setTimingSamplePeriod(const uint32_t timingSamplePeriod)
+{
+    mTimingSamplePeriod = std::max(timingSamplePeriod, uint32_t{1});
+    mInstructionsUntilSample = 1;
+}
+
+Statistics::Counters& Statistics::getCounters()
+{
+    return mCounters;
+}
+
+const Statistics::Counters& Statistics::getCounters() const
+{
+    return mCounters;
+}
+
+const Histogram& Statistics::getPhaseLatencies(const Phase phase) const
+{
+    return mPhaseLatencies[static_cast<std::size_t>(phase)];
+}
+
+const Histogram& Statistics::getInstructionLatencies() const
+{
+    return mInstructionLatencies;
+}
+
+const Histogram& Statistics::getCascadeSizes() const
+{
+    return mCascadeSizes;
+}
+
+void Statistics::describe(const std::size_t pendingExpressionCount,
+                          std::vector<std::string>& entries) const
+{
+    entries.push_back("instructions = " + std::to_string(mCounters.instructions));
+    entries.push_back("rejected instructions = "
+                      + std::to_string(mCounters.rejectedInstructions));
+    entries.push_back("parsed expressions = " + std::to_string(mCounters.parsedExpressions));
+    entries.push_back("cached expressions = " + std::to_string(mCounters.cachedExpressions));
+    entries.push_back("assigned expression nodes = "
+                      + std::to_string(mCounters.assignedExpressionNodes));
+    entries.push_back("pending expressions = " + std::to_string(pendingExpressionCount));
+
+    if (mCascadeSizes.getCount() > 0) {
+        entries.push_back("cascade size p50 = "
+                          + std::to_string(mCascadeSizes.getPercentile(0.5)));
+        entries.push_back("cascade size max = " + std::to_string(mCascadeSizes.getMax()));
+    }
+
+    for (std::size_t phaseIndex = 0; phaseIndex < mPhaseLatencies.size(); ++phaseIndex) {
+        describeLatencies(cPhaseNames[phaseIndex], mPhaseLatencies[phaseIndex], entries);
+    }
+    describeLatencies("instruction", mInstructionLatencies, entries);
+}
+
+std::string Statistics::dumpJson(const std::size_t pendingExpressionCount) const
+{
+    std::string json;
+
+    json.append("{\"instructions\":").append(std::to_string(mCounters.instructions));
+    json.append(",\"rejected_instructions\":")
+          .append(std::to_string(mCounters.rejectedInstructions));
+    json.append(",\"parsed_expressions\":").append(std::to_string(mCounters.parsedExpressions));
+    json.append(",\"cached_expressions\":").append(std::to_string(mCounters.cachedExpressions));
+    json.append(",\"assigned_expression_nodes\":")
+          .append(std::to_string(mCounters.assignedExpressionNodes));
+    json.append(",\"pending_expressions\":").append(std::to_string(pendingExpressionCount));
+    json.append(",\"timing_sample_period\":").append(std::to_string(mTimingSamplePeriod));
+
+    dumpHistogram(",", "cascade_sizes", mCascadeSizes, json);
+
+    json.append(",\"latencies_ns\":{");
+    dumpHistogram("", "instruction", mInstructionLatencies, json);
+    for (std::size_t phaseIndex = 0; phaseIndex < mPhaseLatencies.size(); ++phaseIndex) {
+        dumpHistogram(",", cPhaseNames[phaseIndex], mPhaseLatencies[phaseIndex], json);
+    }
+    json.append("}}");
+
+    return json;
+}
+
+} // namespace Calculator
@@ -0,0 +1,309 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Calculator {
+
+/// Default number of instructions per timed instruction (one instruction out of 1024 is timed)
+inline constexpr uint32_t cDefaultTimingSamplePeriod{1024};
+
+/**
+ * @brief Histogram of non-negative values with a bounded relative error (HDR-style)
+ *
+ * Values are counted in log-linear buckets: every power of two range is split into
+ * 16 buckets, so any value is known within 1/16 of itself whatever its magnitude,
+ * with a fixed amount of memory and a constant recording cost.
+ */
+class Histogram
+{
+public:
+    /**
+     * @brief Counts a value
+     *
+     * @param[in] value Value to count
+     */
+    void record(uint64_t value);
+
+    /**
+     * @brief Getter for the number of values counted
+     *
+     * @return Number of values
+     */
+    [[nodiscard]] uint64_t getCount() const;
+
+    /**
+     * @brief Getter for the largest value counted
+     *
+     * @return Largest value (0 if nothing was counted)
+     */
+    [[nodiscard]] uint64_t getMax() const;
+
+    /**
+     * @brief Getter for the average of the values counted
+     *
+     * @return Average value (0 if nothing was counted)
+     */
+    [[nodiscard]] double getMean() const;
+
+    /**
+     * @brief Retrieves the value below which a given fraction of the values fall
+     *
+     * @param[in] fraction Fraction of the values (e.g. 0.99 for the 99th percentile)
+     *
+     * @return Upper bound of the bucket holding the percentile (0 if nothing was counted)
+     */
+    [[nodiscard]] uint64_t getPercentile(double fraction) const;
+
+private:
+    /// Number of bits of the values resolved exactly within each power of two range
+    static constexpr uint64_t cSubBucketBits{4};
+    /// Number of buckets per power of two range
+    static constexpr uint64_t cSubBucketCount{uint64_t{1} << cSubBucketBits};
+    /// Number of buckets covering every 64 bits value (values below 32 have their own bucket)
+    static constexpr std::size_t cBucketCount{(64 - cSubBucketBits + 1) * cSubBucketCount};
+
+    /**
+     * @brief Computes the bucket of a value
+     *
+     * @param[in] value Value to count
+     *
+     * @return Index of the bucket
+     */
+    [[nodiscard]] static std::size_t getBucketIndex(uint64_t value);
+
+    /**
+     * @brief Computes the largest value of a bucket
+     *
+     * @param[in] bucketIndex Index of the bucket
+     *
+     * @return Largest value counted in the bucket
+     */
+    [[nodiscard]] static uint64_t getBucketUpperBound(std::size_t bucketIndex);
+
+private:
+    /// Number of values counted in each bucket
+    std::array<uint64_t, cBucketCount> mBuckets{};
+
+    /// Number of values counted
+    uint64_t mCount{0};
+
+    /// Sum of the values counted
+    uint64_t mSum{0};
+
+    /// Largest value counted
+    uint64_t mMax{0};
+};
+
+/**
+ * @brief Always-on instrumentation of the instructions processed by a Runner
+ *
+ * Counters are updated on every instruction. Timing every phase of every instruction would cost
+ * more than many instructions (a clock read takes tens of nanoseconds), so only one instruction
+ * out of a sample period is timed: its phases are recorded in latency histograms, whose
+ * percentiles stay representative of the whole workload.
+ */
+class Statistics
+{
+public:
+    /**
+     * @brief Phases of the processing of an instruction
+     */
+    enum class Phase : uint8_t {
+
+        DETECTION = 0,   // Recognition of the instruction and lookup of cached expressions
+        PARSING = 1,     // Parsing and compilation of an instruction
+        EVALUATION = 2,  // Execution of the program of an arithmetic expression
+        PROPAGATION = 3, // Storage of the result and propagation to the dependent operands
+        COMMAND = 4,     // Execution of a command (result, undo, checkpoint...)
+        COUNT = 5        // Number of phases
+    };
+
+    /**
+     * @brief Counters of the instructions processed
+     */
+    struct Counters
+    {
+        /// Instructions processed
+        uint64_t instructions{0};
+        /// Instructions rejected because they could not be parsed
+        uint64_t rejectedInstructions{0};
+        /// Arithmetic expressions parsed and compiled
+        uint64_t parsedExpressions{0};
+        /// Arithmetic expressions served by the expression cache (not parsed)
+        uint64_t cachedExpressions{0};
+        /// Program instructions executed to evaluate the assigned arithmetic expressions (and the
+        /// precompiled formulas), excluding the re-evaluations of their dependent operands
+        uint64_t assignedExpressionNodes{0};
+    };
+
+    /**
+     * @brief Class constructor
+     *
+     * @param[in] timingSamplePeriod Number of instructions per timed instruction
+     * (1 times every instruction)
+     */
+    explicit Statistics(uint32_t timingSamplePeriod = cDefaultTimingSamplePeriod);
+
+    /**
+     * @brief Changes the number of instructions per timed instruction
+     *
+     * @param[in] timingSamplePeriod Number of instructions per timed instruction
+     * (1 times every instruction)
+     */
+    void setTimingSamplePeriod(uint32_t timingSamplePeriod);
+
+    /**
+     * @brief Starts processing an instruction, timing it if it is sampled
+     */
+    void beginInstruction()
+    {
+        ++mCounters.instructions;
+        mIsTiming = --mInstructionsUntilSample == 0;
+
+        if (mIsTiming) {
+            mInstructionsUntilSample = mTimingSamplePeriod;
+            mPhaseStartTime = std::chrono::steady_clock::now();
+            mInstructionStartTime = mPhaseStartTime;
+        }
+    }
+
+    /**
+     * @brief Ends a phase of the instruction being processed, the next one starting right away
+     *
+     * @param[in] phase Phase that ended
+     */
+    void endPhase(const Phase phase)
+    {
+        if (mIsTiming) {
+            const auto phaseEndTime = std::chrono::steady_clock::now();
+            recordDuration(mPhaseLatencies[static_cast<std::size_t>(phase)],
+                           phaseEndTime - mPhaseStartTime);
+            mPhaseStartTime = phaseEndTime;
+        }
+    }
+
+    /**
+     * @brief Ends the processing of the instruction
+     */
+    void endInstruction()
+    {
+        if (mIsTiming) {
+            recordDuration(mInstructionLatencies, mPhaseStartTime - mInstructionStartTime);
+            mIsTiming = false;
+        }
+    }
+
+    /**
+     * @brief Counts the operands affected by an assignment (including the assigned one)
+     *
+     * @param[in] cascadeSize Number of operands whose value changed
+     */
+    void recordCascade(const std::size_t cascadeSize)
+    {
+        mCascadeSizes.record(cascadeSize);
+    }
+
+    /**
+     * @brief Getter for the counters, to be updated along with the instructions processed
+     *
+     * @return Reference to the counters
+     */
+    [[nodiscard]] Counters& getCounters();
+
+    /**
+     * @brief Getter for the counters
+     *
+     * @return Const reference to the counters
+     */
+    [[nodiscard]] const Counters& getCounters() const;
+
+    /**
+     * @brief Getter for the latencies of a phase (in nanoseconds)
+     *
+     * @param[in] phase Phase of the instructions
+     *
+     * @return Const reference to the histogram of the latencies
+     */
+    [[nodiscard]] const Histogram& getPhaseLatencies(Phase phase) const;
+
+    /**
+     * @brief Getter for the latencies of whole instructions (in nanoseconds)
+     *
+     * @return Const reference to the histogram of the latencies
+     */
+    [[nodiscard]] const Histogram& getInstructionLatencies() const;
+
+    /**
+     * @brief Getter for the sizes of the cascades of the assignments
+     *
+     * @return Const reference to the histogram of the cascade sizes
+     */
+    [[nodiscard]] const Histogram& getCascadeSizes() const;
+
+    /**
+     * @brief Describes the statistics in a human readable way, one entry per figure
+     *
+     * @param[in] pendingExpressionCount Number of expressions pending in the state
+     * @param[out] entries Entries describing the statistics (e.g. "instructions = 42")
+     */
+    void describe(std::size_t pendingExpressionCount, std::vector<std::string>& entries) const;
+
+    /**
+     * @brief Dumps the statistics as a single line JSON object
+     *
+     * @param[in] pendingExpressionCount Number of expressions pending in the state
+     *
+     * @return JSON object holding every counter and a summary of every histogram
+     */
+    [[nodiscard]] std::string dumpJson(std::size_t pendingExpressionCount) const;
+
+private:
+    /**
+     * @brief Records a duration in a latency histogram
+     *
+     * @param[in,out] latencies Latency histogram
+     * @param[in] duration Duration to record
+     */
+    static void recordDuration(Histogram& latencies, std::chrono::steady_clock::duration duration)
+    {
+        const auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(duration);
+        latencies.record(static_cast<uint64_t>(nanoseconds.count()));
+    }
+
+private:
+    /// Counters of the instructions processed
+    Counters mCounters;
+
+    // Fields read by every instruction come first, ahead of the large histograms
+
+    /// Number of instructions per timed instruction
+    uint32_t mTimingSamplePeriod;
+
+    /// Number of instructions left before the next timed one
+    uint32_t mInstructionsUntilSample{1};
+
+    /// Whether the instruction being processed is timed
+    bool mIsTiming{false};
+
+    /// Start time of the timed instruction
+    std::chrono::steady_clock::time_point mInstructionStartTime;
+
+    /// Start time of the current phase of the timed instruction
+    std::chrono::steady_clock::time_point mPhaseStartTime;
+
+    /// Latencies of each phase of the timed instructions
+    std::array<Histogram, static_cast<std::size_t>(Phase::COUNT)> mPhaseLatencies;
+
+    /// Latencies of the timed instructions
+    Histogram mInstructionLatencies;
+
+    /// Sizes of the cascades of the assignments
+    Histogram mCascadeSizes;
+};
+
+} // namespace Calculator
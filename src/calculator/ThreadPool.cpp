@@ -0,0 +1,148 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+namespace Calculator {
+
+ThreadPool::ThreadPool(const std::size_t threadCount)
+{
+    const auto queueCount = std::max<std::size_t>(threadCount, 1);
+
+    mQueues.reserve(queueCount);
+    for (std::size_t queueIndex = 0; queueIndex < queueCount; ++queueIndex) {
+        mQueues.push_back(std::make_unique<WorkQueue>());
+    }
+
+    // The calling thread owns the last queue
+    mWorkers.reserve(queueCount - 1);
+    for (std::size_t queueIndex = 0; queueIndex + 1 < queueCount; ++queueIndex) {
+        mWorkers.emplace_back(&ThreadPool::runWorker, this, queueIndex);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        const std::scoped_lock lock(mMutex);
+        mIsStopping = true;
+    }
+    mLoopStarted.notify_all();
+
+    for (auto& worker : mWorkers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::parallelFor(const std::size_t iterationCount,
+                             const std::size_t chunkSize,
+                             const LoopBody& loopBody)
+{
+    if (iterationCount == 0) {
+        return;
+    }
+
+    const auto iterationsPerChunk = std::max<std::size_t>(chunkSize, 1);
+    const auto chunkCount = (iterationCount + iterationsPerChunk - 1) / iterationsPerChunk;
+
+    // Not worth waking up the workers
+    if (mWorkers.empty() || chunkCount == 1) {
+        loopBody(0, iterationCount);
+        return;
+    }
+
+    // The loop must be published before any of its chunks can be taken
+    mLoopBody = &loopBody;
+    mPendingChunkCount = chunkCount;
+
+    // Deal out consecutive chunks to the queues, round robin
+    for (std::size_t chunkIndex = 0; chunkIndex < chunkCount; ++chunkIndex) {
+        const auto begin = chunkIndex * iterationsPerChunk;
+        const Chunk chunk{begin, std::min(begin + iterationsPerChunk, iterationCount)};
+
+        auto& queue = *mQueues[chunkIndex % mQueues.size()];
+        const std::scoped_lock lock(queue.mutex);
+        queue.chunks.push_back(chunk);
+    }
+
+    {
+        const std::scoped_lock lock(mMutex);
+        ++mLoopGeneration;
+    }
+    mLoopStarted.notify_all();
+
+    runChunks(mQueues.size() - 1);
+
+    std::unique_lock lock(mMutex);
+    mLoopCompleted.wait(lock, [this] { return mPendingChunkCount == 0; });
+    mLoopBody = nullptr;
+}
+
+std::size_t ThreadPool::getThreadCount() const
+{
+    return mQueues.size();
+}
+
+void ThreadPool::runWorker(const std::size_t queueIndex)
+{
+    uint64_t lastLoopGeneration{0};
+
+    while (true) {
+        {
+            std::unique_lock lock(mMutex);
+            mLoopStarted.wait(lock, [this, lastLoopGeneration] {
+                return mIsStopping || mLoopGeneration != lastLoopGeneration;
+            });
+
+            if (mIsStopping) {
+                return;
+            }
+
+            lastLoopGeneration = mLoopGeneration;
+        }
+
+        runChunks(queueIndex);
+    }
+}
+
+void ThreadPool::runChunks(const std::size_t queueIndex)
+{
+    Chunk chunk;
+    while (takeChunk(queueIndex, chunk)) {
+        (*mLoopBody)(chunk.begin, chunk.end);
+
+        // The last chunk wakes up the thread waiting for the loop
+        if (mPendingChunkCount.fetch_sub(1) == 1) {
+            const std::scoped_lock lock(mMutex);
+            mLoopCompleted.notify_all();
+        }
+    }
+}
+
+bool ThreadPool::takeChunk(const std::size_t queueIndex, Chunk& chunk)
+{
+    // Own queue first, most recently dealt chunk first
+    {
+        auto& queue = *mQueues[queueIndex];
+        const std::scoped_lock lock(queue.mutex);
+        if (!queue.chunks.empty()) {
+            chunk = queue.chunks.back();
+            queue.chunks.pop_back();
+            return true;
+        }
+    }
+
+    // Then steal the oldest chunk of another queue
+    for (std::size_t offset = 1; offset < mQueues.size(); ++offset) {
+        auto& queue = *mQueues[(queueIndex + offset) % mQueues.size()];
+        const std::scoped_lock lock(queue.mutex);
+        if (!queue.chunks.empty()) {
+            chunk = queue.chunks.front();
+            queue.chunks.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+} // namespace Calculator
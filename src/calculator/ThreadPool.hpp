@@ -0,0 +1,137 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Calculator {
+
+/**
+ * @brief Pool of worker threads running parallel loops with work stealing
+ *
+ * The iterations of a loop are split into chunks that are dealt out to one queue per thread.
+ * Each thread runs the chunks of its own queue and, once it is empty, steals chunks from the
+ * other queues, so that uneven chunks do not leave threads idle.
+ * The calling thread takes part in the loop as well.
+ */
+class ThreadPool
+{
+public:
+    /// Alias representing the body of a parallel loop, run on a chunk of iterations [begin, end)
+    using LoopBody = std::function<void(std::size_t begin, std::size_t end)>;
+
+    /**
+     * @brief Class constructor, starts the worker threads
+     *
+     * @param[in] threadCount Number of threads running the loops, including the calling one
+     * (at least one)
+     */
+    explicit ThreadPool(std::size_t threadCount);
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Class destructor, stops the worker threads
+     */
+    ~ThreadPool();
+
+    /**
+     * @brief Runs a loop over [0, iterationCount) and waits for all of its iterations
+     *
+     * @param[in] iterationCount Number of iterations
+     * @param[in] chunkSize Number of consecutive iterations run as a single task (at least one)
+     * @param[in] loopBody Body of the loop
+     */
+    void parallelFor(std::size_t iterationCount, std::size_t chunkSize, const LoopBody& loopBody);
+
+    /**
+     * @brief Getter for the number of threads running the loops
+     *
+     * @return Number of threads, including the calling one
+     */
+    [[nodiscard]] std::size_t getThreadCount() const;
+
+private:
+    /**
+     * @brief Chunk of iterations of a loop
+     */
+    struct Chunk
+    {
+        /// First iteration of the chunk
+        std::size_t begin{};
+        /// Iteration following the last one of the chunk
+        std::size_t end{};
+    };
+
+    /**
+     * @brief Chunks waiting to be run, owned by one thread
+     */
+    struct WorkQueue
+    {
+        /// Protects the chunks
+        std::mutex mutex;
+        /// Chunks (the owner pops from the back, thieves from the front)
+        std::deque<Chunk> chunks;
+    };
+
+    /**
+     * @brief Main loop of a worker thread
+     *
+     * @param[in] queueIndex Index of the queue owned by the worker
+     */
+    void runWorker(std::size_t queueIndex);
+
+    /**
+     * @brief Runs chunks until every queue is empty
+     *
+     * @param[in] queueIndex Index of the queue owned by the calling thread
+     */
+    void runChunks(std::size_t queueIndex);
+
+    /**
+     * @brief Takes a chunk from the queue of a thread, or steals one from another queue
+     *
+     * @param[in] queueIndex Index of the queue owned by the calling thread
+     * @param[out] chunk Chunk taken
+     *
+     * @return True if a chunk was taken (false if every queue is empty)
+     */
+    [[nodiscard]] bool takeChunk(std::size_t queueIndex, Chunk& chunk);
+
+private:
+    /// Queue of each thread (the last one belongs to the thread calling parallelFor)
+    std::vector<std::unique_ptr<WorkQueue>> mQueues;
+
+    /// Worker threads
+    std::vector<std::thread> mWorkers;
+
+    /// Body of the loop currently running
+    const LoopBody* mLoopBody{nullptr};
+
+    /// Number of chunks of the current loop not completed yet
+    std::atomic<std::size_t> mPendingChunkCount{0};
+
+    /// Protects the loop generation and the stop flag
+    std::mutex mMutex;
+
+    /// Signals the workers that a loop started or that they must stop
+    std::condition_variable mLoopStarted;
+
+    /// Signals the calling thread that every chunk of the loop completed
+    std::condition_variable mLoopCompleted;
+
+    /// Number of loops started so far (lets workers tell a new loop from the one they just ran)
+    uint64_t mLoopGeneration{0};
+
+    /// Whether the workers must stop
+    bool mIsStopping{false};
+};
+
+} // namespace Calculator
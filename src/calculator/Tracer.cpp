@@ -0,0 +1,167 @@
+#include "Tracer.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#include <unistd.h>
+
+namespace Calculator {
+
+std::unique_ptr<Tracer> Tracer::open(const std::string& path,
+                                     const std::size_t capacity,
+                                     const std::chrono::milliseconds flushInterval)
+{
+    auto* const file = std::fopen(path.c_str(), "we");
+    if (!file) {
+        return nullptr;
+    }
+
+    std::fputs("{\"traceEvents\":[", file);
+
+    return std::unique_ptr<Tracer>(
+          new Tracer(file, std::bit_ceil(std::max<std::size_t>(capacity, 2)), flushInterval));
+}
+
+Tracer::Tracer(std::FILE* const file,
+               const std::size_t capacity,
+               const std::chrono::milliseconds flushInterval)
+    : mFile{file}
+    , mOriginTime{Clock::now()}
+    , mProcessId{getpid()}
+    , mSlots{std::make_unique<Slot[]>(capacity)}
+    , mSlotMask{capacity - 1}
+    , mFlushInterval{flushInterval}
+{
+    for (std::size_t slotIndex = 0; slotIndex < capacity; ++slotIndex) {
+        mSlots[slotIndex].sequence.store(slotIndex, std::memory_order_relaxed);
+    }
+
+    mFlusher = std::thread(&Tracer::runFlusher, this);
+}
+
+Tracer::~Tracer()
+{
+    {
+        const std::scoped_lock lock(mMutex);
+        mIsStopping = true;
+    }
+    mStopRequested.notify_one();
+    mFlusher.join();
+
+    // Spans recorded after the last flush are written before the trace is completed
+    flushSpans();
+    std::fprintf(mFile,
+                 "\n],\"displayTimeUnit\":\"ns\",\"otherData\":{\"droppedSpans\":%llu}}\n",
+                 static_cast<unsigned long long>(getDroppedCount()));
+    std::fclose(mFile);
+}
+
+void Tracer::recordSpan(const char* const name,
+                        const std::string_view operandName,
+                        const Clock::time_point startTime,
+                        const Clock::time_point endTime)
+{
+    // Producers claim positions with a compare and swap: a slot still holding the span recorded
+    // one lap earlier means the buffer is full
+    auto position = mEnqueuePosition.load(std::memory_order_relaxed);
+    Slot* slot{nullptr};
+
+    while (true) {
+        slot = &mSlots[position & mSlotMask];
+        const auto sequence = slot->sequence.load(std::memory_order_acquire);
+
+        if (sequence == position) {
+            if (mEnqueuePosition.compare_exchange_weak(
+                      position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (sequence < position) {
+            mDroppedCount.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            position = mEnqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    const auto toNanoseconds = [](const Clock::duration duration) {
+        return static_cast<uint64_t>(
+              std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+    };
+
+    slot->name = name;
+    slot->startTime = toNanoseconds(startTime - mOriginTime);
+    slot->duration = toNanoseconds(endTime - startTime);
+    slot->threadId = getThreadId();
+    slot->operandNameSize
+          = static_cast<uint8_t>(std::min(operandName.size(), cMaxOperandNameSize));
+    std::memcpy(slot->operandName.data(), operandName.data(), slot->operandNameSize);
+
+    slot->sequence.store(position + 1, std::memory_order_release);
+}
+
+uint64_t Tracer::getDroppedCount() const
+{
+    return mDroppedCount.load(std::memory_order_relaxed);
+}
+
+void Tracer::runFlusher()
+{
+    std::unique_lock lock(mMutex);
+
+    while (!mIsStopping) {
+        lock.unlock();
+        flushSpans();
+        std::fflush(mFile);
+        lock.lock();
+
+        mStopRequested.wait_for(lock, mFlushInterval, [this] { return mIsStopping; });
+    }
+}
+
+void Tracer::flushSpans()
+{
+    while (true) {
+        auto& slot = mSlots[mDequeuePosition & mSlotMask];
+        if (slot.sequence.load(std::memory_order_acquire) != mDequeuePosition + 1) {
+            return;
+        }
+
+        // Timestamps of the trace are in microseconds
+        std::fprintf(mFile,
+                     "%s\n{\"name\":\"%s\",\"cat\":\"calculator\",\"ph\":\"X\",\"pid\":%d,"
+                     "\"tid\":%u,\"ts\":%llu.%03llu,\"dur\":%llu.%03llu",
+                     mIsFirstSpanWritten ? "," : "",
+                     slot.name,
+                     mProcessId,
+                     slot.threadId,
+                     static_cast<unsigned long long>(slot.startTime / 1000),
+                     static_cast<unsigned long long>(slot.startTime % 1000),
+                     static_cast<unsigned long long>(slot.duration / 1000),
+                     static_cast<unsigned long long>(slot.duration % 1000));
+
+        // Operand names are made of letters, digits and underscores: they need no escaping
+        if (slot.operandNameSize > 0) {
+            std::fprintf(mFile,
+                         ",\"args\":{\"operand\":\"%.*s\"}",
+                         static_cast<int>(slot.operandNameSize),
+                         slot.operandName.data());
+        }
+        std::fputc('}', mFile);
+        mIsFirstSpanWritten = true;
+
+        // The slot is free for the span recorded one lap later
+        slot.sequence.store(mDequeuePosition + mSlotMask + 1, std::memory_order_release);
+        ++mDequeuePosition;
+    }
+}
+
+uint32_t Tracer::getThreadId()
+{
+    static std::atomic<uint32_t> sThreadCount{0};
+    thread_local const auto threadId = sThreadCount.fetch_add(1, std::memory_order_relaxed) + 1;
+
+    return threadId;
+}
+
+} // namespace Calculator
@@ -0,0 +1,225 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace Calculator {
+
+/// Default number of events the ring buffer of a Tracer holds before dropping new ones
+inline constexpr std::size_t cDefaultTraceCapacity{1 << 16};
+/// Default interval between two flushes of the ring buffer of a Tracer
+inline constexpr std::chrono::milliseconds cDefaultTraceFlushInterval{10};
+
+/**
+ * @brief Records timed spans of the processing of instructions into a Chrome trace-event file
+ *
+ * The file is a JSON trace (viewable in Perfetto or chrome://tracing) made of complete events,
+ * tagged with the name of the operand they apply to. Spans are pushed into a fixed-size lock-free
+ * ring buffer by any thread (including the threads of a parallel propagation) and written out by
+ * a background thread: recording a span never blocks nor allocates. When the buffer is full,
+ * spans are dropped and counted instead.
+ */
+class Tracer
+{
+public:
+    /// Clock timing the spans
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Span being timed, recorded once ended
+     *
+     * Spans of a null tracer are not timed, so that tracing costs a single branch when disabled
+     */
+    class Span
+    {
+    public:
+        /**
+         * @brief Class constructor, starts timing the span
+         *
+         * @param[in] tracer Tracer recording the span (null if tracing is disabled)
+         * @param[in] name Name of the span (a string literal)
+         */
+        Span(Tracer* const tracer, const char* const name)
+            : mTracer{tracer}
+            , mName{name}
+            , mStartTime{tracer ? Clock::now() : Clock::time_point{}}
+        {
+        }
+
+        /**
+         * @brief Ends the span and records it
+         *
+         * @param[in] operandName Name of the operand the span applies to (empty if none)
+         */
+        void end(const std::string_view operandName) const
+        {
+            if (mTracer) {
+                mTracer->recordSpan(mName, operandName, mStartTime, Clock::now());
+            }
+        }
+
+    private:
+        /// Tracer recording the span
+        Tracer* mTracer;
+
+        /// Name of the span
+        const char* mName;
+
+        /// Start time of the span
+        Clock::time_point mStartTime;
+    };
+
+    /**
+     * @brief Creates a trace file and starts the thread writing the spans into it
+     *
+     * @param[in] path Path of the trace file (replaced if it exists)
+     * @param[in] capacity Number of spans the ring buffer holds (rounded up to a power of two)
+     * @param[in] flushInterval Interval between two flushes of the ring buffer
+     *
+     * @return Tracer writing into the file (null if the file cannot be created, errno is set)
+     */
+    [[nodiscard]] static std::unique_ptr<Tracer> open(
+          const std::string& path,
+          std::size_t capacity = cDefaultTraceCapacity,
+          std::chrono::milliseconds flushInterval = cDefaultTraceFlushInterval);
+
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    /**
+     * @brief Class destructor, writes the remaining spans and completes the trace file
+     */
+    ~Tracer();
+
+    /**
+     * @brief Records a span, unless the ring buffer is full
+     *
+     * Safe to call from any thread
+     *
+     * @param[in] name Name of the span (a string literal)
+     * @param[in] operandName Name of the operand the span applies to (empty if none, truncated
+     * if longer than cMaxOperandNameSize)
+     * @param[in] startTime Start time of the span
+     * @param[in] endTime End time of the span
+     */
+    void recordSpan(const char* name,
+                    std::string_view operandName,
+                    Clock::time_point startTime,
+                    Clock::time_point endTime);
+
+    /**
+     * @brief Getter for the number of spans dropped because the ring buffer was full
+     *
+     * @return Number of dropped spans
+     */
+    [[nodiscard]] uint64_t getDroppedCount() const;
+
+    /// Maximum size of the operand names kept by the spans
+    static constexpr std::size_t cMaxOperandNameSize{39};
+
+private:
+    /**
+     * @brief Slot of the ring buffer
+     *
+     * The sequence of a slot tells whether it is free for the span at a given position
+     * (sequence equal to the position) or holds it (sequence equal to the position plus one)
+     */
+    struct Slot
+    {
+        /// Position of the span the slot is free for or holds
+        std::atomic<uint64_t> sequence{0};
+        /// Name of the span
+        const char* name{nullptr};
+        /// Start time of the span, relative to the creation of the tracer (in nanoseconds)
+        uint64_t startTime{0};
+        /// Duration of the span (in nanoseconds)
+        uint64_t duration{0};
+        /// Identifier of the thread that recorded the span
+        uint32_t threadId{0};
+        /// Size of the operand name
+        uint8_t operandNameSize{0};
+        /// Name of the operand the span applies to
+        std::array<char, cMaxOperandNameSize> operandName{};
+    };
+
+    /**
+     * @brief Class constructor
+     *
+     * @param[in] file Trace file, whose header was written
+     * @param[in] capacity Number of spans the ring buffer holds (a power of two)
+     * @param[in] flushInterval Interval between two flushes of the ring buffer
+     */
+    Tracer(std::FILE* file, std::size_t capacity, std::chrono::milliseconds flushInterval);
+
+    /**
+     * @brief Main loop of the thread writing the spans, until the tracer is destroyed
+     */
+    void runFlusher();
+
+    /**
+     * @brief Writes every span of the ring buffer into the trace file
+     */
+    void flushSpans();
+
+    /**
+     * @brief Retrieves the identifier of the calling thread in the trace
+     *
+     * @return Small integer identifying the thread
+     */
+    [[nodiscard]] static uint32_t getThreadId();
+
+private:
+    /// Trace file
+    std::FILE* mFile;
+
+    /// Creation time of the tracer, origin of the timestamps of the trace
+    Clock::time_point mOriginTime;
+
+    /// Identifier of the process in the trace
+    int mProcessId;
+
+    /// Slots of the ring buffer
+    std::unique_ptr<Slot[]> mSlots;
+
+    /// Number of slots of the ring buffer minus one (a power of two minus one)
+    std::size_t mSlotMask;
+
+    /// Position of the next span to record
+    alignas(64) std::atomic<uint64_t> mEnqueuePosition{0};
+
+    /// Number of spans dropped because the ring buffer was full
+    std::atomic<uint64_t> mDroppedCount{0};
+
+    /// Position of the next span to write (only used by the flushing thread)
+    alignas(64) uint64_t mDequeuePosition{0};
+
+    /// Whether a span was already written (they are separated by commas)
+    bool mIsFirstSpanWritten{false};
+
+    /// Interval between two flushes of the ring buffer
+    std::chrono::milliseconds mFlushInterval;
+
+    /// Protects the stop request
+    std::mutex mMutex;
+
+    /// Signaled when the tracer is destroyed
+    std::condition_variable mStopRequested;
+
+    /// Whether the tracer is being destroyed
+    bool mIsStopping{false};
+
+    /// Thread writing the spans
+    std::thread mFlusher;
+};
+
+} // namespace Calculator
@@ -0,0 +1,397 @@
+#include "ColumnarEvaluator.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define COLUMNAR_EVALUATOR_X86
+#endif
+
+namespace {
+/// Number of rows evaluated at once (small enough for the value stack to stay in cache)
+constexpr std::size_t cBlockSize{1024};
+
+/**
+ * @brief Kernels applying a single instruction to a block of rows
+ *
+ * Arithmetic kernels store their result in place of their left operand
+ */
+struct Kernels
+{
+    /// Fills a block with a constant
+    void (*broadcast)(float value, float* output, std::size_t rowCount);
+    /// Converts a block of variable values to floating point
+    void (*load)(const int32_t* input, float* output, std::size_t rowCount);
+    /// Adds two blocks
+    void (*add)(float* left, const float* right, std::size_t rowCount);
+    /// Subtracts two blocks
+    void (*sub)(float* left, const float* right, std::size_t rowCount);
+    /// Multiplies two blocks
+    void (*mul)(float* left, const float* right, std::size_t rowCount);
+    /// Divides two blocks
+    void (*div)(float* left, const float* right, std::size_t rowCount);
+    /// Truncates a block of results to integers
+    void (*truncate)(const float* input, int32_t* output, std::size_t rowCount);
+};
+
+/**
+ * @brief Performs an arithmetic operation the same way the Evaluator does
+ *
+ * @tparam opCode Arithmetic operation
+ *
+ * @param[in] leftOperand Left Operand
+ * @param[in] rightOperand Right Operand
+ *
+ * @return Operation result
+ */
+template <Bytecode::OpCode opCode>
+constexpr float performArithmeticOperation(const float leftOperand, const float rightOperand)
+{
+    using Bytecode::OpCode;
+
+    if constexpr (opCode == OpCode::ADD) {
+        return leftOperand + rightOperand;
+    } else if constexpr (opCode == OpCode::SUB) {
+        return leftOperand - rightOperand;
+    } else if constexpr (opCode == OpCode::MUL) {
+        return leftOperand * rightOperand;
+    } else {
+        return leftOperand / rightOperand;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Scalar kernels (also used for the rows left over by the vectorized ones)
+////////////////////////////////////////////////////////////////////////////////
+
+void scalarBroadcast(const float value, float* output, const std::size_t rowCount)
+{
+    std::fill_n(output, rowCount, value);
+}
+
+void scalarLoad(const int32_t* input, float* output, const std::size_t rowCount)
+{
+    for (std::size_t row = 0; row < rowCount; ++row) {
+        output[row] = static_cast<float>(input[row]);
+    }
+}
+
+template <Bytecode::OpCode opCode>
+void scalarOperation(float* left, const float* right, const std::size_t rowCount)
+{
+    for (std::size_t row = 0; row < rowCount; ++row) {
+        left[row] = performArithmeticOperation<opCode>(left[row], right[row]);
+    }
+}
+
+void scalarTruncate(const float* input, int32_t* output, const std::size_t rowCount)
+{
+    for (std::size_t row = 0; row < rowCount; ++row) {
+        output[row] = static_cast<int32_t>(input[row]);
+    }
+}
+
+constexpr Kernels cScalarKernels{scalarBroadcast,
+                                 scalarLoad,
+                                 scalarOperation<Bytecode::OpCode::ADD>,
+                                 scalarOperation<Bytecode::OpCode::SUB>,
+                                 scalarOperation<Bytecode::OpCode::MUL>,
+                                 scalarOperation<Bytecode::OpCode::DIV>,
+                                 scalarTruncate};
+
+#ifdef COLUMNAR_EVALUATOR_X86
+
+////////////////////////////////////////////////////////////////////////////////
+// SSE2 kernels
+////////////////////////////////////////////////////////////////////////////////
+
+/// Number of rows handled by a single SSE2 instruction
+constexpr std::size_t cSSE2Width{4};
+
+__attribute__((target("sse2"))) void sse2Broadcast(const float value,
+                                                   float* output,
+                                                   const std::size_t rowCount)
+{
+    const auto values = _mm_set1_ps(value);
+
+    std::size_t row{0};
+    for (; row + cSSE2Width <= rowCount; row += cSSE2Width) {
+        _mm_storeu_ps(output + row, values);
+    }
+
+    scalarBroadcast(value, output + row, rowCount - row);
+}
+
+__attribute__((target("sse2"))) void sse2Load(const int32_t* input,
+                                              float* output,
+                                              const std::size_t rowCount)
+{
+    std::size_t row{0};
+    for (; row + cSSE2Width <= rowCount; row += cSSE2Width) {
+        const auto values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + row));
+        _mm_storeu_ps(output + row, _mm_cvtepi32_ps(values));
+    }
+
+    scalarLoad(input + row, output + row, rowCount - row);
+}
+
+template <Bytecode::OpCode opCode>
+__attribute__((target("sse2"))) void sse2Operation(float* left,
+                                                   const float* right,
+                                                   const std::size_t rowCount)
+{
+    using Bytecode::OpCode;
+
+    std::size_t row{0};
+    for (; row + cSSE2Width <= rowCount; row += cSSE2Width) {
+        const auto leftValues = _mm_loadu_ps(left + row);
+        const auto rightValues = _mm_loadu_ps(right + row);
+
+        if constexpr (opCode == OpCode::ADD) {
+            _mm_storeu_ps(left + row, _mm_add_ps(leftValues, rightValues));
+        } else if constexpr (opCode == OpCode::SUB) {
+            _mm_storeu_ps(left + row, _mm_sub_ps(leftValues, rightValues));
+        } else if constexpr (opCode == OpCode::MUL) {
+            _mm_storeu_ps(left + row, _mm_mul_ps(leftValues, rightValues));
+        } else {
+            _mm_storeu_ps(left + row, _mm_div_ps(leftValues, rightValues));
+        }
+    }
+
+    scalarOperation<opCode>(left + row, right + row, rowCount - row);
+}
+
+__attribute__((target("sse2"))) void sse2Truncate(const float* input,
+                                                  int32_t* output,
+                                                  const std::size_t rowCount)
+{
+    std::size_t row{0};
+    for (; row + cSSE2Width <= rowCount; row += cSSE2Width) {
+        const auto values = _mm_cvttps_epi32(_mm_loadu_ps(input + row));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + row), values);
+    }
+
+    scalarTruncate(input + row, output + row, rowCount - row);
+}
+
+constexpr Kernels cSSE2Kernels{sse2Broadcast,
+                               sse2Load,
+                               sse2Operation<Bytecode::OpCode::ADD>,
+                               sse2Operation<Bytecode::OpCode::SUB>,
+                               sse2Operation<Bytecode::OpCode::MUL>,
+                               sse2Operation<Bytecode::OpCode::DIV>,
+                               sse2Truncate};
+
+////////////////////////////////////////////////////////////////////////////////
+// AVX2 kernels
+////////////////////////////////////////////////////////////////////////////////
+
+/// Number of rows handled by a single AVX2 instruction
+constexpr std::size_t cAVX2Width{8};
+
+__attribute__((target("avx2"))) void avx2Broadcast(const float value,
+                                                   float* output,
+                                                   const std::size_t rowCount)
+{
+    const auto values = _mm256_set1_ps(value);
+
+    std::size_t row{0};
+    for (; row + cAVX2Width <= rowCount; row += cAVX2Width) {
+        _mm256_storeu_ps(output + row, values);
+    }
+
+    scalarBroadcast(value, output + row, rowCount - row);
+}
+
+__attribute__((target("avx2"))) void avx2Load(const int32_t* input,
+                                              float* output,
+                                              const std::size_t rowCount)
+{
+    std::size_t row{0};
+    for (; row + cAVX2Width <= rowCount; row += cAVX2Width) {
+        const auto values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + row));
+        _mm256_storeu_ps(output + row, _mm256_cvtepi32_ps(values));
+    }
+
+    scalarLoad(input + row, output + row, rowCount - row);
+}
+
+template <Bytecode::OpCode opCode>
+__attribute__((target("avx2"))) void avx2Operation(float* left,
+                                                   const float* right,
+                                                   const std::size_t rowCount)
+{
+    using Bytecode::OpCode;
+
+    std::size_t row{0};
+    for (; row + cAVX2Width <= rowCount; row += cAVX2Width) {
+        const auto leftValues = _mm256_loadu_ps(left + row);
+        const auto rightValues = _mm256_loadu_ps(right + row);
+
+        if constexpr (opCode == OpCode::ADD) {
+            _mm256_storeu_ps(left + row, _mm256_add_ps(leftValues, rightValues));
+        } else if constexpr (opCode == OpCode::SUB) {
+            _mm256_storeu_ps(left + row, _mm256_sub_ps(leftValues, rightValues));
+        } else if constexpr (opCode == OpCode::MUL) {
+            _mm256_storeu_ps(left + row, _mm256_mul_ps(leftValues, rightValues));
+        } else {
+            _mm256_storeu_ps(left + row, _mm256_div_ps(leftValues, rightValues));
+        }
+    }
+
+    scalarOperation<opCode>(left + row, right + row, rowCount - row);
+}
+
+__attribute__((target("avx2"))) void avx2Truncate(const float* input,
+                                                  int32_t* output,
+                                                  const std::size_t rowCount)
+{
+    std::size_t row{0};
+    for (; row + cAVX2Width <= rowCount; row += cAVX2Width) {
+        const auto values = _mm256_cvttps_epi32(_mm256_loadu_ps(input + row));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + row), values);
+    }
+
+    scalarTruncate(input + row, output + row, rowCount - row);
+}
+
+constexpr Kernels cAVX2Kernels{avx2Broadcast,
+                               avx2Load,
+                               avx2Operation<Bytecode::OpCode::ADD>,
+                               avx2Operation<Bytecode::OpCode::SUB>,
+                               avx2Operation<Bytecode::OpCode::MUL>,
+                               avx2Operation<Bytecode::OpCode::DIV>,
+                               avx2Truncate};
+
+#endif // COLUMNAR_EVALUATOR_X86
+
+/**
+ * @brief Retrieves the kernels of an instruction set
+ *
+ * @param[in] instructionSet Instruction set (must be supported by the running CPU)
+ *
+ * @return Kernels of the instruction set
+ */
+const Kernels& getKernels(const ColumnarEvaluator::InstructionSet instructionSet)
+{
+#ifdef COLUMNAR_EVALUATOR_X86
+    switch (instructionSet) {
+    case ColumnarEvaluator::InstructionSet::AVX2:
+        return cAVX2Kernels;
+    case ColumnarEvaluator::InstructionSet::SSE2:
+        return cSSE2Kernels;
+    case ColumnarEvaluator::InstructionSet::SCALAR:
+        break;
+    }
+#else
+    static_cast<void>(instructionSet);
+#endif
+
+    return cScalarKernels;
+}
+} // namespace
+
+ColumnarEvaluator::ColumnarEvaluator(const Bytecode::Program& program)
+    : ColumnarEvaluator(program, getSupportedInstructionSet())
+{
+}
+
+ColumnarEvaluator::ColumnarEvaluator(const Bytecode::Program& program,
+                                     const InstructionSet instructionSet)
+    : mProgram{program}
+    , mInstructionSet{std::min(instructionSet, getSupportedInstructionSet())}
+{
+}
+
+Evaluator::Dependencies ColumnarEvaluator::execute(const Columns columns,
+                                                   const std::span<int32_t> output) const
+{
+    // An empty program evaluates to zero on every row
+    if (mProgram.empty()) {
+        std::ranges::fill(output, 0);
+        return {};
+    }
+
+    // Check every column upfront, so that loads never have to
+    Evaluator::Dependencies dependencies;
+    for (const auto symbolId : mProgram.getVariables()) {
+        if (symbolId >= columns.size() || columns[symbolId].size() < output.size()) {
+            dependencies.push_back(symbolId);
+        }
+    }
+
+    if (!dependencies.empty()) {
+        return dependencies;
+    }
+
+    const auto& kernels = getKernels(mInstructionSet);
+
+    // Each stack entry holds the values of a whole block of rows
+    std::vector<float> stack(std::size_t{mProgram.getMaxStackDepth()} * cBlockSize);
+
+    for (std::size_t firstRow = 0; firstRow < output.size(); firstRow += cBlockSize) {
+        const auto rowCount = std::min(cBlockSize, output.size() - firstRow);
+
+        // 'top' always points one block past the last value block on the stack
+        auto* top = stack.data();
+
+        for (const auto& instruction : mProgram.getInstructions()) {
+            using Bytecode::OpCode;
+
+            switch (instruction.opCode) {
+            case OpCode::PUSH_CONST:
+                kernels.broadcast(std::bit_cast<float>(instruction.operand), top, rowCount);
+                top += cBlockSize;
+                break;
+            case OpCode::LOAD_VAR:
+                kernels.load(columns[instruction.operand].data() + firstRow, top, rowCount);
+                top += cBlockSize;
+                break;
+            case OpCode::ADD:
+                top -= cBlockSize;
+                kernels.add(top - cBlockSize, top, rowCount);
+                break;
+            case OpCode::SUB:
+                top -= cBlockSize;
+                kernels.sub(top - cBlockSize, top, rowCount);
+                break;
+            case OpCode::MUL:
+                top -= cBlockSize;
+                kernels.mul(top - cBlockSize, top, rowCount);
+                break;
+            case OpCode::DIV:
+                top -= cBlockSize;
+                kernels.div(top - cBlockSize, top, rowCount);
+                break;
+            }
+        }
+
+        kernels.truncate(stack.data(), output.data() + firstRow, rowCount);
+    }
+
+    return {};
+}
+
+ColumnarEvaluator::InstructionSet ColumnarEvaluator::getInstructionSet() const
+{
+    return mInstructionSet;
+}
+
+ColumnarEvaluator::InstructionSet ColumnarEvaluator::getSupportedInstructionSet()
+{
+    static const auto supportedInstructionSet = [] {
+#ifdef COLUMNAR_EVALUATOR_X86
+        if (__builtin_cpu_supports("avx2")) {
+            return InstructionSet::AVX2;
+        }
+        if (__builtin_cpu_supports("sse2")) {
+            return InstructionSet::SSE2;
+        }
+#endif
+        return InstructionSet::SCALAR;
+    }();
+
+    return supportedInstructionSet;
+}
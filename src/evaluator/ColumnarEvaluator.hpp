@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+#include "bytecode/Program.hpp"
+#include "evaluator/Evaluator.hpp"
+
+/**
+ * @brief Class responsible for evaluating one compiled expression over many variable bindings
+ *
+ * Inputs are provided column by column: each variable read by the expression has its own
+ * contiguous array of values, one per row. Rows are processed in blocks, every instruction of the
+ * program being applied to a whole block at once with vectorized (AVX2 or SSE2) kernels.
+ * The instruction set is selected at runtime, with a scalar fallback.
+ *
+ * Each row produces exactly the same value as the Evaluator would for the same bindings.
+ */
+class ColumnarEvaluator
+{
+public:
+    /// Alias representing the values of one variable, one per row
+    using Column = std::span<const int32_t>;
+    /// Alias representing the input columns, indexed by the symbol identifier of their variable
+    using Columns = std::span<const Column>;
+
+    /**
+     * @brief Instruction sets the kernels can be run with
+     */
+    enum class InstructionSet : uint8_t {
+
+        SCALAR = 0, // Portable scalar code
+        SSE2 = 1,   // 4 rows per instruction
+        AVX2 = 2    // 8 rows per instruction
+    };
+
+    /**
+     * @brief Class constructor
+     *
+     * The best instruction set supported by the running CPU is used
+     *
+     * @param[in] program Reference to the program to evaluate
+     */
+    explicit ColumnarEvaluator(const Bytecode::Program& program);
+
+    /**
+     * @brief Class constructor
+     *
+     * @param[in] program Reference to the program to evaluate
+     * @param[in] instructionSet Instruction set to use
+     * (capped to the best one supported by the running CPU)
+     */
+    ColumnarEvaluator(const Bytecode::Program& program, InstructionSet instructionSet);
+
+    /**
+     * @brief Evaluates the program for every row of the input columns
+     *
+     * The number of rows is given by the size of the output column.
+     * If some of the variables read by the program do not have a column with enough rows,
+     * nothing is evaluated and the result will be those variables
+     *
+     * @param[in] columns Input columns, indexed by symbol identifier
+     * @param[out] output Value of the expression for each row
+     *
+     * @return Variables without a valid column (empty on success)
+     */
+    [[nodiscard]] Evaluator::Dependencies execute(Columns columns, std::span<int32_t> output) const;
+
+    /**
+     * @brief Getter for the instruction set used by the kernels
+     *
+     * @return Instruction set in use
+     */
+    [[nodiscard]] InstructionSet getInstructionSet() const;
+
+    /**
+     * @brief Detects the best instruction set supported by the running CPU
+     *
+     * @return Best supported instruction set
+     */
+    [[nodiscard]] static InstructionSet getSupportedInstructionSet();
+
+private:
+    /// Reference to the program being evaluated
+    const Bytecode::Program& mProgram;
+
+    /// Instruction set used by the kernels
+    InstructionSet mInstructionSet;
+};
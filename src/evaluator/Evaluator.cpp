@@ -1,5 +1,7 @@
 #include "Evaluator.hpp"
 
+#include <algorithm>
+
 #include "utils/Constants.hpp"
 
 namespace {
@@ -32,21 +34,20 @@ constexpr auto performArithmeticOperation(const char operation,
 }
 } // namespace
 
-Evaluator::Evaluator(const std::unique_ptr<AST::Node>& astRootNode,
-                     const std::unordered_map<std::string, int>& operandLookupMap)
-    : mAstRootNode{astRootNode}
-    , mDependenciesLookupMap{operandLookupMap}
+Evaluator::Evaluator(const AST::Tree& ast, const Symbols::ValueSlots valueSlots)
+    : mAst{ast}
+    , mValueSlots{valueSlots}
 {
 }
 
 Evaluator::Result Evaluator::execute()
 {
-    if (!mAstRootNode) {
-        std::cerr << "Empty AST";
-        return {};
+    if (mAst.empty()) {
+        return Utils::Error{Utils::ErrorCode::EMPTY_PROGRAM, 0};
     }
 
-    const auto expressionValue = static_cast<int32_t>(analyseAndTraverseASTNode(mAstRootNode));
+    const auto expressionValue
+          = static_cast<int32_t>(analyseAndTraverseASTNode(mAst.getRootNodeIndex()));
 
     if (!mDependencies.empty()) {
         return mDependencies;
@@ -55,30 +56,36 @@ Evaluator::Result Evaluator::execute()
     return expressionValue;
 }
 
-float Evaluator::analyseAndTraverseASTNode(const std::unique_ptr<AST::Node>& node)
+float Evaluator::analyseAndTraverseASTNode(const AST::NodeIndex nodeIndex)
 {
-    const auto nodeValue = node->getNodeValue();
+    const auto& node = mAst.getNode(nodeIndex);
 
-    if (std::isdigit(nodeValue)) {
-        return static_cast<float>(nodeValue - '0');
-    } else if (std::isalpha(nodeValue)) {
+    switch (node.getNodeType()) {
+    case AST::NodeType::CONSTANT:
+        return static_cast<float>(node.getConstant());
 
-        const auto nodeValueString = {nodeValue};
+    case AST::NodeType::VARIABLE: {
+        const auto symbolId = node.getSymbolId();
 
-        // If the variable exists in the lookup map, return the corresponding value
-        if (mDependenciesLookupMap.contains(nodeValueString)) {
-            return static_cast<float>(mDependenciesLookupMap.at(nodeValueString));
+        // If the variable holds a value, return it
+        if (Symbols::isDefined(mValueSlots, symbolId)) {
+            return static_cast<float>(mValueSlots[symbolId].value);
         }
 
-        // Otherwise, add it as a dependencies
-        mDependencies.insert(nodeValueString);
+        // Otherwise, add it as a dependency
+        if (std::ranges::find(mDependencies, symbolId) == mDependencies.cend()) {
+            mDependencies.push_back(symbolId);
+        }
 
-    } else {
-        const auto leftNodeValue = analyseAndTraverseASTNode(node->getReferenceToLeftNodePointer());
-        const auto rightNodeValue
-              = analyseAndTraverseASTNode(node->getReferenceToRightNodePointer());
+        return 0.f;
+    }
 
-        return performArithmeticOperation(nodeValue, leftNodeValue, rightNodeValue);
+    case AST::NodeType::OPERATOR: {
+        const auto leftNodeValue = analyseAndTraverseASTNode(node.getLeftNodeIndex());
+        const auto rightNodeValue = analyseAndTraverseASTNode(node.getRightNodeIndex());
+
+        return performArithmeticOperation(node.getOperator(), leftNodeValue, rightNodeValue);
+    }
     }
 
     return 0.f;
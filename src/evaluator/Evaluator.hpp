@@ -1,12 +1,11 @@
 #pragma once
 
-#include <memory>
-#include <string>
 #include <variant>
-#include <unordered_map>
-#include <unordered_set>
+#include <vector>
 
 #include "ast/Node.hpp"
+#include "symbols/ValueSlot.hpp"
+#include "utils/Error.hpp"
 
 /**
  * @brief Class responsible for evaluating arithmetic expressions contained in an AST
@@ -16,30 +15,30 @@
 class Evaluator
 {
 public:
-    /// Alias representing a set of operands that are dependencies of an expression
-    using Dependencies = std::unordered_set<std::string>;
-    /// Alias representing the result of the evaluation: an value or a set of dependencies
-    using Result = std::variant<int, Dependencies>;
+    /// Alias representing the distinct operands that are dependencies of an expression
+    using Dependencies = std::vector<Symbols::SymbolId>;
+    /// Alias representing the result of the evaluation: a value, a set of dependencies or the
+    /// error that prevented the evaluation
+    using Result = std::variant<int, Dependencies, Utils::Error>;
 
     /**
      * @brief Class constructor
      *
-     * @param[in] astRootNode Reference to the root node of an (AST)
-     * @param[in] dependenciesLookupMap Map of operand names to their corresponding integer values
+     * @param[in] ast Reference to the AST to evaluate
+     * @param[in] valueSlots Values of the operands, indexed by their symbol identifier
      */
-    explicit Evaluator(const std::unique_ptr<AST::Node>& astRootNode,
-                       const std::unordered_map<std::string, int>& dependenciesLookupMap);
+    explicit Evaluator(const AST::Tree& ast, Symbols::ValueSlots valueSlots);
 
     /**
      * @brief Evaluates an AST holding an arithmetic expression and outputs a result
      *
      * During the evaluation, if dependencies are detected within the AST,
-     * the provided dependencies map is used for value lookup
+     * the provided value slots are used for value lookup
      *
      * If the evaluation is successful, the result will be the value o the expression
      *
      * However, if there are unresolved dependencies (variables) in the expression,
-     * the result will be those dependencies
+     * the result will be those dependencies (and an EMPTY_PROGRAM error if the AST is empty)
      *
      * @return Result of the arithmetic expression
      */
@@ -49,21 +48,21 @@ private:
     /**
      * @brief Helper method used to recursively traverse the AST and evaluate each node's content
      *
-     * @param[in] node Reference to an AST node to analyse
+     * @param[in] nodeIndex Index of the AST node to analyse
      *
      * @return Final value of the node
      */
-    [[nodiscard]] float analyseAndTraverseASTNode(const std::unique_ptr<AST::Node>& node);
+    [[nodiscard]] float analyseAndTraverseASTNode(AST::NodeIndex nodeIndex);
 
 private:
-    /// Reference to the AST root node
-    const std::unique_ptr<AST::Node>& mAstRootNode;
+    /// Reference to the AST being evaluated
+    const AST::Tree& mAst;
 
-    /// Map used to lookup the value of specific operands
-    ///( used to resolve dependencies when analysing an AST)
-    const std::unordered_map<std::string, int>& mDependenciesLookupMap;
+    /// Values used to lookup specific operands
+    /// (used to resolve dependencies when analysing an AST)
+    Symbols::ValueSlots mValueSlots;
 
-    /// Set of dependencies encountered during AST evaluation
-    /// (operands not found on the dependencies lookup map)
+    /// Dependencies encountered during AST evaluation
+    /// (operands without a value)
     Dependencies mDependencies;
 };
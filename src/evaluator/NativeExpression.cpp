@@ -0,0 +1,258 @@
+#include "NativeExpression.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) && defined(__unix__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace {
+/// Number of SSE registers, i.e. maximum stack depth of a translatable program
+constexpr uint32_t cRegisterCount{16};
+
+/// Register holding the address of the value slots (first argument in the System V ABI)
+constexpr uint8_t cValueSlotsRegister{7}; // rdi
+
+/**
+ * @brief Encoder of the few x86-64 instructions needed to run a program
+ *
+ * The N-th stack entry lives in register xmmN
+ */
+class CodeBuffer
+{
+public:
+    /**
+     * @brief Appends "mov eax, imm32; movd xmmN, eax"
+     *
+     * @param[in] destination Destination register
+     * @param[in] bits Bit pattern of the constant
+     */
+    void loadConstant(const uint8_t destination, const uint32_t bits)
+    {
+        mBytes.push_back(0xB8);
+        appendImmediate(bits);
+
+        mBytes.push_back(0x66);
+        appendRex(destination, 0);
+        mBytes.insert(mBytes.end(), {0x0F, 0x6E});
+        appendRegisters(destination, 0);
+    }
+
+    /**
+     * @brief Appends "cvtsi2ss xmmN, dword [rdi + offset]"
+     *
+     * @param[in] destination Destination register
+     * @param[in] offset Offset of the value within the value slots
+     */
+    void loadVariable(const uint8_t destination, const uint32_t offset)
+    {
+        mBytes.push_back(0xF3);
+        appendRex(destination, cValueSlotsRegister);
+        mBytes.insert(mBytes.end(), {0x0F, 0x2A});
+
+        // [base + disp32] addressing
+        mBytes.push_back(static_cast<uint8_t>(0x80 | ((destination & 7) << 3)
+                                              | (cValueSlotsRegister & 7)));
+        appendImmediate(offset);
+    }
+
+    /**
+     * @brief Appends a scalar single precision operation "op xmmN, xmmM"
+     *
+     * @param[in] opCode Arithmetic operation
+     * @param[in] destination Left operand and destination register
+     * @param[in] source Right operand register
+     */
+    void operate(const Bytecode::OpCode opCode, const uint8_t destination, const uint8_t source)
+    {
+        using Bytecode::OpCode;
+
+        uint8_t instruction{};
+        switch (opCode) {
+        case OpCode::ADD:
+            instruction = 0x58; // addss
+            break;
+        case OpCode::SUB:
+            instruction = 0x5C; // subss
+            break;
+        case OpCode::MUL:
+            instruction = 0x59; // mulss
+            break;
+        case OpCode::DIV:
+            instruction = 0x5E; // divss
+            break;
+        case OpCode::PUSH_CONST:
+        case OpCode::LOAD_VAR:
+            return;
+        }
+
+        mBytes.push_back(0xF3);
+        appendRex(destination, source);
+        mBytes.insert(mBytes.end(), {0x0F, instruction});
+        appendRegisters(destination, source);
+    }
+
+    /**
+     * @brief Appends "cvttss2si eax, xmm0; ret"
+     */
+    void returnTruncatedResult()
+    {
+        mBytes.insert(mBytes.end(), {0xF3, 0x0F, 0x2C, 0xC0, 0xC3});
+    }
+
+    /**
+     * @brief Getter for the encoded machine code
+     *
+     * @return Machine code
+     */
+    [[nodiscard]] const std::vector<uint8_t>& getBytes() const
+    {
+        return mBytes;
+    }
+
+private:
+    /**
+     * @brief Appends a REX prefix if any of the registers is an extended one
+     *
+     * @param[in] reg Register encoded in the 'reg' field of the ModRM byte
+     * @param[in] rm Register encoded in the 'rm' field of the ModRM byte
+     */
+    void appendRex(const uint8_t reg, const uint8_t rm)
+    {
+        if (reg >= 8 || rm >= 8) {
+            mBytes.push_back(static_cast<uint8_t>(0x40 | ((reg >> 3) << 2) | (rm >> 3)));
+        }
+    }
+
+    /**
+     * @brief Appends a register to register ModRM byte
+     *
+     * @param[in] reg Register encoded in the 'reg' field
+     * @param[in] rm Register encoded in the 'rm' field
+     */
+    void appendRegisters(const uint8_t reg, const uint8_t rm)
+    {
+        mBytes.push_back(static_cast<uint8_t>(0xC0 | ((reg & 7) << 3) | (rm & 7)));
+    }
+
+    /**
+     * @brief Appends a 32 bits little endian immediate
+     *
+     * @param[in] value Value of the immediate
+     */
+    void appendImmediate(const uint32_t value)
+    {
+        for (int shift = 0; shift < 32; shift += 8) {
+            mBytes.push_back(static_cast<uint8_t>(value >> shift));
+        }
+    }
+
+private:
+    /// Encoded machine code
+    std::vector<uint8_t> mBytes;
+};
+} // namespace
+
+std::optional<NativeExpression> NativeExpression::compile(const Bytecode::Program& program)
+{
+    if (program.empty() || program.getMaxStackDepth() > cRegisterCount) {
+        return std::nullopt;
+    }
+
+    CodeBuffer codeBuffer;
+    uint8_t stackDepth{0};
+
+    for (const auto& instruction : program.getInstructions()) {
+        using Bytecode::OpCode;
+
+        switch (instruction.opCode) {
+        case OpCode::PUSH_CONST:
+            codeBuffer.loadConstant(stackDepth++, instruction.operand);
+            break;
+        case OpCode::LOAD_VAR: {
+            const auto offset = uint64_t{instruction.operand} * sizeof(Symbols::ValueSlot)
+                                + offsetof(Symbols::ValueSlot, value);
+            if (offset > std::numeric_limits<int32_t>::max()) {
+                return std::nullopt;
+            }
+
+            codeBuffer.loadVariable(stackDepth++, static_cast<uint32_t>(offset));
+            break;
+        }
+        case OpCode::ADD:
+        case OpCode::SUB:
+        case OpCode::MUL:
+        case OpCode::DIV:
+            --stackDepth;
+            codeBuffer.operate(
+                  instruction.opCode, static_cast<uint8_t>(stackDepth - 1), stackDepth);
+            break;
+        }
+    }
+
+    codeBuffer.returnTruncatedResult();
+    const auto& bytes = codeBuffer.getBytes();
+
+#if defined(__x86_64__) && defined(__unix__)
+    // The mapping is never writable and executable at the same time
+    const auto pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    const auto codeSize = (bytes.size() + pageSize - 1) / pageSize * pageSize;
+
+    auto* code
+          = mmap(nullptr, codeSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (code == MAP_FAILED) {
+        return std::nullopt;
+    }
+
+    std::memcpy(code, bytes.data(), bytes.size());
+    if (mprotect(code, codeSize, PROT_READ | PROT_EXEC) != 0) {
+        munmap(code, codeSize);
+        return std::nullopt;
+    }
+
+    return NativeExpression(code, codeSize);
+#else
+    return std::nullopt;
+#endif
+}
+
+NativeExpression::NativeExpression(void* code, const std::size_t codeSize)
+    : mCode{code}
+    , mCodeSize{codeSize}
+{
+}
+
+NativeExpression::NativeExpression(NativeExpression&& other) noexcept
+    : mCode{std::exchange(other.mCode, nullptr)}
+    , mCodeSize{std::exchange(other.mCodeSize, 0)}
+{
+}
+
+NativeExpression& NativeExpression::operator=(NativeExpression&& other) noexcept
+{
+    if (this != &other) {
+        std::swap(mCode, other.mCode);
+        std::swap(mCodeSize, other.mCodeSize);
+    }
+
+    return *this;
+}
+
+NativeExpression::~NativeExpression()
+{
+#if defined(__x86_64__) && defined(__unix__)
+    if (mCode) {
+        munmap(mCode, mCodeSize);
+    }
+#endif
+}
+
+int32_t NativeExpression::execute(const Symbols::ValueSlots valueSlots) const
+{
+    return reinterpret_cast<Function>(mCode)(valueSlots.data());
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "bytecode/Program.hpp"
+#include "symbols/ValueSlot.hpp"
+
+/**
+ * @brief Compiled program translated to native x86-64 machine code
+ *
+ * The code is generated in its own executable memory mapping. Operands are loaded straight from
+ * the value slots and the whole computation happens in SSE registers (one per stack entry),
+ * with the same single precision arithmetic as the VirtualMachine, so both always agree.
+ *
+ * Only available on x86-64 POSIX systems: elsewhere, programs are never compiled and callers
+ * keep using the interpreter.
+ */
+class NativeExpression
+{
+public:
+    /**
+     * @brief Translates a program to machine code
+     *
+     * @param[in] program Program to translate
+     *
+     * @return Native expression (empty if the architecture is not supported, if the program
+     * needs more stack entries than there are registers or if no executable memory is available)
+     */
+    [[nodiscard]] static std::optional<NativeExpression> compile(const Bytecode::Program& program);
+
+    /**
+     * @brief Checks if programs can be translated to machine code on this system
+     *
+     * @return True if the JIT is supported (false otherwise)
+     */
+    [[nodiscard]] static constexpr bool isSupported()
+    {
+#if defined(__x86_64__) && defined(__unix__)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    NativeExpression(const NativeExpression&) = delete;
+    NativeExpression& operator=(const NativeExpression&) = delete;
+
+    NativeExpression(NativeExpression&& other) noexcept;
+    NativeExpression& operator=(NativeExpression&& other) noexcept;
+
+    /**
+     * @brief Class destructor, releases the executable memory
+     */
+    ~NativeExpression();
+
+    /**
+     * @brief Runs the machine code
+     *
+     * Unlike the VirtualMachine, variables are not checked: every variable read by the program
+     * must hold a value
+     *
+     * @param[in] valueSlots Values of the operands, indexed by their symbol identifier
+     *
+     * @return Value of the expression
+     */
+    [[nodiscard]] int32_t execute(Symbols::ValueSlots valueSlots) const;
+
+private:
+    /// Alias representing the signature of the generated code
+    using Function = int32_t (*)(const Symbols::ValueSlot*);
+
+    /**
+     * @brief Class constructor
+     *
+     * @param[in] code Executable mapping holding the machine code
+     * @param[in] codeSize Size of the mapping
+     */
+    NativeExpression(void* code, std::size_t codeSize);
+
+private:
+    /// Executable mapping holding the machine code
+    void* mCode{nullptr};
+
+    /// Size of the mapping
+    std::size_t mCodeSize{0};
+};
@@ -0,0 +1,141 @@
+#include "VirtualMachine.hpp"
+
+#include <array>
+#include <bit>
+#include <vector>
+
+namespace {
+/// Amount of stack entries that can be handled without heap allocations
+constexpr std::size_t cInlineBufferSize{64};
+
+/**
+ * @brief Scratch buffer that only allocates when the requested size exceeds its inline capacity
+ */
+class ScratchBuffer
+{
+public:
+    /**
+     * @brief Class constructor
+     *
+     * @param[in] size Number of values the buffer must hold
+     */
+    explicit ScratchBuffer(const std::size_t size)
+    {
+        if (size > mInlineValues.size()) {
+            mHeapValues.resize(size);
+            mValues = mHeapValues.data();
+        }
+    }
+
+    ScratchBuffer(const ScratchBuffer&) = delete;
+    ScratchBuffer& operator=(const ScratchBuffer&) = delete;
+
+    /**
+     * @brief Getter for the underlying storage
+     *
+     * @return Pointer to the first value of the buffer
+     */
+    [[nodiscard]] float* data()
+    {
+        return mValues;
+    }
+
+private:
+    /// Inline storage
+    std::array<float, cInlineBufferSize> mInlineValues{};
+    /// Heap storage (only used for large programs)
+    std::vector<float> mHeapValues;
+    /// Storage in use
+    float* mValues{mInlineValues.data()};
+};
+} // namespace
+
+VirtualMachine::VirtualMachine(const Bytecode::Program& program,
+                               const Symbols::ValueSlots valueSlots)
+    : mInstructions{program.getInstructions()}
+    , mVariables{program.getVariables()}
+    , mMaxStackDepth{program.getMaxStackDepth()}
+    , mValueSlots{valueSlots}
+{
+}
+
+VirtualMachine::VirtualMachine(const Bytecode::ImageFormula& formula,
+                               const std::span<const Symbols::SymbolId> symbolBindings,
+                               const Symbols::ValueSlots valueSlots)
+    : mInstructions{formula.instructions}
+    , mVariables{formula.variables}
+    , mMaxStackDepth{formula.maxStackDepth}
+    , mSymbolBindings{symbolBindings}
+    , mValueSlots{valueSlots}
+{
+}
+
+Evaluator::Result VirtualMachine::execute()
+{
+    if (mInstructions.empty()) {
+        return Utils::Error{Utils::ErrorCode::EMPTY_PROGRAM, 0};
+    }
+
+    // Image formulas refer to their variables by index, programs by symbol identifier
+    const auto resolveSymbol = [this](const uint32_t variable) {
+        return mSymbolBindings[variable];
+    };
+    const auto isBound = !mSymbolBindings.empty();
+
+    // Check every variable upfront, so that loads never have to
+    Evaluator::Dependencies dependencies;
+    for (const auto variable : mVariables) {
+        const auto symbolId = isBound ? resolveSymbol(variable) : variable;
+        if (!Symbols::isDefined(mValueSlots, symbolId)) {
+            dependencies.push_back(symbolId);
+        }
+    }
+
+    if (!dependencies.empty()) {
+        return dependencies;
+    }
+
+    if (isBound) {
+        return run(resolveSymbol);
+    }
+    return run([](const uint32_t variable) { return variable; });
+}
+
+template <typename SymbolResolver>
+int32_t VirtualMachine::run(const SymbolResolver& resolveSymbol) const
+{
+    // Interpreter loop: 'top' always points one past the last value on the stack
+    ScratchBuffer stack(mMaxStackDepth);
+    auto* top = stack.data();
+
+    for (const auto& instruction : mInstructions) {
+        using Bytecode::OpCode;
+
+        switch (instruction.opCode) {
+        case OpCode::PUSH_CONST:
+            *top++ = std::bit_cast<float>(instruction.operand);
+            break;
+        case OpCode::LOAD_VAR:
+            *top++ = static_cast<float>(mValueSlots[resolveSymbol(instruction.operand)].value);
+            break;
+        case OpCode::ADD:
+            --top;
+            top[-1] += *top;
+            break;
+        case OpCode::SUB:
+            --top;
+            top[-1] -= *top;
+            break;
+        case OpCode::MUL:
+            --top;
+            top[-1] *= *top;
+            break;
+        case OpCode::DIV:
+            --top;
+            top[-1] /= *top;
+            break;
+        }
+    }
+
+    return static_cast<int32_t>(*stack.data());
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <span>
+
+#include "bytecode/Program.hpp"
+#include "bytecode/ProgramImage.hpp"
+#include "evaluator/Evaluator.hpp"
+#include "symbols/ValueSlot.hpp"
+
+/**
+ * @brief Class responsible for executing compiled arithmetic expressions
+ *
+ * Programs are run on a value stack by a single non-recursive interpreter loop.
+ * Produces the same results as the Evaluator for the AST the program was compiled from.
+ * Formulas of a program image are executed in place, their variables being bound to symbols.
+ */
+class VirtualMachine
+{
+public:
+    /**
+     * @brief Class constructor
+     *
+     * @param[in] program Reference to the program to execute
+     * @param[in] valueSlots Values of the operands, indexed by their symbol identifier
+     */
+    explicit VirtualMachine(const Bytecode::Program& program, Symbols::ValueSlots valueSlots);
+
+    /**
+     * @brief Class constructor
+     *
+     * @param[in] formula Formula of a program image to execute (in place)
+     * @param[in] symbolBindings Symbol identifiers of the symbols of the image
+     * @param[in] valueSlots Values of the operands, indexed by their symbol identifier
+     */
+    VirtualMachine(const Bytecode::ImageFormula& formula,
+                   std::span<const Symbols::SymbolId> symbolBindings,
+                   Symbols::ValueSlots valueSlots);
+
+    /**
+     * @brief Executes the program and outputs a result
+     *
+     * The variables read by the program are checked before any instruction is executed.
+     * If some of them do not hold a value, the program is not executed
+     * and the result will be those dependencies (an EMPTY_PROGRAM error if there is no instruction)
+     *
+     * @return Result of the arithmetic expression
+     */
+    [[nodiscard]] Evaluator::Result execute();
+
+private:
+    /**
+     * @brief Runs the interpreter loop once every variable is known to hold a value
+     *
+     * @param[in] resolveSymbol Callable mapping the operand of a load to a symbol identifier
+     *
+     * @return Value of the arithmetic expression
+     */
+    template <typename SymbolResolver>
+    [[nodiscard]] int32_t run(const SymbolResolver& resolveSymbol) const;
+
+private:
+    /// Instructions being executed
+    std::span<const Bytecode::Instruction> mInstructions;
+
+    /// Variables read by the instructions
+    std::span<const Symbols::SymbolId> mVariables;
+
+    /// Maximum stack depth reached by the instructions
+    uint32_t mMaxStackDepth;
+
+    /// Symbol identifiers of the variables of an image formula (empty for programs)
+    std::span<const Symbols::SymbolId> mSymbolBindings;
+
+    /// Values used to lookup specific operands
+    Symbols::ValueSlots mValueSlots;
+};
@@ -1,27 +1,427 @@
 
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <vector>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "calculator/FormulaLibrary.hpp"
 #include "calculator/Runner.hpp"
+#include "server/EventLoop.hpp"
+#include "storage/Journal.hpp"
 
-int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[])
-{
-    Calculator::Runner calculator;
+namespace {
+/// Size of the chunks read from non-mappable inputs (pipes, terminals...)
+constexpr std::size_t cInputChunkSize{1 << 20};
+/// Amount of buffered output after which it is written out
+constexpr std::size_t cOutputFlushThreshold{1 << 20};
 
-    const auto getUserInputString = [] {
-        std::cout << "\nInput Arithmetic expression to evaluate: ";
-        std::string input;
-        std::getline(std::cin, input);
+/// Alias representing a callback invoked for every line of an input
+using LineHandler = std::function<void(std::string_view)>;
 
-        return input;
+/**
+ * @brief Processes an instruction and appends its results to an output buffer
+ *
+ * Results are separated by commas and terminated by a new line (nothing is appended if empty).
+ * If the instruction is rejected, the reason is appended to the diagnostics buffer instead
+ *
+ * @param[in,out] calculator Calculator processing the instruction
+ * @param[in] instruction Instruction to process
+ * @param[in,out] output Output buffer
+ * @param[in,out] diagnostics Diagnostics buffer
+ */
+void processInstruction(Calculator::Runner& calculator,
+                        const std::string_view instruction,
+                        std::string& output,
+                        std::string& diagnostics)
+{
+    const auto outputSize = output.size();
+
+    const auto appendResult = [&output, outputSize](const std::string_view result) {
+        if (output.size() != outputSize) {
+            output.append(", ");
+        }
+        output.append(result);
     };
+    const auto instructionResult = calculator.processInstruction(instruction, appendResult);
+
+    if (output.size() != outputSize) {
+        output.push_back('\n');
+    }
+
+    if (!instructionResult) {
+        const auto error = instructionResult.getError();
+        diagnostics.append(calculator.describeError(error));
+        diagnostics.append(" (at offset ").append(std::to_string(error.offset)).append(")\n");
+    }
+}
+
+/**
+ * @brief Writes an output buffer to the standard output, a diagnostics buffer to the standard
+ * error, and empties them
+ *
+ * @param[in,out] output Output buffer
+ * @param[in,out] diagnostics Diagnostics buffer
+ */
+void flushOutput(std::string& output, std::string& diagnostics)
+{
+    std::fwrite(output.data(), 1, output.size(), stdout);
+    output.clear();
+
+    if (!diagnostics.empty()) {
+        std::fflush(stdout);
+        std::fwrite(diagnostics.data(), 1, diagnostics.size(), stderr);
+        diagnostics.clear();
+    }
+}
+
+/**
+ * @brief Splits a block of text into lines (without their line terminators)
+ *
+ * @param[in] text Text to split
+ * @param[in] handleLine Callback invoked for every complete line
+ *
+ * @return Trailing part of the text that is not terminated by a new line
+ */
+std::string_view splitLines(std::string_view text, const LineHandler& handleLine)
+{
+    while (const auto* lineEnd
+           = static_cast<const char*>(std::memchr(text.data(), '\n', text.size()))) {
+        const auto lineLength = static_cast<std::size_t>(lineEnd - text.data());
+
+        auto line = text.substr(0, lineLength);
+        if (line.ends_with('\r')) {
+            line.remove_suffix(1);
+        }
+
+        handleLine(line);
+        text.remove_prefix(lineLength + 1);
+    }
+
+    return text;
+}
+
+/**
+ * @brief Reads every line of a file descriptor
+ *
+ * Regular files are memory mapped, any other input is read in large chunks
+ *
+ * @param[in] fileDescriptor File descriptor to read from
+ * @param[in] handleLine Callback invoked for every line
+ *
+ * @return True if the whole input was read (false otherwise)
+ */
+bool readLines(const int fileDescriptor, const LineHandler& handleLine)
+{
+    struct stat fileStatus{};
+    if (fstat(fileDescriptor, &fileStatus) == 0 && S_ISREG(fileStatus.st_mode)
+        && fileStatus.st_size > 0) {
+
+        const auto fileSize = static_cast<std::size_t>(fileStatus.st_size);
+        auto* const mapping = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+
+        if (mapping != MAP_FAILED) {
+            madvise(mapping, fileSize, MADV_SEQUENTIAL);
+
+            const auto remainder
+                  = splitLines({static_cast<const char*>(mapping), fileSize}, handleLine);
+            if (!remainder.empty()) {
+                handleLine(remainder);
+            }
+
+            munmap(mapping, fileSize);
+            return true;
+        }
+    }
+
+    // Fall back to chunked reads, carrying incomplete lines over to the next chunk
+    std::vector<char> buffer(cInputChunkSize);
+    std::size_t carriedOver{0};
 
     while (true) {
-        const auto operationResults = calculator.processInstruction(getUserInputString());
+        if (carriedOver == buffer.size()) {
+            buffer.resize(2 * buffer.size());
+        }
+
+        const auto bytesRead
+              = read(fileDescriptor, buffer.data() + carriedOver, buffer.size() - carriedOver);
+        if (bytesRead < 0) {
+            return false;
+        }
+
+        if (bytesRead == 0) {
+            if (carriedOver > 0) {
+                handleLine({buffer.data(), carriedOver});
+            }
+            return true;
+        }
+
+        const auto remainder = splitLines(
+              {buffer.data(), carriedOver + static_cast<std::size_t>(bytesRead)}, handleLine);
+
+        std::memmove(buffer.data(), remainder.data(), remainder.size());
+        carriedOver = remainder.size();
+    }
+}
+
+/**
+ * @brief Processes every instruction of a script without prompting the user
+ *
+ * Results are accumulated in a large output buffer and a throughput summary is written
+ * to the standard error once the whole script was processed
+ *
+ * When the state is durable, the instructions are committed to the journal in groups,
+ * before their results are written out
+ *
+ * @param[in,out] calculator Calculator processing the instructions
+ * @param[in] fileDescriptor File descriptor of the script
+ * @param[in,out] journal Journal making the state durable (null if it is not)
+ *
+ * @return Process exit code
+ */
+int runBatch(Calculator::Runner& calculator, const int fileDescriptor, Storage::Journal* journal)
+{
+    std::string output;
+    output.reserve(cOutputFlushThreshold + cInputChunkSize);
+    std::string diagnostics;
+
+    std::string instruction;
+    uint64_t instructionCount{0};
+    bool isCommitted{true};
+
+    const auto startTime = std::chrono::steady_clock::now();
+
+    const auto isInputRead = readLines(fileDescriptor, [&](const std::string_view line) {
+        if (!isCommitted || line.find_first_not_of(" \t") == std::string_view::npos) {
+            return;
+        }
+
+        instruction.assign(line);
+        processInstruction(calculator, instruction, output, diagnostics);
+        ++instructionCount;
+
+        if (journal) {
+            journal->record(instruction);
+        }
+
+        if (output.size() + diagnostics.size() >= cOutputFlushThreshold) {
+            isCommitted = !journal || journal->commit();
+            if (isCommitted) {
+                flushOutput(output, diagnostics);
+            }
+        }
+    });
+
+    isCommitted = isCommitted && (!journal || journal->commit());
+    if (!isCommitted) {
+        std::perror("Failed to commit instructions");
+        return 1;
+    }
+
+    flushOutput(output, diagnostics);
+    std::fflush(stdout);
+
+    const std::chrono::duration<double> elapsedTime = std::chrono::steady_clock::now() - startTime;
 
-        for (auto itr = operationResults.cbegin(); itr != operationResults.cend(); ++itr) {
-            std::cout << *itr << (std::next(itr) != operationResults.cend() ? ", " : "\n");
+    if (!isInputRead) {
+        std::perror("Failed to read instructions");
+        return 1;
+    }
+
+    const auto elapsedSeconds = elapsedTime.count();
+    std::fprintf(stderr,
+                 "Processed %llu instructions in %.3f s (%.0f instructions/s)\n",
+                 static_cast<unsigned long long>(instructionCount),
+                 elapsedSeconds,
+                 elapsedSeconds > 0. ? static_cast<double>(instructionCount) / elapsedSeconds
+                                     : 0.);
+
+    return 0;
+}
+
+/**
+ * @brief Prompts the user for instructions until the end of the input
+ *
+ * When the state is durable, every instruction is committed to the journal before its results
+ * are printed
+ *
+ * @param[in,out] calculator Calculator processing the instructions
+ * @param[in,out] journal Journal making the state durable (null if it is not)
+ *
+ * @return Process exit code
+ */
+int runInteractive(Calculator::Runner& calculator, Storage::Journal* journal)
+{
+    const auto getUserInputString = [](std::string& input) -> bool {
+        std::cout << "\nInput Arithmetic expression to evaluate: ";
+        return static_cast<bool>(std::getline(std::cin, input));
+    };
+
+    std::string input;
+    std::string output;
+    std::string diagnostics;
+
+    while (getUserInputString(input)) {
+        processInstruction(calculator, input, output, diagnostics);
+
+        if (journal) {
+            journal->record(input);
+            if (!journal->commit()) {
+                std::perror("Failed to commit instruction");
+                return 1;
+            }
         }
+
+        std::cout << output;
+        output.clear();
+        std::cerr << diagnostics;
+        diagnostics.clear();
     }
 
+    std::cout << "\n";
     return 0;
-}
\ No newline at end of file
+}
+
+/// Server stopped by the termination signals
+Server::EventLoop* gServer{nullptr};
+
+/**
+ * @brief Serves calculator sessions on an endpoint until the process is interrupted
+ *
+ * @param[in] endpointText Endpoint to listen on (e.g. "unix:/tmp/calculator.sock" or "7000")
+ *
+ * @return Process exit code
+ */
+int runServer(const std::string_view endpointText)
+{
+    const auto endpoint = Server::Endpoint::parse(endpointText);
+    if (!endpoint) {
+        std::cerr << "Invalid endpoint: \'" << endpointText << "\'\n";
+        return 1;
+    }
+
+    Server::raiseFileDescriptorLimit();
+
+    Server::EventLoop server;
+    if (!server.listen(*endpoint)) {
+        std::perror("Failed to listen");
+        return 1;
+    }
+
+    gServer = &server;
+    struct sigaction stopAction{};
+    stopAction.sa_handler = [](int) { gServer->stop(); };
+    sigaction(SIGINT, &stopAction, nullptr);
+    sigaction(SIGTERM, &stopAction, nullptr);
+
+    std::cerr << "Listening on " << endpointText << "\n";
+    const auto isStopped = server.run();
+
+    signal(SIGINT, SIG_DFL);
+    signal(SIGTERM, SIG_DFL);
+    gServer = nullptr;
+
+    if (!isStopped) {
+        std::perror("Failed to wait for events");
+        return 1;
+    }
+
+    return 0;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    // Server session: every connection gets its own calculator
+    if (argc == 3 && std::string_view(argv[1]) == "--listen") {
+        return runServer(argv[2]);
+    }
+
+    Calculator::Runner calculator;
+    std::unique_ptr<Calculator::Tracer> tracer;
+    std::optional<Storage::Journal> journal;
+
+    // Traced session: the processing of the instructions is recorded into a trace file
+    if (argc >= 3 && std::string_view(argv[1]) == "--trace") {
+        tracer = Calculator::Tracer::open(argv[2]);
+        if (!tracer) {
+            std::perror(argv[2]);
+            return 1;
+        }
+        calculator.setTracer(tracer.get());
+
+        argv[2] = argv[0];
+        argv += 2;
+        argc -= 2;
+    }
+
+    // Durable session: the state is recovered from the data directory and logged to it
+    if (argc >= 3 && std::string_view(argv[1]) == "--data-dir") {
+        journal = Storage::Journal::open(argv[2], calculator);
+        if (!journal) {
+            std::perror(argv[2]);
+            return 1;
+        }
+
+        argv[2] = argv[0];
+        argv += 2;
+        argc -= 2;
+    }
+    // Session starting with precompiled formulas, registered straight from the mapped image
+    else if (argc >= 3 && std::string_view(argv[1]) == "--formulas") {
+        const auto formulaLibrary = Calculator::FormulaLibrary::open(argv[2]);
+        if (!formulaLibrary) {
+            std::perror(argv[2]);
+            return 1;
+        }
+
+        [[maybe_unused]] const auto results
+              = calculator.registerFormulas(formulaLibrary->getImage());
+        std::cerr << "Registered " << formulaLibrary->getImage().getFormulaCount()
+                  << " formulas from " << argv[2] << "\n";
+
+        argv[2] = argv[0];
+        argv += 2;
+        argc -= 2;
+    }
+
+    auto* const journalPointer = journal ? &*journal : nullptr;
+
+    // Interactive session: no script was provided and the user is typing on a terminal
+    if (argc == 1 && isatty(STDIN_FILENO)) {
+        return runInteractive(calculator, journalPointer);
+    }
+
+    // Batch session: the script is either the provided file or the standard input
+    if (argc == 1 || (argc == 2 && std::string_view(argv[1]) == "-")) {
+        return runBatch(calculator, STDIN_FILENO, journalPointer);
+    }
+
+    if (argc == 2) {
+        const auto fileDescriptor = open(argv[1], O_RDONLY | O_CLOEXEC);
+        if (fileDescriptor < 0) {
+            std::perror(argv[1]);
+            return 1;
+        }
+
+        const auto exitCode = runBatch(calculator, fileDescriptor, journalPointer);
+        close(fileDescriptor);
+
+        return exitCode;
+    }
+
+    std::cerr << "Usage: " << argv[0]
+              << " [--trace file] [--data-dir directory | --formulas image] [script | -]"
+                 " | --listen endpoint\n";
+    return 1;
+}
@@ -1,84 +1,93 @@
 #include "Parser.hpp"
 
 #include <algorithm>
-#include <cctype>
-#include <iostream>
-#include <ranges>
+#include <array>
+#include <charconv>
+#include <limits>
 #include <utility>
-#include <vector>
-#include <unordered_set>
 
 #include "ast/Node.hpp"
+#include "bytecode/Compiler.hpp"
+#include "bytecode/Optimizer.hpp"
 #include "utils/Constants.hpp"
-#include "utils/Methods.hpp"
 
 namespace {
 using namespace Utils::Constants;
+using Utils::ErrorCode;
 
 /**
- * @brief Checks if the provided character is a parenthesis
- *
- * @param[in] character Character to evaluate
- *
- * @return True if is a supported parenthesis (false otherwise)
+ * @brief Classes of characters an instruction is made of
  */
-constexpr bool isParenthesis(const char character)
-{
-    switch (character) {
-    case cLeftParenthesis:
-    case cRightParenthesis:
-        return true;
-    default:
-        return false;
+enum class CharacterClass : uint8_t {
+
+    INVALID = 0,           // Character not supported in any instruction
+    WHITE_SPACE = 1,       // Separator between tokens
+    DIGIT = 2,             // Part of an integer literal or of an operand name
+    LETTER = 3,            // Start of an operand name (or of a command)
+    UNDERSCORE = 4,        // Part of an operand name
+    OPERATOR = 5,          // Binary arithmetic operator
+    LEFT_PARENTHESIS = 6,  // Start of a sub-expression
+    RIGHT_PARENTHESIS = 7, // End of a sub-expression
+    ASSIGNMENT = 8         // Separator between the LHS and the RHS of an arithmetic expression
+};
+
+/// Class of every possible character, indexed by the character's value
+constexpr auto cCharacterClasses = [] {
+    std::array<CharacterClass, std::numeric_limits<unsigned char>::max() + 1> characterClasses{};
+
+    for (const auto character : {' ', '\t', '\n', '\v', '\f', '\r'}) {
+        characterClasses[static_cast<unsigned char>(character)] = CharacterClass::WHITE_SPACE;
     }
-}
-
-/**
- * @brief Checks if the provided character is a valid binary operator
- *
- * @param[in] character Character to evaluate
- *
- * @return True if is a supported operator (false otherwise)
- */
-constexpr bool isOperator(const char character)
-{
-    switch (character) {
-    case cAddOp:
-    case cSubOp:
-    case cMultOp:
-    case cDivOp:
-        return true;
-    default:
-        return false;
+    for (auto character = '0'; character <= '9'; ++character) {
+        characterClasses[static_cast<unsigned char>(character)] = CharacterClass::DIGIT;
     }
-}
+    for (auto character = 'a'; character <= 'z'; ++character) {
+        characterClasses[static_cast<unsigned char>(character)] = CharacterClass::LETTER;
+    }
+    for (auto character = 'A'; character <= 'Z'; ++character) {
+        characterClasses[static_cast<unsigned char>(character)] = CharacterClass::LETTER;
+    }
+    for (const auto character : {cAddOp, cSubOp, cMultOp, cDivOp}) {
+        characterClasses[static_cast<unsigned char>(character)] = CharacterClass::OPERATOR;
+    }
+
+    characterClasses[static_cast<unsigned char>('_')] = CharacterClass::UNDERSCORE;
+    characterClasses[static_cast<unsigned char>(cLeftParenthesis)]
+          = CharacterClass::LEFT_PARENTHESIS;
+    characterClasses[static_cast<unsigned char>(cRightParenthesis)]
+          = CharacterClass::RIGHT_PARENTHESIS;
+    characterClasses[static_cast<unsigned char>(cAssignOp)] = CharacterClass::ASSIGNMENT;
+
+    return characterClasses;
+}();
 
 /**
- * @brief Checks if the provided character is a single digit integer
+ * @brief Retrieves the class of a character
  *
- * @param[in] previousCharacter Adjacent character to evaluate (cannot be a digit)
- * @param[in] character Character to evaluate
+ * @param[in] character Character to classify
  *
- * @return True if is a single digit character (false otherwise)
+ * @return Class of the character
  */
-constexpr bool isSingleDigitInteger(const char previousCharacter, const char character)
+constexpr CharacterClass getCharacterClass(const char character)
 {
-    return !std::isdigit(previousCharacter) && std::isdigit(character);
+    return cCharacterClasses[static_cast<unsigned char>(character)];
 }
 
 /**
- * @brief Checks if the provided character is a unary minus
+ * @brief Checks if the provided character can be part of an operand name
+ *
+ * Operand names start with a letter, which can be followed by letters, digits or underscores
  *
- * @param[in] previousCharacter Adjacent character to evaluate (cannot be an operator, space or '(')
  * @param[in] character Character to evaluate
  *
- * @return True if character is an unary minus (false otherwise)
+ * @return True if the character can be part of an operand name (false otherwise)
  */
-constexpr bool isUnaryMinus(const char previousCharacter, const char character)
+constexpr bool isOperandNameCharacter(const char character)
 {
-    return character == cSubOp
-           && (isOperator(previousCharacter) || std::isspace(previousCharacter)
-               || previousCharacter == cLeftParenthesis);
+    const auto characterClass = getCharacterClass(character);
+
+    return characterClass == CharacterClass::LETTER || characterClass == CharacterClass::DIGIT
+           || characterClass == CharacterClass::UNDERSCORE;
 }
 
 /**
@@ -117,221 +126,385 @@ constexpr uint8_t operatorPrecedence(const char op)
 }
 } // namespace
 
-Parser::Parser(const std::string& inputToParse)
-    : mInputString{inputToParse}
-    , mRHSValueStack{std::make_unique<ASTofRSH>()}
+Parser::Parser(const std::string_view inputToParse, Symbols::SymbolTable& symbolTable)
+    : mSymbolTable{symbolTable}
+    , mInput{inputToParse}
+{
+}
+
+bool Parser::isOperandName(const std::string_view name)
 {
+    return !name.empty() && getCharacterClass(name.front()) == CharacterClass::LETTER
+           && std::ranges::all_of(name, isOperandNameCharacter);
 }
 
-bool Parser::execute()
+Utils::Expected<> Parser::execute()
 {
-    Utils::Methods::removeWhiteSpacesFromString(mInputString);
+    mPosition = 0;
+    mNewOperandNames.clear();
+    mNewOperandIds.clear();
+    skipWhiteSpaces();
+
+    // Every instruction starts with either an operand name or a command
+    const auto operandName = readOperandName();
+    if (operandName.empty()) {
+        return makeError(ErrorCode::INVALID_INSTRUCTION);
+    }
+
+    const auto operandNameEnd = mPosition;
+    skipWhiteSpaces();
+
+    if (mPosition == mInput.size()) {
+        if (operandName == cStatsCommand) {
+            mInstructionType = InstructionType::STATS;
+            mIsMachineReadable = false;
+            return {};
+        }
+
+        mInstructionType = InstructionType::RESULT;
+        if (operandName != cResultCommand) {
+            return Utils::Error{ErrorCode::INVALID_INSTRUCTION, operandNameEnd};
+        }
+
+        return {};
+    }
+
+    if (getCharacterClass(mInput[mPosition]) != CharacterClass::ASSIGNMENT) {
+        // Commands and their argument are separated by white spaces
+        if (mPosition == operandNameEnd) {
+            return makeError(ErrorCode::INVALID_INSTRUCTION);
+        }
+
+        if (operandName == cCheckpointCommand || operandName == cRestoreCommand) {
+            mInstructionType = operandName == cCheckpointCommand ? InstructionType::CHECKPOINT
+                                                                 : InstructionType::RESTORE;
+            return parseCheckpointName();
+        }
 
-    const auto inputStringTokens
-          = Utils::Methods::splitString(mInputString, Utils::Constants::cAssignOp);
+        if (operandName == cStatsCommand) {
+            mInstructionType = InstructionType::STATS;
+            return parseStatsFormat();
+        }
+
+        mInstructionType = InstructionType::UNDO;
+        if (operandName != cUndoCommand) {
+            return Utils::Error{ErrorCode::INVALID_INSTRUCTION, operandNameEnd};
+        }
 
-    if (inputStringTokens.size() != 2) {
-        return false;
+        return parseUndoCount();
     }
 
-    mLHSString = inputStringTokens.front();
-    mRHSString = inputStringTokens.back();
+    // Skip the assignment operator
+    ++mPosition;
 
-    return parseLHS() && parseRHS();
+    // TODO[FM]: Add support for a more complex parsing.
+    // Ideally we would also create an AST for the LHS but for now,
+    // we only support LHS values with a single operand name
+    // (e.g. 'x' from "x=2+2" or 'total' from "total=a+b")
+    mInstructionType = InstructionType::ASSIGNMENT;
+    mLHSOperand = resolveOperandName(operandName);
+
+    if (auto parsingResult = parseRHS(); !parsingResult) {
+        return parsingResult;
+    }
+    internNewOperandNames();
+
+    mRHSProgram = Bytecode::compile(Bytecode::simplify(mRHSAST));
+    return {};
 }
 
-std::string Parser::getOperandOfLHS() const
+Parser::InstructionType Parser::getInstructionType() const
 {
-    return mLHSString;
+    return mInstructionType;
 }
 
-std::shared_ptr<Parser::ASTofRSH> Parser::getASTOfRHS() const
+int Parser::getUndoCount() const
 {
-    return mRHSValueStack;
+    return mUndoCount;
 }
 
-bool Parser::parseLHS()
+std::string_view Parser::getCheckpointName() const
 {
-    // TODO[FM]: Add support for a more complex parsing.
-    // Ideally we would also create an AST for the LHS but for now,
-    // we only support LHS values with a single letter operands
-    // (e.g. 'x' from in "x=2+2")
-    if (mLHSString.size() != 1) {
-        return false;
-    }
+    return mCheckpointName;
+}
 
-    return true;
+bool Parser::isMachineReadable() const
+{
+    return mIsMachineReadable;
 }
 
-bool Parser::parseRHS()
+Symbols::SymbolId Parser::getOperandOfLHS() const
 {
-    return validateRHS() && createASTforRHS();
+    return mLHSOperand;
 }
 
-bool Parser::validateRHS()
+const Parser::ASTofRSH& Parser::getASTOfRHS() const
 {
-    if (mRHSString.empty()) {
-        std::cerr << "Empty expression provided" << "\n";
-        return false;
-    }
+    return mRHSAST;
+}
 
-    // String will be wrapped around parenthesis for easier parsing
-    std::string validatedString{cLeftParenthesis};
-    validatedString.reserve(mRHSString.size());
+Parser::ASTofRSH Parser::extractASTOfRHS()
+{
+    return std::exchange(mRHSAST, {});
+}
 
-    uint32_t leftParenthesisCounter{0};
-    uint32_t rightParenthesisCounter{0};
+const Bytecode::Program& Parser::getProgramOfRHS() const
+{
+    return mRHSProgram;
+}
 
-    for (const auto& character : mRHSString) {
+Bytecode::Program Parser::extractProgramOfRHS()
+{
+    return std::exchange(mRHSProgram, {});
+}
 
-        const auto& previousValidCharacter = validatedString.back();
+void Parser::skipWhiteSpaces()
+{
+    while (mPosition < mInput.size()
+           && getCharacterClass(mInput[mPosition]) == CharacterClass::WHITE_SPACE) {
+        ++mPosition;
+    }
+}
 
-        // Check digit validity
-        // TODO: Add support for expressions with integers with more than one digit
-        if (isSingleDigitInteger(previousValidCharacter, character)) {
+std::string_view Parser::readOperandName()
+{
+    if (mPosition == mInput.size()
+        || getCharacterClass(mInput[mPosition]) != CharacterClass::LETTER) {
+        return {};
+    }
 
-            // Right parenthesis should not be followed by a digit (e.g. ")2" )
-            if (previousValidCharacter == cRightParenthesis) {
-                std::cerr << "Invalid expression provided" << "\n";
-                return false;
-            }
-        }
-        // Check operator validity
-        else if (isOperator(character)) {
+    const auto nameStart = mPosition;
+    while (++mPosition < mInput.size() && isOperandNameCharacter(mInput[mPosition])) {
+    }
 
-            // Check if the operator is used as a unary minus
-            // TODO: Add support for expressions with negative integers (e.g. "-2*3")
-            if (isUnaryMinus(previousValidCharacter, character)) {
-                std::cout << "Negative values are not currently supported" << "\n";
-                return false;
-            }
+    return mInput.substr(nameStart, mPosition - nameStart);
+}
 
-            // Check if the previous character was not and operator or a left parenthesis
-            // (e.g. "++2" or ")+2")
-            if (isOperator(previousValidCharacter) || previousValidCharacter == cLeftParenthesis) {
-                std::cerr << "Invalid expression provided" << "\n";
-                return false;
-            }
-        }
-        // Check parenthesis validity
-        else if (isParenthesis(character)) {
-
-            // Keep tabs on the amount of parenthesis pairs
-            if (character == cLeftParenthesis) {
-                ++leftParenthesisCounter;
-            } else if (character == cRightParenthesis) {
-                ++rightParenthesisCounter;
-            }
+Utils::Expected<> Parser::parseUndoCount()
+{
+    const auto argumentStart = mPosition;
+    while (mPosition < mInput.size()
+           && getCharacterClass(mInput[mPosition]) != CharacterClass::WHITE_SPACE) {
+        ++mPosition;
+    }
+    const auto argumentEnd = mPosition;
 
-            // Left parenthesis should not be preceded by a digit (e.g. "2("))
-            // TODO: Add support for expressions with implicit multiplication
-            if (character == cLeftParenthesis && std::isdigit(previousValidCharacter)) {
-                std::cerr << "Invalid expression provided" << "\n";
-                return false;
-            }
-        }
-        // Account for single character variables
-        else if (!std::isalpha(character)) {
-            std::cerr << "Invalid expression provided" << "\n";
-            return false;
-        }
+    // The argument must be the last token of the instruction
+    skipWhiteSpaces();
+    if (mPosition != mInput.size()) {
+        return makeError(ErrorCode::INVALID_ARGUMENT);
+    }
 
-        validatedString.push_back(character);
+    const auto [numberEnd, errorCode] = std::from_chars(
+          mInput.data() + argumentStart, mInput.data() + argumentEnd, mUndoCount);
+    if (errorCode != std::errc{}) {
+        mUndoCount = -1;
     }
 
-    // Validate the amount of parenthesis pairs
-    if (leftParenthesisCounter != rightParenthesisCounter) {
-        std::cerr << "Parenthesis do not match" << "\n";
-        return false;
+    return {};
+}
+
+Utils::Expected<> Parser::parseCheckpointName()
+{
+    mCheckpointName = readOperandName();
+
+    // The name must be the last token of the instruction
+    skipWhiteSpaces();
+    if (mCheckpointName.empty() || mPosition != mInput.size()) {
+        return makeError(ErrorCode::INVALID_ARGUMENT);
     }
 
-    // Validate that the expression does not end with an operator
-    if (isOperator(validatedString.back())) {
-        std::cerr << "Invalid expression provided" << "\n";
-        return false;
+    return {};
+}
+
+Utils::Expected<> Parser::parseStatsFormat()
+{
+    const auto formatStart = mPosition;
+    const auto format = readOperandName();
+
+    mIsMachineReadable = format == cStatsJsonFormat;
+    if (!mIsMachineReadable) {
+        return Utils::Error{ErrorCode::INVALID_ARGUMENT, formatStart};
     }
 
-    // Finalize the string wrapping by adding a right parenthesis at the end
-    validatedString.append(1, cRightParenthesis);
-    mRHSString.swap(validatedString);
-    mRHSString.shrink_to_fit();
+    // The format must be the last token of the instruction
+    skipWhiteSpaces();
+    if (mPosition != mInput.size()) {
+        return makeError(ErrorCode::INVALID_ARGUMENT);
+    }
 
-    return true;
+    return {};
 }
 
-bool Parser::createASTforRHS()
+Utils::Expected<> Parser::parseRHS()
 {
-    if (mRHSString.empty()) {
-        std::cerr << "Empty expression provided" << "\n";
-        return false;
+    skipWhiteSpaces();
+    if (mPosition == mInput.size()) {
+        return makeError(ErrorCode::EMPTY_EXPRESSION);
     }
 
-    // Helper lambda used to add new nodes to the AST
-    const auto generateNewNode = [this]() {
-        if (!mRHSOperatorStack.empty() && !mRHSValueStack->empty()) {
+    // Every remaining character yields at most one node: reserving upfront keeps the node pool
+    // to a single allocation
+    const auto remainingCharacterCount = mInput.size() - mPosition;
+    mRHSAST = ASTofRSH(remainingCharacterCount);
+    mRHSValueStack.clear();
+    mRHSValueStack.reserve(remainingCharacterCount);
+    mRHSOperatorStack.clear();
+    mRHSOperatorStack.reserve(remainingCharacterCount);
 
-            const auto operation = mRHSOperatorStack.top();
-            mRHSOperatorStack.pop();
+    // Tokens alternate between operands (literals, operand names or sub-expressions)
+    // and binary operators
+    bool isExpectingOperand{true};
+    uint32_t openParenthesisCounter{0};
 
-            auto rightValue = std::move(mRHSValueStack->top());
-            mRHSValueStack->pop();
+    while (mPosition < mInput.size()) {
 
-            auto leftValue = std::move(mRHSValueStack->top());
-            mRHSValueStack->pop();
+        const auto character = mInput[mPosition];
+        const auto characterClass = getCharacterClass(character);
 
-            mRHSValueStack->emplace(std::make_unique<AST::Node>(
-                  operation, std::move(leftValue), std::move(rightValue)));
+        if (characterClass == CharacterClass::WHITE_SPACE) {
+            ++mPosition;
+            continue;
         }
-    };
 
-    // Analyse input
-    for (const auto& character : mRHSString) {
+        if (isExpectingOperand) {
 
-        // Account for the possibility that we might have either a number or a variable in the
-        // provided string
-        if (std::isdigit(character) || std::isalpha(character)) {
-            mRHSValueStack->emplace(std::make_unique<AST::Node>(character));
+            if (characterClass == CharacterClass::DIGIT) {
+                int32_t literal{};
+                const auto [literalEnd, errorCode] = std::from_chars(
+                      mInput.data() + mPosition, mInput.data() + mInput.size(), literal);
 
-        } else if (isOperator(character)) {
+                if (errorCode != std::errc{}) {
+                    return makeError(ErrorCode::LITERAL_TOO_LARGE);
+                }
+
+                mRHSValueStack.push_back(mRHSAST.addConstant(literal));
+                mPosition = static_cast<std::size_t>(literalEnd - mInput.data());
+                isExpectingOperand = false;
+                continue;
+            }
+
+            if (characterClass == CharacterClass::LETTER) {
+
+                // Operand names are resolved once, here, so that they are only handled through
+                // their symbol identifiers from now on
+                mRHSValueStack.push_back(
+                      mRHSAST.addVariable(resolveOperandName(readOperandName())));
+                isExpectingOperand = false;
+                continue;
+            }
+
+            if (characterClass == CharacterClass::LEFT_PARENTHESIS) {
+                mRHSOperatorStack.push_back(character);
+                ++openParenthesisCounter;
+                ++mPosition;
+                continue;
+            }
+
+            // TODO: Add support for expressions with negative integers (e.g. "-2*3")
+            if (character == cSubOp) {
+                return makeError(ErrorCode::NEGATIVE_VALUE);
+            }
+
+            // Operand names should start with a letter, operators should not follow another
+            // operator or a left parenthesis (e.g. "_a", "++2" or "(*2")
+            return makeError(ErrorCode::UNEXPECTED_CHARACTER);
+        }
+
+        if (characterClass == CharacterClass::OPERATOR) {
 
             // Generate new nodes until an operator with a lower precedence
             // than the new one is found on the top of the operator stack
             while (!mRHSOperatorStack.empty()
-                   && operatorPrecedence(mRHSOperatorStack.top())
+                   && operatorPrecedence(mRHSOperatorStack.back())
                             >= operatorPrecedence(character)) {
-                generateNewNode();
+                generateOperatorNode();
             }
 
-            mRHSOperatorStack.push(character);
+            mRHSOperatorStack.push_back(character);
+            isExpectingOperand = true;
 
-        } else if (character == cLeftParenthesis) {
-            mRHSOperatorStack.push(character);
+        } else if (characterClass == CharacterClass::RIGHT_PARENTHESIS) {
 
-        } else if (character == cRightParenthesis) {
-
-            // Generate new nodes until we reach the closest left parenthesis
-            while (!mRHSOperatorStack.empty() && mRHSOperatorStack.top() != cLeftParenthesis) {
-                generateNewNode();
+            if (openParenthesisCounter == 0) {
+                return makeError(ErrorCode::UNMATCHED_PARENTHESIS);
             }
 
-            // Pop left parenthesis
-            if (!mRHSOperatorStack.empty()) {
-                mRHSOperatorStack.pop();
+            // Generate new nodes until we reach the closest left parenthesis, then pop it
+            while (mRHSOperatorStack.back() != cLeftParenthesis) {
+                generateOperatorNode();
             }
+
+            mRHSOperatorStack.pop_back();
+            --openParenthesisCounter;
+
+        } else {
+            // Operands should be separated by an operator (e.g. "2a", ")2" or "2(")
+            // TODO: Add support for expressions with implicit multiplication
+            return makeError(ErrorCode::UNEXPECTED_CHARACTER);
         }
+
+        ++mPosition;
+    }
+
+    // Validate that the expression does not end with an operator
+    if (isExpectingOperand) {
+        return makeError(ErrorCode::UNEXPECTED_END);
+    }
+
+    // Validate the amount of parenthesis pairs
+    if (openParenthesisCounter != 0) {
+        return makeError(ErrorCode::UNMATCHED_PARENTHESIS);
     }
 
     // Generate new nodes until the operator stack is empty
     while (!mRHSOperatorStack.empty()) {
-        generateNewNode();
+        generateOperatorNode();
+    }
+
+    return {};
+}
+
+Utils::Error Parser::makeError(const Utils::ErrorCode code) const
+{
+    return {code, mPosition};
+}
+
+Symbols::SymbolId Parser::resolveOperandName(const std::string_view name)
+{
+    if (const auto symbolId = mSymbolTable.find(name)) {
+        return *symbolId;
     }
 
-#ifdef DEBUG_BUILD
-    if (!mRHSValueStack->empty()) {
-        std::cout << "Generated Abstract Syntax Tree:\n";
-        AST::printAST(mRHSValueStack->top());
+    // Identifiers are dense: the n-th new name will be interned right after the known ones
+    const auto [newName, isNew] = mNewOperandIds.try_emplace(
+          name, static_cast<Symbols::SymbolId>(mSymbolTable.size() + mNewOperandNames.size()));
+    if (isNew) {
+        mNewOperandNames.push_back(name);
     }
-#endif
 
-    return true;
+    return newName->second;
+}
+
+void Parser::internNewOperandNames()
+{
+    for (const auto name : mNewOperandNames) {
+        [[maybe_unused]] const auto symbolId = mSymbolTable.intern(name);
+    }
+    mNewOperandNames.clear();
+    mNewOperandIds.clear();
+}
+
+void Parser::generateOperatorNode()
+{
+    const auto operation = mRHSOperatorStack.back();
+    mRHSOperatorStack.pop_back();
+
+    const auto rightValue = mRHSValueStack.back();
+    mRHSValueStack.pop_back();
+
+    const auto leftValue = mRHSValueStack.back();
+    mRHSValueStack.pop_back();
+
+    mRHSValueStack.push_back(mRHSAST.addOperator(operation, leftValue, rightValue));
 }
@@ -1,10 +1,14 @@
 #pragma once
 
-#include <memory>
-#include <stack>
-#include <string>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
 #include "ast/Node.hpp"
+#include "bytecode/Program.hpp"
+#include "symbols/SymbolTable.hpp"
+#include "utils/Error.hpp"
 
 /**
  * @brief Class responsible for parsing arithmetic expressions and generating Abstract Syntax Trees
@@ -12,81 +16,248 @@
 class Parser
 {
 public:
-    /// Alias representing a whole AST (stack of AST node unique pointers)
-    using ASTofRSH = std::stack<std::unique_ptr<AST::Node>>;
+    /// Alias representing a whole AST (contiguous pool of AST nodes)
+    using ASTofRSH = AST::Tree;
+
+    /**
+     * @brief Kinds of instructions recognized by the parser
+     */
+    enum class InstructionType : uint8_t {
+
+        ASSIGNMENT = 0, // Arithmetic expression assigned to an operand (e.g. "a = b + 1")
+        RESULT = 1,     // Command presenting the result of the last fulfilled operation
+        UNDO = 2,       // Command undoing a certain amount of operations (e.g. "undo 2")
+        CHECKPOINT = 3, // Command recording the state under a name (e.g. "checkpoint before")
+        RESTORE = 4,    // Command bringing the state back to a checkpoint (e.g. "restore before")
+        STATS = 5       // Command reporting the statistics of the calculator (e.g. "stats json")
+    };
 
     /**
      * @brief Class constructor
      *
-     * @param[in] inputToParse String containing the arithmetic expression to parse
+     * The input is not copied: it must outlive the execution of the parser
+     *
+     * @param[in] inputToParse String containing the instruction to parse
+     * @param[in] symbolTable Symbol table used to intern the operands of the expression (once the
+     * instruction is known to be valid)
+     */
+    explicit Parser(std::string_view inputToParse, Symbols::SymbolTable& symbolTable);
+
+    /**
+     * @brief Checks if a string is a valid operand name
+     *
+     * Operand names start with a letter, which can be followed by letters, digits or underscores
+     *
+     * @param[in] name String to evaluate
+     *
+     * @return True if the string is a valid operand name (false otherwise)
+     */
+    [[nodiscard]] static bool isOperandName(std::string_view name);
+
+    /**
+     * @brief Checks the input for a valid instruction and, for arithmetic expressions,
+     * generates the appropriate AST
+     *
+     * The input is processed in a single pass: commands are recognized and arithmetic expressions
+     * are tokenized, validated and turned into an AST at the same time.
+     * On success, the AST is also simplified and compiled into a program ready to be executed
+     *
+     * @return Nothing if parsing and AST generation were successful, otherwise the error found
+     * (with the position of the offending byte of the input)
+     */
+    Utils::Expected<> execute();
+
+    /**
+     * @brief Getter for the kind of the parsed instruction
+     *
+     * @return Instruction type (only meaningful once parsing succeeded)
      */
-    explicit Parser(const std::string& inputToParse);
+    [[nodiscard]] InstructionType getInstructionType() const;
 
     /**
-     * @brief Checks the input for a valid arithmetic expression and generates the appropriate AST
+     * @brief Getter for the argument of an undo command
      *
-     * @return True if parsing and AST generation were successful (false otherwise)
+     * @return Number of operations to undo (-1 if the argument is not a number)
      */
-    [[nodiscard]] bool execute();
+    [[nodiscard]] int getUndoCount() const;
+
+    /**
+     * @brief Getter for the argument of a checkpoint or restore command
+     *
+     * @return View over the name of the checkpoint
+     */
+    [[nodiscard]] std::string_view getCheckpointName() const;
+
+    /**
+     * @brief Getter for the format requested by a stats command
+     *
+     * @return True if the statistics must be machine readable ("stats json"), false if they
+     * must be human readable ("stats")
+     */
+    [[nodiscard]] bool isMachineReadable() const;
 
     /**
      * @brief Retrieves the operand of the LHS (Left Hand Side) expression
      *
-     * @return String containing the operand of the LHS
+     * @return Symbol identifier of the operand of the LHS
      */
-    [[nodiscard]] std::string getOperandOfLHS() const;
+    [[nodiscard]] Symbols::SymbolId getOperandOfLHS() const;
 
     /**
      * @brief Getter for the generated AST of the RHS (Right Hand Side) expression
      *
-     * @return Shared pointer to a stack containing all the ATS nodes
+     * @return Reference to the generated AST
+     */
+    [[nodiscard]] const ASTofRSH& getASTOfRHS() const;
+
+    /**
+     * @brief Moves the generated AST of the RHS (Right Hand Side) expression out of the parser
+     *
+     * Allows the AST to be stored elsewhere without copying its node pool
+     *
+     * @return Generated AST (the parser is left with an empty one)
+     */
+    [[nodiscard]] ASTofRSH extractASTOfRHS();
+
+    /**
+     * @brief Getter for the compiled program of the RHS (Right Hand Side) expression
+     *
+     * The program is compiled from the simplified AST once parsing succeeds (constant
+     * sub-expressions are folded and the operands they no longer depend on are dropped)
+     *
+     * @return Reference to the compiled program
+     */
+    [[nodiscard]] const Bytecode::Program& getProgramOfRHS() const;
+
+    /**
+     * @brief Moves the compiled program of the RHS (Right Hand Side) expression out of the parser
+     *
+     * @return Compiled program (the parser is left with an empty one)
      */
-    [[nodiscard]] std::shared_ptr<ASTofRSH> getASTOfRHS() const;
+    [[nodiscard]] Bytecode::Program extractProgramOfRHS();
 
 private:
     /**
-     * @brief Parses the LHS of the arithmetic expression
+     * @brief Skips the white spaces found at the current position of the input
+     */
+    void skipWhiteSpaces();
+
+    /**
+     * @brief Reads the operand name found at the current position of the input
+     *
+     * Operand names start with a letter, which can be followed by letters, digits or underscores
+     *
+     * @return View over the operand name (empty if there is no operand name at that position)
+     */
+    [[nodiscard]] std::string_view readOperandName();
+
+    /**
+     * @brief Parses the argument of an undo command found at the current position of the input
+     *
+     * @return Nothing if the rest of the input is a single argument (an error otherwise)
+     */
+    Utils::Expected<> parseUndoCount();
+
+    /**
+     * @brief Parses the argument of a checkpoint or restore command found at the current position
+     * of the input
+     *
+     * Checkpoint names follow the same rules as operand names
+     *
+     * @return Nothing if the rest of the input is a single checkpoint name (an error otherwise)
+     */
+    Utils::Expected<> parseCheckpointName();
+
+    /**
+     * @brief Parses the argument of a stats command found at the current position of the input
      *
-     * @return True if parsing the LHS was successful (false otherwise)
+     * @return Nothing if the rest of the input is a single supported format (an error otherwise)
      */
-    [[nodiscard]] bool parseLHS();
+    Utils::Expected<> parseStatsFormat();
 
     /**
      * @brief Parses the RHS (Right Hand Side) of the arithmetic expression
      *
-     * @return True if parsing the RHS was successful (false otherwise)
+     * Uses the Shunting Yard algorithm to validate the RHS expression and convert it into an AST
+     * while it is being tokenized
+     *
+     * @return Nothing if the RHS is a valid expression and its AST was created (otherwise, the
+     * error found)
      */
-    [[nodiscard]] bool parseRHS();
+    Utils::Expected<> parseRHS();
 
     /**
-     * @brief Validates the RHS of the arithmetic expression
+     * @brief Creates an error detected at the current position of the input
+     *
+     * @param[in] code Reason of the error
      *
-     * @return True if the RHS is a valid expression, false otherwise
+     * @return Error located at the current position
      */
-    [[nodiscard]] bool validateRHS();
+    [[nodiscard]] Utils::Error makeError(Utils::ErrorCode code) const;
 
     /**
-     * @brief Creates an AST for the RHS of the arithmetic expression
+     * @brief Retrieves the symbol identifier of an operand name without interning it
+     *
+     * Names that are not interned yet get the identifier they will be interned with once the
+     * instruction is known to be valid (see internNewOperandNames): rejected instructions leave
+     * the symbol table untouched
      *
-     * Uses the Shunting Yard algorithm to convert the RHS expression into an AST
+     * @param[in] name Operand name
      *
-     * @return True if AST creation was successful (false otherwise)
+     * @return Symbol identifier of the name
      */
-    [[nodiscard]] bool createASTforRHS();
+    [[nodiscard]] Symbols::SymbolId resolveOperandName(std::string_view name);
 
-private:
-    ///  String representation of the LHS operand
-    std::string mLHSString;
+    /**
+     * @brief Interns the operand names resolved since parsing started, in order
+     */
+    void internNewOperandNames();
 
-    /// String representation of the RHS expression
-    std::string mRHSString;
+    /**
+     * @brief Pops an operator and its two operands from the parsing stacks
+     * and attaches them to a new node of the AST
+     */
+    void generateOperatorNode();
+
+private:
+    /// Symbol table used to intern operand names
+    Symbols::SymbolTable& mSymbolTable;
 
     /// Input string to parse
-    std::string mInputString;
+    std::string_view mInput;
+
+    /// Position of the next character of the input to process
+    std::size_t mPosition{0};
+
+    /// Kind of the parsed instruction
+    InstructionType mInstructionType{InstructionType::ASSIGNMENT};
+
+    /// Argument of an undo command
+    int mUndoCount{0};
+
+    /// Argument of a checkpoint or restore command
+    std::string_view mCheckpointName;
+
+    /// Whether a stats command requested machine readable statistics
+    bool mIsMachineReadable{false};
+
+    /// Symbol identifier of the LHS operand
+    Symbols::SymbolId mLHSOperand{};
+
+    /// Operand names resolved but not interned yet, in the order of their future identifiers
+    std::vector<std::string_view> mNewOperandNames;
+    /// Future identifiers of the operand names resolved but not interned yet
+    std::unordered_map<std::string_view, Symbols::SymbolId> mNewOperandIds;
 
     /// Stack to manage the operators of the RHS arithmetic expression during RHS expression parsing
-    std::stack<char> mRHSOperatorStack;
+    std::vector<char> mRHSOperatorStack;
+
+    /// Stack holding the indices of the AST nodes yet to be attached to a parent node
+    std::vector<AST::NodeIndex> mRHSValueStack;
+
+    /// AST representing the RHS expression
+    ASTofRSH mRHSAST;
 
-    /// Shared ownership pointer holding a stack of AST nodes that represent the RHS expression
-    std::shared_ptr<ASTofRSH> mRHSValueStack;
+    /// Program compiled from the simplified AST of the RHS expression
+    Bytecode::Program mRHSProgram;
 };
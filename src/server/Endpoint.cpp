@@ -0,0 +1,194 @@
+#include "Endpoint.hpp"
+
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+/// Prefix of the endpoints of Unix domain sockets
+constexpr std::string_view cUnixPrefix{"unix:"};
+/// Address of TCP endpoints when none is given
+constexpr std::string_view cDefaultHost{"127.0.0.1"};
+/// Maximum number of connections waiting to be accepted
+constexpr int cListenBacklog{SOMAXCONN};
+
+/**
+ * @brief Fills the socket address of an endpoint
+ *
+ * @param[in] endpoint Endpoint to convert
+ * @param[out] address Socket address
+ *
+ * @return Size of the socket address (0 if the endpoint cannot be represented)
+ */
+socklen_t makeSocketAddress(const Server::Endpoint& endpoint, sockaddr_storage& address)
+{
+    address = {};
+
+    if (endpoint.family == Server::Endpoint::Family::UNIX) {
+        auto& unixAddress = reinterpret_cast<sockaddr_un&>(address);
+        if (endpoint.address.size() >= sizeof(unixAddress.sun_path)) {
+            return 0;
+        }
+
+        unixAddress.sun_family = AF_UNIX;
+        std::memcpy(unixAddress.sun_path, endpoint.address.data(), endpoint.address.size());
+        return sizeof(sockaddr_un);
+    }
+
+    auto& inetAddress = reinterpret_cast<sockaddr_in&>(address);
+    inetAddress.sin_family = AF_INET;
+    inetAddress.sin_port = htons(endpoint.port);
+    if (inet_pton(AF_INET, endpoint.address.c_str(), &inetAddress.sin_addr) != 1) {
+        return 0;
+    }
+
+    return sizeof(sockaddr_in);
+}
+
+/**
+ * @brief Creates a socket for an endpoint
+ *
+ * @param[in] endpoint Endpoint of the socket
+ * @param[in] flags Additional socket type flags (e.g. SOCK_NONBLOCK)
+ *
+ * @return File descriptor of the socket (-1 on failure)
+ */
+int createSocket(const Server::Endpoint& endpoint, const int flags)
+{
+    const auto domain = endpoint.family == Server::Endpoint::Family::UNIX ? AF_UNIX : AF_INET;
+    return socket(domain, SOCK_STREAM | SOCK_CLOEXEC | flags, 0);
+}
+} // namespace
+
+namespace Server {
+
+std::optional<Endpoint> Endpoint::parse(std::string_view text)
+{
+    Endpoint endpoint;
+
+    if (text.starts_with(cUnixPrefix)) {
+        text.remove_prefix(cUnixPrefix.size());
+        if (text.empty()) {
+            return std::nullopt;
+        }
+
+        endpoint.family = Family::UNIX;
+        endpoint.address = text;
+        return endpoint;
+    }
+
+    auto host = cDefaultHost;
+    if (const auto separator = text.rfind(':'); separator != std::string_view::npos) {
+        host = text.substr(0, separator);
+        text.remove_prefix(separator + 1);
+    }
+
+    const auto* const textEnd = text.data() + text.size();
+    const auto [end, error] = std::from_chars(text.data(), textEnd, endpoint.port);
+    if (error != std::errc{} || end != textEnd) {
+        return std::nullopt;
+    }
+
+    endpoint.family = Family::TCP;
+    endpoint.address = host == "localhost" ? cDefaultHost : host;
+
+    sockaddr_storage address{};
+    if (makeSocketAddress(endpoint, address) == 0) {
+        return std::nullopt;
+    }
+
+    return endpoint;
+}
+
+int listenOn(const Endpoint& endpoint)
+{
+    sockaddr_storage address{};
+    const auto addressSize = makeSocketAddress(endpoint, address);
+    if (addressSize == 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    const auto socketDescriptor = createSocket(endpoint, SOCK_NONBLOCK);
+    if (socketDescriptor < 0) {
+        return -1;
+    }
+
+    if (endpoint.family == Endpoint::Family::UNIX) {
+        // Only a socket left over by a previous server may be replaced
+        struct stat fileStatus{};
+        if (stat(endpoint.address.c_str(), &fileStatus) == 0 && S_ISSOCK(fileStatus.st_mode)) {
+            unlink(endpoint.address.c_str());
+        }
+    } else {
+        const int reuseAddress{1};
+        setsockopt(
+              socketDescriptor, SOL_SOCKET, SO_REUSEADDR, &reuseAddress, sizeof(reuseAddress));
+    }
+
+    if (bind(socketDescriptor, reinterpret_cast<const sockaddr*>(&address), addressSize) != 0
+        || listen(socketDescriptor, cListenBacklog) != 0) {
+        const auto error = errno;
+        close(socketDescriptor);
+        errno = error;
+        return -1;
+    }
+
+    return socketDescriptor;
+}
+
+int connectTo(const Endpoint& endpoint)
+{
+    sockaddr_storage address{};
+    const auto addressSize = makeSocketAddress(endpoint, address);
+    if (addressSize == 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    const auto socketDescriptor = createSocket(endpoint, 0);
+    if (socketDescriptor < 0) {
+        return -1;
+    }
+
+    if (connect(socketDescriptor, reinterpret_cast<const sockaddr*>(&address), addressSize) != 0) {
+        const auto error = errno;
+        close(socketDescriptor);
+        errno = error;
+        return -1;
+    }
+
+    if (endpoint.family == Endpoint::Family::TCP) {
+        const int noDelay{1};
+        setsockopt(socketDescriptor, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    }
+
+    return socketDescriptor;
+}
+
+std::size_t raiseFileDescriptorLimit()
+{
+    rlimit limit{};
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0) {
+        return 0;
+    }
+
+    if (limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+        getrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    return static_cast<std::size_t>(limit.rlim_cur);
+}
+
+} // namespace Server
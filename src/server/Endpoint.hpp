@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace Server {
+
+/**
+ * @brief Local address of the calculator server
+ *
+ * Written either as "unix:<path>" for a Unix domain socket,
+ * or as "[<host>:]<port>" for a TCP socket (the host defaults to 127.0.0.1)
+ */
+struct Endpoint
+{
+    /**
+     * @brief Supported socket families
+     */
+    enum class Family : uint8_t {
+        UNIX = 0, // Unix domain socket, bound to a path
+        TCP = 1,  // TCP socket, bound to an IPv4 address and a port
+    };
+
+    /// Family of the socket
+    Family family{Family::TCP};
+
+    /// Path of the Unix domain socket, or IPv4 address of the TCP socket
+    std::string address;
+
+    /// Port of the TCP socket
+    uint16_t port{};
+
+    /**
+     * @brief Parses the textual representation of an endpoint
+     *
+     * @param[in] text Endpoint to parse (e.g. "unix:/tmp/calculator.sock" or "localhost:7000")
+     *
+     * @return Parsed endpoint (empty if the text is not a valid endpoint)
+     */
+    [[nodiscard]] static std::optional<Endpoint> parse(std::string_view text);
+};
+
+/**
+ * @brief Creates a non-blocking socket listening on an endpoint
+ *
+ * A stale Unix domain socket left at the same path is replaced
+ *
+ * @param[in] endpoint Endpoint to listen on
+ *
+ * @return File descriptor of the socket (-1 on failure, errno is set)
+ */
+[[nodiscard]] int listenOn(const Endpoint& endpoint);
+
+/**
+ * @brief Creates a blocking socket connected to an endpoint
+ *
+ * @param[in] endpoint Endpoint to connect to
+ *
+ * @return File descriptor of the socket (-1 on failure, errno is set)
+ */
+[[nodiscard]] int connectTo(const Endpoint& endpoint);
+
+/**
+ * @brief Raises the limit of open file descriptors of the process to its maximum
+ *
+ * Every session holds a socket, so the default limit is usually too low
+ *
+ * @return Maximum number of open file descriptors of the process
+ */
+std::size_t raiseFileDescriptorLimit();
+
+} // namespace Server
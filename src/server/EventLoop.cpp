@@ -0,0 +1,293 @@
+#include "EventLoop.hpp"
+
+#include <array>
+#include <cerrno>
+#include <span>
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+/// Size of the buffer receiving the data read from the sockets
+constexpr std::size_t cReadBufferSize{1 << 16};
+/// Maximum number of reads of a connection per event, so that busy clients do not starve others
+constexpr int cMaxReadsPerEvent{4};
+/// Amount of pending responses above which a connection is not read from anymore
+constexpr std::size_t cMaxPendingOutput{1 << 20};
+/// Maximum number of events handled per wait
+constexpr int cMaxEventCount{256};
+
+/**
+ * @brief Registers a socket in an epoll instance or updates the events it is watched for
+ *
+ * @param[in] epollDescriptor Epoll instance
+ * @param[in] operation EPOLL_CTL_ADD or EPOLL_CTL_MOD
+ * @param[in] socketDescriptor Socket to watch
+ * @param[in] events Events to watch for
+ *
+ * @return True on success
+ */
+bool watchSocket(const int epollDescriptor,
+                 const int operation,
+                 const int socketDescriptor,
+                 const uint32_t events)
+{
+    epoll_event event{};
+    event.events = events;
+    event.data.fd = socketDescriptor;
+    return epoll_ctl(epollDescriptor, operation, socketDescriptor, &event) == 0;
+}
+
+/**
+ * @brief Checks if the last socket operation failed only because it would have blocked
+ * or was interrupted (EWOULDBLOCK is the same error as EAGAIN on Linux)
+ *
+ * @return True if the operation can be retried later
+ */
+bool isTransientError()
+{
+    return errno == EAGAIN || errno == EINTR;
+}
+} // namespace
+
+namespace Server {
+
+EventLoop::Connection::Connection(const std::size_t expressionCacheCapacity)
+    : session{expressionCacheCapacity}
+    , watchedEvents{EPOLLIN}
+{
+}
+
+EventLoop::EventLoop(const std::size_t expressionCacheCapacity)
+    : mExpressionCacheCapacity{expressionCacheCapacity}
+    , mEpollDescriptor{epoll_create1(EPOLL_CLOEXEC)}
+    , mStopDescriptor{eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)}
+    , mReadBuffer(cReadBufferSize)
+{
+    if (mEpollDescriptor >= 0 && mStopDescriptor >= 0) {
+        watchSocket(mEpollDescriptor, EPOLL_CTL_ADD, mStopDescriptor, EPOLLIN);
+    }
+}
+
+EventLoop::~EventLoop()
+{
+    for (std::size_t socketDescriptor = 0; socketDescriptor < mConnections.size();
+         ++socketDescriptor) {
+        if (mConnections[socketDescriptor]) {
+            close(static_cast<int>(socketDescriptor));
+        }
+    }
+
+    if (mListenDescriptor >= 0) {
+        close(mListenDescriptor);
+        if (mEndpoint.family == Endpoint::Family::UNIX) {
+            unlink(mEndpoint.address.c_str());
+        }
+    }
+
+    for (const auto descriptor : {mStopDescriptor, mEpollDescriptor}) {
+        if (descriptor >= 0) {
+            close(descriptor);
+        }
+    }
+}
+
+bool EventLoop::listen(const Endpoint& endpoint)
+{
+    if (mEpollDescriptor < 0 || mStopDescriptor < 0 || mListenDescriptor >= 0) {
+        errno = mListenDescriptor >= 0 ? EALREADY : EBADF;
+        return false;
+    }
+
+    mListenDescriptor = listenOn(endpoint);
+    if (mListenDescriptor < 0) {
+        return false;
+    }
+
+    mEndpoint = endpoint;
+    return watchSocket(mEpollDescriptor, EPOLL_CTL_ADD, mListenDescriptor, EPOLLIN);
+}
+
+bool EventLoop::run()
+{
+    std::array<epoll_event, cMaxEventCount> events{};
+
+    while (true) {
+        const auto eventCount = epoll_wait(mEpollDescriptor, events.data(), cMaxEventCount, -1);
+        if (eventCount < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+
+        const auto readyEvents = std::span{events}.first(static_cast<std::size_t>(eventCount));
+        for (const auto& event : readyEvents) {
+            if (event.data.fd == mStopDescriptor) {
+                uint64_t stopCount{};
+                [[maybe_unused]] const auto bytesRead
+                      = read(mStopDescriptor, &stopCount, sizeof(stopCount));
+                return true;
+            }
+
+            if (event.data.fd == mListenDescriptor) {
+                acceptConnections();
+            } else {
+                serveConnection(event.data.fd, event.events);
+            }
+        }
+    }
+}
+
+void EventLoop::stop()
+{
+    // Writing to an event file descriptor is async-signal-safe
+    const uint64_t stopCount{1};
+    [[maybe_unused]] const auto bytesWritten
+          = write(mStopDescriptor, &stopCount, sizeof(stopCount));
+}
+
+std::size_t EventLoop::getSessionCount() const
+{
+    return mConnectionCount;
+}
+
+void EventLoop::acceptConnections()
+{
+    while (true) {
+        const auto socketDescriptor
+              = accept4(mListenDescriptor, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+        // Either every pending connection was accepted, or the process ran out of descriptors
+        // (pending connections are then accepted once some are closed)
+        if (socketDescriptor < 0) {
+            return;
+        }
+
+        if (mEndpoint.family == Endpoint::Family::TCP) {
+            const int noDelay{1};
+            setsockopt(socketDescriptor, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        }
+
+        if (!watchSocket(mEpollDescriptor, EPOLL_CTL_ADD, socketDescriptor, EPOLLIN)) {
+            close(socketDescriptor);
+            continue;
+        }
+
+        const auto connectionIndex = static_cast<std::size_t>(socketDescriptor);
+        if (connectionIndex >= mConnections.size()) {
+            mConnections.resize(connectionIndex + 1);
+        }
+
+        mConnections[connectionIndex] = std::make_unique<Connection>(mExpressionCacheCapacity);
+        ++mConnectionCount;
+    }
+}
+
+void EventLoop::serveConnection(const int socketDescriptor, const uint32_t events)
+{
+    // Events of a connection closed earlier in the same batch are stale
+    const auto connectionIndex = static_cast<std::size_t>(socketDescriptor);
+    if (connectionIndex >= mConnections.size() || !mConnections[connectionIndex]) {
+        return;
+    }
+
+    auto& connection = *mConnections[connectionIndex];
+
+    // Pending data is read before handling a hang up, the client may have sent its last
+    // requests right before closing its side
+    if ((events & (EPOLLIN | EPOLLHUP | EPOLLERR)) != 0 && !connection.isClosing
+        && !readRequests(socketDescriptor, connection)) {
+        closeConnection(socketDescriptor);
+        return;
+    }
+
+    if (!writeResponses(socketDescriptor, connection)) {
+        closeConnection(socketDescriptor);
+        return;
+    }
+
+    const auto pendingOutputSize = connection.session.getPendingOutput().size();
+    if (connection.isClosing && pendingOutputSize == 0) {
+        closeConnection(socketDescriptor);
+        return;
+    }
+
+    // Watch for writability while responses are pending, and stop reading from clients
+    // which do not read their responses
+    uint32_t watchedEvents{0};
+    if (!connection.isClosing && pendingOutputSize < cMaxPendingOutput) {
+        watchedEvents |= EPOLLIN;
+    }
+    if (pendingOutputSize > 0) {
+        watchedEvents |= EPOLLOUT;
+    }
+
+    if (watchedEvents != connection.watchedEvents) {
+        connection.watchedEvents = watchedEvents;
+        if (!watchSocket(mEpollDescriptor, EPOLL_CTL_MOD, socketDescriptor, watchedEvents)) {
+            closeConnection(socketDescriptor);
+        }
+    }
+}
+
+bool EventLoop::readRequests(const int socketDescriptor, Connection& connection)
+{
+    for (int readCount = 0; readCount < cMaxReadsPerEvent; ++readCount) {
+        const auto bytesRead = recv(socketDescriptor, mReadBuffer.data(), mReadBuffer.size(), 0);
+
+        if (bytesRead < 0) {
+            return isTransientError();
+        }
+
+        // The client will not send any more requests: answer the last one and close
+        if (bytesRead == 0) {
+            connection.session.finish();
+            connection.isClosing = true;
+            return true;
+        }
+
+        if (!connection.session.receive(
+                  {mReadBuffer.data(), static_cast<std::size_t>(bytesRead)})) {
+            return false;
+        }
+
+        if (static_cast<std::size_t>(bytesRead) < mReadBuffer.size()) {
+            return true;
+        }
+    }
+
+    return true;
+}
+
+bool EventLoop::writeResponses(const int socketDescriptor, Connection& connection)
+{
+    while (true) {
+        const auto output = connection.session.getPendingOutput();
+        if (output.empty()) {
+            return true;
+        }
+
+        const auto bytesWritten
+              = send(socketDescriptor, output.data(), output.size(), MSG_NOSIGNAL);
+        if (bytesWritten < 0) {
+            return isTransientError();
+        }
+
+        connection.session.consumeOutput(static_cast<std::size_t>(bytesWritten));
+    }
+}
+
+void EventLoop::closeConnection(const int socketDescriptor)
+{
+    // Closing the socket also removes it from the epoll instance
+    close(socketDescriptor);
+    mConnections[static_cast<std::size_t>(socketDescriptor)].reset();
+    --mConnectionCount;
+}
+
+} // namespace Server
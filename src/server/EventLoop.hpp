@@ -0,0 +1,157 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Endpoint.hpp"
+#include "Session.hpp"
+
+namespace Server {
+
+/**
+ * @brief Single threaded server running a calculator session per connection
+ *
+ * Every socket is non-blocking and watched by a single epoll instance (level triggered).
+ * Readable connections have all of their pipelined requests processed at once and their
+ * responses are written back as far as the socket accepts them: the rest is kept until the
+ * socket becomes writable again. Connections with too many pending responses are not read
+ * from until they catch up.
+ */
+class EventLoop
+{
+public:
+    /**
+     * @brief Class constructor
+     *
+     * @param[in] expressionCacheCapacity Maximum number of compiled arithmetic expressions
+     * cached by each session
+     */
+    explicit EventLoop(
+          std::size_t expressionCacheCapacity = cDefaultSessionExpressionCacheCapacity);
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    /**
+     * @brief Class destructor, closes every connection (and removes the Unix domain socket)
+     */
+    ~EventLoop();
+
+    /**
+     * @brief Starts listening for connections
+     *
+     * @param[in] endpoint Endpoint to listen on
+     *
+     * @return True if the server is listening (false otherwise, errno is set)
+     */
+    [[nodiscard]] bool listen(const Endpoint& endpoint);
+
+    /**
+     * @brief Serves the connections until the loop is stopped
+     *
+     * @return True if the loop was stopped (false if waiting for events failed, errno is set)
+     */
+    bool run();
+
+    /**
+     * @brief Makes the loop return (may be called from another thread or a signal handler)
+     */
+    void stop();
+
+    /**
+     * @brief Getter for the number of open sessions
+     *
+     * @return Number of connections being served
+     */
+    [[nodiscard]] std::size_t getSessionCount() const;
+
+private:
+    /**
+     * @brief Connection of a client and its calculator session
+     */
+    struct Connection
+    {
+        /**
+         * @brief Structure constructor
+         *
+         * @param[in] expressionCacheCapacity Maximum number of compiled arithmetic expressions
+         * cached by the session
+         */
+        explicit Connection(std::size_t expressionCacheCapacity);
+
+        /// Calculator session of the client
+        Session session;
+        /// Events the socket is watched for
+        uint32_t watchedEvents;
+        /// Whether the client stopped sending requests (the connection closes once flushed)
+        bool isClosing{false};
+    };
+
+    /**
+     * @brief Accepts every pending connection
+     */
+    void acceptConnections();
+
+    /**
+     * @brief Serves a connection which received data or became writable
+     *
+     * @param[in] socketDescriptor Socket of the connection
+     * @param[in] events Events reported for the socket
+     */
+    void serveConnection(int socketDescriptor, uint32_t events);
+
+    /**
+     * @brief Reads and processes the requests received on a connection
+     *
+     * @param[in] socketDescriptor Socket of the connection
+     * @param[in,out] connection Connection to read from
+     *
+     * @return False if the connection failed and must be closed
+     */
+    [[nodiscard]] bool readRequests(int socketDescriptor, Connection& connection);
+
+    /**
+     * @brief Writes as many pending responses as the socket of a connection accepts
+     *
+     * @param[in] socketDescriptor Socket of the connection
+     * @param[in,out] connection Connection to write to
+     *
+     * @return False if the connection failed and must be closed
+     */
+    [[nodiscard]] bool writeResponses(int socketDescriptor, Connection& connection);
+
+    /**
+     * @brief Closes a connection and ends its session
+     *
+     * @param[in] socketDescriptor Socket of the connection
+     */
+    void closeConnection(int socketDescriptor);
+
+private:
+    /// Maximum number of compiled arithmetic expressions cached by each session
+    std::size_t mExpressionCacheCapacity;
+
+    /// Epoll instance watching every socket
+    int mEpollDescriptor{-1};
+
+    /// Event file descriptor signalled to stop the loop
+    int mStopDescriptor{-1};
+
+    /// Socket accepting connections
+    int mListenDescriptor{-1};
+
+    /// Endpoint the server listens on
+    Endpoint mEndpoint;
+
+    /// Connections, indexed by socket file descriptor
+    std::vector<std::unique_ptr<Connection>> mConnections;
+
+    /// Number of open connections
+    std::size_t mConnectionCount{0};
+
+    /// Buffer receiving the data read from the sockets (shared by every connection)
+    std::vector<char> mReadBuffer;
+};
+
+} // namespace Server
@@ -0,0 +1,95 @@
+#include "Session.hpp"
+
+#include <cstring>
+#include <string>
+
+namespace Server {
+
+Session::Session(const std::size_t expressionCacheCapacity)
+    : mRunner{expressionCacheCapacity}
+{
+}
+
+bool Session::receive(std::string_view data)
+{
+    while (const auto* lineEnd
+           = static_cast<const char*>(std::memchr(data.data(), '\n', data.size()))) {
+        const auto lineLength = static_cast<std::size_t>(lineEnd - data.data());
+
+        // Requests split across reads are completed in place, others are processed directly
+        if (mPendingInput.empty()) {
+            processRequest(data.substr(0, lineLength));
+        } else {
+            mPendingInput.append(data.substr(0, lineLength));
+            processRequest(mPendingInput);
+            mPendingInput.clear();
+        }
+
+        data.remove_prefix(lineLength + 1);
+    }
+
+    if (mPendingInput.size() + data.size() > cMaxRequestLength) {
+        return false;
+    }
+
+    mPendingInput.append(data);
+    return true;
+}
+
+void Session::finish()
+{
+    if (!mPendingInput.empty()) {
+        processRequest(mPendingInput);
+        mPendingInput.clear();
+    }
+}
+
+std::string_view Session::getPendingOutput() const
+{
+    return std::string_view{mOutput}.substr(mOutputOffset);
+}
+
+void Session::consumeOutput(const std::size_t size)
+{
+    mOutputOffset += size;
+
+    // Sent responses are dropped once everything was sent, which keeps the buffer allocated
+    if (mOutputOffset == mOutput.size()) {
+        mOutput.clear();
+        mOutputOffset = 0;
+    }
+}
+
+void Session::processRequest(std::string_view request)
+{
+    if (request.ends_with('\r')) {
+        request.remove_suffix(1);
+    }
+
+    // Blank requests get an empty response, without being processed
+    if (request.find_first_not_of(" \t") == std::string_view::npos) {
+        mOutput.push_back('\n');
+        return;
+    }
+
+    // Results are formatted straight into the output buffer
+    const auto outputSize = mOutput.size();
+    const auto appendResult = [this, outputSize](const std::string_view result) {
+        if (mOutput.size() != outputSize) {
+            mOutput.append(", ");
+        }
+        mOutput.append(result);
+    };
+
+    // Rejected requests are answered with the reason and the position of the rejection
+    if (const auto instructionResult = mRunner.processInstruction(request, appendResult);
+        !instructionResult) {
+        const auto error = instructionResult.getError();
+        mOutput.append("error: ").append(mRunner.describeError(error));
+        mOutput.append(" at offset ").append(std::to_string(error.offset));
+    }
+
+    mOutput.push_back('\n');
+}
+
+} // namespace Server
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "calculator/Runner.hpp"
+
+namespace Server {
+
+/// Default maximum number of compiled arithmetic expressions kept by each session
+inline constexpr std::size_t cDefaultSessionExpressionCacheCapacity{64};
+
+/// Maximum length of a request line (longer lines end the session)
+inline constexpr std::size_t cMaxRequestLength{1 << 16};
+
+/**
+ * @brief Calculator session of a client, speaking a line protocol
+ *
+ * Every request is a line holding one instruction. Every request gets exactly one response line,
+ * in order: the results of the instruction separated by commas (empty if there are none).
+ * Requests can be pipelined: any number of them may be received at once, including
+ * incomplete ones which are completed by later data.
+ */
+class Session
+{
+public:
+    /**
+     * @brief Class constructor
+     *
+     * @param[in] expressionCacheCapacity Maximum number of compiled arithmetic expressions
+     * cached by the calculator of the session
+     */
+    explicit Session(std::size_t expressionCacheCapacity = cDefaultSessionExpressionCacheCapacity);
+
+    /**
+     * @brief Processes the complete requests of the data received from the client
+     *
+     * @param[in] data Data received (may end with an incomplete request)
+     *
+     * @return True if the data was processed (false if a request is too long)
+     */
+    [[nodiscard]] bool receive(std::string_view data);
+
+    /**
+     * @brief Processes the last request when the client stops sending data,
+     * even if it is not terminated by a new line
+     */
+    void finish();
+
+    /**
+     * @brief Retrieves the responses not sent yet
+     *
+     * @return View over the pending responses (valid until the next call to a non-const method)
+     */
+    [[nodiscard]] std::string_view getPendingOutput() const;
+
+    /**
+     * @brief Discards responses that were sent to the client
+     *
+     * @param[in] size Number of bytes sent
+     */
+    void consumeOutput(std::size_t size);
+
+private:
+    /**
+     * @brief Processes a request and appends its response to the pending output
+     *
+     * The response holds the results of the request, or the error it was rejected with
+     * ("error: <description> at offset <position in the request>")
+     *
+     * @param[in] request Request (without its line terminator)
+     */
+    void processRequest(std::string_view request);
+
+private:
+    /// Calculator of the session
+    Calculator::Runner mRunner;
+
+    /// Incomplete request received so far
+    std::string mPendingInput;
+
+    /// Responses (the ones before the output offset were already sent)
+    std::string mOutput;
+
+    /// Number of bytes of the output already sent
+    std::size_t mOutputOffset{0};
+};
+
+} // namespace Server
@@ -0,0 +1,46 @@
+#include "Checksum.hpp"
+
+#include <array>
+
+namespace {
+/// Reversed CRC-32C polynomial
+constexpr uint32_t cPolynomial{0x82F63B78};
+
+/**
+ * @brief Builds the lookup table of the checksum (one entry per byte value)
+ *
+ * @return Lookup table
+ */
+constexpr std::array<uint32_t, 256> makeChecksumTable()
+{
+    std::array<uint32_t, 256> table{};
+
+    for (uint32_t byte = 0; byte < table.size(); ++byte) {
+        auto checksum = byte;
+        for (int bit = 0; bit < 8; ++bit) {
+            checksum = (checksum >> 1) ^ ((checksum & 1) != 0 ? cPolynomial : 0);
+        }
+        table[byte] = checksum;
+    }
+
+    return table;
+}
+
+/// Lookup table of the checksum
+constexpr auto cChecksumTable = makeChecksumTable();
+} // namespace
+
+namespace Storage {
+
+uint32_t computeChecksum(const std::span<const std::byte> bytes, uint32_t checksum)
+{
+    checksum = ~checksum;
+    for (const auto byte : bytes) {
+        const auto tableIndex = (checksum ^ static_cast<uint32_t>(byte)) & 0xFF;
+        checksum = (checksum >> 8) ^ cChecksumTable[tableIndex];
+    }
+
+    return ~checksum;
+}
+
+} // namespace Storage
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace Storage {
+
+/**
+ * @brief Computes the CRC-32C (Castagnoli) checksum of a block of bytes
+ *
+ * @param[in] bytes Bytes to checksum
+ * @param[in] checksum Checksum of the preceding bytes, to checksum several blocks as one
+ *
+ * @return Checksum of the bytes
+ */
+[[nodiscard]] uint32_t computeChecksum(std::span<const std::byte> bytes, uint32_t checksum = 0);
+
+} // namespace Storage
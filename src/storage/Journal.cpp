@@ -0,0 +1,120 @@
+#include "Journal.hpp"
+
+#include <cerrno>
+
+#include <sys/stat.h>
+
+#include "SnapshotFile.hpp"
+
+namespace {
+/// Name of the snapshot file in a data directory
+constexpr std::string_view cSnapshotFileName{"snapshot"};
+/// Name of the write-ahead log in a data directory
+constexpr std::string_view cLogFileName{"wal"};
+} // namespace
+
+namespace Storage {
+
+std::optional<Journal> Journal::open(const std::string& directory,
+                                     Calculator::Runner& runner,
+                                     const uint64_t snapshotInterval)
+{
+    if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST) {
+        return std::nullopt;
+    }
+
+    const auto snapshotPath = directory + "/" + std::string{cSnapshotFileName};
+    uint64_t sequence{0};
+
+    // The snapshot is read in place: it is only mapped while the state is loaded from it
+    if (const auto snapshot = MappedSnapshot::open(snapshotPath)) {
+        if (!runner.loadSnapshot(snapshot->getImage())) {
+            errno = EINVAL;
+            return std::nullopt;
+        }
+        sequence = snapshot->getSequence();
+    } else if (errno != ENOENT) {
+        return std::nullopt;
+    }
+
+    // Records older than the snapshot are left over by a crash before the log was emptied
+    uint64_t loggedCount{0};
+    uint64_t replayedCount{0};
+
+    auto log = WriteAheadLog::open(
+          directory + "/" + std::string{cLogFileName},
+          [&](const uint64_t recordSequence, const std::string_view instruction) {
+              ++loggedCount;
+              if (recordSequence > sequence) {
+                  // Results (or errors) of replayed instructions were reported before the restart
+                  [[maybe_unused]] const auto instructionResult
+                        = runner.processInstruction(instruction, [](const std::string_view) {});
+                  sequence = recordSequence;
+                  ++replayedCount;
+              }
+          });
+    if (!log) {
+        return std::nullopt;
+    }
+
+    Journal journal{runner, directory, std::move(*log), snapshotInterval};
+    journal.mSequence = sequence;
+    journal.mModificationCount = runner.getModificationCount();
+    journal.mLoggedCount = loggedCount;
+    journal.mReplayedCount = replayedCount;
+
+    return journal;
+}
+
+Journal::Journal(Calculator::Runner& runner,
+                 const std::string& directory,
+                 WriteAheadLog log,
+                 const uint64_t snapshotInterval)
+    : mRunner{&runner}
+    , mSnapshotPath{directory + "/" + std::string{cSnapshotFileName}}
+    , mLog{std::move(log)}
+    , mSnapshotInterval{snapshotInterval}
+{
+}
+
+void Journal::record(const std::string_view instruction)
+{
+    const auto modificationCount = mRunner->getModificationCount();
+    if (modificationCount == mModificationCount) {
+        return;
+    }
+
+    mModificationCount = modificationCount;
+    mLog.append(++mSequence, instruction);
+    ++mLoggedCount;
+}
+
+bool Journal::commit()
+{
+    if (!mLog.commit()) {
+        return false;
+    }
+
+    return mSnapshotInterval == 0 || mLoggedCount < mSnapshotInterval || saveSnapshot();
+}
+
+bool Journal::saveSnapshot()
+{
+    // Pending records are part of the snapshot: they never need to reach the log
+    std::vector<std::byte> image;
+    mRunner->saveSnapshot(image);
+
+    if (!writeSnapshotFile(mSnapshotPath, mSequence, image) || !mLog.clear()) {
+        return false;
+    }
+
+    mLoggedCount = 0;
+    return true;
+}
+
+uint64_t Journal::getReplayedCount() const
+{
+    return mReplayedCount;
+}
+
+} // namespace Storage
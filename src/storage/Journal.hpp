@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "WriteAheadLog.hpp"
+#include "calculator/Runner.hpp"
+
+namespace Storage {
+
+/// Default number of logged instructions after which a snapshot replaces the log
+inline constexpr uint64_t cDefaultSnapshotInterval{100'000};
+
+/**
+ * @brief Makes the state of a calculator durable in a data directory
+ *
+ * Instructions that modified the state are appended to a write-ahead log, committed in groups.
+ * Every so often, a compact snapshot of the whole state replaces the log. On startup, the
+ * latest snapshot is mapped and loaded, then only the instructions logged after it are replayed.
+ */
+class Journal
+{
+public:
+    /**
+     * @brief Opens the data directory (created if missing) and recovers the state it holds
+     *
+     * @param[in] directory Path of the data directory
+     * @param[in,out] runner Calculator to recover the state into (must not be used yet)
+     * @param[in] snapshotInterval Number of logged instructions after which a snapshot
+     * replaces the log (0 disables the periodic snapshots)
+     *
+     * @return Opened journal (empty if the directory cannot be opened or holds corrupted data,
+     * errno is set)
+     */
+    [[nodiscard]] static std::optional<Journal> open(
+          const std::string& directory,
+          Calculator::Runner& runner,
+          uint64_t snapshotInterval = cDefaultSnapshotInterval);
+
+    /**
+     * @brief Logs an instruction that was just processed, if it modified the state
+     *
+     * The instruction is only durable once committed
+     *
+     * @param[in] instruction Instruction processed by the calculator
+     */
+    void record(std::string_view instruction);
+
+    /**
+     * @brief Makes every recorded instruction durable (and takes a snapshot when due)
+     *
+     * @return True on success (false otherwise, errno is set)
+     */
+    [[nodiscard]] bool commit();
+
+    /**
+     * @brief Writes a snapshot of the current state and empties the log
+     *
+     * @return True on success (false otherwise, errno is set)
+     */
+    [[nodiscard]] bool saveSnapshot();
+
+    /**
+     * @brief Getter for the number of instructions replayed from the log when opening
+     *
+     * @return Number of replayed instructions
+     */
+    [[nodiscard]] uint64_t getReplayedCount() const;
+
+private:
+    /**
+     * @brief Class constructor
+     *
+     * @param[in,out] runner Calculator whose state is made durable
+     * @param[in] directory Path of the data directory
+     * @param[in] log Write-ahead log of the directory
+     * @param[in] snapshotInterval Number of logged instructions between two snapshots
+     */
+    Journal(Calculator::Runner& runner,
+            const std::string& directory,
+            WriteAheadLog log,
+            uint64_t snapshotInterval);
+
+private:
+    /// Calculator whose state is made durable
+    Calculator::Runner* mRunner;
+
+    /// Path of the snapshot file
+    std::string mSnapshotPath;
+
+    /// Write-ahead log of the instructions processed since the snapshot
+    WriteAheadLog mLog;
+
+    /// Number of logged instructions after which a snapshot replaces the log
+    uint64_t mSnapshotInterval;
+
+    /// Sequence number of the last logged instruction
+    uint64_t mSequence{0};
+
+    /// Modification count of the state when the last instruction was logged
+    uint64_t mModificationCount{0};
+
+    /// Number of instructions in the log
+    uint64_t mLoggedCount{0};
+
+    /// Number of instructions replayed from the log when opening
+    uint64_t mReplayedCount{0};
+};
+
+} // namespace Storage
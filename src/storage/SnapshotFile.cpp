@@ -0,0 +1,192 @@
+#include "SnapshotFile.hpp"
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Checksum.hpp"
+#include "utils/BinaryStream.hpp"
+
+namespace {
+/// Magic number (and format version) at the beginning of every snapshot
+constexpr std::array<char, 8> cMagic{'C', 'A', 'L', 'C', 'S', 'N', 'P', '1'};
+
+/**
+ * @brief Synchronizes a file (or a directory) to the storage
+ *
+ * @param[in] path Path of the file
+ * @param[in] flags Flags the file is opened with
+ *
+ * @return True on success (false otherwise, errno is set)
+ */
+bool synchronizePath(const std::string& path, const int flags)
+{
+    const auto fileDescriptor = open(path.c_str(), flags | O_CLOEXEC);
+    if (fileDescriptor < 0) {
+        return false;
+    }
+
+    const auto isSynchronized = fsync(fileDescriptor) == 0;
+    close(fileDescriptor);
+    return isSynchronized;
+}
+} // namespace
+
+namespace Storage {
+
+bool writeSnapshotFile(const std::string& path,
+                       const uint64_t sequence,
+                       const std::span<const std::byte> image)
+{
+    std::vector<std::byte> header;
+    const auto magic = std::as_bytes(std::span{cMagic});
+    header.insert(header.end(), magic.begin(), magic.end());
+
+    Utils::BinaryWriter writer{header};
+    writer.writeFixed64(sequence);
+    writer.writeFixed64(image.size());
+    writer.writeFixed32(computeChecksum(image));
+
+    // Write a temporary file first: renaming it replaces the previous snapshot atomically
+    const auto temporaryPath = path + ".tmp";
+    const auto fileDescriptor
+          = open(temporaryPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fileDescriptor < 0) {
+        return false;
+    }
+
+    bool isWritten{true};
+    for (auto bytes : {std::span<const std::byte>{header}, image}) {
+        while (isWritten && !bytes.empty()) {
+            const auto bytesWritten = write(fileDescriptor, bytes.data(), bytes.size());
+            if (bytesWritten < 0 && errno == EINTR) {
+                continue;
+            }
+
+            isWritten = bytesWritten > 0;
+            if (isWritten) {
+                bytes = bytes.subspan(static_cast<std::size_t>(bytesWritten));
+            }
+        }
+    }
+
+    isWritten = isWritten && fsync(fileDescriptor) == 0;
+    close(fileDescriptor);
+
+    if (!isWritten || rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        return false;
+    }
+
+    // The rename itself is only durable once the directory is synchronized
+    auto directory = std::filesystem::path{path}.parent_path().string();
+    return synchronizePath(directory.empty() ? "." : directory, O_RDONLY | O_DIRECTORY);
+}
+
+std::optional<MappedSnapshot> MappedSnapshot::open(const std::string& path)
+{
+    const auto fileDescriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fileDescriptor < 0) {
+        return std::nullopt;
+    }
+
+    struct stat fileStatus{};
+    if (fstat(fileDescriptor, &fileStatus) != 0) {
+        close(fileDescriptor);
+        return std::nullopt;
+    }
+
+    const auto fileSize = static_cast<std::size_t>(fileStatus.st_size);
+    auto* const mapping = fileSize > 0
+                                ? mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fileDescriptor, 0)
+                                : MAP_FAILED;
+    close(fileDescriptor);
+
+    if (mapping == MAP_FAILED) {
+        if (fileSize == 0) {
+            errno = EINVAL;
+        }
+        return std::nullopt;
+    }
+
+    const std::span<const std::byte> mappedBytes{static_cast<const std::byte*>(mapping), fileSize};
+    const auto magic = std::as_bytes(std::span{cMagic});
+
+    Utils::BinaryReader reader{mappedBytes};
+    const auto fileMagic = reader.readBytes(magic.size());
+    const auto sequence = reader.readFixed64();
+    const auto imageSize = reader.readFixed64();
+    const auto checksum = reader.readFixed32();
+    const auto image = reader.readBytes(static_cast<std::size_t>(imageSize));
+
+    MappedSnapshot snapshot{mappedBytes, sequence, image};
+
+    if (!reader.isValid() || !reader.isAtEnd()
+        || std::memcmp(fileMagic.data(), magic.data(), magic.size()) != 0
+        || computeChecksum(image) != checksum) {
+        errno = EINVAL;
+        return std::nullopt;
+    }
+
+    return snapshot;
+}
+
+MappedSnapshot::MappedSnapshot(const std::span<const std::byte> mapping,
+                               const uint64_t sequence,
+                               const std::span<const std::byte> image)
+    : mMapping{mapping}
+    , mSequence{sequence}
+    , mImage{image}
+{
+}
+
+MappedSnapshot::MappedSnapshot(MappedSnapshot&& other) noexcept
+    : mMapping{std::exchange(other.mMapping, {})}
+    , mSequence{other.mSequence}
+    , mImage{std::exchange(other.mImage, {})}
+{
+}
+
+MappedSnapshot& MappedSnapshot::operator=(MappedSnapshot&& other) noexcept
+{
+    if (this != &other) {
+        unmap();
+        mMapping = std::exchange(other.mMapping, {});
+        mSequence = other.mSequence;
+        mImage = std::exchange(other.mImage, {});
+    }
+
+    return *this;
+}
+
+MappedSnapshot::~MappedSnapshot()
+{
+    unmap();
+}
+
+uint64_t MappedSnapshot::getSequence() const
+{
+    return mSequence;
+}
+
+std::span<const std::byte> MappedSnapshot::getImage() const
+{
+    return mImage;
+}
+
+void MappedSnapshot::unmap()
+{
+    if (!mMapping.empty()) {
+        munmap(const_cast<std::byte*>(mMapping.data()), mMapping.size());
+        mMapping = {};
+    }
+}
+
+} // namespace Storage
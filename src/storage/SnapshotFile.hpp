@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+
+namespace Storage {
+
+/**
+ * @brief Writes a snapshot file atomically: the previous snapshot (if any) stays in place
+ * until the new one is entirely on the storage
+ *
+ * @param[in] path Path of the snapshot file
+ * @param[in] sequence Sequence number of the last record whose effects the image holds
+ * @param[in] image Image of the state
+ *
+ * @return True if the snapshot is durable (false otherwise, errno is set)
+ */
+[[nodiscard]] bool writeSnapshotFile(const std::string& path,
+                                     uint64_t sequence,
+                                     std::span<const std::byte> image);
+
+/**
+ * @brief Snapshot file mapped in memory, read in place
+ */
+class MappedSnapshot
+{
+public:
+    /**
+     * @brief Maps a snapshot file and checks its integrity
+     *
+     * @param[in] path Path of the snapshot file
+     *
+     * @return Mapped snapshot (empty if the file cannot be mapped or is corrupted, errno is set:
+     * ENOENT when there is no snapshot yet)
+     */
+    [[nodiscard]] static std::optional<MappedSnapshot> open(const std::string& path);
+
+    MappedSnapshot(MappedSnapshot&& other) noexcept;
+    MappedSnapshot& operator=(MappedSnapshot&& other) noexcept;
+    MappedSnapshot(const MappedSnapshot&) = delete;
+    MappedSnapshot& operator=(const MappedSnapshot&) = delete;
+
+    /**
+     * @brief Class destructor, unmaps the file
+     */
+    ~MappedSnapshot();
+
+    /**
+     * @brief Getter for the sequence number of the snapshot
+     *
+     * @return Sequence number of the last record whose effects the image holds
+     */
+    [[nodiscard]] uint64_t getSequence() const;
+
+    /**
+     * @brief Getter for the image of the state
+     *
+     * @return View over the image, valid as long as the snapshot is mapped
+     */
+    [[nodiscard]] std::span<const std::byte> getImage() const;
+
+private:
+    /**
+     * @brief Class constructor
+     *
+     * @param[in] mapping Mapping of the whole file
+     * @param[in] sequence Sequence number of the snapshot
+     * @param[in] image Image of the state, within the mapping
+     */
+    MappedSnapshot(std::span<const std::byte> mapping,
+                   uint64_t sequence,
+                   std::span<const std::byte> image);
+
+    /**
+     * @brief Unmaps the file
+     */
+    void unmap();
+
+private:
+    /// Mapping of the whole file (empty once moved from)
+    std::span<const std::byte> mMapping;
+
+    /// Sequence number of the last record whose effects the image holds
+    uint64_t mSequence;
+
+    /// Image of the state, within the mapping
+    std::span<const std::byte> mImage;
+};
+
+} // namespace Storage
@@ -0,0 +1,233 @@
+#include "WriteAheadLog.hpp"
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <span>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Checksum.hpp"
+#include "utils/BinaryStream.hpp"
+
+namespace {
+/// Magic number (and format version) at the beginning of every log
+constexpr std::array<char, 8> cMagic{'C', 'A', 'L', 'C', 'W', 'A', 'L', '1'};
+
+/**
+ * @brief Writes a whole buffer to a file, retrying partial writes
+ *
+ * @param[in] fileDescriptor File to write to
+ * @param[in] bytes Bytes to write
+ *
+ * @return True on success (false otherwise, errno is set)
+ */
+bool writeAll(const int fileDescriptor, std::span<const std::byte> bytes)
+{
+    while (!bytes.empty()) {
+        const auto bytesWritten = write(fileDescriptor, bytes.data(), bytes.size());
+        if (bytesWritten < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+
+        bytes = bytes.subspan(static_cast<std::size_t>(bytesWritten));
+    }
+
+    return true;
+}
+
+/**
+ * @brief Reads a whole file
+ *
+ * @param[in] fileDescriptor File to read
+ * @param[out] content Content of the file
+ *
+ * @return True on success (false otherwise, errno is set)
+ */
+bool readAll(const int fileDescriptor, std::vector<std::byte>& content)
+{
+    struct stat fileStatus{};
+    if (fstat(fileDescriptor, &fileStatus) != 0) {
+        return false;
+    }
+
+    content.resize(static_cast<std::size_t>(fileStatus.st_size));
+    std::size_t offset{0};
+
+    while (offset < content.size()) {
+        const auto bytesRead = pread(fileDescriptor,
+                                     content.data() + offset,
+                                     content.size() - offset,
+                                     static_cast<off_t>(offset));
+        if (bytesRead <= 0) {
+            if (bytesRead < 0 && errno == EINTR) {
+                continue;
+            }
+            content.resize(offset);
+            return bytesRead == 0;
+        }
+
+        offset += static_cast<std::size_t>(bytesRead);
+    }
+
+    return true;
+}
+} // namespace
+
+namespace Storage {
+
+std::optional<WriteAheadLog> WriteAheadLog::open(const std::string& path,
+                                                 const RecordHandler& handleRecord)
+{
+    const auto fileDescriptor = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fileDescriptor < 0) {
+        return std::nullopt;
+    }
+
+    WriteAheadLog log{fileDescriptor};
+
+    std::vector<std::byte> content;
+    if (!readAll(fileDescriptor, content)) {
+        return std::nullopt;
+    }
+
+    const auto magic = std::as_bytes(std::span{cMagic});
+
+    // A new log only holds its header
+    if (content.empty()) {
+        if (!writeAll(fileDescriptor, magic) || fdatasync(fileDescriptor) != 0) {
+            return std::nullopt;
+        }
+        return log;
+    }
+
+    if (content.size() < magic.size()
+        || std::memcmp(content.data(), magic.data(), magic.size()) != 0) {
+        errno = EINVAL;
+        return std::nullopt;
+    }
+
+    // Read the records back until the end of the log or the first torn one
+    Utils::BinaryReader reader{std::span{content}.subspan(magic.size())};
+    auto validSize = magic.size();
+
+    while (!reader.isAtEnd()) {
+        const auto payloadSize = reader.readFixed32();
+        const auto checksum = reader.readFixed32();
+        const auto checkedBytes = reader.readBytes(sizeof(uint64_t) + payloadSize);
+        if (!reader.isValid() || computeChecksum(checkedBytes) != checksum) {
+            break;
+        }
+
+        const auto sequence = Utils::BinaryReader{checkedBytes}.readFixed64();
+        const auto payload = checkedBytes.subspan(sizeof(uint64_t));
+        handleRecord(sequence,
+                     {reinterpret_cast<const char*>(payload.data()), payload.size()});
+
+        validSize = magic.size() + reader.getOffset();
+    }
+
+    if (validSize < content.size()
+        && (ftruncate(fileDescriptor, static_cast<off_t>(validSize)) != 0
+            || fdatasync(fileDescriptor) != 0)) {
+        return std::nullopt;
+    }
+
+    if (lseek(fileDescriptor, static_cast<off_t>(validSize), SEEK_SET) < 0) {
+        return std::nullopt;
+    }
+
+    return log;
+}
+
+WriteAheadLog::WriteAheadLog(const int fileDescriptor)
+    : mFileDescriptor{fileDescriptor}
+{
+}
+
+WriteAheadLog::WriteAheadLog(WriteAheadLog&& other) noexcept
+    : mFileDescriptor{other.mFileDescriptor}
+    , mPendingRecords{std::move(other.mPendingRecords)}
+{
+    other.mFileDescriptor = -1;
+}
+
+WriteAheadLog& WriteAheadLog::operator=(WriteAheadLog&& other) noexcept
+{
+    if (this != &other) {
+        close();
+        mFileDescriptor = other.mFileDescriptor;
+        mPendingRecords = std::move(other.mPendingRecords);
+        other.mFileDescriptor = -1;
+    }
+
+    return *this;
+}
+
+WriteAheadLog::~WriteAheadLog()
+{
+    close();
+}
+
+void WriteAheadLog::append(const uint64_t sequence, const std::string_view payload)
+{
+    std::array<std::byte, sizeof(uint64_t)> sequenceBytes{};
+    for (std::size_t byteIndex = 0; byteIndex < sequenceBytes.size(); ++byteIndex) {
+        sequenceBytes[byteIndex] = static_cast<std::byte>(sequence >> (8 * byteIndex));
+    }
+
+    // The checksum covers the sequence number and the payload
+    const auto payloadBytes = std::as_bytes(std::span{payload});
+    const auto checksum = computeChecksum(payloadBytes, computeChecksum(sequenceBytes));
+
+    Utils::BinaryWriter writer{mPendingRecords};
+    writer.writeFixed32(static_cast<uint32_t>(payload.size()));
+    writer.writeFixed32(checksum);
+    mPendingRecords.insert(mPendingRecords.end(), sequenceBytes.begin(), sequenceBytes.end());
+    mPendingRecords.insert(mPendingRecords.end(), payloadBytes.begin(), payloadBytes.end());
+}
+
+bool WriteAheadLog::commit()
+{
+    if (mPendingRecords.empty()) {
+        return true;
+    }
+
+    if (!writeAll(mFileDescriptor, mPendingRecords) || fdatasync(mFileDescriptor) != 0) {
+        return false;
+    }
+
+    mPendingRecords.clear();
+    return true;
+}
+
+bool WriteAheadLog::clear()
+{
+    mPendingRecords.clear();
+
+    const auto headerSize = static_cast<off_t>(cMagic.size());
+    return ftruncate(mFileDescriptor, headerSize) == 0
+           && lseek(mFileDescriptor, headerSize, SEEK_SET) == headerSize
+           && fdatasync(mFileDescriptor) == 0;
+}
+
+std::size_t WriteAheadLog::getPendingSize() const
+{
+    return mPendingRecords.size();
+}
+
+void WriteAheadLog::close()
+{
+    if (mFileDescriptor >= 0) {
+        [[maybe_unused]] const auto isCommitted = commit();
+        ::close(mFileDescriptor);
+        mFileDescriptor = -1;
+    }
+}
+
+} // namespace Storage
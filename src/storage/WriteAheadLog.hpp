@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Storage {
+
+/**
+ * @brief Append-only binary log of records, made durable in groups
+ *
+ * Every record holds a sequence number and a payload, framed by their size and a checksum.
+ * Appended records are buffered until the next commit, which writes all of them at once and
+ * synchronizes the file a single time (group commit). A record torn by a crash fails its
+ * checksum: it is dropped along with everything after it when the log is opened again.
+ */
+class WriteAheadLog
+{
+public:
+    /// Alias representing a callback invoked for every record read back from a log
+    using RecordHandler = std::function<void(uint64_t sequence, std::string_view payload)>;
+
+    /**
+     * @brief Opens a log (created if missing) and reads back its records
+     *
+     * @param[in] path Path of the log file
+     * @param[in] handleRecord Callback invoked for every valid record, in order
+     *
+     * @return Opened log, positioned after its last valid record
+     * (empty if the file cannot be opened or is not a log, errno is set)
+     */
+    [[nodiscard]] static std::optional<WriteAheadLog> open(const std::string& path,
+                                                           const RecordHandler& handleRecord);
+
+    WriteAheadLog(WriteAheadLog&& other) noexcept;
+    WriteAheadLog& operator=(WriteAheadLog&& other) noexcept;
+    WriteAheadLog(const WriteAheadLog&) = delete;
+    WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+    /**
+     * @brief Class destructor, commits the pending records (if possible) and closes the log
+     */
+    ~WriteAheadLog();
+
+    /**
+     * @brief Appends a record, durable once committed
+     *
+     * @param[in] sequence Sequence number of the record
+     * @param[in] payload Payload of the record
+     */
+    void append(uint64_t sequence, std::string_view payload);
+
+    /**
+     * @brief Writes the pending records and waits for them to reach the storage
+     *
+     * @return True if every record is durable (false otherwise, errno is set)
+     */
+    [[nodiscard]] bool commit();
+
+    /**
+     * @brief Removes every record of the log (e.g. once a snapshot holds their effects)
+     *
+     * @return True if the log is empty on the storage (false otherwise, errno is set)
+     */
+    [[nodiscard]] bool clear();
+
+    /**
+     * @brief Getter for the size of the records waiting for a commit
+     *
+     * @return Number of pending bytes
+     */
+    [[nodiscard]] std::size_t getPendingSize() const;
+
+private:
+    /**
+     * @brief Class constructor
+     *
+     * @param[in] fileDescriptor File descriptor of the log, positioned after its last record
+     */
+    explicit WriteAheadLog(int fileDescriptor);
+
+    /**
+     * @brief Closes the log
+     */
+    void close();
+
+private:
+    /// File descriptor of the log (-1 once moved from)
+    int mFileDescriptor;
+
+    /// Records waiting for a commit
+    std::vector<std::byte> mPendingRecords;
+};
+
+} // namespace Storage
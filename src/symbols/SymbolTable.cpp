@@ -0,0 +1,42 @@
+#include "SymbolTable.hpp"
+
+#include <cassert>
+
+namespace Symbols {
+
+SymbolId SymbolTable::intern(const std::string_view name)
+{
+    if (const auto itr = mIdentifiersMap.find(name); itr != mIdentifiersMap.cend()) {
+        return itr->second;
+    }
+
+    const auto symbolId = static_cast<SymbolId>(mNames.size());
+
+    // Keys of node based maps are never relocated, so they can be referenced by identifier
+    const auto [itr, inserted] = mIdentifiersMap.emplace(name, symbolId);
+    mNames.push_back(&itr->first);
+
+    return symbolId;
+}
+
+std::optional<SymbolId> SymbolTable::find(const std::string_view name) const
+{
+    if (const auto itr = mIdentifiersMap.find(name); itr != mIdentifiersMap.cend()) {
+        return itr->second;
+    }
+
+    return {};
+}
+
+const std::string& SymbolTable::getName(const SymbolId symbolId) const
+{
+    assert(symbolId < mNames.size());
+    return *mNames[symbolId];
+}
+
+std::size_t SymbolTable::size() const
+{
+    return mNames.size();
+}
+
+} // namespace Symbols
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Symbols {
+
+/// Dense identifier of an interned operand name
+using SymbolId = uint32_t;
+
+/**
+ * @brief Interns operand names into small, dense integer identifiers
+ *
+ * Names are hashed once (when they are parsed) and from then on operands are only handled
+ * through their identifiers, which can directly index arrays of values
+ */
+class SymbolTable
+{
+public:
+    /**
+     * @brief Class' default constructor
+     */
+    SymbolTable() = default;
+
+    SymbolTable(const SymbolTable&) = delete;
+    SymbolTable& operator=(const SymbolTable&) = delete;
+
+    /**
+     * @brief Retrieves the identifier of a name, interning it if needed
+     *
+     * @param[in] name Operand name
+     *
+     * @return Identifier of the name
+     */
+    SymbolId intern(std::string_view name);
+
+    /**
+     * @brief Retrieves the identifier of a name without interning it
+     *
+     * @param[in] name Operand name
+     *
+     * @return Identifier of the name (empty if the name was never interned)
+     */
+    [[nodiscard]] std::optional<SymbolId> find(std::string_view name) const;
+
+    /**
+     * @brief Retrieves the name of an interned identifier
+     *
+     * @param[in] symbolId Identifier to look up
+     *
+     * @return Reference to the name of the identifier
+     */
+    [[nodiscard]] const std::string& getName(SymbolId symbolId) const;
+
+    /**
+     * @brief Getter for the amount of interned names
+     *
+     * Identifiers are always smaller than this value
+     *
+     * @return Number of interned names
+     */
+    [[nodiscard]] std::size_t size() const;
+
+private:
+    /**
+     * @brief Transparent hash allowing lookups with string views
+     */
+    struct NameHash
+    {
+        using is_transparent = void;
+
+        std::size_t operator()(const std::string_view name) const
+        {
+            return std::hash<std::string_view>{}(name);
+        }
+    };
+
+    /// Map of names to their identifiers
+    std::unordered_map<std::string, SymbolId, NameHash, std::equal_to<>> mIdentifiersMap;
+
+    /// Names indexed by identifier (pointing to the keys of the identifiers map)
+    std::vector<const std::string*> mNames;
+};
+
+} // namespace Symbols
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+#include "symbols/SymbolTable.hpp"
+
+namespace Symbols {
+
+/**
+ * @brief Value currently held by an operand
+ */
+struct ValueSlot
+{
+    /// Value of the operand
+    int32_t value{0};
+    /// Whether the operand currently holds a value
+    bool isDefined{false};
+};
+
+/// Alias representing the values of all operands, indexed by their symbol identifier
+using ValueSlots = std::span<const ValueSlot>;
+
+/**
+ * @brief Checks if an operand holds a value
+ *
+ * @param[in] valueSlots Values of all operands
+ * @param[in] symbolId Identifier of the operand
+ *
+ * @return True if the operand holds a value (false otherwise)
+ */
+[[nodiscard]] inline bool isDefined(const ValueSlots valueSlots, const SymbolId symbolId)
+{
+    return symbolId < valueSlots.size() && valueSlots[symbolId].isDefined;
+}
+
+} // namespace Symbols
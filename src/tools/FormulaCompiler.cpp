@@ -0,0 +1,106 @@
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "calculator/FormulaLibrary.hpp"
+
+namespace {
+/**
+ * @brief Reads a whole file
+ *
+ * @param[in] path Path of the file
+ * @param[out] content Content of the file
+ *
+ * @return True on success (false otherwise, errno is set)
+ */
+bool readFile(const char* path, std::string& content)
+{
+    std::FILE* file = std::fopen(path, "rb");
+    if (file == nullptr) {
+        return false;
+    }
+
+    std::array<char, 1 << 16> buffer{};
+    std::size_t bytesRead{0};
+    while ((bytesRead = std::fread(buffer.data(), 1, buffer.size(), file)) > 0) {
+        content.append(buffer.data(), bytesRead);
+    }
+
+    const auto isRead = std::ferror(file) == 0;
+    std::fclose(file);
+    return isRead;
+}
+
+/**
+ * @brief Writes a whole file
+ *
+ * @param[in] path Path of the file
+ * @param[in] content Content of the file
+ *
+ * @return True on success (false otherwise, errno is set)
+ */
+bool writeFile(const char* path, const std::vector<std::byte>& content)
+{
+    std::FILE* file = std::fopen(path, "wb");
+    if (file == nullptr) {
+        return false;
+    }
+
+    const auto isWritten = std::fwrite(content.data(), 1, content.size(), file) == content.size();
+    return std::fclose(file) == 0 && isWritten;
+}
+
+/**
+ * @brief Reports an invalid formula, located by its line and column in the formula file
+ *
+ * @param[in] path Path of the formula file
+ * @param[in] source Content of the formula file
+ * @param[in] error Error of the formula (its offset being relative to the whole file)
+ */
+void reportInvalidFormula(const char* path, const std::string_view source, const Utils::Error error)
+{
+    const auto errorPrefix = source.substr(0, std::min(error.offset, source.size()));
+    const auto lineNumber = std::ranges::count(errorPrefix, '\n') + 1;
+    const auto lineStart = errorPrefix.rfind('\n');
+    const auto columnNumber
+          = errorPrefix.size() - (lineStart == std::string_view::npos ? 0 : lineStart + 1) + 1;
+
+    std::cerr << path << ':' << lineNumber << ':' << columnNumber << ": Invalid formula: "
+              << Utils::getErrorMessage(error.code) << '\n';
+}
+} // namespace
+
+/**
+ * @brief Compiles a formula file (one assignment per line) into a program image,
+ * to be loaded with "Calculator-Challenge --formulas <image>"
+ */
+int main(int argc, char* argv[])
+{
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " formulas.txt formulas.img\n";
+        return 1;
+    }
+
+    std::string source;
+    if (!readFile(argv[1], source)) {
+        std::perror(argv[1]);
+        return 1;
+    }
+
+    const auto image = Calculator::FormulaLibrary::compile(source);
+    if (!image) {
+        reportInvalidFormula(argv[1], source, image.getError());
+        return 1;
+    }
+
+    if (!writeFile(argv[2], *image)) {
+        std::perror(argv[2]);
+        return 1;
+    }
+
+    return 0;
+}
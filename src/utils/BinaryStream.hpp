@@ -0,0 +1,313 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace Utils {
+
+/**
+ * @brief Appends values to a byte buffer in a compact, platform independent encoding
+ *
+ * Unsigned integers are written as LEB128 variable length integers, signed integers are
+ * zigzag encoded first so that small negative values stay small. Fixed size values are
+ * written in little endian order.
+ */
+class BinaryWriter
+{
+public:
+    /**
+     * @brief Class constructor
+     *
+     * @param[in,out] buffer Buffer the values are appended to
+     */
+    explicit BinaryWriter(std::vector<std::byte>& buffer)
+        : mBuffer{buffer}
+    {
+    }
+
+    /**
+     * @brief Appends an unsigned integer (variable length)
+     *
+     * @param[in] value Value to append
+     */
+    void writeUnsigned(uint64_t value)
+    {
+        while (value >= 0x80) {
+            mBuffer.push_back(static_cast<std::byte>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+
+        mBuffer.push_back(static_cast<std::byte>(value));
+    }
+
+    /**
+     * @brief Appends a signed integer (zigzag encoded, variable length)
+     *
+     * @param[in] value Value to append
+     */
+    void writeSigned(const int64_t value)
+    {
+        writeUnsigned((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+    }
+
+    /**
+     * @brief Appends a single byte
+     *
+     * @param[in] value Value to append
+     */
+    void writeByte(const uint8_t value)
+    {
+        mBuffer.push_back(static_cast<std::byte>(value));
+    }
+
+    /**
+     * @brief Appends a 32 bits value (fixed length, little endian)
+     *
+     * @param[in] value Value to append
+     */
+    void writeFixed32(const uint32_t value)
+    {
+        for (int shift = 0; shift < 32; shift += 8) {
+            mBuffer.push_back(static_cast<std::byte>(value >> shift));
+        }
+    }
+
+    /**
+     * @brief Appends a 64 bits value (fixed length, little endian)
+     *
+     * @param[in] value Value to append
+     */
+    void writeFixed64(const uint64_t value)
+    {
+        writeFixed32(static_cast<uint32_t>(value));
+        writeFixed32(static_cast<uint32_t>(value >> 32));
+    }
+
+    /**
+     * @brief Appends a string, preceded by its length
+     *
+     * @param[in] text String to append
+     */
+    void writeString(const std::string_view text)
+    {
+        writeUnsigned(text.size());
+        const auto* const bytes = reinterpret_cast<const std::byte*>(text.data());
+        mBuffer.insert(mBuffer.end(), bytes, bytes + text.size());
+    }
+
+private:
+    /// Buffer the values are appended to
+    std::vector<std::byte>& mBuffer;
+};
+
+/**
+ * @brief Reads values written by a BinaryWriter from a byte buffer
+ *
+ * Reading past the end of the buffer or a malformed value makes the reader invalid:
+ * every later read then returns zero, so callers only have to check the reader once done
+ */
+class BinaryReader
+{
+public:
+    /**
+     * @brief Class constructor
+     *
+     * @param[in] buffer Buffer to read from
+     */
+    explicit BinaryReader(const std::span<const std::byte> buffer)
+        : mBuffer{buffer}
+    {
+    }
+
+    /**
+     * @brief Reads an unsigned integer (variable length)
+     *
+     * @return Value read (0 on failure)
+     */
+    uint64_t readUnsigned()
+    {
+        uint64_t value{0};
+
+        for (int shift = 0; shift < 64 && mIsValid; shift += 7) {
+            if (mOffset == mBuffer.size()) {
+                break;
+            }
+
+            const auto byte = static_cast<uint64_t>(mBuffer[mOffset++]);
+            value |= (byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+
+        mIsValid = false;
+        return 0;
+    }
+
+    /**
+     * @brief Reads a signed integer (zigzag encoded, variable length)
+     *
+     * @return Value read (0 on failure)
+     */
+    int64_t readSigned()
+    {
+        const auto value = readUnsigned();
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    /**
+     * @brief Reads a single byte
+     *
+     * @return Value read (0 on failure)
+     */
+    uint8_t readByte()
+    {
+        if (!mIsValid || mOffset == mBuffer.size()) {
+            mIsValid = false;
+            return 0;
+        }
+
+        return static_cast<uint8_t>(mBuffer[mOffset++]);
+    }
+
+    /**
+     * @brief Reads a 32 bits value (fixed length, little endian)
+     *
+     * @return Value read (0 on failure)
+     */
+    uint32_t readFixed32()
+    {
+        if (!mIsValid || mBuffer.size() - mOffset < sizeof(uint32_t)) {
+            mIsValid = false;
+            return 0;
+        }
+
+        uint32_t value{0};
+        for (int shift = 0; shift < 32; shift += 8) {
+            value |= static_cast<uint32_t>(mBuffer[mOffset++]) << shift;
+        }
+
+        return value;
+    }
+
+    /**
+     * @brief Reads a 64 bits value (fixed length, little endian)
+     *
+     * @return Value read (0 on failure)
+     */
+    uint64_t readFixed64()
+    {
+        const auto low = readFixed32();
+        const auto high = readFixed32();
+        return mIsValid ? (static_cast<uint64_t>(high) << 32) | low : 0;
+    }
+
+    /**
+     * @brief Reads raw bytes
+     *
+     * @param[in] size Number of bytes to read
+     *
+     * @return View over the bytes in the buffer (empty on failure)
+     */
+    std::span<const std::byte> readBytes(const std::size_t size)
+    {
+        if (!mIsValid || mBuffer.size() - mOffset < size) {
+            mIsValid = false;
+            return {};
+        }
+
+        const auto bytes = mBuffer.subspan(mOffset, size);
+        mOffset += size;
+        return bytes;
+    }
+
+    /**
+     * @brief Getter for the number of bytes read so far
+     *
+     * @return Position of the next value to read
+     */
+    [[nodiscard]] std::size_t getOffset() const
+    {
+        return mOffset;
+    }
+
+    /**
+     * @brief Reads a string preceded by its length
+     *
+     * @return View over the string in the buffer (empty on failure)
+     */
+    std::string_view readString()
+    {
+        const auto size = readUnsigned();
+        if (!mIsValid || mBuffer.size() - mOffset < size) {
+            mIsValid = false;
+            return {};
+        }
+
+        const std::string_view text{reinterpret_cast<const char*>(mBuffer.data() + mOffset),
+                                    static_cast<std::size_t>(size)};
+        mOffset += static_cast<std::size_t>(size);
+        return text;
+    }
+
+    /**
+     * @brief Reads a count of items, each one taking at least one byte in the buffer
+     *
+     * Guards against corrupted counts before anything is allocated for the items
+     *
+     * @return Count read (0 on failure or if it exceeds the remaining bytes)
+     */
+    std::size_t readCount()
+    {
+        const auto count = readUnsigned();
+        if (count > mBuffer.size() - mOffset) {
+            mIsValid = false;
+            return 0;
+        }
+
+        return static_cast<std::size_t>(count);
+    }
+
+    /**
+     * @brief Checks if every read so far succeeded
+     *
+     * @return True if the values read are valid (false otherwise)
+     */
+    [[nodiscard]] bool isValid() const
+    {
+        return mIsValid;
+    }
+
+    /**
+     * @brief Checks if the whole buffer was read
+     *
+     * @return True if there is nothing left to read (false otherwise)
+     */
+    [[nodiscard]] bool isAtEnd() const
+    {
+        return mOffset == mBuffer.size();
+    }
+
+    /**
+     * @brief Marks the values read as invalid (e.g. when they are inconsistent)
+     */
+    void invalidate()
+    {
+        mIsValid = false;
+    }
+
+private:
+    /// Buffer to read from
+    std::span<const std::byte> mBuffer;
+
+    /// Position of the next value to read
+    std::size_t mOffset{0};
+
+    /// Whether every read so far succeeded
+    bool mIsValid{true};
+};
+
+} // namespace Utils
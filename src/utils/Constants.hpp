@@ -1,5 +1,7 @@
 #pragma once
 
+#include <string_view>
+
 namespace Utils::Constants {
 /// Valid white space character
 inline constexpr auto cWhiteSpace{' '};
@@ -17,4 +19,16 @@ inline constexpr auto cMultOp{'*'};
 inline constexpr auto cDivOp{'/'};
 /// Valid assignment operator character
 inline constexpr auto cAssignOp{'='};
+/// Supported string for the undo command
+inline constexpr std::string_view cUndoCommand{"undo"};
+/// Supported string for the result command
+inline constexpr std::string_view cResultCommand{"result"};
+/// Supported string for the checkpoint command
+inline constexpr std::string_view cCheckpointCommand{"checkpoint"};
+/// Supported string for the restore command
+inline constexpr std::string_view cRestoreCommand{"restore"};
+/// Supported string for the stats command
+inline constexpr std::string_view cStatsCommand{"stats"};
+/// Supported argument of the stats command requesting machine readable statistics
+inline constexpr std::string_view cStatsJsonFormat{"json"};
 } // namespace Utils::Constants
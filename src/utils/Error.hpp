@@ -0,0 +1,192 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <variant>
+
+namespace Utils {
+
+/**
+ * @brief Reasons why an instruction could not be processed
+ */
+enum class ErrorCode : uint8_t {
+
+    INVALID_INSTRUCTION = 0,   // Neither an assignment nor a supported command
+    INVALID_ARGUMENT = 1,      // Missing, extra or malformed argument of a command
+    EMPTY_EXPRESSION = 2,      // Assignment without a RHS (e.g. "a =")
+    LITERAL_TOO_LARGE = 3,     // Integer literal that does not fit in 32 bits
+    NEGATIVE_VALUE = 4,        // Unary minus (e.g. "a = -2")
+    UNEXPECTED_CHARACTER = 5,  // Operator, operand or character out of place (e.g. "a = 2 ++ 3")
+    UNEXPECTED_END = 6,        // Expression ending with an operator (e.g. "a = 2 +")
+    UNMATCHED_PARENTHESIS = 7, // Parenthesis without its counterpart
+    EMPTY_PROGRAM = 8,         // Evaluation of a program without instructions
+    NO_RESULT_AVAILABLE = 9,   // Result requested before any operation was fulfilled
+    NOTHING_TO_UNDO = 10,      // Undo requested while no operation can be undone
+    UNKNOWN_CHECKPOINT = 11,   // Restore of a checkpoint that was never recorded
+    CYCLIC_DEPENDENCY = 12     // Assignment closing a cycle (e.g. "b = a" once "a = b" is pending)
+};
+
+/**
+ * @brief Failure to process an instruction
+ */
+struct Error
+{
+    /// Reason of the failure
+    ErrorCode code;
+    /// Position, in the instruction, of the byte the failure was detected at
+    std::size_t offset;
+
+    bool operator==(const Error&) const = default;
+};
+
+/**
+ * @brief Retrieves the human readable description of an error code
+ *
+ * @param[in] code Error code to describe
+ *
+ * @return Static description of the error
+ */
+constexpr std::string_view getErrorMessage(const ErrorCode code)
+{
+    switch (code) {
+    case ErrorCode::INVALID_INSTRUCTION:
+        return "Invalid instruction provided";
+    case ErrorCode::INVALID_ARGUMENT:
+        return "Invalid command argument provided";
+    case ErrorCode::EMPTY_EXPRESSION:
+        return "Empty expression provided";
+    case ErrorCode::LITERAL_TOO_LARGE:
+        return "Integer literal is too large";
+    case ErrorCode::NEGATIVE_VALUE:
+        return "Negative values are not currently supported";
+    case ErrorCode::UNEXPECTED_CHARACTER:
+        return "Invalid expression provided";
+    case ErrorCode::UNEXPECTED_END:
+        return "Expression ends with an operator";
+    case ErrorCode::UNMATCHED_PARENTHESIS:
+        return "Parenthesis do not match";
+    case ErrorCode::EMPTY_PROGRAM:
+        return "Empty program";
+    case ErrorCode::NO_RESULT_AVAILABLE:
+        return "There is no result available yet";
+    case ErrorCode::NOTHING_TO_UNDO:
+        return "No operations were undone";
+    case ErrorCode::UNKNOWN_CHECKPOINT:
+        return "Unknown checkpoint";
+    case ErrorCode::CYCLIC_DEPENDENCY:
+        return "Cyclic dependency found";
+    }
+
+    return "Unknown error";
+}
+
+/**
+ * @brief Either the value produced by an operation or the error that prevented it
+ *
+ * Stands in for std::expected (C++23): failures are plain values, so reporting them neither
+ * allocates nor performs any I/O. Operations producing nothing use the default std::monostate
+ * value, so that a default constructed result means success
+ *
+ * @tparam Value Type of the value produced on success
+ */
+template<typename Value = std::monostate>
+class [[nodiscard]] Expected
+{
+public:
+    /**
+     * @brief Class constructor, for a success holding a default constructed value
+     */
+    Expected() = default;
+
+    /**
+     * @brief Class constructor, for a success
+     *
+     * @param[in] value Value produced by the operation
+     */
+    Expected(Value value)
+        : mResult{std::in_place_index<0>, std::move(value)}
+    {
+    }
+
+    /**
+     * @brief Class constructor, for a failure
+     *
+     * @param[in] error Error that prevented the operation
+     */
+    Expected(const Error error)
+        : mResult{std::in_place_index<1>, error}
+    {
+    }
+
+    /**
+     * @brief Checks whether the operation succeeded
+     *
+     * @return True if a value is held (false if an error is)
+     */
+    [[nodiscard]] bool hasValue() const
+    {
+        return mResult.index() == 0;
+    }
+
+    /**
+     * @brief Checks whether the operation succeeded (see hasValue)
+     */
+    explicit operator bool() const
+    {
+        return hasValue();
+    }
+
+    /**
+     * @brief Getter for the value produced on success (only valid if hasValue())
+     *
+     * @return Reference to the value
+     */
+    [[nodiscard]] const Value& getValue() const
+    {
+        return *std::get_if<0>(&mResult);
+    }
+
+    /**
+     * @brief Getter for the value produced on success (only valid if hasValue())
+     *
+     * @return Reference to the value, which can be moved out
+     */
+    [[nodiscard]] Value& getValue()
+    {
+        return *std::get_if<0>(&mResult);
+    }
+
+    /**
+     * @brief Accesses the value produced on success, like std::optional (only valid if hasValue())
+     */
+    const Value& operator*() const
+    {
+        return getValue();
+    }
+
+    /**
+     * @brief Accesses the value produced on success, like std::optional (only valid if hasValue())
+     */
+    const Value* operator->() const
+    {
+        return &getValue();
+    }
+
+    /**
+     * @brief Getter for the error that prevented the operation (only valid if !hasValue())
+     *
+     * @return Error of the operation
+     */
+    [[nodiscard]] Error getError() const
+    {
+        return *std::get_if<1>(&mResult);
+    }
+
+private:
+    /// Value produced by the operation or error that prevented it
+    std::variant<Value, Error> mResult;
+};
+
+} // namespace Utils
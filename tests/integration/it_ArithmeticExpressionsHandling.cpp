@@ -35,3 +35,320 @@ TEST(CalculatorIntegrationTest, calculatorCorrectlyPerformsSupportedOperations)
         ASSERT_EQ(operationResults, expectedResults);
     }
 }
+
+/**
+ * @brief Tests that the calculator supports operands with multi-character names
+ */
+TEST(CalculatorIntegrationTest, calculatorSupportsMultiCharacterOperandNames)
+{
+    Calculator::Runner calculator;
+
+    for (const auto& [arithmeticExpression, expectedResults] :
+         std::initializer_list<std::pair<std::string, std::vector<std::string>>>{
+               {"total=price*qty+tax", {}},             // Unresolved dependencies
+               {"price=2*3", {"price = 6"}},            // Partially resolves 'total'
+               {"qty=4", {"qty = 4"}},                  // Partially resolves 'total'
+               {"tax=price/2", {"tax = 3", "total = 27"}}, // Resolution of 'total'
+               {"result", {"return tax = 3"}},          // Request result of the last operation
+               {"p2=total-tax1", {}},                   // Names can contain digits
+               {"tax1=7", {"tax1 = 7", "p2 = 20"}}}) {
+
+        const auto operationResults = calculator.processInstruction(arithmeticExpression);
+        ASSERT_EQ(operationResults, expectedResults) << arithmeticExpression;
+    }
+}
+
+/**
+ * @brief Tests that the calculator supports integer literals with multiple digits
+ */
+TEST(CalculatorIntegrationTest, calculatorSupportsMultiDigitLiterals)
+{
+    Calculator::Runner calculator;
+
+    for (const auto& [arithmeticExpression, expectedResults] :
+         std::initializer_list<std::pair<std::string, std::vector<std::string>>>{
+               {"a = 42", {"a = 42"}},
+               {"b = (a + 358) * 10", {"b = 4000"}},
+               {"c = b / 16 - 250", {"c = 0"}},
+               {"d = 2147483648", {}}}) { // Literal does not fit 32 bits
+
+        const auto operationResults = calculator.processInstruction(arithmeticExpression);
+        ASSERT_EQ(operationResults, expectedResults) << arithmeticExpression;
+    }
+}
+
+/**
+ * @brief Tests that repeated arithmetic expressions are served from the expression cache
+ * and evaluated against the current operand values
+ */
+TEST(CalculatorIntegrationTest, calculatorReusesCompiledExpressions)
+{
+    Calculator::Runner calculator;
+
+    for (const auto& [arithmeticExpression, expectedResults] :
+         std::initializer_list<std::pair<std::string, std::vector<std::string>>>{
+               {"total=a+b*c", {}},                      // Miss: compiled and cached
+               {"a=1", {"a = 1"}},                       // Miss
+               {"b=2", {"b = 2"}},                       // Miss
+               {"c=3", {"c = 3", "total = 7"}},          // Miss
+               {"total = a + b * c", {"total = 7"}},     // Hit (white spaces are ignored)
+               {"c=3", {"c = 3", "total = 7"}},          // Hit
+               {"grand_total=a+b*c", {"grand_total = 7"}}, // Hit (another LHS, same RHS)
+               {"result", {"return grand_total = 7"}}}) { // Commands are not cached
+
+        const auto operationResults = calculator.processInstruction(arithmeticExpression);
+        ASSERT_EQ(operationResults, expectedResults) << arithmeticExpression;
+    }
+
+    ASSERT_EQ(calculator.getExpressionCache().getHitCount(), 3);
+    ASSERT_EQ(calculator.getExpressionCache().getMissCount(), 4);
+}
+
+/**
+ * @brief Tests that results can be handed over to a callback instead of being returned
+ */
+TEST(CalculatorIntegrationTest, calculatorHandsResultsToACallback)
+{
+    Calculator::Runner calculator;
+    std::string output;
+
+    const auto appendResult = [&output](const std::string_view result) {
+        output.append(result);
+        output.push_back(';');
+    };
+
+    for (const auto* instruction : {"b=a*2", "a=0-21", "a=7", "undo 1", "result"}) {
+        ASSERT_TRUE(calculator.processInstruction(instruction, appendResult)) << instruction;
+    }
+
+    ASSERT_EQ(output, "a = -21;b = -42;a = 7;b = 14;delete a;return b = 14;");
+}
+
+/**
+ * @brief Tests that rejected instructions report why and where, without any result
+ */
+TEST(CalculatorIntegrationTest, calculatorReportsWhyInstructionsAreRejected)
+{
+    using Utils::ErrorCode;
+
+    Calculator::Runner calculator;
+    std::string output;
+
+    const auto appendResult = [&output](const std::string_view result) {
+        output.append(result);
+    };
+
+    for (const auto& [instruction, expectedError] :
+         std::initializer_list<std::pair<std::string_view, Utils::Error>>{
+               {"result", {ErrorCode::NO_RESULT_AVAILABLE, 0}},
+               {" undo 1", {ErrorCode::NOTHING_TO_UNDO, 1}},
+               {"restore  missing", {ErrorCode::UNKNOWN_CHECKPOINT, 9}},
+               {"a = 2 $ 3", {ErrorCode::UNEXPECTED_CHARACTER, 6}}}) {
+
+        const auto instructionResult = calculator.processInstruction(instruction, appendResult);
+        ASSERT_FALSE(instructionResult) << instruction;
+        ASSERT_EQ(instructionResult.getError(), expectedError) << instruction;
+    }
+
+    // Cycles are reported at the LHS operand, whether the expression was parsed or cached
+    ASSERT_TRUE(calculator.processInstruction("a = b", appendResult));
+    for (auto attempt = 0; attempt < 2; ++attempt) {
+        const auto instructionResult = calculator.processInstruction("  b = a + 1", appendResult);
+        ASSERT_FALSE(instructionResult);
+        ASSERT_EQ(instructionResult.getError(), (Utils::Error{ErrorCode::CYCLIC_DEPENDENCY, 2}));
+    }
+
+    ASSERT_TRUE(output.empty());
+    ASSERT_EQ(calculator.describeError({ErrorCode::CYCLIC_DEPENDENCY, 2}),
+              "Cyclic dependency found: 'b' -> 'a' -> 'b'");
+    ASSERT_EQ(calculator.describeError({ErrorCode::UNKNOWN_CHECKPOINT, 9}), "Unknown checkpoint");
+}
+
+/**
+ * @brief Tests that simplified expressions no longer depend on the operands they discarded
+ */
+TEST(CalculatorIntegrationTest, calculatorSimplifiesExpressions)
+{
+    Calculator::Runner calculator;
+
+    for (const auto& [arithmeticExpression, expectedResults] :
+         std::initializer_list<std::pair<std::string, std::vector<std::string>>>{
+               {"x = a*0 + 2*(3+4)", {"x = 14"}}, // 'a' is not a dependency
+               {"y = (b-b) + c*1", {}},           // Only depends on 'c'
+               {"b = 5", {"b = 5"}},              // Does not affect 'y'
+               {"c = 7", {"c = 7", "y = 7"}},
+               {"z = 7/2*2 + c", {"z = 14"}}}) {  // Integer division is not folded
+
+        const auto operationResults = calculator.processInstruction(arithmeticExpression);
+        ASSERT_EQ(operationResults, expectedResults) << arithmeticExpression;
+    }
+}
+
+/**
+ * @brief Tests that resolving the head of a long chain of dependencies resolves every link
+ * of the chain, in order
+ */
+TEST(CalculatorIntegrationTest, calculatorResolvesLongDependencyChains)
+{
+    constexpr auto chainLength{100'000};
+    Calculator::Runner calculator;
+
+    // Every link depends on the previous one: "v1=v0+1", "v2=v1+1", ...
+    for (auto link = 1; link <= chainLength; ++link) {
+        const auto instruction
+              = "v" + std::to_string(link) + "=v" + std::to_string(link - 1) + "+1";
+        ASSERT_TRUE(calculator.processInstruction(instruction).empty());
+    }
+
+    const auto operationResults = calculator.processInstruction("v0=0");
+    ASSERT_EQ(operationResults.size(), chainLength + 1);
+
+    for (auto link = 0; link <= chainLength; ++link) {
+        ASSERT_EQ(operationResults[static_cast<std::size_t>(link)],
+                  "v" + std::to_string(link) + " = " + std::to_string(link));
+    }
+}
+
+/**
+ * @brief Tests that operands reachable through several dependency paths (diamonds)
+ * are evaluated and reported once, after all of their dependencies
+ */
+TEST(CalculatorIntegrationTest, calculatorResolvesDiamondDependenciesOnce)
+{
+    constexpr auto diamondCount{32};
+    Calculator::Runner calculator;
+
+    // Stacked diamonds: "l1=s0+1", "r1=s0*2", "s1=l1+r1", "l2=s1+1", ...
+    for (auto diamond = 1; diamond <= diamondCount; ++diamond) {
+        const auto index = std::to_string(diamond);
+        const auto previousSum = "s" + std::to_string(diamond - 1);
+
+        ASSERT_TRUE(calculator.processInstruction("l" + index + "=" + previousSum + "+1").empty());
+        ASSERT_TRUE(calculator.processInstruction("r" + index + "=" + previousSum + "*2").empty());
+        const auto sum = "s" + index + "=l" + index + "-r" + index;
+        ASSERT_TRUE(calculator.processInstruction(sum).empty());
+    }
+
+    // s(n) = (s(n-1) + 1) - s(n-1) * 2 = 1 - s(n-1): with s0 = 0, the sums alternate
+    const auto operationResults = calculator.processInstruction("s0=0");
+    ASSERT_EQ(operationResults.size(), 3 * diamondCount + 1);
+
+    std::vector<std::string> expectedResults{"s0 = 0"};
+    for (auto diamond = 1; diamond <= diamondCount; ++diamond) {
+        const auto index = std::to_string(diamond);
+        const auto previousSum = (diamond - 1) % 2;
+
+        expectedResults.push_back("l" + index + " = " + std::to_string(previousSum + 1));
+        expectedResults.push_back("r" + index + " = " + std::to_string(previousSum * 2));
+        expectedResults.push_back("s" + index + " = " + std::to_string(1 - previousSum));
+    }
+
+    ASSERT_EQ(operationResults, expectedResults);
+}
+
+/**
+ * @brief Tests that an operand written during a propagation is read with its new value by the
+ * expressions evaluated after it, even when an expression evaluated before read its old value
+ */
+TEST(CalculatorIntegrationTest, calculatorReadsOperandsUpdatedDuringAPropagation)
+{
+    Calculator::Runner calculator;
+
+    for (const auto& [arithmeticExpression, expectedResults] :
+         std::initializer_list<std::pair<std::string, std::vector<std::string>>>{
+               {"x = 0", {"x = 0"}},
+               {"e1 = x + a", {}},   // Only depends on 'a' ('x' already has a value)
+               {"x = a + 1", {}},    // 'x' is pending again
+               {"e2 = x + e1", {}},  // Depends on both
+               {"a = 1", {"a = 1", "e1 = 1", "x = 2", "e2 = 3"}}}) {
+
+        const auto operationResults = calculator.processInstruction(arithmeticExpression);
+        ASSERT_EQ(operationResults, expectedResults) << arithmeticExpression;
+    }
+}
+
+/**
+ * @brief Tests that expressions keep producing the same results once they became hot
+ * and got translated to machine code
+ */
+TEST(CalculatorIntegrationTest, calculatorKeepsResultsOfHotExpressions)
+{
+    constexpr auto updateCount{3 * static_cast<int>(Calculator::cDefaultJitThreshold)};
+    Calculator::Runner calculator;
+
+    ASSERT_TRUE(calculator.processInstruction("y = (x*3 - 7) / 2 + z").empty());
+    ASSERT_EQ(calculator.processInstruction("z = 1"), std::vector<std::string>{"z = 1"});
+
+    for (auto update = 0; update < updateCount; ++update) {
+        const auto expectedValue
+              = static_cast<int>((static_cast<float>(update) * 3.f - 7.f) / 2.f + 1.f);
+
+        const std::vector<std::string> expectedResults{"x = " + std::to_string(update),
+                                                       "y = " + std::to_string(expectedValue)};
+        ASSERT_EQ(calculator.processInstruction("x = " + std::to_string(update)), expectedResults);
+    }
+}
+
+/**
+ * @brief Tests that expressions reading operands updated during a propagation produce the same
+ * results once they became hot and got translated to machine code as when they were interpreted
+ */
+TEST(CalculatorIntegrationTest, calculatorKeepsResultsOfHotExpressionsReadingUpdatedOperands)
+{
+    constexpr auto updateCount{3 * static_cast<int>(Calculator::cDefaultJitThreshold)};
+    Calculator::Runner calculator;
+
+    for (const auto* const instruction : {"x = 0", "e1 = x + a", "x = a + 1", "e2 = x + e1"}) {
+        [[maybe_unused]] const auto results = calculator.processInstruction(instruction);
+    }
+
+    // 'e1' reads the value 'x' had before the update, 'e2' the new one
+    auto previousX{0};
+    for (auto update = 1; update <= updateCount; ++update) {
+        const auto e1 = previousX + update;
+        const auto x = update + 1;
+
+        const std::vector<std::string> expectedResults{"a = " + std::to_string(update),
+                                                       "e1 = " + std::to_string(e1),
+                                                       "x = " + std::to_string(x),
+                                                       "e2 = " + std::to_string(x + e1)};
+        ASSERT_EQ(calculator.processInstruction("a = " + std::to_string(update)), expectedResults)
+              << "update " << update;
+
+        previousX = x;
+    }
+}
+
+/**
+ * @brief Tests that checkpoints bring back the values, the pending expressions and the order
+ * of operations they recorded, whichever branch of the history they belong to
+ */
+TEST(CalculatorIntegrationTest, calculatorRestoresCheckpoints)
+{
+    Calculator::Runner calculator;
+
+    for (const auto& [arithmeticExpression, expectedResults] :
+         std::initializer_list<std::pair<std::string, std::vector<std::string>>>{
+               {"a = 1", {"a = 1"}},
+               {"b = c + a", {}},
+               {"checkpoint start", {}},
+               {"c = 2", {"c = 2", "b = 3"}},
+               {"b = 10", {"b = 10"}},
+               {"checkpoint first", {}},
+               {"restore start", {}},
+               {"result", {"return a = 1"}}, // 'b' and 'c' have no value anymore
+               {"c = 5", {"c = 5", "b = 6"}}, // 'b' still depends on 'c'
+               {"undo 2", {"delete c", "delete b"}},
+               {"checkpoint second", {}},
+               {"restore first", {}},        // Other branch of the history
+               {"result", {"return b = 10"}},
+               {"a = 7", {"a = 7"}},         // 'b' no longer depends on anything
+               {"restore second", {}},
+               {"result", {"return a = 1"}},
+               {"c = 3", {"c = 3"}},         // 'b' was deleted by the undo
+               {"restore unknown", {}}}) {
+
+        const auto operationResults = calculator.processInstruction(arithmeticExpression);
+        ASSERT_EQ(operationResults, expectedResults) << arithmeticExpression;
+    }
+}
@@ -0,0 +1,150 @@
+#include "gtest/gtest.h"
+
+#include "bytecode/Compiler.hpp"
+#include "bytecode/Optimizer.hpp"
+
+using namespace ::testing;
+
+/**
+ * @brief Test fixture for the AST simplification pass
+ */
+class OptimizerUnitTest : public Test
+{
+protected:
+    /**
+     * @brief Builds an AST from an expression written in postfix notation (e.g. "45+7*")
+     *
+     * Variables are single letters whose symbol identifier is their position in the alphabet
+     *
+     * @param[in] postfixExpression Single character operands and operators in postfix order
+     *
+     * @return Generated AST
+     */
+    [[nodiscard]] static AST::Tree buildAST(const std::string& postfixExpression)
+    {
+        AST::Tree ast(postfixExpression.size());
+        std::vector<AST::NodeIndex> valueStack;
+
+        for (const auto character : postfixExpression) {
+            if (std::isdigit(character)) {
+                valueStack.push_back(ast.addConstant(character - '0'));
+                continue;
+            }
+
+            if (std::isalpha(character)) {
+                valueStack.push_back(
+                      ast.addVariable(static_cast<Symbols::SymbolId>(character - 'a')));
+                continue;
+            }
+
+            const auto rightNode = valueStack.back();
+            valueStack.pop_back();
+            const auto leftNode = valueStack.back();
+            valueStack.pop_back();
+            valueStack.push_back(ast.addOperator(character, leftNode, rightNode));
+        }
+
+        return ast;
+    }
+
+    /**
+     * @brief Checks that simplifying an expression yields the expected one
+     *
+     * @param[in] postfixExpression Expression to simplify, in postfix notation
+     * @param[in] expectedPostfixExpression Expected simplified expression, in postfix notation
+     */
+    static void expectSimplification(const std::string& postfixExpression,
+                                     const std::string& expectedPostfixExpression)
+    {
+        const auto simplifiedAST = Bytecode::simplify(buildAST(postfixExpression));
+        const auto expectedAST = buildAST(expectedPostfixExpression);
+
+        // Both node pools are in post-order, so identical trees have identical pools
+        const auto nodes = simplifiedAST.getNodes();
+        const auto expectedNodes = expectedAST.getNodes();
+        ASSERT_EQ(nodes.size(), expectedNodes.size()) << postfixExpression;
+
+        for (std::size_t index = 0; index < nodes.size(); ++index) {
+            const auto& node = nodes[index];
+            const auto& expectedNode = expectedNodes[index];
+
+            ASSERT_EQ(node.getNodeType(), expectedNode.getNodeType()) << postfixExpression;
+            ASSERT_EQ(node.getSymbolId(), expectedNode.getSymbolId()) << postfixExpression;
+            ASSERT_EQ(node.getLeftNodeIndex(), expectedNode.getLeftNodeIndex())
+                  << postfixExpression;
+            ASSERT_EQ(node.getRightNodeIndex(), expectedNode.getRightNodeIndex())
+                  << postfixExpression;
+        }
+    }
+};
+
+/**
+ * @brief Tests that constant sub-expressions are folded
+ */
+TEST_F(OptimizerUnitTest, optimizerFoldsConstantSubExpressions)
+{
+    expectSimplification("23+a*", "5a*");         // (2+3)*a
+    expectSimplification("a84/4*+", "a8+");       // a+8/4*4
+    expectSimplification("84/1+2*", "6");         // (8/4+1)*2
+    expectSimplification("9", "9");
+    expectSimplification("a", "a");
+}
+
+/**
+ * @brief Tests that constant sub-expressions are not folded when their value is not an integer
+ */
+TEST_F(OptimizerUnitTest, optimizerKeepsFractionalAndUndefinedValues)
+{
+    expectSimplification("72/a*", "72/a*"); // 7/2*a
+    expectSimplification("92/2*", "92/2*"); // 9/2*2 (9/2 is not folded, so neither is its parent)
+    expectSimplification("90/", "90/");     // 9/0
+    expectSimplification("00/", "00/");     // 0/0
+}
+
+/**
+ * @brief Tests that operations with a neutral element are replaced by their other operand
+ */
+TEST_F(OptimizerUnitTest, optimizerRemovesNeutralElements)
+{
+    expectSimplification("a1*", "a");
+    expectSimplification("1a*", "a");
+    expectSimplification("a1/", "a");
+    expectSimplification("a0+", "a");
+    expectSimplification("0a+", "a");
+    expectSimplification("a0-", "a");
+    expectSimplification("ab*32-*", "ab*"); // a*b*(3-2)
+
+    // Not an identity: 0-a and 1/a
+    expectSimplification("0a-", "0a-");
+    expectSimplification("1a/", "1a/");
+}
+
+/**
+ * @brief Tests that absorbing operations are folded only when the discarded operand is finite
+ */
+TEST_F(OptimizerUnitTest, optimizerFoldsAbsorbingOperationsOfFiniteOperands)
+{
+    expectSimplification("ab+0*", "0");     // (a+b)*0
+    expectSimplification("0ab-*", "0");     // 0*(a-b)
+    expectSimplification("ab+ab+-", "0");   // (a+b)-(a+b)
+    expectSimplification("ab+c+1-ab+c+1--", "0");
+
+    // Products and quotients may overflow or divide by zero: their value has to be computed
+    expectSimplification("ab/0*", "ab/0*"); // a/b*0
+    expectSimplification("ab*ab*-", "ab*ab*-");
+    expectSimplification("ab+ba+-", "ab+ba+-"); // Not structurally identical
+}
+
+/**
+ * @brief Tests that variables only referenced by discarded sub-expressions are no longer
+ * dependencies of the compiled program
+ */
+TEST_F(OptimizerUnitTest, optimizerDropsDiscardedDependencies)
+{
+    // (a+b)*0+c*(4-3)
+    const auto program = Bytecode::compile(Bytecode::simplify(buildAST("ab+0*c43-*+")));
+
+    const std::vector<Symbols::SymbolId> expectedVariables{2};
+    ASSERT_TRUE(std::ranges::equal(program.getVariables(), expectedVariables));
+    ASSERT_EQ(program.getInstructions().size(), 1);
+}
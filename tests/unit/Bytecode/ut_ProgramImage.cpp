@@ -0,0 +1,151 @@
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "bytecode/ProgramImage.hpp"
+#include "evaluator/VirtualMachine.hpp"
+#include "parser/Parser.hpp"
+
+using namespace ::testing;
+
+/**
+ * @brief Test fixture for the ProgramImage class, holding an image of a few formulas
+ */
+class ProgramImageUnitTest : public Test
+{
+protected:
+    void SetUp() override
+    {
+        for (const auto* const formula :
+             {"total = price * quantity + tax", "tax = price / 3", "constant = (2 + 3) * 4"}) {
+            Parser parser(formula, mSymbolTable);
+            ASSERT_TRUE(parser.execute()) << formula;
+            mTargets.push_back(parser.getOperandOfLHS());
+            mPrograms.push_back(parser.extractProgramOfRHS());
+        }
+
+        std::vector<Bytecode::ProgramImage::Formula> formulas;
+        for (std::size_t formulaIndex = 0; formulaIndex < mPrograms.size(); ++formulaIndex) {
+            formulas.push_back({mTargets[formulaIndex], &mPrograms[formulaIndex]});
+        }
+        mImage = Bytecode::ProgramImage::write(formulas, mSymbolTable);
+    }
+
+protected:
+    /// Symbol table the formulas are compiled with
+    Symbols::SymbolTable mSymbolTable;
+
+    /// Operands the formulas are assigned to
+    std::vector<Symbols::SymbolId> mTargets;
+
+    /// Compiled programs of the formulas
+    std::vector<Bytecode::Program> mPrograms;
+
+    /// Image of the formulas
+    std::vector<std::byte> mImage;
+};
+
+/**
+ * @brief Tests that formulas read back from an image match the programs they were written from,
+ * once bound to the symbols of another symbol table
+ */
+TEST_F(ProgramImageUnitTest, programImageRoundTripsFormulas)
+{
+    const auto image = Bytecode::ProgramImage::open(mImage);
+    ASSERT_TRUE(image);
+    ASSERT_EQ(image->getFormulaCount(), 3U);
+    ASSERT_EQ(image->getSymbolCount(), 5U);
+    ASSERT_EQ(image->getSymbolName(0), "total");
+    ASSERT_EQ(image->getSymbolName(image->getFormula(1).target), "tax");
+
+    // Symbols get other identifiers in the symbol table the image is loaded with
+    Symbols::SymbolTable otherSymbolTable;
+    otherSymbolTable.intern("unrelated");
+    std::vector<Symbols::SymbolId> symbolBindings;
+    for (std::size_t symbolIndex = 0; symbolIndex < image->getSymbolCount(); ++symbolIndex) {
+        symbolBindings.push_back(otherSymbolTable.intern(image->getSymbolName(symbolIndex)));
+    }
+
+    for (std::size_t formulaIndex = 0; formulaIndex < mPrograms.size(); ++formulaIndex) {
+        const auto program
+              = Bytecode::ProgramImage::bind(image->getFormula(formulaIndex), symbolBindings);
+        ASSERT_EQ(program.getMaxStackDepth(), mPrograms[formulaIndex].getMaxStackDepth());
+        ASSERT_EQ(program.getInstructions().size(),
+                  mPrograms[formulaIndex].getInstructions().size());
+
+        for (std::size_t variableIndex = 0; variableIndex < program.getVariables().size();
+             ++variableIndex) {
+            ASSERT_EQ(otherSymbolTable.getName(program.getVariables()[variableIndex]),
+                      mSymbolTable.getName(mPrograms[formulaIndex].getVariables()[variableIndex]));
+        }
+    }
+}
+
+/**
+ * @brief Tests that formulas executed in place give the same results as their programs
+ */
+TEST_F(ProgramImageUnitTest, programImageFormulasAreExecutedInPlace)
+{
+    const auto image = Bytecode::ProgramImage::open(mImage);
+    ASSERT_TRUE(image);
+
+    std::vector<Symbols::SymbolId> symbolBindings;
+    for (std::size_t symbolIndex = 0; symbolIndex < image->getSymbolCount(); ++symbolIndex) {
+        symbolBindings.push_back(*mSymbolTable.find(image->getSymbolName(symbolIndex)));
+    }
+
+    std::vector<Symbols::ValueSlot> values(mSymbolTable.size());
+    values[*mSymbolTable.find("price")] = {7, true};
+
+    // Missing values are reported with the symbol identifiers of their operands
+    VirtualMachine pendingMachine(image->getFormula(0), symbolBindings, values);
+    ASSERT_EQ(std::get<Evaluator::Dependencies>(pendingMachine.execute()),
+              (Evaluator::Dependencies{*mSymbolTable.find("quantity"), *mSymbolTable.find("tax")}));
+
+    values[*mSymbolTable.find("quantity")] = {3, true};
+    values[*mSymbolTable.find("tax")] = {2, true};
+
+    for (std::size_t formulaIndex = 0; formulaIndex < mPrograms.size(); ++formulaIndex) {
+        VirtualMachine imageMachine(image->getFormula(formulaIndex), symbolBindings, values);
+        VirtualMachine programMachine(mPrograms[formulaIndex], values);
+        ASSERT_EQ(imageMachine.execute(), programMachine.execute());
+    }
+}
+
+/**
+ * @brief Tests that malformed images are rejected when opened
+ */
+TEST_F(ProgramImageUnitTest, programImageRejectsMalformedImages)
+{
+    // Truncated images
+    for (std::size_t size = 0; size < mImage.size(); ++size) {
+        ASSERT_FALSE(Bytecode::ProgramImage::open(std::span{mImage}.first(size))) << size;
+    }
+
+    // Misaligned images
+    std::vector<std::byte> shiftedImage(mImage.size() + 1);
+    std::memcpy(shiftedImage.data() + 1, mImage.data(), mImage.size());
+    ASSERT_FALSE(Bytecode::ProgramImage::open(std::span{shiftedImage}.subspan(1)));
+
+    // Other versions
+    auto corruptedImage = mImage;
+    corruptedImage[8] = std::byte{2};
+    ASSERT_FALSE(Bytecode::ProgramImage::open(corruptedImage));
+
+    // Unknown operation codes, loads of undeclared variables and unbalanced stacks
+    const auto image = Bytecode::ProgramImage::open(mImage);
+    ASSERT_TRUE(image);
+    const auto instructionOffset = static_cast<std::size_t>(
+          reinterpret_cast<const std::byte*>(image->getFormula(0).instructions.data())
+          - mImage.data());
+
+    for (const auto& [byteOffset, value] : std::vector<std::pair<std::size_t, uint8_t>>{
+               {0, 9}, {4, 4}, {24, 2}, {16, 0}}) {
+        corruptedImage = mImage;
+        corruptedImage[instructionOffset + byteOffset] = std::byte{value};
+        ASSERT_FALSE(Bytecode::ProgramImage::open(corruptedImage)) << byteOffset;
+    }
+}
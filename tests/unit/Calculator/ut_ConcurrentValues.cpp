@@ -0,0 +1,206 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <numeric>
+#include <random>
+#include <thread>
+
+#include "calculator/ConcurrentValues.hpp"
+#include "calculator/State.hpp"
+
+using namespace ::testing;
+
+/**
+ * @brief Tests that readers only see committed values, along with the names of the operands
+ */
+TEST(ConcurrentValuesUnitTest, concurrentValuesOnlyExposeCommittedValues)
+{
+    Symbols::SymbolTable symbolTable;
+    const auto operandA = symbolTable.intern("a");
+    const auto operandB = symbolTable.intern("b");
+
+    auto values = std::make_shared<Calculator::ConcurrentValues>();
+    auto reader = Calculator::ConcurrentValues::Reader::attach(values);
+    ASSERT_TRUE(reader);
+
+    Calculator::ConcurrentValues::Snapshot snapshot;
+    reader->read(snapshot);
+    ASSERT_EQ(snapshot.version, 0U);
+    ASSERT_TRUE(snapshot.values.empty());
+
+    values->write(operandA, {1, true});
+    reader->read(snapshot);
+    ASSERT_TRUE(snapshot.values.empty());
+
+    values->commit(symbolTable);
+    reader->read(snapshot);
+    ASSERT_EQ(snapshot.version, 1U);
+    ASSERT_EQ(snapshot.names, (std::vector<std::string_view>{"a", "b"}));
+    ASSERT_EQ(snapshot.values[operandA].value, 1);
+    ASSERT_TRUE(snapshot.values[operandA].isDefined);
+    ASSERT_FALSE(snapshot.values[operandB].isDefined);
+
+    // Values written twice before a commit only expose the last one
+    values->write(operandB, {2, true});
+    values->write(operandB, {3, true});
+    values->write(operandA, {});
+    reader->read(snapshot);
+    ASSERT_EQ(snapshot.version, 1U);
+    ASSERT_TRUE(snapshot.values[operandA].isDefined);
+    ASSERT_FALSE(snapshot.values[operandB].isDefined);
+
+    values->commit(symbolTable);
+    reader->read(snapshot);
+    ASSERT_EQ(snapshot.version, 2U);
+    ASSERT_FALSE(snapshot.values[operandA].isDefined);
+    ASSERT_EQ(snapshot.values[operandB].value, 3);
+}
+
+/**
+ * @brief Tests that the number of attached readers is bounded and that slots are reused
+ */
+TEST(ConcurrentValuesUnitTest, concurrentValuesBoundTheNumberOfReaders)
+{
+    auto values = std::make_shared<Calculator::ConcurrentValues>();
+    std::vector<Calculator::ConcurrentValues::Reader> readers;
+
+    for (std::size_t readerIndex = 0; readerIndex < Calculator::cMaxConcurrentReaderCount;
+         ++readerIndex) {
+        auto reader = Calculator::ConcurrentValues::Reader::attach(values);
+        ASSERT_TRUE(reader);
+        readers.push_back(std::move(*reader));
+    }
+
+    ASSERT_FALSE(Calculator::ConcurrentValues::Reader::attach(values));
+
+    readers.pop_back();
+    ASSERT_TRUE(Calculator::ConcurrentValues::Reader::attach(values));
+}
+
+/**
+ * @brief Tests that readers running alongside the writer always see whole commits:
+ * every commit moves units between operands, so the total never changes
+ */
+TEST(ConcurrentValuesUnitTest, concurrentValuesKeepSnapshotsConsistent)
+{
+    constexpr std::size_t cOperandCount{5000};
+    constexpr int32_t cInitialValue{10};
+    constexpr int cCommitCount{20'000};
+    constexpr int cReaderCount{4};
+    constexpr int64_t cTotal{static_cast<int64_t>(cOperandCount) * cInitialValue};
+
+    Symbols::SymbolTable symbolTable;
+    auto values = std::make_shared<Calculator::ConcurrentValues>();
+    std::vector<int32_t> operandValues(cOperandCount, cInitialValue);
+
+    for (std::size_t operand = 0; operand < cOperandCount; ++operand) {
+        const auto symbolId = symbolTable.intern("v" + std::to_string(operand));
+        values->write(symbolId, {cInitialValue, true});
+    }
+    values->commit(symbolTable);
+
+    std::atomic<bool> isWriting{true};
+    std::atomic<int> inconsistentSnapshotCount{0};
+    std::atomic<int> snapshotCount{0};
+    std::vector<std::thread> readers;
+
+    for (int readerIndex = 0; readerIndex < cReaderCount; ++readerIndex) {
+        readers.emplace_back([&] {
+            auto reader = Calculator::ConcurrentValues::Reader::attach(values);
+            Calculator::ConcurrentValues::Snapshot snapshot;
+            uint64_t lastVersion{0};
+
+            // Read at least once after the writer is done
+            bool isLastRead{false};
+            while (!isLastRead) {
+                isLastRead = !isWriting.load();
+                reader->read(snapshot);
+
+                int64_t total{0};
+                for (const auto& value : snapshot.values) {
+                    total += value.isDefined ? value.value : 0;
+                }
+
+                if (total != cTotal || snapshot.values.size() != cOperandCount
+                    || snapshot.version < lastVersion) {
+                    ++inconsistentSnapshotCount;
+                }
+
+                lastVersion = snapshot.version;
+                ++snapshotCount;
+            }
+        });
+    }
+
+    std::mt19937 generator{42};
+    std::uniform_int_distribution<std::size_t> operandDistribution{0, cOperandCount - 1};
+
+    for (int commit = 0; commit < cCommitCount; ++commit) {
+        for (int transfer = 0; transfer < 4; ++transfer) {
+            const auto source = operandDistribution(generator);
+            const auto destination = operandDistribution(generator);
+
+            --operandValues[source];
+            values->write(static_cast<Symbols::SymbolId>(source), {operandValues[source], true});
+            ++operandValues[destination];
+            values->write(static_cast<Symbols::SymbolId>(destination),
+                          {operandValues[destination], true});
+        }
+        values->commit(symbolTable);
+    }
+    isWriting = false;
+
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    ASSERT_EQ(inconsistentSnapshotCount, 0);
+    ASSERT_GE(snapshotCount, cReaderCount);
+
+    // The last snapshot holds the final values
+    auto reader = Calculator::ConcurrentValues::Reader::attach(values);
+    Calculator::ConcurrentValues::Snapshot snapshot;
+    reader->read(snapshot);
+    ASSERT_EQ(snapshot.version, static_cast<uint64_t>(cCommitCount) + 1);
+    for (std::size_t operand = 0; operand < cOperandCount; ++operand) {
+        ASSERT_EQ(snapshot.values[operand].value, operandValues[operand]);
+    }
+}
+
+/**
+ * @brief Tests that a state commits the values changed by each of its operations
+ */
+TEST(ConcurrentValuesUnitTest, stateSharesItsValuesWithReaders)
+{
+    Calculator::State calculatorState;
+    auto& symbolTable = calculatorState.getSymbolTable();
+    const auto operandA = symbolTable.intern("a");
+
+    // Values stored before sharing them are committed right away
+    [[maybe_unused]] const auto affectedValues = calculatorState.storeExpressionValue(operandA, 1);
+    calculatorState.updateOperationOrder(operandA);
+
+    const auto values = calculatorState.enableConcurrentReads();
+    ASSERT_EQ(calculatorState.enableConcurrentReads(), values);
+
+    auto reader = Calculator::ConcurrentValues::Reader::attach(values);
+    Calculator::ConcurrentValues::Snapshot snapshot;
+    reader->read(snapshot);
+    ASSERT_EQ(snapshot.names, (std::vector<std::string_view>{"a"}));
+    ASSERT_EQ(snapshot.values[operandA].value, 1);
+
+    const auto operandB = symbolTable.intern("b");
+    [[maybe_unused]] const auto newAffectedValues
+          = calculatorState.storeExpressionValue(operandB, 2);
+    calculatorState.updateOperationOrder(operandB);
+
+    reader->read(snapshot);
+    ASSERT_EQ(snapshot.names, (std::vector<std::string_view>{"a", "b"}));
+    ASSERT_EQ(snapshot.values[operandB].value, 2);
+
+    [[maybe_unused]] const auto undoneOperations
+          = calculatorState.undoLastRegisteredOperations(2);
+    reader->read(snapshot);
+    ASSERT_FALSE(snapshot.values[operandA].isDefined);
+    ASSERT_FALSE(snapshot.values[operandB].isDefined);
+}
@@ -0,0 +1,200 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <random>
+
+#include "calculator/DependencyOrder.hpp"
+
+using namespace ::testing;
+
+/**
+ * @brief Test fixture for the DependencyOrder class
+ */
+class DependencyOrderUnitTest : public Test
+{
+protected:
+    /**
+     * @brief Adds dependencies to an operand, unless they would introduce a cycle
+     *
+     * @param[in] operand Operand whose dependencies are added
+     * @param[in] dependencies New dependencies of the operand
+     *
+     * @return Cycle introduced by the new dependencies (empty if they were added)
+     */
+    std::vector<Symbols::SymbolId> addDependencies(const Symbols::SymbolId operand,
+                                                   const std::vector<Symbols::SymbolId>& dependencies)
+    {
+        const auto cycle = mDependencyOrder.insertDependencies(
+              operand, dependencies, mDependencyGraph, [this](const Symbols::SymbolId dependant) {
+                  return std::span<const Symbols::SymbolId>{mDependencyLists[dependant]};
+              });
+
+        if (cycle.empty()) {
+            for (const auto dependency : dependencies) {
+                mDependencyGraph[dependency].push_back(operand);
+                mDependencyLists[operand].push_back(dependency);
+            }
+        }
+
+        return {cycle.begin(), cycle.end()};
+    }
+
+    /**
+     * @brief Checks if an operand depends on another one, by searching the whole graph
+     *
+     * @param[in] operand Operand which may depend on the other one
+     * @param[in] dependency Operand which may be depended on
+     *
+     * @return True if there is a path from the dependency to the operand
+     */
+    [[nodiscard]] bool dependsOn(const Symbols::SymbolId operand,
+                                 const Symbols::SymbolId dependency) const
+    {
+        std::vector<bool> isVisited(mDependencyGraph.size());
+        std::vector<Symbols::SymbolId> operandsToVisit{dependency};
+
+        while (!operandsToVisit.empty()) {
+            const auto visitedOperand = operandsToVisit.back();
+            operandsToVisit.pop_back();
+
+            if (visitedOperand == operand) {
+                return true;
+            }
+
+            for (const auto dependant : mDependencyGraph[visitedOperand]) {
+                if (!isVisited[dependant]) {
+                    isVisited[dependant] = true;
+                    operandsToVisit.push_back(dependant);
+                }
+            }
+        }
+
+        return false;
+    }
+
+protected:
+    /// Order under test
+    Calculator::DependencyOrder mDependencyOrder;
+
+    /// Dependency graph: operands depending on each operand
+    Calculator::PropagationEngine::DependencyGraph mDependencyGraph;
+
+    /// Dependencies of each operand
+    Calculator::PropagationEngine::DependencyGraph mDependencyLists;
+};
+
+/**
+ * @brief Tests that cycles are reported with their path, each operand depending on the next one
+ */
+TEST_F(DependencyOrderUnitTest, dependencyOrderReportsCycles)
+{
+    mDependencyGraph.resize(4);
+    mDependencyLists.resize(4);
+
+    // 0 depends on 1, 1 depends on 2, 2 depends on 3
+    ASSERT_TRUE(addDependencies(0, {1}).empty());
+    ASSERT_TRUE(addDependencies(1, {2}).empty());
+    ASSERT_TRUE(addDependencies(2, {3}).empty());
+    ASSERT_LT(mDependencyOrder.getPosition(3), mDependencyOrder.getPosition(2));
+    ASSERT_LT(mDependencyOrder.getPosition(2), mDependencyOrder.getPosition(1));
+    ASSERT_LT(mDependencyOrder.getPosition(1), mDependencyOrder.getPosition(0));
+
+    const std::vector<Symbols::SymbolId> expectedCycle{3, 0, 1, 2, 3};
+    ASSERT_EQ(addDependencies(3, {0}), expectedCycle);
+
+    const std::vector<Symbols::SymbolId> expectedSelfCycle{2, 2};
+    ASSERT_EQ(addDependencies(2, {2}), expectedSelfCycle);
+}
+
+/**
+ * @brief Tests random dependencies against a search of the whole graph
+ */
+TEST_F(DependencyOrderUnitTest, dependencyOrderMatchesFullSearch)
+{
+    constexpr Symbols::SymbolId cOperandCount{200};
+    std::mt19937 randomGenerator(42);
+
+    mDependencyGraph.resize(cOperandCount);
+    mDependencyLists.resize(cOperandCount);
+
+    for (int step = 0; step < 2'000; ++step) {
+        const auto operand = static_cast<Symbols::SymbolId>(randomGenerator() % cOperandCount);
+        const auto dependency = static_cast<Symbols::SymbolId>(randomGenerator() % cOperandCount);
+
+        const auto isCyclic = dependsOn(dependency, operand);
+        const auto cycle = addDependencies(operand, {dependency});
+        ASSERT_EQ(!cycle.empty(), isCyclic) << "step " << step;
+
+        // Every operand of the cycle depends on the next one
+        for (std::size_t index = 0; index + 1 < cycle.size(); ++index) {
+            ASSERT_TRUE(cycle[index] == operand
+                        || std::ranges::count(mDependencyLists[cycle[index]], cycle[index + 1]));
+        }
+
+        // Every operand comes after its dependencies
+        for (Symbols::SymbolId dependant = 0; dependant < cOperandCount; ++dependant) {
+            for (const auto dependantDependency : mDependencyLists[dependant]) {
+                ASSERT_LT(mDependencyOrder.getPosition(dependantDependency),
+                          mDependencyOrder.getPosition(dependant));
+            }
+        }
+    }
+}
+
+/**
+ * @brief Tests that defining stacked diamonds top-down (formulas before their inputs) never
+ * moves the operands defined before
+ */
+TEST_F(DependencyOrderUnitTest, dependencyOrderPlacesTopDownFormulasWithoutReordering)
+{
+    constexpr Symbols::SymbolId cDiamondCount{50};
+
+    // Level k is made of a_k = x_(k-1) + 1, b_k = x_(k-1) * 2 and x_k = (a_k + b_k) / 3, whose
+    // identifiers are given in the order they are first met, like interned operand names
+    std::vector<Symbols::SymbolId> leftOperands(cDiamondCount + 1);
+    std::vector<Symbols::SymbolId> rightOperands(cDiamondCount + 1);
+    std::vector<Symbols::SymbolId> joinOperands(cDiamondCount + 1);
+    Symbols::SymbolId nextOperand{0};
+
+    for (auto level = cDiamondCount; level > 0; --level) {
+        leftOperands[level] = nextOperand++;
+        joinOperands[level - 1] = nextOperand++;
+        rightOperands[level] = nextOperand++;
+        if (level == cDiamondCount) {
+            joinOperands[level] = nextOperand++;
+        }
+    }
+
+    const auto getLeft = [&](const Symbols::SymbolId level) { return leftOperands[level]; };
+    const auto getRight = [&](const Symbols::SymbolId level) { return rightOperands[level]; };
+    const auto getJoin = [&](const Symbols::SymbolId level) { return joinOperands[level]; };
+
+    mDependencyGraph.resize(nextOperand);
+    mDependencyLists.resize(nextOperand);
+    std::vector<Symbols::SymbolId> definedOperands;
+
+    for (auto level = cDiamondCount; level > 0; --level) {
+        std::vector<int64_t> positions;
+        for (const auto operand : definedOperands) {
+            positions.push_back(mDependencyOrder.getPosition(operand));
+        }
+
+        ASSERT_TRUE(addDependencies(getLeft(level), {getJoin(level - 1)}).empty());
+        ASSERT_TRUE(addDependencies(getRight(level), {getJoin(level - 1)}).empty());
+        ASSERT_TRUE(addDependencies(getJoin(level), {getLeft(level), getRight(level)}).empty());
+
+        for (std::size_t index = 0; index < definedOperands.size(); ++index) {
+            ASSERT_EQ(mDependencyOrder.getPosition(definedOperands[index]), positions[index]);
+        }
+        definedOperands.insert(definedOperands.end(),
+                               {getLeft(level), getRight(level), getJoin(level)});
+    }
+
+    // Every operand comes after its dependencies
+    for (Symbols::SymbolId dependant = 0; dependant < mDependencyLists.size(); ++dependant) {
+        for (const auto dependency : mDependencyLists[dependant]) {
+            ASSERT_LT(mDependencyOrder.getPosition(dependency),
+                      mDependencyOrder.getPosition(dependant));
+        }
+    }
+}
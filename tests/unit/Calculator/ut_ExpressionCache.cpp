@@ -0,0 +1,102 @@
+#include "gtest/gtest.h"
+
+#include "calculator/ExpressionCache.hpp"
+
+using namespace ::testing;
+
+/**
+ * @brief Test fixture for the ExpressionCache class
+ */
+class ExpressionCacheUnitTest : public Test
+{
+protected:
+    /**
+     * @brief Creates a program pushing a single constant
+     *
+     * @param[in] value Constant pushed by the program
+     *
+     * @return Compiled program shared with the cache
+     */
+    [[nodiscard]] static Calculator::ExpressionCache::CompiledExpression makeProgram(
+          const float value)
+    {
+        Bytecode::Program program;
+        program.emitConstant(value);
+
+        return std::make_shared<const Bytecode::Program>(std::move(program));
+    }
+};
+
+/**
+ * @brief Tests that lookups are counted as hits or misses
+ */
+TEST_F(ExpressionCacheUnitTest, cacheCountsHitsAndMisses)
+{
+    Calculator::ExpressionCache cache(4);
+
+    ASSERT_EQ(cache.find("a+b"), nullptr);
+    const auto program = makeProgram(1.f);
+    cache.insert("a+b", program);
+
+    ASSERT_EQ(cache.find("a+b"), program);
+    ASSERT_EQ(cache.find("a+b"), program);
+    ASSERT_EQ(cache.find("a-b"), nullptr);
+
+    ASSERT_EQ(cache.getHitCount(), 2);
+    ASSERT_EQ(cache.getMissCount(), 2);
+    ASSERT_EQ(cache.size(), 1);
+}
+
+/**
+ * @brief Tests that expressions only differing by their white spaces share the same entry,
+ * unless the white spaces separate two words
+ */
+TEST_F(ExpressionCacheUnitTest, cacheNormalizesWhiteSpaces)
+{
+    Calculator::ExpressionCache cache(4);
+
+    const auto program = makeProgram(1.f);
+    cache.insert(" a + b*(c - 1) ", program);
+
+    ASSERT_EQ(cache.find("a+b*(c-1)"), program);
+    ASSERT_EQ(cache.find("a +\tb * ( c-1 )"), program);
+
+    cache.insert("1 2", makeProgram(2.f));
+    ASSERT_EQ(cache.find("12"), nullptr);
+    ASSERT_NE(cache.find("1   2"), nullptr);
+}
+
+/**
+ * @brief Tests that the least recently used expression is evicted once the cache is full
+ */
+TEST_F(ExpressionCacheUnitTest, cacheEvictsLeastRecentlyUsedExpression)
+{
+    Calculator::ExpressionCache cache(2);
+
+    cache.insert("a", makeProgram(1.f));
+    cache.insert("b", makeProgram(2.f));
+
+    // Using "a" makes "b" the least recently used expression
+    ASSERT_NE(cache.find("a"), nullptr);
+    cache.insert("c", makeProgram(3.f));
+
+    ASSERT_EQ(cache.size(), 2);
+    ASSERT_NE(cache.find("a"), nullptr);
+    ASSERT_EQ(cache.find("b"), nullptr);
+    ASSERT_NE(cache.find("c"), nullptr);
+}
+
+/**
+ * @brief Tests that a cache without capacity does not store anything
+ */
+TEST_F(ExpressionCacheUnitTest, cacheWithoutCapacityIsDisabled)
+{
+    Calculator::ExpressionCache cache(0);
+
+    cache.insert("a+b", makeProgram(1.f));
+
+    ASSERT_EQ(cache.find("a+b"), nullptr);
+    ASSERT_EQ(cache.size(), 0);
+    ASSERT_EQ(cache.getHitCount(), 0);
+    ASSERT_EQ(cache.getMissCount(), 0);
+}
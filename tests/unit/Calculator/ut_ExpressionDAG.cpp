@@ -0,0 +1,145 @@
+#include "gtest/gtest.h"
+
+#include "calculator/ExpressionDAG.hpp"
+
+using namespace ::testing;
+
+/**
+ * @brief Test fixture for the ExpressionDAG class
+ */
+class ExpressionDAGUnitTest : public Test
+{
+protected:
+    /**
+     * @brief Creates the program of "left * right + offset"
+     *
+     * @param[in] left Symbol of the left factor
+     * @param[in] right Symbol of the right factor
+     * @param[in] offset Symbol added to the product
+     *
+     * @return Compiled program
+     */
+    [[nodiscard]] static Bytecode::Program makeProductPlusOffset(const Symbols::SymbolId left,
+                                                                 const Symbols::SymbolId right,
+                                                                 const Symbols::SymbolId offset)
+    {
+        Bytecode::Program program;
+        program.emitVariable(left);
+        program.emitVariable(right);
+        program.emitOperation(Bytecode::OpCode::MUL);
+        program.emitVariable(offset);
+        program.emitOperation(Bytecode::OpCode::ADD);
+
+        return program;
+    }
+
+protected:
+    /// Graph under test
+    Calculator::ExpressionDAG mExpressionDAG;
+
+    /// Values of the operands, indexed by symbol identifier
+    std::vector<Symbols::ValueSlot> mValueSlots{{2, true}, {3, true}, {4, true}, {0, false}};
+};
+
+/**
+ * @brief Tests that identical sub-expressions are stored once
+ */
+TEST_F(ExpressionDAGUnitTest, graphSharesIdenticalSubExpressions)
+{
+    const auto firstRoot = mExpressionDAG.insert(makeProductPlusOffset(0, 1, 2));
+    ASSERT_EQ(mExpressionDAG.size(), 5);
+
+    // "b*c+d" and "c*b+d" are the same expression
+    const auto secondRoot = mExpressionDAG.insert(makeProductPlusOffset(1, 0, 2));
+    ASSERT_EQ(secondRoot, firstRoot);
+    ASSERT_EQ(mExpressionDAG.size(), 5);
+
+    // "b*c+e" only adds the variable 'e' and the final addition
+    const auto thirdRoot = mExpressionDAG.insert(makeProductPlusOffset(0, 1, 3));
+    ASSERT_NE(thirdRoot, firstRoot);
+    ASSERT_EQ(mExpressionDAG.size(), 7);
+}
+
+/**
+ * @brief Tests that nodes are removed once no expression uses them anymore
+ */
+TEST_F(ExpressionDAGUnitTest, graphRemovesUnreferencedNodes)
+{
+    const auto firstRoot = mExpressionDAG.insert(makeProductPlusOffset(0, 1, 2));
+    const auto secondRoot = mExpressionDAG.insert(makeProductPlusOffset(0, 1, 3));
+    ASSERT_EQ(mExpressionDAG.size(), 7);
+
+    mExpressionDAG.release(secondRoot);
+    ASSERT_EQ(mExpressionDAG.size(), 5);
+
+    mExpressionDAG.release(firstRoot);
+    ASSERT_EQ(mExpressionDAG.size(), 0);
+}
+
+/**
+ * @brief Tests that expressions are evaluated like the virtual machine does
+ */
+TEST_F(ExpressionDAGUnitTest, graphEvaluatesExpressions)
+{
+    const auto definedRoot = mExpressionDAG.insert(makeProductPlusOffset(0, 1, 2));
+    const auto undefinedRoot = mExpressionDAG.insert(makeProductPlusOffset(0, 1, 3));
+
+    mExpressionDAG.beginPropagation();
+    ASSERT_EQ(mExpressionDAG.evaluate(definedRoot, mValueSlots), 10);
+    ASSERT_EQ(mExpressionDAG.evaluate(undefinedRoot, mValueSlots), std::nullopt);
+
+    Bytecode::Program division;
+    division.emitVariable(2);
+    division.emitVariable(1);
+    division.emitOperation(Bytecode::OpCode::DIV);
+    const auto divisionRoot = mExpressionDAG.insert(division);
+
+    mExpressionDAG.beginPropagation();
+    ASSERT_EQ(mExpressionDAG.evaluate(divisionRoot, mValueSlots), 1);
+}
+
+/**
+ * @brief Tests that memoized values are only reused within the same propagation
+ */
+TEST_F(ExpressionDAGUnitTest, graphDiscardsMemoizedValuesBetweenPropagations)
+{
+    const auto rootNode = mExpressionDAG.insert(makeProductPlusOffset(0, 1, 2));
+
+    mExpressionDAG.beginPropagation();
+    ASSERT_EQ(mExpressionDAG.evaluate(rootNode, mValueSlots), 10);
+
+    // Within the same propagation, the memoized value is returned
+    mValueSlots[0].value = 5;
+    ASSERT_EQ(mExpressionDAG.evaluate(rootNode, mValueSlots), 10);
+
+    mExpressionDAG.beginPropagation();
+    ASSERT_EQ(mExpressionDAG.evaluate(rootNode, mValueSlots), 19);
+}
+
+/**
+ * @brief Tests that writing an operand during a propagation only discards the memoized values
+ * which read it
+ */
+TEST_F(ExpressionDAGUnitTest, graphDiscardsMemoizedValuesReadingAWrittenOperand)
+{
+    const auto firstRoot = mExpressionDAG.insert(makeProductPlusOffset(0, 1, 2));
+    const auto secondRoot = mExpressionDAG.insert(makeProductPlusOffset(1, 2, 0));
+
+    mExpressionDAG.beginPropagation();
+    ASSERT_EQ(mExpressionDAG.evaluate(firstRoot, mValueSlots), 10);
+    ASSERT_EQ(mExpressionDAG.evaluate(secondRoot, mValueSlots), 14);
+
+    // Both expressions read 'c' (through "a*b" for the first one, directly for the second one)
+    mValueSlots[2].value = 5;
+    mExpressionDAG.invalidate(2);
+    ASSERT_EQ(mExpressionDAG.evaluate(firstRoot, mValueSlots), 11);
+    ASSERT_EQ(mExpressionDAG.evaluate(secondRoot, mValueSlots), 17);
+
+    // Values which do not read the written operand are still memoized
+    mValueSlots[0].value = 6;
+    mExpressionDAG.invalidate(3);
+    ASSERT_EQ(mExpressionDAG.evaluate(firstRoot, mValueSlots), 11);
+
+    // Operands read by no expression are ignored
+    mExpressionDAG.invalidate(42);
+}
@@ -0,0 +1,80 @@
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "calculator/FormulaLibrary.hpp"
+
+using namespace ::testing;
+
+/**
+ * @brief Tests that registering compiled formulas has the same effects as processing them
+ * as instructions, whether they can be evaluated right away or are left pending
+ */
+TEST(FormulaLibraryUnitTest, registeredFormulasBehaveLikeInstructions)
+{
+    const std::vector<std::string> formulas{
+          "price = 3", "total = price * quantity + tax", "tax = price / 3", "double = 2 * total"};
+
+    std::string source{"# Prices\n\n"};
+    for (const auto& formula : formulas) {
+        source += formula + "\n";
+    }
+
+    const auto image = Calculator::FormulaLibrary::compile(source);
+    ASSERT_TRUE(image);
+
+    const auto path = "/tmp/ut_FormulaLibrary." + std::to_string(getpid()) + ".img";
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    ASSERT_NE(file, nullptr);
+    std::fwrite(image->data(), 1, image->size(), file);
+    std::fclose(file);
+
+    const auto library = Calculator::FormulaLibrary::open(path);
+    std::remove(path.c_str());
+    ASSERT_TRUE(library);
+    ASSERT_EQ(library->getImage().getFormulaCount(), formulas.size());
+
+    Calculator::Runner registeredRunner;
+    ASSERT_EQ(registeredRunner.processInstruction("unrelated = 1"),
+              std::vector<std::string>{"unrelated = 1"});
+    ASSERT_EQ(registeredRunner.registerFormulas(library->getImage()),
+              (std::vector<std::string>{"price = 3", "tax = 1"}));
+
+    Calculator::Runner processedRunner;
+    [[maybe_unused]] const auto unrelatedResults
+          = processedRunner.processInstruction("unrelated = 1");
+    for (const auto& formula : formulas) {
+        [[maybe_unused]] const auto results = processedRunner.processInstruction(formula);
+    }
+
+    for (const auto* const instruction : {"quantity = 4", "result", "price = 6", "undo 3"}) {
+        ASSERT_EQ(registeredRunner.processInstruction(instruction),
+                  processedRunner.processInstruction(instruction))
+              << instruction;
+    }
+}
+
+/**
+ * @brief Tests that formula files are rejected along with the position of their first error
+ */
+TEST(FormulaLibraryUnitTest, formulaLibraryRejectsInvalidFormulas)
+{
+    const auto unfinishedImage = Calculator::FormulaLibrary::compile("a = 1\nb = 2 +\nc = (\n");
+    ASSERT_FALSE(unfinishedImage);
+    ASSERT_EQ(unfinishedImage.getError(), (Utils::Error{Utils::ErrorCode::UNEXPECTED_END, 13}));
+
+    const auto commandImage = Calculator::FormulaLibrary::compile("a = 1\n  undo 1\n");
+    ASSERT_FALSE(commandImage);
+    ASSERT_EQ(commandImage.getError(),
+              (Utils::Error{Utils::ErrorCode::INVALID_INSTRUCTION, 8}));
+
+    ASSERT_FALSE(Calculator::FormulaLibrary::open("/nonexistent/formulas.img"));
+
+    const auto emptyImage = Calculator::FormulaLibrary::compile("# Nothing yet\n");
+    ASSERT_TRUE(emptyImage);
+    ASSERT_TRUE(Bytecode::ProgramImage::open(*emptyImage));
+}
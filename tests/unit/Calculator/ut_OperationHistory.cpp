@@ -0,0 +1,144 @@
+#include "gtest/gtest.h"
+
+#include <random>
+
+#include "calculator/OperationHistory.hpp"
+
+using namespace ::testing;
+
+namespace {
+
+/**
+ * @brief Retrieves the last fulfilled operand by scanning a whole history
+ *
+ * @param[in] history Operands of the operations, oldest first
+ * @param[in] valueSlots Current values of the operands
+ *
+ * @return Operand of the last fulfilled operation (empty if there is none)
+ */
+std::optional<Symbols::SymbolId> findLastFulfilledOperand(
+      const std::vector<Symbols::SymbolId>& history,
+      const Symbols::ValueSlots valueSlots)
+{
+    for (auto operand = history.rbegin(); operand != history.rend(); ++operand) {
+        if (Symbols::isDefined(valueSlots, *operand)) {
+            return *operand;
+        }
+    }
+
+    return std::nullopt;
+}
+
+} // namespace
+
+/**
+ * @brief Tests that the last fulfilled operation follows value changes
+ */
+TEST(OperationHistoryUnitTest, operationHistoryTracksLastFulfilledOperation)
+{
+    std::vector<Symbols::ValueSlot> valueSlots(3);
+    Calculator::OperationHistory operationHistory;
+    ASSERT_FALSE(operationHistory.getLastFulfilledOperand());
+
+    // a = 1, b = c + 1, c = 2
+    valueSlots[0] = {1, true};
+    operationHistory.push(0, valueSlots);
+    operationHistory.push(1, valueSlots);
+    ASSERT_EQ(operationHistory.getLastFulfilledOperand(), 0);
+
+    valueSlots[2] = {2, true};
+    operationHistory.push(2, valueSlots);
+    ASSERT_EQ(operationHistory.getLastFulfilledOperand(), 2);
+
+    // b gets resolved, but it was registered before c
+    valueSlots[1] = {3, true};
+    operationHistory.updateValue(1, valueSlots);
+    ASSERT_EQ(operationHistory.getLastFulfilledOperand(), 2);
+
+    // Undo c, b loses its value
+    valueSlots[2] = {};
+    operationHistory.updateValue(2, valueSlots);
+    ASSERT_EQ(operationHistory.pop(valueSlots), 2);
+    ASSERT_EQ(operationHistory.getLastFulfilledOperand(), 1);
+
+    valueSlots[1] = {};
+    operationHistory.updateValue(1, valueSlots);
+    ASSERT_EQ(operationHistory.getLastFulfilledOperand(), 0);
+    ASSERT_EQ(operationHistory.size(), 2);
+    ASSERT_EQ(operationHistory.top(), 1);
+}
+
+/**
+ * @brief Tests that a bounded history forgets its oldest operations
+ */
+TEST(OperationHistoryUnitTest, operationHistoryForgetsOperationsBeyondItsDepth)
+{
+    std::vector<Symbols::ValueSlot> valueSlots(4);
+    Calculator::OperationHistory operationHistory(2);
+
+    valueSlots[0] = {1, true};
+    operationHistory.push(0, valueSlots);
+    operationHistory.push(1, valueSlots);
+    operationHistory.push(2, valueSlots);
+    ASSERT_EQ(operationHistory.size(), 2);
+    ASSERT_FALSE(operationHistory.getLastFulfilledOperand());
+
+    // Only the latest entry of an operand which is still kept counts
+    operationHistory.push(0, valueSlots);
+    ASSERT_EQ(operationHistory.getLastFulfilledOperand(), 0);
+    operationHistory.push(3, valueSlots);
+    operationHistory.push(3, valueSlots);
+    ASSERT_FALSE(operationHistory.getLastFulfilledOperand());
+
+    valueSlots[0] = {2, true};
+    operationHistory.updateValue(0, valueSlots);
+    ASSERT_FALSE(operationHistory.getLastFulfilledOperand());
+
+    ASSERT_EQ(operationHistory.pop(valueSlots), 3);
+    ASSERT_EQ(operationHistory.pop(valueSlots), 3);
+    ASSERT_EQ(operationHistory.size(), 0);
+}
+
+/**
+ * @brief Tests random sequences of operations against a full scan of the history
+ */
+TEST(OperationHistoryUnitTest, operationHistoryMatchesFullScan)
+{
+    constexpr Symbols::SymbolId cOperandCount{8};
+    std::mt19937 randomGenerator(42);
+
+    for (const std::size_t maxDepth : {0U, 1U, 5U, 32U}) {
+        std::vector<Symbols::ValueSlot> valueSlots(cOperandCount);
+        std::vector<Symbols::SymbolId> history;
+        Calculator::OperationHistory operationHistory(maxDepth);
+
+        for (int step = 0; step < 10'000; ++step) {
+            const auto operand = static_cast<Symbols::SymbolId>(randomGenerator() % cOperandCount);
+
+            switch (randomGenerator() % 3) {
+            case 0:
+                operationHistory.push(operand, valueSlots);
+                history.push_back(operand);
+                if (maxDepth > 0 && history.size() > maxDepth) {
+                    history.erase(history.begin());
+                }
+                break;
+            case 1:
+                if (!history.empty()) {
+                    ASSERT_EQ(operationHistory.pop(valueSlots), history.back());
+                    history.pop_back();
+                }
+                break;
+            default:
+                valueSlots[operand].isDefined = !valueSlots[operand].isDefined;
+                operationHistory.updateValue(operand, valueSlots);
+                break;
+            }
+
+            ASSERT_EQ(operationHistory.size(), history.size());
+            ASSERT_EQ(operationHistory.getLastFulfilledOperand(),
+                      findLastFulfilledOperand(history, valueSlots))
+                  << "depth " << maxDepth << ", step " << step;
+        }
+    }
+}
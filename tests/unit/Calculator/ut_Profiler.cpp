@@ -0,0 +1,44 @@
+#include "gtest/gtest.h"
+
+#include <string_view>
+
+#include "calculator/Profiler.hpp"
+#include "calculator/Runner.hpp"
+
+using namespace ::testing;
+using Method = Calculator::Profiler::Method;
+
+/**
+ * @brief Tests that every call of a profiled method of the state is accumulated
+ */
+TEST(ProfilerUnitTest, profilerCountsTheCallsOfTheStateMethods)
+{
+    Calculator::Profiler profiler;
+    Calculator::Runner calculator;
+    calculator.setProfiler(&profiler);
+
+    for (const std::string_view instruction :
+         {"a = 1", "b = c + a", "c = 2", "result", "checkpoint x", "undo 1", "restore x"}) {
+        [[maybe_unused]] const auto results = calculator.processInstruction(instruction);
+    }
+
+    ASSERT_EQ(profiler.getTotals(Method::STORE_EXPRESSION_VALUE).calls, 2);
+    ASSERT_EQ(profiler.getTotals(Method::STORE_EXPRESSION_DEPENDENCIES).calls, 1);
+    ASSERT_EQ(profiler.getTotals(Method::UPDATE_OPERATION_ORDER).calls, 3);
+    ASSERT_EQ(profiler.getTotals(Method::GET_LAST_FULFILLED_OPERATION).calls, 1);
+    ASSERT_EQ(profiler.getTotals(Method::UNDO_LAST_OPERATIONS).calls, 1);
+    ASSERT_EQ(profiler.getTotals(Method::CREATE_CHECKPOINT).calls, 1);
+    ASSERT_EQ(profiler.getTotals(Method::RESTORE_CHECKPOINT).calls, 1);
+    ASSERT_GT(profiler.getTotals(Method::STORE_EXPRESSION_VALUE).time.count(), 0);
+
+    // Calls are no longer accumulated once profiling is disabled
+    calculator.setProfiler(nullptr);
+    [[maybe_unused]] const auto results = calculator.processInstruction("a = 3");
+    ASSERT_EQ(profiler.getTotals(Method::STORE_EXPRESSION_VALUE).calls, 2);
+
+    profiler.reset();
+    ASSERT_EQ(profiler.getTotals(Method::STORE_EXPRESSION_VALUE).calls, 0);
+    ASSERT_EQ(profiler.getTotals(Method::STORE_EXPRESSION_VALUE).time.count(), 0);
+    ASSERT_STREQ(Calculator::Profiler::getMethodName(Method::STORE_EXPRESSION_VALUE),
+                 "storeExpressionValue");
+}
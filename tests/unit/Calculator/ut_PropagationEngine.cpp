@@ -0,0 +1,96 @@
+#include "gtest/gtest.h"
+
+#include "calculator/PropagationEngine.hpp"
+
+using namespace ::testing;
+
+/**
+ * @brief Test fixture for the PropagationEngine class
+ */
+class PropagationEngineUnitTest : public Test
+{
+protected:
+    /**
+     * @brief Retrieves the operands of a schedule, along with their levels
+     *
+     * @param[in] changedOperand Operand whose value changed
+     *
+     * @return Pairs of scheduled operands and levels
+     */
+    [[nodiscard]] std::vector<std::pair<Symbols::SymbolId, uint32_t>>
+          getSchedule(const Symbols::SymbolId changedOperand)
+    {
+        std::vector<std::pair<Symbols::SymbolId, uint32_t>> schedule;
+        for (const auto& [operand, level] :
+             mPropagationEngine.schedule(changedOperand, mDependencyGraph)) {
+            schedule.emplace_back(operand, level);
+        }
+
+        return schedule;
+    }
+
+protected:
+    /// Engine under test
+    Calculator::PropagationEngine mPropagationEngine;
+
+    /// Dependency graph: operands depending on each operand
+    Calculator::PropagationEngine::DependencyGraph mDependencyGraph;
+};
+
+/**
+ * @brief Tests that operands reachable through several paths are scheduled once,
+ * after all of their affected dependencies
+ */
+TEST_F(PropagationEngineUnitTest, engineSchedulesDiamondsOnceInTopologicalOrder)
+{
+    // 0 -> {1, 2}, 1 -> {3}, 2 -> {3}, 3 -> {4}, 0 -> {4}
+    mDependencyGraph = {{1, 2, 4}, {3}, {3}, {4}, {}};
+
+    const std::vector<std::pair<Symbols::SymbolId, uint32_t>> expectedSchedule{
+          {1, 1}, {2, 1}, {3, 2}, {4, 3}};
+    ASSERT_EQ(getSchedule(0), expectedSchedule);
+
+    // Scheduling is repeatable and only covers the operands downstream of the changed one
+    ASSERT_EQ(getSchedule(0), expectedSchedule);
+
+    const std::vector<std::pair<Symbols::SymbolId, uint32_t>> expectedPartialSchedule{
+          {3, 1}, {4, 2}};
+    ASSERT_EQ(getSchedule(2), expectedPartialSchedule);
+}
+
+/**
+ * @brief Tests that operands which are part of a cycle are never scheduled
+ */
+TEST_F(PropagationEngineUnitTest, engineDoesNotScheduleCycles)
+{
+    // 0 -> {1}, 1 -> {2}, 2 -> {1, 3}: 1 and 2 depend on each other
+    mDependencyGraph = {{1}, {2}, {1, 3}, {}};
+    ASSERT_TRUE(getSchedule(0).empty());
+
+    // A cycle going through the changed operand is cut at the changed operand
+    // 0 -> {1}, 1 -> {2}, 2 -> {0}
+    mDependencyGraph = {{1}, {2}, {0}};
+
+    const std::vector<std::pair<Symbols::SymbolId, uint32_t>> expectedSchedule{{1, 1}, {2, 2}};
+    ASSERT_EQ(getSchedule(0), expectedSchedule);
+}
+
+/**
+ * @brief Tests that only operands with an updated dependency are flagged as outdated
+ */
+TEST_F(PropagationEngineUnitTest, engineFlagsDependentsOfUpdatedOperands)
+{
+    // 0 -> {1, 2}, 1 -> {3}
+    mDependencyGraph = {{1, 2}, {3}, {}, {}};
+
+    static_cast<void>(mPropagationEngine.schedule(0, mDependencyGraph));
+    mPropagationEngine.markUpdated(0, mDependencyGraph);
+
+    ASSERT_TRUE(mPropagationEngine.isOutdated(1));
+    ASSERT_TRUE(mPropagationEngine.isOutdated(2));
+    ASSERT_FALSE(mPropagationEngine.isOutdated(3));
+
+    // Flags do not carry over to the next propagation
+    static_cast<void>(mPropagationEngine.schedule(1, mDependencyGraph));
+    ASSERT_FALSE(mPropagationEngine.isOutdated(2));
+}
@@ -0,0 +1,278 @@
+#include "gtest/gtest.h"
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <variant>
+
+#include "calculator/State.hpp"
+#include "evaluator/VirtualMachine.hpp"
+#include "parser/Parser.hpp"
+
+using namespace ::testing;
+
+/**
+ * @brief Test fixture for the State class
+ */
+class StateUnitTest : public Test
+{
+protected:
+    /**
+     * @brief Processes an assignment, storing its value or its dependencies into a state
+     *
+     * @param[in,out] calculatorState State to update
+     * @param[in] instruction Assignment to process (e.g. "b = a + 1")
+     *
+     * @return Operands and values affected by the assignment
+     */
+    static std::vector<Calculator::State::OperandValue>
+          processAssignment(Calculator::State& calculatorState, const std::string& instruction)
+    {
+        Parser parser(instruction, calculatorState.getSymbolTable());
+        EXPECT_TRUE(parser.execute()) << instruction;
+
+        VirtualMachine virtualMachine(parser.getProgramOfRHS(), calculatorState.getOperandValues());
+        const auto result = virtualMachine.execute();
+
+        if (const auto* value = std::get_if<int>(&result)) {
+            return calculatorState.storeExpressionValue(parser.getOperandOfLHS(), *value);
+        }
+
+        EXPECT_TRUE(calculatorState.storeExpressionDependencies(
+              parser.getOperandOfLHS(),
+              parser.getProgramOfRHS(),
+              std::get<Evaluator::Dependencies>(result)));
+        return {};
+    }
+
+    /**
+     * @brief Builds a wide dependency graph: many operands depend on "x",
+     * and as many depend on pairs of those
+     *
+     * @param[in,out] calculatorState State to register the expressions into
+     */
+    static void buildWideGraph(Calculator::State& calculatorState)
+    {
+        for (auto operand = 0; operand < cLevelSize; ++operand) {
+            const auto index = std::to_string(operand);
+            processAssignment(calculatorState, "a" + index + " = (x + " + index + ") * y");
+        }
+
+        for (auto operand = 0; operand < cLevelSize; ++operand) {
+            const auto index = std::to_string(operand);
+            const auto otherIndex = std::to_string((operand * 7) % cLevelSize);
+            processAssignment(calculatorState,
+                              "b" + index + " = a" + index + " - a" + otherIndex + " / 3");
+        }
+    }
+
+protected:
+    /// Number of operands of each level of the wide graph
+    static constexpr int cLevelSize{3000};
+};
+
+/**
+ * @brief Tests that a parallel propagation reports the same values, in the same order,
+ * as a sequential one
+ */
+TEST_F(StateUnitTest, parallelPropagationMatchesSequentialPropagation)
+{
+    Calculator::State sequentialState;
+    buildWideGraph(sequentialState);
+
+    Calculator::State parallelState;
+    parallelState.enableParallelPropagation(4, 16);
+    buildWideGraph(parallelState);
+
+    // Operands are only resolved once 'y' has a value
+    ASSERT_EQ(processAssignment(sequentialState, "y = 3"),
+              processAssignment(parallelState, "y = 3"));
+
+    // Enough updates to get the expressions translated to machine code
+    for (auto value = 0; value < 2 * static_cast<int>(Calculator::cDefaultJitThreshold); ++value) {
+        const auto instruction = "x = " + std::to_string(value);
+
+        const auto sequentialValues = processAssignment(sequentialState, instruction);
+        ASSERT_EQ(sequentialValues.size(), 2 * cLevelSize + 1);
+        ASSERT_EQ(processAssignment(parallelState, instruction), sequentialValues) << instruction;
+    }
+}
+
+/**
+ * @brief Tests that shared sub-expressions read the value an operand was given earlier in the
+ * same propagation, not the one memoized before it changed
+ */
+TEST_F(StateUnitTest, propagationReadsOperandsWrittenDuringThePropagation)
+{
+    Calculator::State calculatorState;
+
+    // "e1" reads the old value of "x" (it does not depend on it), "e2" its new one
+    for (const auto* const instruction : {"x = 0", "e1 = x + a", "x = a + 1", "e2 = x + e1"}) {
+        processAssignment(calculatorState, instruction);
+    }
+
+    const auto& symbolTable = calculatorState.getSymbolTable();
+    const auto getOperand = [&symbolTable](const std::string_view name) {
+        return *symbolTable.find(name);
+    };
+
+    const std::vector<Calculator::State::OperandValue> expectedValues{
+          {getOperand("a"), 1}, {getOperand("e1"), 1}, {getOperand("x"), 2}, {getOperand("e2"), 3}};
+    ASSERT_EQ(processAssignment(calculatorState, "a = 1"), expectedValues);
+}
+
+/**
+ * @brief Tests that a parallel propagation reads the operands written during the propagation
+ * like a sequential one, including once the expressions are translated to machine code
+ */
+TEST_F(StateUnitTest, parallelPropagationMatchesSequentialPropagationOfUpdatedOperands)
+{
+    Calculator::State sequentialState;
+    Calculator::State parallelState;
+
+    // Every level is evaluated on the pool, however small
+    parallelState.enableParallelPropagation(4, 1);
+
+    for (const auto* const instruction : {"x = 0", "e1 = x + a", "x = a + 1", "e2 = x + e1"}) {
+        processAssignment(sequentialState, instruction);
+        processAssignment(parallelState, instruction);
+    }
+
+    for (auto value = 1; value <= 2 * static_cast<int>(Calculator::cDefaultJitThreshold); ++value) {
+        const auto instruction = "a = " + std::to_string(value);
+
+        const auto sequentialValues = processAssignment(sequentialState, instruction);
+        ASSERT_EQ(sequentialValues.size(), 4) << instruction;
+        ASSERT_EQ(processAssignment(parallelState, instruction), sequentialValues) << instruction;
+
+        // e2 = (a + 1) + (x + a), 'x' still holding its value of the previous update in 'e1'
+        const auto previousX = value == 1 ? 0 : value;
+        ASSERT_EQ(sequentialValues.back().second, (value + 1) + (previousX + value)) << instruction;
+    }
+}
+
+/**
+ * @brief Tests that restoring a checkpoint only depends on the changes made since,
+ * and that long histories are released without exhausting the stack
+ */
+TEST_F(StateUnitTest, stateRestoresCheckpointsAfterLongHistories)
+{
+    auto calculatorState = std::make_unique<Calculator::State>();
+    processAssignment(*calculatorState, "y = x + 1");
+    processAssignment(*calculatorState, "x = 1");
+    calculatorState->createCheckpoint("start");
+
+    const auto x = calculatorState->getSymbolTable().intern("x");
+    const auto y = calculatorState->getSymbolTable().intern("y");
+
+    for (auto value = 0; value < 200'000; ++value) {
+        ASSERT_EQ(calculatorState->storeExpressionValue(x, value).size(), 2);
+    }
+    calculatorState->createCheckpoint("end");
+
+    ASSERT_TRUE(calculatorState->restoreCheckpoint("start"));
+    ASSERT_EQ(calculatorState->getOperandValues()[x].value, 1);
+    ASSERT_EQ(calculatorState->getOperandValues()[y].value, 2);
+
+    ASSERT_TRUE(calculatorState->restoreCheckpoint("end"));
+    ASSERT_EQ(calculatorState->getOperandValues()[y].value, 200'000);
+
+    ASSERT_FALSE(calculatorState->restoreCheckpoint("missing"));
+    calculatorState.reset();
+}
+
+/**
+ * @brief Tests that cycles are rejected however long they are, along with their path
+ */
+TEST_F(StateUnitTest, stateRejectsLongCyclicDependencies)
+{
+    constexpr int cChainLength{10'000};
+
+    Calculator::State calculatorState;
+    for (auto operand = 0; operand + 1 < cChainLength; ++operand) {
+        processAssignment(calculatorState,
+                          "a" + std::to_string(operand) + " = a" + std::to_string(operand + 1));
+    }
+
+    Parser parser("a" + std::to_string(cChainLength - 1) + " = a0 + 1",
+                  calculatorState.getSymbolTable());
+    ASSERT_TRUE(parser.execute());
+    const auto& variables = parser.getProgramOfRHS().getVariables();
+    ASSERT_FALSE(calculatorState.storeExpressionDependencies(parser.getOperandOfLHS(),
+                                                             parser.getProgramOfRHS(),
+                                                             {variables.begin(), variables.end()}));
+
+    // The last operand would depend on the first one, which depends on the second one...
+    const auto& symbolTable = calculatorState.getSymbolTable();
+    const auto cycle = calculatorState.getCyclicDependency();
+    ASSERT_EQ(cycle.size(), cChainLength + 1);
+    ASSERT_EQ(cycle.front(), parser.getOperandOfLHS());
+    ASSERT_EQ(cycle.back(), parser.getOperandOfLHS());
+    for (auto operand = 0; operand + 1 < cChainLength; ++operand) {
+        ASSERT_EQ(symbolTable.getName(cycle[static_cast<std::size_t>(operand) + 1]),
+                  "a" + std::to_string(operand));
+    }
+
+    // Closing the chain elsewhere is fine
+    processAssignment(calculatorState, "a" + std::to_string(cChainLength - 1) + " = b");
+    ASSERT_TRUE(calculatorState.getCyclicDependency().empty());
+    ASSERT_EQ(processAssignment(calculatorState, "b = 7").size(), cChainLength + 1);
+}
+
+/**
+ * @brief Tests that a state loaded from a snapshot behaves exactly like the original one:
+ * same values, pending expressions, order of operations and checkpoints
+ */
+TEST_F(StateUnitTest, stateSnapshotRoundTripsTheWholeState)
+{
+    Calculator::State originalState;
+    processAssignment(originalState, "a = 1");
+    processAssignment(originalState, "b = a + c");
+    processAssignment(originalState, "d = b * (e - 2)");
+    originalState.createCheckpoint("before");
+    processAssignment(originalState, "c = 2");
+    originalState.createCheckpoint("after");
+    processAssignment(originalState, "a = 5");
+
+    std::vector<std::byte> image;
+    originalState.saveSnapshot(image);
+
+    Calculator::State loadedState;
+    ASSERT_TRUE(loadedState.loadSnapshot(image));
+    ASSERT_FALSE(loadedState.loadSnapshot(image));
+
+    const auto snapshotValues = [](const Calculator::State& calculatorState) {
+        std::vector<std::pair<std::string, std::optional<int>>> values;
+        const auto& symbolTable = calculatorState.getSymbolTable();
+        for (Symbols::SymbolId operand = 0; operand < symbolTable.size(); ++operand) {
+            const auto& value = calculatorState.getOperandValues()[operand];
+            values.emplace_back(symbolTable.getName(operand),
+                                value.isDefined ? std::optional{value.value} : std::nullopt);
+        }
+        return values;
+    };
+    ASSERT_EQ(snapshotValues(loadedState), snapshotValues(originalState));
+    ASSERT_EQ(loadedState.getLastFulfilledOperation(), originalState.getLastFulfilledOperation());
+
+    // Both states keep evolving the same way
+    for (auto* calculatorState : {&originalState, &loadedState}) {
+        processAssignment(*calculatorState, "e = 4");
+        [[maybe_unused]] const auto undoneOperations
+              = calculatorState->undoLastRegisteredOperations(2);
+        ASSERT_TRUE(calculatorState->restoreCheckpoint("after"));
+        processAssignment(*calculatorState, "e = 3");
+    }
+    ASSERT_EQ(snapshotValues(loadedState), snapshotValues(originalState));
+    ASSERT_TRUE(loadedState.restoreCheckpoint("before"));
+    ASSERT_TRUE(originalState.restoreCheckpoint("before"));
+    ASSERT_EQ(snapshotValues(loadedState), snapshotValues(originalState));
+
+    // Truncated images are rejected
+    for (std::size_t size = 0; size < image.size(); ++size) {
+        Calculator::State truncatedState;
+        ASSERT_FALSE(truncatedState.loadSnapshot(std::span{image}.first(size))) << size;
+    }
+}
@@ -0,0 +1,114 @@
+#include "gtest/gtest.h"
+
+#include "calculator/Runner.hpp"
+#include "calculator/Statistics.hpp"
+
+using namespace ::testing;
+
+/**
+ * @brief Tests that percentiles are known within the resolution of the histogram buckets
+ */
+TEST(StatisticsUnitTest, histogramBoundsPercentiles)
+{
+    Calculator::Histogram histogram;
+    ASSERT_EQ(histogram.getPercentile(0.5), 0U);
+
+    for (uint64_t value = 1; value <= 1000; ++value) {
+        histogram.record(value);
+    }
+    histogram.record(1'000'000'000);
+
+    ASSERT_EQ(histogram.getCount(), 1001U);
+    ASSERT_EQ(histogram.getMax(), 1'000'000'000U);
+    ASSERT_EQ(histogram.getPercentile(1.), 1'000'000'000U);
+
+    // Small values are exact, larger ones are bounded within 1/16 of themselves
+    ASSERT_EQ(histogram.getPercentile(0.01), 11U);
+    const auto median = histogram.getPercentile(0.5);
+    ASSERT_GE(median, 501U);
+    ASSERT_LE(median, 501U + 501U / 16);
+    const auto lastPercentile = histogram.getPercentile(0.99);
+    ASSERT_GE(lastPercentile, 991U);
+    ASSERT_LE(lastPercentile, 991U + 991U / 16);
+
+    // Every 64 bits value has a bucket
+    histogram.record(std::numeric_limits<uint64_t>::max());
+    ASSERT_EQ(histogram.getPercentile(1.), std::numeric_limits<uint64_t>::max());
+}
+
+/**
+ * @brief Tests that the runner counts the instructions it processes and times their phases
+ */
+TEST(StatisticsUnitTest, runnerCountsAndTimesInstructions)
+{
+    Calculator::Runner runner;
+    runner.getStatistics().setTimingSamplePeriod(1);
+
+    for (const auto* instruction : {"a=b+1", "b=2", "c=b*2", "c=b*2", "1=2", "result"}) {
+        [[maybe_unused]] const auto results = runner.processInstruction(instruction);
+    }
+
+    const auto& statistics = runner.getStatistics();
+    const auto& counters = statistics.getCounters();
+    ASSERT_EQ(counters.instructions, 6U);
+    ASSERT_EQ(counters.rejectedInstructions, 1U);
+    ASSERT_EQ(counters.parsedExpressions, 3U);
+    ASSERT_EQ(counters.cachedExpressions, 1U);
+    // Re-evaluating 'a' when "b=2" is assigned is not counted
+    ASSERT_EQ(counters.assignedExpressionNodes, 3U + 1U + 3U + 3U);
+
+    // "b=2" also gives a value to 'a', the others only to the assigned operand
+    ASSERT_EQ(statistics.getCascadeSizes().getCount(), 3U);
+    ASSERT_EQ(statistics.getCascadeSizes().getMax(), 2U);
+
+    using Phase = Calculator::Statistics::Phase;
+    ASSERT_EQ(statistics.getInstructionLatencies().getCount(), 6U);
+    ASSERT_EQ(statistics.getPhaseLatencies(Phase::DETECTION).getCount(), 6U);
+    ASSERT_EQ(statistics.getPhaseLatencies(Phase::PARSING).getCount(), 5U);
+    ASSERT_EQ(statistics.getPhaseLatencies(Phase::EVALUATION).getCount(), 4U);
+    ASSERT_EQ(statistics.getPhaseLatencies(Phase::PROPAGATION).getCount(), 4U);
+    ASSERT_EQ(statistics.getPhaseLatencies(Phase::COMMAND).getCount(), 1U);
+}
+
+/**
+ * @brief Tests that only one instruction out of the sample period is timed
+ */
+TEST(StatisticsUnitTest, runnerSamplesTimings)
+{
+    Calculator::Runner runner;
+    runner.getStatistics().setTimingSamplePeriod(4);
+
+    for (int instructionIndex = 0; instructionIndex < 10; ++instructionIndex) {
+        [[maybe_unused]] const auto results = runner.processInstruction("a=1");
+    }
+
+    ASSERT_EQ(runner.getStatistics().getCounters().instructions, 10U);
+    ASSERT_EQ(runner.getStatistics().getInstructionLatencies().getCount(), 3U);
+}
+
+/**
+ * @brief Tests that the stats command reports the statistics in both formats
+ */
+TEST(StatisticsUnitTest, statsCommandReportsStatistics)
+{
+    Calculator::Runner runner;
+    [[maybe_unused]] const auto assignmentResults = runner.processInstruction("a=b+1");
+
+    const auto entries = runner.processInstruction("stats");
+    ASSERT_GE(entries.size(), 6U);
+    ASSERT_EQ(entries[0], "instructions = 2");
+    ASSERT_NE(std::find(entries.cbegin(), entries.cend(), "pending expressions = 1"),
+              entries.cend());
+
+    const auto dump = runner.processInstruction("stats json");
+    ASSERT_EQ(dump.size(), 1U);
+    ASSERT_TRUE(dump[0].starts_with("{\"instructions\":3,"));
+    ASSERT_NE(dump[0].find("\"pending_expressions\":1,"), std::string::npos);
+    ASSERT_NE(dump[0].find("\"latencies_ns\":{\"instruction\":{\"count\":"), std::string::npos);
+    ASSERT_TRUE(dump[0].ends_with("}}"));
+
+    // Resolved expressions are no longer pending
+    [[maybe_unused]] const auto resolutionResults = runner.processInstruction("b=1");
+    ASSERT_NE(runner.processInstruction("stats json")[0].find("\"pending_expressions\":0,"),
+              std::string::npos);
+}
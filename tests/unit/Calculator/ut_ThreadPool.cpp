@@ -0,0 +1,79 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <numeric>
+
+#include "calculator/ThreadPool.hpp"
+
+using namespace ::testing;
+
+/**
+ * @brief Tests that every iteration of a loop is run exactly once
+ */
+TEST(ThreadPoolUnitTest, threadPoolRunsEveryIterationOnce)
+{
+    Calculator::ThreadPool threadPool(4);
+    ASSERT_EQ(threadPool.getThreadCount(), 4);
+
+    for (const auto& [iterationCount, chunkSize] :
+         std::initializer_list<std::pair<std::size_t, std::size_t>>{
+               {0, 8}, {1, 8}, {7, 8}, {1000, 1}, {1000, 7}, {100'000, 64}}) {
+        std::vector<std::atomic<int>> runCounts(iterationCount);
+
+        threadPool.parallelFor(iterationCount, chunkSize, [&runCounts](auto begin, auto end) {
+            for (auto iteration = begin; iteration < end; ++iteration) {
+                ++runCounts[iteration];
+            }
+        });
+
+        for (std::size_t iteration = 0; iteration < iterationCount; ++iteration) {
+            ASSERT_EQ(runCounts[iteration], 1) << iterationCount << " iterations";
+        }
+    }
+}
+
+/**
+ * @brief Tests that uneven chunks get stolen by idle threads
+ */
+TEST(ThreadPoolUnitTest, threadPoolBalancesUnevenChunks)
+{
+    Calculator::ThreadPool threadPool(4);
+
+    // The first chunks are much slower than the others
+    std::vector<uint64_t> results(64);
+    threadPool.parallelFor(results.size(), 1, [&results](auto begin, auto end) {
+        for (auto iteration = begin; iteration < end; ++iteration) {
+            const auto workload = iteration < 4 ? 1'000'000 : 1'000;
+
+            uint64_t sum{0};
+            for (auto step = 0; step < workload; ++step) {
+                sum += static_cast<uint64_t>(step) * iteration;
+            }
+            results[iteration] = sum;
+        }
+    });
+
+    for (std::size_t iteration = 0; iteration < results.size(); ++iteration) {
+        const uint64_t workload = iteration < 4 ? 1'000'000 : 1'000;
+        ASSERT_EQ(results[iteration], workload * (workload - 1) / 2 * iteration);
+    }
+}
+
+/**
+ * @brief Tests that a pool with a single thread runs the loops on the calling thread
+ */
+TEST(ThreadPoolUnitTest, threadPoolWithSingleThreadRunsOnCallingThread)
+{
+    Calculator::ThreadPool threadPool(0);
+    ASSERT_EQ(threadPool.getThreadCount(), 1);
+
+    const auto callingThread = std::this_thread::get_id();
+    std::size_t iterationCount{0};
+
+    threadPool.parallelFor(100, 10, [&](auto begin, auto end) {
+        ASSERT_EQ(std::this_thread::get_id(), callingThread);
+        iterationCount += end - begin;
+    });
+
+    ASSERT_EQ(iterationCount, 100);
+}
@@ -0,0 +1,131 @@
+#include "gtest/gtest.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <unistd.h>
+
+#include "calculator/Runner.hpp"
+#include "calculator/Tracer.hpp"
+
+using namespace ::testing;
+
+/**
+ * @brief Test fixture for the Tracer class, writing its trace into a temporary file
+ */
+class TracerUnitTest : public Test
+{
+protected:
+    void SetUp() override
+    {
+        mPath = "/tmp/ut_Tracer." + std::to_string(getpid()) + ".json";
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove(mPath);
+    }
+
+    /**
+     * @brief Reads the whole trace file
+     *
+     * @return Content of the trace file
+     */
+    [[nodiscard]] std::string readTrace() const
+    {
+        std::ifstream traceFile(mPath);
+        std::stringstream trace;
+        trace << traceFile.rdbuf();
+
+        return trace.str();
+    }
+
+    /**
+     * @brief Counts the occurrences of a string in the trace
+     *
+     * @param[in] trace Content of the trace file
+     * @param[in] text String to count
+     *
+     * @return Number of occurrences
+     */
+    [[nodiscard]] static std::size_t countOccurrences(const std::string& trace,
+                                                      const std::string& text)
+    {
+        std::size_t count{0};
+        for (auto position = trace.find(text); position != std::string::npos;
+             position = trace.find(text, position + 1)) {
+            ++count;
+        }
+
+        return count;
+    }
+
+    /// Path of the trace file
+    std::string mPath;
+};
+
+/**
+ * @brief Tests that the runner traces parsing, evaluation and every dependent re-evaluation
+ */
+TEST_F(TracerUnitTest, runnerTracesPropagationCascades)
+{
+    {
+        auto tracer = Calculator::Tracer::open(mPath);
+        ASSERT_NE(tracer, nullptr);
+
+        Calculator::Runner runner;
+        runner.setTracer(tracer.get());
+
+        for (const auto* instruction : {"total=price*quantity", "price=quantity+1", "quantity=3"}) {
+            [[maybe_unused]] const auto results = runner.processInstruction(instruction);
+        }
+        runner.setTracer(nullptr);
+        [[maybe_unused]] const auto untracedResults = runner.processInstruction("price=2");
+    }
+
+    const auto trace = readTrace();
+    ASSERT_TRUE(trace.starts_with("{\"traceEvents\":["));
+    ASSERT_TRUE(trace.ends_with("\"otherData\":{\"droppedSpans\":0}}\n"));
+
+    ASSERT_EQ(countOccurrences(trace, "\"name\":\"parse\""), 3U);
+    ASSERT_EQ(countOccurrences(trace, "\"name\":\"evaluate\""), 3U);
+    ASSERT_EQ(countOccurrences(trace, "\"name\":\"propagate\""), 1U);
+    ASSERT_EQ(countOccurrences(trace, "\"name\":\"reevaluate\""), 2U);
+
+    // 'price' is re-evaluated before 'total', which depends on it
+    const auto pricePosition
+          = trace.find("\"name\":\"reevaluate\",\"cat\":\"calculator\",\"ph\":\"X\"");
+    ASSERT_NE(pricePosition, std::string::npos);
+    const auto priceEnd = trace.find('}', trace.find("\"args\"", pricePosition));
+    ASSERT_NE(trace.substr(pricePosition, priceEnd - pricePosition).find("\"operand\":\"price\""),
+              std::string::npos);
+    ASSERT_EQ(countOccurrences(trace, "\"operand\":\"total\""), 3U);
+}
+
+/**
+ * @brief Tests that spans are dropped instead of blocking when the ring buffer is full
+ */
+TEST_F(TracerUnitTest, tracerDropsSpansWhenFull)
+{
+    {
+        auto tracer = Calculator::Tracer::open(mPath, 4, std::chrono::hours{1});
+        ASSERT_NE(tracer, nullptr);
+
+        // Operand names are truncated as well
+        const std::string operandName(Calculator::Tracer::cMaxOperandNameSize + 8, 'a');
+        const auto now = Calculator::Tracer::Clock::now();
+        for (int spanIndex = 0; spanIndex < 10; ++spanIndex) {
+            tracer->recordSpan("span", operandName, now, now);
+        }
+
+        ASSERT_EQ(tracer->getDroppedCount(), 6U);
+    }
+
+    const auto trace = readTrace();
+    ASSERT_EQ(countOccurrences(trace, "\"name\":\"span\""), 4U);
+    const std::string truncatedName(Calculator::Tracer::cMaxOperandNameSize, 'a');
+    ASSERT_EQ(countOccurrences(trace, "\"operand\":\"" + truncatedName + "\""), 4U);
+    ASSERT_NE(trace.find("\"droppedSpans\":6"), std::string::npos);
+}
@@ -0,0 +1,158 @@
+#include "gtest/gtest.h"
+
+#include "bytecode/Compiler.hpp"
+#include "evaluator/ColumnarEvaluator.hpp"
+#include "evaluator/Evaluator.hpp"
+
+using namespace ::testing;
+
+/**
+ * @brief Test fixture for the ColumnarEvaluator class
+ */
+class ColumnarEvaluatorUnitTest : public Test
+{
+protected:
+    /**
+     * @brief Builds an AST from an expression written in postfix notation (e.g. "45+7*")
+     *
+     * Variables are single letters whose symbol identifier is their position in the alphabet
+     *
+     * @param[in] postfixExpression Single character operands and operators in postfix order
+     *
+     * @return Generated AST
+     */
+    [[nodiscard]] static AST::Tree buildAST(const std::string& postfixExpression)
+    {
+        AST::Tree ast(postfixExpression.size());
+        std::vector<AST::NodeIndex> valueStack;
+
+        for (const auto character : postfixExpression) {
+            if (std::isdigit(character)) {
+                valueStack.push_back(ast.addConstant(character - '0'));
+                continue;
+            }
+
+            if (std::isalpha(character)) {
+                valueStack.push_back(
+                      ast.addVariable(static_cast<Symbols::SymbolId>(character - 'a')));
+                continue;
+            }
+
+            const auto rightNode = valueStack.back();
+            valueStack.pop_back();
+            const auto leftNode = valueStack.back();
+            valueStack.pop_back();
+            valueStack.push_back(ast.addOperator(character, leftNode, rightNode));
+        }
+
+        return ast;
+    }
+
+    /**
+     * @brief Fills the input columns of 'a' and 'b'
+     *
+     * Values cover zero, negative numbers and magnitudes that cannot be represented exactly
+     * in single precision
+     *
+     * @param[in] rowCount Number of rows of each column
+     */
+    void fillColumns(const std::size_t rowCount)
+    {
+        mValues.assign(2, std::vector<int32_t>(rowCount));
+
+        uint32_t seed{12345};
+        for (auto& values : mValues) {
+            for (auto& value : values) {
+                seed = seed * 1664525 + 1013904223;
+                value = static_cast<int32_t>(seed) >> (seed % 31);
+            }
+        }
+
+        mColumns.assign(mValues.begin(), mValues.end());
+    }
+
+protected:
+    /// Values of the input columns, indexed by symbol identifier
+    std::vector<std::vector<int32_t>> mValues;
+
+    /// Views over the input columns
+    std::vector<ColumnarEvaluator::Column> mColumns;
+};
+
+/**
+ * @brief Tests that every row matches the result of the Evaluator, with every instruction set
+ */
+TEST_F(ColumnarEvaluatorUnitTest, columnarEvaluatorMatchesEvaluator)
+{
+    // Not a multiple of the block size nor of the vector widths
+    constexpr std::size_t cRowCount{2500};
+    fillColumns(cRowCount);
+
+    for (const auto& postfixExpression : {"45+72/+",      // 4+5+7/2
+                                          "4a+7b/+",      // 4+a+7/b
+                                          "7a/b*",        // 7/a*b
+                                          "ab-3-",        // a-b-3
+                                          "1ab/a/-9*",    // (1-a/b/a)*9
+                                          "ab*a*b*a*b*"}) // a*b*a*b*a*b
+    {
+        const auto ast = buildAST(postfixExpression);
+        const auto program = Bytecode::compile(ast);
+
+        for (const auto instructionSet : {ColumnarEvaluator::InstructionSet::SCALAR,
+                                          ColumnarEvaluator::InstructionSet::SSE2,
+                                          ColumnarEvaluator::InstructionSet::AVX2}) {
+            ColumnarEvaluator columnarEvaluator(program, instructionSet);
+
+            std::vector<int32_t> output(cRowCount);
+            ASSERT_TRUE(columnarEvaluator.execute(mColumns, output).empty());
+
+            for (std::size_t row = 0; row < cRowCount; ++row) {
+                const std::vector<Symbols::ValueSlot> valueSlots{{mValues[0][row], true},
+                                                                 {mValues[1][row], true}};
+                Evaluator evaluator(ast, valueSlots);
+
+                ASSERT_EQ(Evaluator::Result{output[row]}, evaluator.execute())
+                      << postfixExpression << " (row " << row << ")";
+            }
+        }
+    }
+}
+
+/**
+ * @brief Tests that the ColumnarEvaluator outputs the variables without a valid column
+ * instead of evaluating the program
+ */
+TEST_F(ColumnarEvaluatorUnitTest, columnarEvaluatorOutputsMissingColumns)
+{
+    constexpr std::size_t cRowCount{16};
+    fillColumns(cRowCount);
+
+    // 'b' is too short and 'd' has no column
+    mColumns[1] = mColumns[1].first(cRowCount - 1);
+
+    // "4+a+7/b*d"
+    const auto program = Bytecode::compile(buildAST("4a+7b/d*+"));
+    ColumnarEvaluator columnarEvaluator(program);
+
+    std::vector<int32_t> output(cRowCount, -1);
+    const Evaluator::Dependencies expectedDependencies{/* b */ 1, /* d */ 3};
+    ASSERT_EQ(columnarEvaluator.execute(mColumns, output), expectedDependencies);
+
+    // Nothing was evaluated
+    ASSERT_EQ(std::ranges::count(output, -1), cRowCount);
+}
+
+/**
+ * @brief Tests that the requested instruction set is capped to the supported one
+ */
+TEST_F(ColumnarEvaluatorUnitTest, columnarEvaluatorUsesSupportedInstructionSet)
+{
+    const Bytecode::Program program;
+
+    ColumnarEvaluator columnarEvaluator(program, ColumnarEvaluator::InstructionSet::AVX2);
+    ASSERT_LE(columnarEvaluator.getInstructionSet(),
+              ColumnarEvaluator::getSupportedInstructionSet());
+
+    ColumnarEvaluator scalarEvaluator(program, ColumnarEvaluator::InstructionSet::SCALAR);
+    ASSERT_EQ(scalarEvaluator.getInstructionSet(), ColumnarEvaluator::InstructionSet::SCALAR);
+}
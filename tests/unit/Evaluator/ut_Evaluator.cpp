@@ -2,6 +2,13 @@
 
 #include "evaluator/Evaluator.hpp"
 
+namespace {
+/// Symbol identifier of the operand 'a'
+constexpr Symbols::SymbolId cSymbolA{0};
+/// Symbol identifier of the operand 'b'
+constexpr Symbols::SymbolId cSymbolB{1};
+} // namespace
+
 /**
  * @brief Tests that the Evaluator correctly calculates the integer result
  * from ASTs representing arithmetic expressions without dependencies
@@ -10,22 +17,22 @@ TEST(EvaluatorUnitTest, evaluatorOutputsCorrectResultWithoutDependencies)
 {
     // Constructing a valid AST for the arithmetic expression: "4+5+7/2"
     using namespace AST;
-    const auto rootNode = std::make_unique<Node>(
-          // First Level: root node representing '+'
-          '+',
-          // Second Level: left child (4 + 5)
-          std::make_unique<Node>('+',
-                                 // Third Level: leaf nodes '4' and '5'
-                                 std::make_unique<Node>('4'),
-                                 std::make_unique<Node>('5')),
-          // Second Level: right child (7 / 2)
-          std::make_unique<Node>('/',
-                                 // Third Level: leaf nodes '7' and '2'
-                                 std::make_unique<Node>('7'),
-                                 std::make_unique<Node>('2')));
+    Tree ast;
+    // Third Level: leaf nodes '4' and '5'
+    const auto leftLeftNode = ast.addConstant(4);
+    const auto leftRightNode = ast.addConstant(5);
+    // Second Level: left child (4 + 5)
+    const auto leftNode = ast.addOperator('+', leftLeftNode, leftRightNode);
+    // Third Level: leaf nodes '7' and '2'
+    const auto rightLeftNode = ast.addConstant(7);
+    const auto rightRightNode = ast.addConstant(2);
+    // Second Level: right child (7 / 2)
+    const auto rightNode = ast.addOperator('/', rightLeftNode, rightRightNode);
+    // First Level: root node representing '+'
+    ast.addOperator('+', leftNode, rightNode);
 
-    // Create an Evaluator with the AST and an empty operand lookup map
-    Evaluator evaluator(rootNode, {});
+    // Create an Evaluator with the AST and no operand values
+    Evaluator evaluator(ast, {});
     const auto result = evaluator.execute();
 
     // Verify that the evaluation resulted in the expected integer value
@@ -43,25 +50,25 @@ TEST(EvaluatorUnitTest, evaluatorOutputsCorrectResultWithDependencies)
 {
     // Constructing a valid AST for the arithmetic expression: "4+a+7/b"
     using namespace AST;
-    const auto rootNode = std::make_unique<Node>(
-          // First Level: root node representing '+'
-          '+',
-          // Second Level: left child (4 + a)
-          std::make_unique<Node>('+',
-                                 // Third Level: leaf nodes '4' and 'a'
-                                 std::make_unique<Node>('4'),
-                                 std::make_unique<Node>('a')),
-          // Second Level: right child (7 / b)
-          std::make_unique<Node>('/',
-                                 // Third Level: leaf nodes '7' and 'b'
-                                 std::make_unique<Node>('7'),
-                                 std::make_unique<Node>('b')));
+    Tree ast;
+    // Third Level: leaf nodes '4' and 'a'
+    const auto leftLeftNode = ast.addConstant(4);
+    const auto leftRightNode = ast.addVariable(cSymbolA);
+    // Second Level: left child (4 + a)
+    const auto leftNode = ast.addOperator('+', leftLeftNode, leftRightNode);
+    // Third Level: leaf nodes '7' and 'b'
+    const auto rightLeftNode = ast.addConstant(7);
+    const auto rightRightNode = ast.addVariable(cSymbolB);
+    // Second Level: right child (7 / b)
+    const auto rightNode = ast.addOperator('/', rightLeftNode, rightRightNode);
+    // First Level: root node representing '+'
+    ast.addOperator('+', leftNode, rightNode);
 
-    // Setup the dependencies lookup map
-    const std::unordered_map<std::string, int> dependenciesLookupMap{{"a", 5}, {"b", 2}};
+    // Setup the operand values (indexed by symbol identifier)
+    const std::vector<Symbols::ValueSlot> valueSlots{{5, true}, {2, true}};
 
-    // Create an Evaluator with the AST and the operand lookup map
-    Evaluator evaluator(rootNode, dependenciesLookupMap);
+    // Create an Evaluator with the AST and the operand values
+    Evaluator evaluator(ast, valueSlots);
     const auto result = evaluator.execute();
 
     // Verify that the evaluation resulted in the expected integer value
@@ -79,26 +86,40 @@ TEST(EvaluatorUnitTest, evaluatorOutputsDependenciesInsteadOfResult)
 {
     // Constructing a valid AST for the arithmetic expression: "4+a+7/b"
     using namespace AST;
-    const auto rootNode = std::make_unique<Node>(
-          // First Level: root node representing '+'
-          '+',
-          // Second Level: left child (4 + a)
-          std::make_unique<Node>('+',
-                                 // Third Level: leaf nodes '4' and 'a'
-                                 std::make_unique<Node>('4'),
-                                 std::make_unique<Node>('a')),
-          // Second Level: right child (7 / b)
-          std::make_unique<Node>('/',
-                                 // Third Level: leaf nodes '7' and 'b'
-                                 std::make_unique<Node>('7'),
-                                 std::make_unique<Node>('b')));
+    Tree ast;
+    // Third Level: leaf nodes '4' and 'a'
+    const auto leftLeftNode = ast.addConstant(4);
+    const auto leftRightNode = ast.addVariable(cSymbolA);
+    // Second Level: left child (4 + a)
+    const auto leftNode = ast.addOperator('+', leftLeftNode, leftRightNode);
+    // Third Level: leaf nodes '7' and 'b'
+    const auto rightLeftNode = ast.addConstant(7);
+    const auto rightRightNode = ast.addVariable(cSymbolB);
+    // Second Level: right child (7 / b)
+    const auto rightNode = ast.addOperator('/', rightLeftNode, rightRightNode);
+    // First Level: root node representing '+'
+    ast.addOperator('+', leftNode, rightNode);
 
-    // Create an Evaluator with the AST and an empty operand lookup map
-    Evaluator evaluator(rootNode, {});
+    // Create an Evaluator with the AST and no operand values
+    Evaluator evaluator(ast, {});
     const auto result = evaluator.execute();
 
     // Verify that the evaluation resulted in the expected dependencies
     ASSERT_TRUE(std::holds_alternative<Evaluator::Dependencies>(result));
-    const Evaluator::Dependencies expectedDependencies{"a", "b"};
+    const Evaluator::Dependencies expectedDependencies{cSymbolA, cSymbolB};
     ASSERT_EQ(std::get<Evaluator::Dependencies>(result), expectedDependencies);
 }
+
+/**
+ * @brief Tests that the Evaluator reports an error instead of a result for an empty AST
+ */
+TEST(EvaluatorUnitTest, evaluatorOutputsErrorForEmptyAST)
+{
+    const AST::Tree ast;
+
+    Evaluator evaluator(ast, {});
+    const auto result = evaluator.execute();
+
+    ASSERT_TRUE(std::holds_alternative<Utils::Error>(result));
+    ASSERT_EQ(std::get<Utils::Error>(result).code, Utils::ErrorCode::EMPTY_PROGRAM);
+}
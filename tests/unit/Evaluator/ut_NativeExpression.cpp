@@ -0,0 +1,139 @@
+#include "gtest/gtest.h"
+
+#include "evaluator/NativeExpression.hpp"
+#include "evaluator/VirtualMachine.hpp"
+
+using namespace ::testing;
+
+/**
+ * @brief Test fixture for the NativeExpression class
+ */
+class NativeExpressionUnitTest : public Test
+{
+protected:
+    /**
+     * @brief Draws the next pseudo-random number (deterministic linear congruential generator)
+     *
+     * @return Pseudo-random number
+     */
+    [[nodiscard]] uint32_t nextRandom()
+    {
+        mSeed = mSeed * 1664525 + 1013904223;
+        return mSeed >> 8;
+    }
+
+    /**
+     * @brief Generates a random program
+     *
+     * Leaves are constants or variables among the value slots. Operands are pushed
+     * until the requested stack depth is reached, so that every register gets used
+     *
+     * @param[in] leafCount Number of leaves of the expression
+     * @param[in] maxStackDepth Maximum number of values held by the stack
+     *
+     * @return Generated program
+     */
+    [[nodiscard]] Bytecode::Program generateProgram(const std::size_t leafCount,
+                                                    const uint32_t maxStackDepth)
+    {
+        using Bytecode::OpCode;
+        constexpr std::array cOperations{OpCode::ADD, OpCode::SUB, OpCode::MUL, OpCode::DIV};
+
+        Bytecode::Program program;
+        uint32_t stackDepth{0};
+
+        for (std::size_t leaf = 0; leaf < leafCount; ++leaf) {
+            if (nextRandom() % 2 == 0) {
+                program.emitConstant(static_cast<float>(nextRandom() % 10));
+            } else {
+                program.emitVariable(nextRandom() % cVariableCount);
+            }
+            ++stackDepth;
+
+            // Reduce the stack randomly, or when it is full
+            while (stackDepth > 1
+                   && (stackDepth == maxStackDepth || nextRandom() % 3 == 0)) {
+                program.emitOperation(cOperations[nextRandom() % cOperations.size()]);
+                --stackDepth;
+            }
+        }
+
+        for (; stackDepth > 1; --stackDepth) {
+            program.emitOperation(cOperations[nextRandom() % cOperations.size()]);
+        }
+
+        return program;
+    }
+
+    /**
+     * @brief Assigns random values to every value slot
+     */
+    void randomizeValues()
+    {
+        for (auto& valueSlot : mValueSlots) {
+            // Mix small values (including zero) and large ones
+            valueSlot = {static_cast<int32_t>(nextRandom()) >> (nextRandom() % 24), true};
+            if (nextRandom() % 2 == 0) {
+                valueSlot.value = -valueSlot.value;
+            }
+        }
+    }
+
+protected:
+    /// Number of variables read by the generated programs
+    static constexpr uint32_t cVariableCount{8};
+
+    /// Values of the variables, indexed by symbol identifier
+    std::vector<Symbols::ValueSlot> mValueSlots{cVariableCount};
+
+    /// Seed of the pseudo-random number generator
+    uint32_t mSeed{42};
+};
+
+/**
+ * @brief Tests that the machine code outputs the same results as the VirtualMachine
+ * (differential test over randomly generated programs and values)
+ */
+TEST_F(NativeExpressionUnitTest, nativeExpressionMatchesVirtualMachine)
+{
+    if (!NativeExpression::isSupported()) {
+        GTEST_SKIP() << "JIT not supported on this system";
+    }
+
+    for (auto programIndex = 0; programIndex < 500; ++programIndex) {
+        const auto leafCount = 1 + nextRandom() % 40;
+        const auto program = generateProgram(leafCount, 2 + nextRandom() % 15);
+
+        const auto nativeExpression = NativeExpression::compile(program);
+        ASSERT_TRUE(nativeExpression.has_value());
+
+        for (auto valuesIndex = 0; valuesIndex < 20; ++valuesIndex) {
+            randomizeValues();
+
+            VirtualMachine virtualMachine(program, mValueSlots);
+            ASSERT_EQ(Evaluator::Result{nativeExpression->execute(mValueSlots)},
+                      virtualMachine.execute())
+                  << "Program " << programIndex << ", values " << valuesIndex;
+        }
+    }
+}
+
+/**
+ * @brief Tests that programs needing more stack entries than there are registers
+ * are left to the interpreter
+ */
+TEST_F(NativeExpressionUnitTest, nativeExpressionRejectsDeepPrograms)
+{
+    ASSERT_FALSE(NativeExpression::compile(Bytecode::Program{}).has_value());
+
+    // "1+(1+(1+...))" needs one stack entry per leaf
+    Bytecode::Program program;
+    for (auto leaf = 0; leaf < 17; ++leaf) {
+        program.emitConstant(1.f);
+    }
+    for (auto operation = 0; operation < 16; ++operation) {
+        program.emitOperation(Bytecode::OpCode::ADD);
+    }
+
+    ASSERT_FALSE(NativeExpression::compile(program).has_value());
+}
@@ -0,0 +1,124 @@
+#include "gtest/gtest.h"
+
+#include "bytecode/Compiler.hpp"
+#include "evaluator/Evaluator.hpp"
+#include "evaluator/VirtualMachine.hpp"
+
+using namespace ::testing;
+
+/**
+ * @brief Test fixture for the VirtualMachine class
+ */
+class VirtualMachineUnitTest : public Test
+{
+protected:
+    /**
+     * @brief Builds an AST from an expression written in postfix notation (e.g. "45+7*")
+     *
+     * Variables are single letters whose symbol identifier is their position in the alphabet
+     *
+     * @param[in] postfixExpression Single character operands and operators in postfix order
+     *
+     * @return Generated AST
+     */
+    [[nodiscard]] static AST::Tree buildAST(const std::string& postfixExpression)
+    {
+        AST::Tree ast(postfixExpression.size());
+        std::vector<AST::NodeIndex> valueStack;
+
+        for (const auto character : postfixExpression) {
+            if (std::isdigit(character)) {
+                valueStack.push_back(ast.addConstant(character - '0'));
+                continue;
+            }
+
+            if (std::isalpha(character)) {
+                valueStack.push_back(
+                      ast.addVariable(static_cast<Symbols::SymbolId>(character - 'a')));
+                continue;
+            }
+
+            const auto rightNode = valueStack.back();
+            valueStack.pop_back();
+            const auto leftNode = valueStack.back();
+            valueStack.pop_back();
+            valueStack.push_back(ast.addOperator(character, leftNode, rightNode));
+        }
+
+        return ast;
+    }
+
+protected:
+    /// Operand values used by the tests: 'a' holds 5, 'b' holds 2 and 'c' has no value
+    const std::vector<Symbols::ValueSlot> mValueSlots{{5, true}, {2, true}, {}};
+};
+
+/**
+ * @brief Tests that the compiler emits the instructions of an AST in postfix order
+ * and computes the stack depth required to run them
+ */
+TEST_F(VirtualMachineUnitTest, compilerEmitsPostfixInstructions)
+{
+    using Bytecode::OpCode;
+
+    // "4+a+7/a"
+    const auto program = Bytecode::compile(buildAST("4a+7a/+"));
+
+    std::vector<OpCode> opCodes;
+    for (const auto& instruction : program.getInstructions()) {
+        opCodes.push_back(instruction.opCode);
+    }
+
+    const std::vector<OpCode> expectedOpCodes{OpCode::PUSH_CONST,
+                                              OpCode::LOAD_VAR,
+                                              OpCode::ADD,
+                                              OpCode::PUSH_CONST,
+                                              OpCode::LOAD_VAR,
+                                              OpCode::DIV,
+                                              OpCode::ADD};
+    ASSERT_EQ(opCodes, expectedOpCodes);
+
+    // Both loads of 'a' share the same variable slot
+    ASSERT_EQ(program.getVariables().size(), 1);
+    ASSERT_EQ(program.getVariables().front(), 0);
+    ASSERT_EQ(program.getMaxStackDepth(), 3);
+}
+
+/**
+ * @brief Tests that the VirtualMachine outputs the same results as the Evaluator
+ */
+TEST_F(VirtualMachineUnitTest, virtualMachineMatchesEvaluator)
+{
+    for (const auto& postfixExpression : {"45+72/+",      // 4+5+7/2
+                                          "4a+7b/+",      // 4+a+7/b
+                                          "7a/b*",        // 7/a*b
+                                          "ab-3-",        // a-b-3
+                                          "1ab/a/-9*",    // (1-a/b/a)*9
+                                          "ab*a*b*a*b*"}) // a*b*a*b*a*b
+    {
+        const auto ast = buildAST(postfixExpression);
+        const auto program = Bytecode::compile(ast);
+
+        Evaluator evaluator(ast, mValueSlots);
+        VirtualMachine virtualMachine(program, mValueSlots);
+
+        ASSERT_EQ(virtualMachine.execute(), evaluator.execute()) << postfixExpression;
+    }
+}
+
+/**
+ * @brief Tests that the VirtualMachine outputs the unmet dependencies of a program
+ * instead of a result
+ */
+TEST_F(VirtualMachineUnitTest, virtualMachineOutputsDependenciesInsteadOfResult)
+{
+    // "4+a+7/c*d"
+    const auto program = Bytecode::compile(buildAST("4a+7c/d*+"));
+
+    VirtualMachine virtualMachine(program, mValueSlots);
+    const auto result = virtualMachine.execute();
+
+    ASSERT_TRUE(std::holds_alternative<Evaluator::Dependencies>(result));
+    const Evaluator::Dependencies expectedDependencies{/* c */ 2, /* d */ 3};
+    ASSERT_EQ(std::get<Evaluator::Dependencies>(result), expectedDependencies);
+}
@@ -18,48 +18,82 @@ protected:
     void testInputs(const bool isSuccessScenario)
     {
         for (const auto& inputString : mTestInputs) {
-            Parser parser(inputString);
-            ASSERT_EQ(isSuccessScenario, parser.execute());
+            Parser parser(inputString, mSymbolTable);
+            ASSERT_EQ(isSuccessScenario, parser.execute().hasValue()) << inputString;
         }
     }
 
     /**
      * @brief Compares two ASTs to determine if they are identical
      *
-     * @param[in] rootNodeA Reference to the root node of the first AST
-     * @param[in] rootNodeB Reference to the root node of the second AST
+     * @param[in] astA First AST
+     * @param[in] nodeIndexA Index of the node of the first AST to compare
+     * @param[in] astB Second AST
+     * @param[in] nodeIndexB Index of the node of the second AST to compare
      *
      * @return True if the ASTs are identical (false otherwise)
      */
-    [[nodiscard]] bool areASTsIdentical(const std::unique_ptr<AST::Node>& rootNodeA,
-                                        const std::unique_ptr<AST::Node>& rootNodeB)
+    [[nodiscard]] bool areASTsIdentical(const AST::Tree& astA,
+                                        const AST::NodeIndex nodeIndexA,
+                                        const AST::Tree& astB,
+                                        const AST::NodeIndex nodeIndexB)
     {
-        return (!rootNodeA && !rootNodeB)
-               || ((rootNodeA && rootNodeB)
-                   && (rootNodeA->getNodeValue() == rootNodeB->getNodeValue())
-                   && areASTsIdentical(rootNodeA->getReferenceToLeftNodePointer(),
-                                       rootNodeB->getReferenceToLeftNodePointer())
-                   && areASTsIdentical(rootNodeA->getReferenceToRightNodePointer(),
-                                       rootNodeB->getReferenceToRightNodePointer()));
+        if (nodeIndexA == AST::cNullNodeIndex || nodeIndexB == AST::cNullNodeIndex) {
+            return nodeIndexA == nodeIndexB;
+        }
+
+        const auto& nodeA = astA.getNode(nodeIndexA);
+        const auto& nodeB = astB.getNode(nodeIndexB);
+
+        if (nodeA.getNodeType() != nodeB.getNodeType()) {
+            return false;
+        }
+
+        bool areValuesIdentical{false};
+        switch (nodeA.getNodeType()) {
+        case AST::NodeType::CONSTANT:
+            areValuesIdentical = nodeA.getConstant() == nodeB.getConstant();
+            break;
+        case AST::NodeType::VARIABLE:
+            areValuesIdentical = nodeA.getSymbolId() == nodeB.getSymbolId();
+            break;
+        case AST::NodeType::OPERATOR:
+            areValuesIdentical = nodeA.getOperator() == nodeB.getOperator();
+            break;
+        }
+
+        return areValuesIdentical
+               && areASTsIdentical(
+                     astA, nodeA.getLeftNodeIndex(), astB, nodeB.getLeftNodeIndex())
+               && areASTsIdentical(
+                     astA, nodeA.getRightNodeIndex(), astB, nodeB.getRightNodeIndex());
     }
 
     /**
-     * @brief Counts the total number of nodes inside an AST
+     * @brief Counts the total number of nodes reachable from a node of an AST
      *
-     * @param[in] rootNode Reference to the root node of the AST
+     * @param[in] ast AST to inspect
+     * @param[in] nodeIndex Index of the node to start counting from
      *
      * @return Number of nodes of the AST
      */
-    [[nodiscard]] uint32_t getNumberOfNodes(const std::unique_ptr<AST::Node>& rootNode)
+    [[nodiscard]] uint32_t getNumberOfNodes(const AST::Tree& ast, const AST::NodeIndex nodeIndex)
     {
-        return !rootNode ? 0
-                         : 1 + getNumberOfNodes(rootNode->getReferenceToLeftNodePointer())
-                                 + getNumberOfNodes(rootNode->getReferenceToRightNodePointer());
+        if (nodeIndex == AST::cNullNodeIndex) {
+            return 0;
+        }
+
+        const auto& node = ast.getNode(nodeIndex);
+        return 1 + getNumberOfNodes(ast, node.getLeftNodeIndex())
+               + getNumberOfNodes(ast, node.getRightNodeIndex());
     }
 
 protected:
     /// List of inputs to be tested
     std::vector<std::string> mTestInputs;
+
+    /// Symbol table used to intern the operands of the parsed inputs
+    Symbols::SymbolTable mSymbolTable;
 };
 
 /**
@@ -81,11 +115,97 @@ TEST_F(ParserUnitTest, parserFailsWhenNegativeNumbersAreProvided)
 }
 
 /**
- * @brief Tests that the Parser fails when the input has integers with more than one digit
+ * @brief Tests that the Parser succeeds when the input has integers with more than one digit
+ */
+TEST_F(ParserUnitTest, parserSucceedsWhenLiteralsHaveMultipleDigits)
+{
+    mTestInputs = {"a = 42", "b = 1337", "c = 11*11+3-(20)", "d = 10  +  1", "e = 2147483647"};
+    testInputs(true);
+}
+
+/**
+ * @brief Tests that the Parser fails when the input has integers that do not fit 32 bits
  */
 TEST_F(ParserUnitTest, parserFailsWhenLiteralsAreTooLarge)
 {
-    mTestInputs = {"a = 42", "b = 1337", "c = 11*11+3-(20)", "d = 10  +  1"};
+    mTestInputs = {"a = 2147483648", "b = 1+99999999999"};
+    testInputs(false);
+}
+
+/**
+ * @brief Tests that the Parser fails when white spaces split a token
+ */
+TEST_F(ParserUnitTest, parserFailsWhenTokensAreSplit)
+{
+    mTestInputs = {"a = 1 2", "b = c d", "to tal = 1"};
+    testInputs(false);
+}
+
+/**
+ * @brief Tests that the Parser recognizes the supported commands
+ */
+TEST_F(ParserUnitTest, parserRecognizesCommands)
+{
+    {
+        Parser parser("  result ", mSymbolTable);
+        ASSERT_TRUE(parser.execute());
+        ASSERT_EQ(parser.getInstructionType(), Parser::InstructionType::RESULT);
+    }
+    {
+        Parser parser("undo 12", mSymbolTable);
+        ASSERT_TRUE(parser.execute());
+        ASSERT_EQ(parser.getInstructionType(), Parser::InstructionType::UNDO);
+        ASSERT_EQ(parser.getUndoCount(), 12);
+    }
+    {
+        Parser parser("undo many", mSymbolTable);
+        ASSERT_TRUE(parser.execute());
+        ASSERT_EQ(parser.getInstructionType(), Parser::InstructionType::UNDO);
+        ASSERT_EQ(parser.getUndoCount(), -1);
+    }
+    {
+        Parser parser("checkpoint before_update ", mSymbolTable);
+        ASSERT_TRUE(parser.execute());
+        ASSERT_EQ(parser.getInstructionType(), Parser::InstructionType::CHECKPOINT);
+        ASSERT_EQ(parser.getCheckpointName(), "before_update");
+    }
+    {
+        Parser parser("restore before_update", mSymbolTable);
+        ASSERT_TRUE(parser.execute());
+        ASSERT_EQ(parser.getInstructionType(), Parser::InstructionType::RESTORE);
+        ASSERT_EQ(parser.getCheckpointName(), "before_update");
+    }
+    {
+        Parser parser("stats", mSymbolTable);
+        ASSERT_TRUE(parser.execute());
+        ASSERT_EQ(parser.getInstructionType(), Parser::InstructionType::STATS);
+        ASSERT_FALSE(parser.isMachineReadable());
+    }
+    {
+        Parser parser(" stats  json ", mSymbolTable);
+        ASSERT_TRUE(parser.execute());
+        ASSERT_EQ(parser.getInstructionType(), Parser::InstructionType::STATS);
+        ASSERT_TRUE(parser.isMachineReadable());
+    }
+    {
+        // Command names are regular operand names when used in an arithmetic expression
+        Parser parser("undo = result + 1", mSymbolTable);
+        ASSERT_TRUE(parser.execute());
+        ASSERT_EQ(parser.getInstructionType(), Parser::InstructionType::ASSIGNMENT);
+        ASSERT_EQ(mSymbolTable.getName(parser.getOperandOfLHS()), "undo");
+    }
+
+    mTestInputs = {"results",
+                   "undo",
+                   "undo 1 2",
+                   "undo(2)",
+                   "redo 2",
+                   "checkpoint",
+                   "checkpoint 1st",
+                   "restore a b",
+                   "restore(a)",
+                   "stats xml",
+                   "stats json json"};
     testInputs(false);
 }
 
@@ -150,26 +270,149 @@ TEST_F(ParserUnitTest, parserSucceedsWhenValidInputIsProvided)
  */
 TEST_F(ParserUnitTest, parserRetrievesCorrectOperandAndAST)
 {
-    constexpr auto validArithmeticExpression{"a = 5+(1*2)"};
+    constexpr auto validArithmeticExpression{"a = 5+(10*2)"};
     constexpr auto expectedOperand{"a"};
-    const auto expectedAST = std::make_unique<AST::Node>(
-          '+', // First Level
-          std::make_unique<AST::Node>('5'),
-          std::make_unique<AST::Node>('*', // Second Level
-                                      std::make_unique<AST::Node>('1'),
-                                      std::make_unique<AST::Node>('2')));
+    AST::Tree expectedAST;
+    {
+        const auto leftNode = expectedAST.addConstant(5);
+        const auto rightLeftNode = expectedAST.addConstant(10);
+        const auto rightRightNode = expectedAST.addConstant(2);
+        // Second Level
+        const auto rightNode = expectedAST.addOperator('*', rightLeftNode, rightRightNode);
+        // First Level
+        expectedAST.addOperator('+', leftNode, rightNode);
+    }
     constexpr auto expectedASTNodeCount{5};
 
-    Parser parser(validArithmeticExpression);
+    Parser parser(validArithmeticExpression, mSymbolTable);
+    ASSERT_TRUE(parser.execute());
+    ASSERT_EQ(mSymbolTable.getName(parser.getOperandOfLHS()), expectedOperand);
+
+    const auto& retrievedAST = parser.getASTOfRHS();
+    ASSERT_FALSE(retrievedAST.empty());
+
+    // The node pool holds exactly the nodes of the tree, in post-order
+    const auto astRootNodeIndex = retrievedAST.getRootNodeIndex();
+    ASSERT_EQ(retrievedAST.size(), expectedASTNodeCount);
+    ASSERT_EQ(getNumberOfNodes(retrievedAST, astRootNodeIndex), expectedASTNodeCount);
+    ASSERT_TRUE(areASTsIdentical(
+          retrievedAST, astRootNodeIndex, expectedAST, expectedAST.getRootNodeIndex()));
+}
+
+/**
+ * @brief Tests that the Parser fails when operand names are malformed
+ */
+TEST_F(ParserUnitTest, parserFailsWhenOperandNamesAreInvalid)
+{
+    mTestInputs = {"1a = 2", "_a = 2", "a = 2b", "b = (1+2)c", "c = d(2)", "d = _e+1", "e$ = 1"};
+    testInputs(false);
+}
+
+/**
+ * @brief Tests that the Parser reports why an input is rejected and where
+ */
+TEST_F(ParserUnitTest, parserReportsTheCodeAndOffsetOfErrors)
+{
+    using Utils::ErrorCode;
+
+    for (const auto& [input, expectedError] :
+         std::initializer_list<std::pair<std::string_view, Utils::Error>>{
+               {"", {ErrorCode::INVALID_INSTRUCTION, 0}},
+               {"redo 2", {ErrorCode::INVALID_INSTRUCTION, 4}},
+               {"undo 1 2", {ErrorCode::INVALID_ARGUMENT, 7}},
+               {"stats yaml", {ErrorCode::INVALID_ARGUMENT, 6}},
+               {"restore 1x", {ErrorCode::INVALID_ARGUMENT, 8}},
+               {"a =  ", {ErrorCode::EMPTY_EXPRESSION, 5}},
+               {"a = 99999999999", {ErrorCode::LITERAL_TOO_LARGE, 4}},
+               {"a = 2 * -1", {ErrorCode::NEGATIVE_VALUE, 8}},
+               {"a = 2 ++ 3", {ErrorCode::UNEXPECTED_CHARACTER, 7}},
+               {"a = 2 +", {ErrorCode::UNEXPECTED_END, 7}},
+               {"a = (1+2))", {ErrorCode::UNMATCHED_PARENTHESIS, 9}},
+               {"a = (1+2", {ErrorCode::UNMATCHED_PARENTHESIS, 8}}}) {
+
+        Parser parser(input, mSymbolTable);
+        const auto parsingResult = parser.execute();
+        ASSERT_FALSE(parsingResult) << input;
+        ASSERT_EQ(parsingResult.getError().code, expectedError.code) << input;
+        ASSERT_EQ(parsingResult.getError().offset, expectedError.offset) << input;
+    }
+}
+
+/**
+ * @brief Tests that the Parser interns multi-character operand names
+ * and references them from the AST through their symbol identifiers
+ */
+TEST_F(ParserUnitTest, parserSupportsMultiCharacterOperandNames)
+{
+    constexpr auto validArithmeticExpression{"total = price*qty_2+price"};
+
+    Parser parser(validArithmeticExpression, mSymbolTable);
+    ASSERT_TRUE(parser.execute());
+    ASSERT_EQ(mSymbolTable.getName(parser.getOperandOfLHS()), "total");
+
+    const auto priceSymbol = mSymbolTable.find("price");
+    const auto quantitySymbol = mSymbolTable.find("qty_2");
+    ASSERT_TRUE(priceSymbol.has_value());
+    ASSERT_TRUE(quantitySymbol.has_value());
+    ASSERT_EQ(mSymbolTable.size(), 3);
+
+    AST::Tree expectedAST;
+    {
+        const auto leftLeftNode = expectedAST.addVariable(*priceSymbol);
+        const auto leftRightNode = expectedAST.addVariable(*quantitySymbol);
+        const auto leftNode = expectedAST.addOperator('*', leftLeftNode, leftRightNode);
+        const auto rightNode = expectedAST.addVariable(*priceSymbol);
+        expectedAST.addOperator('+', leftNode, rightNode);
+    }
+
+    const auto& retrievedAST = parser.getASTOfRHS();
+    ASSERT_TRUE(areASTsIdentical(retrievedAST,
+                                 retrievedAST.getRootNodeIndex(),
+                                 expectedAST,
+                                 expectedAST.getRootNodeIndex()));
+}
+
+/**
+ * @brief Tests that the AST of a parsed expression is formatted, without being printed
+ */
+TEST_F(ParserUnitTest, parserASTIsFormattedIntoAString)
+{
+    Parser parser("total = (price + 2) * qty", mSymbolTable);
     ASSERT_TRUE(parser.execute());
-    ASSERT_EQ(parser.getOperandOfLHS(), expectedOperand);
 
-    const auto retrievedAST = parser.getASTOfRHS();
+    ASSERT_EQ(AST::formatAST(parser.getASTOfRHS(), mSymbolTable),
+              "*\n"
+              "    +\n"
+              "        price\n"
+              "        2\n"
+              "    qty\n");
+}
 
-    ASSERT_NE(retrievedAST, nullptr);
-    ASSERT_FALSE(retrievedAST->empty());
+/**
+ * @brief Tests that the operand names of a rejected instruction are not interned
+ */
+TEST_F(ParserUnitTest, parserOnlyInternsTheOperandsOfValidInstructions)
+{
+    Parser validParser("total = price * qty", mSymbolTable);
+    ASSERT_TRUE(validParser.execute());
+    ASSERT_EQ(mSymbolTable.size(), 3);
 
-    const auto& astRootNode = retrievedAST->top();
-    ASSERT_EQ(getNumberOfNodes(astRootNode), expectedASTNodeCount);
-    ASSERT_TRUE(areASTsIdentical(astRootNode, expectedAST));
+    for (const auto* const invalidInput : {"junk123 = foo456 $", "junk = price +", "a = (b"}) {
+        Parser parser(invalidInput, mSymbolTable);
+        ASSERT_FALSE(parser.execute()) << invalidInput;
+        ASSERT_EQ(mSymbolTable.size(), 3) << invalidInput;
+        ASSERT_FALSE(mSymbolTable.find("junk").has_value()) << invalidInput;
+    }
+
+    // New names get the identifiers they were resolved with while parsing
+    Parser parser("rate = price * rate + bonus", mSymbolTable);
+    ASSERT_TRUE(parser.execute());
+    ASSERT_EQ(mSymbolTable.size(), 5);
+    ASSERT_EQ(mSymbolTable.getName(parser.getOperandOfLHS()), "rate");
+    ASSERT_EQ(AST::formatAST(parser.getASTOfRHS(), mSymbolTable),
+              "+\n"
+              "    *\n"
+              "        price\n"
+              "        rate\n"
+              "    bonus\n");
 }
@@ -0,0 +1,161 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <array>
+#include <string>
+#include <thread>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "server/EventLoop.hpp"
+
+using namespace ::testing;
+
+/**
+ * @brief Test fixture for the EventLoop class, serving sessions on a Unix domain socket
+ */
+class EventLoopUnitTest : public Test
+{
+protected:
+    void SetUp() override
+    {
+        mEndpoint.family = Server::Endpoint::Family::UNIX;
+        mEndpoint.address = "/tmp/ut_EventLoop." + std::to_string(getpid()) + ".sock";
+
+        ASSERT_TRUE(mEventLoop.listen(mEndpoint));
+        mServerThread = std::thread([this] { mIsStopped = mEventLoop.run(); });
+    }
+
+    void TearDown() override
+    {
+        mEventLoop.stop();
+        mServerThread.join();
+        ASSERT_TRUE(mIsStopped);
+    }
+
+    /**
+     * @brief Reads responses from a socket until a given number of lines was received
+     *
+     * @param[in] socketDescriptor Connected socket
+     * @param[in] lineCount Number of response lines to read
+     *
+     * @return Responses received
+     */
+    static std::string readResponses(const int socketDescriptor, const std::size_t lineCount)
+    {
+        std::string responses;
+        std::array<char, 4096> buffer{};
+
+        while (std::ranges::count(responses, '\n') < static_cast<std::ptrdiff_t>(lineCount)) {
+            const auto bytesRead = recv(socketDescriptor, buffer.data(), buffer.size(), 0);
+            if (bytesRead <= 0) {
+                break;
+            }
+            responses.append(buffer.data(), static_cast<std::size_t>(bytesRead));
+        }
+
+        return responses;
+    }
+
+protected:
+    /// Endpoint the server listens on
+    Server::Endpoint mEndpoint;
+
+    /// Server under test
+    Server::EventLoop mEventLoop;
+
+    /// Thread running the server
+    std::thread mServerThread;
+
+    /// Whether the server was stopped normally
+    bool mIsStopped{false};
+};
+
+/**
+ * @brief Tests that every connection gets its own calculator session
+ */
+TEST_F(EventLoopUnitTest, eventLoopKeepsSessionsApart)
+{
+    const auto firstClient = Server::connectTo(mEndpoint);
+    const auto secondClient = Server::connectTo(mEndpoint);
+    ASSERT_GE(firstClient, 0);
+    ASSERT_GE(secondClient, 0);
+
+    const std::string firstRequests{"a = 1\nb = a + 1\nresult\n"};
+    const std::string secondRequests{"b = 5\nresult\n"};
+    ASSERT_EQ(send(firstClient, firstRequests.data(), firstRequests.size(), 0),
+              static_cast<ssize_t>(firstRequests.size()));
+    ASSERT_EQ(send(secondClient, secondRequests.data(), secondRequests.size(), 0),
+              static_cast<ssize_t>(secondRequests.size()));
+
+    ASSERT_EQ(readResponses(firstClient, 3), "a = 1\nb = 2\nreturn b = 2\n");
+    ASSERT_EQ(readResponses(secondClient, 2), "b = 5\nreturn b = 5\n");
+
+    close(firstClient);
+    close(secondClient);
+}
+
+/**
+ * @brief Tests that many pipelined requests are answered in order, including the last one
+ * sent right before the client stops writing
+ */
+TEST_F(EventLoopUnitTest, eventLoopAnswersPipelinedRequests)
+{
+    constexpr int cRequestCount{20'000};
+
+    const auto client = Server::connectTo(mEndpoint);
+    ASSERT_GE(client, 0);
+
+    std::string requests;
+    std::string expectedResponses;
+    for (auto value = 0; value < cRequestCount; ++value) {
+        requests.append("x = " + std::to_string(value) + "\n");
+        expectedResponses.append("x = " + std::to_string(value) + "\n");
+    }
+    requests.append("result");
+    expectedResponses.append("return x = " + std::to_string(cRequestCount - 1) + "\n");
+
+    // Responses are read while writing, the server stops reading from clients lagging behind
+    std::thread writer([client, &requests] {
+        std::string_view pendingRequests{requests};
+        while (!pendingRequests.empty()) {
+            const auto bytesWritten
+                  = send(client, pendingRequests.data(), pendingRequests.size(), 0);
+            ASSERT_GT(bytesWritten, 0);
+            pendingRequests.remove_prefix(static_cast<std::size_t>(bytesWritten));
+        }
+        shutdown(client, SHUT_WR);
+    });
+
+    ASSERT_EQ(readResponses(client, cRequestCount + 1), expectedResponses);
+    writer.join();
+
+    // The server closes the connection once every response was sent
+    char byte{};
+    ASSERT_EQ(recv(client, &byte, 1, 0), 0);
+    close(client);
+}
+
+/**
+ * @brief Tests the parsing of endpoints
+ */
+TEST(EndpointUnitTest, endpointParsesUnixAndTcpAddresses)
+{
+    const auto unixEndpoint = Server::Endpoint::parse("unix:/tmp/calculator.sock");
+    ASSERT_TRUE(unixEndpoint);
+    ASSERT_EQ(unixEndpoint->family, Server::Endpoint::Family::UNIX);
+    ASSERT_EQ(unixEndpoint->address, "/tmp/calculator.sock");
+
+    const auto tcpEndpoint = Server::Endpoint::parse("localhost:7000");
+    ASSERT_TRUE(tcpEndpoint);
+    ASSERT_EQ(tcpEndpoint->family, Server::Endpoint::Family::TCP);
+    ASSERT_EQ(tcpEndpoint->address, "127.0.0.1");
+    ASSERT_EQ(tcpEndpoint->port, 7000);
+
+    ASSERT_EQ(Server::Endpoint::parse("7001")->address, "127.0.0.1");
+    ASSERT_FALSE(Server::Endpoint::parse("unix:"));
+    ASSERT_FALSE(Server::Endpoint::parse("localhost:port"));
+    ASSERT_FALSE(Server::Endpoint::parse("70000"));
+    ASSERT_FALSE(Server::Endpoint::parse("not.an.address:7000"));
+}
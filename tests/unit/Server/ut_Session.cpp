@@ -0,0 +1,73 @@
+#include "gtest/gtest.h"
+
+#include "server/Session.hpp"
+
+using namespace ::testing;
+
+/**
+ * @brief Tests that every pipelined request gets exactly one response line, in order,
+ * however the requests are split
+ */
+TEST(SessionUnitTest, sessionAnswersEveryPipelinedRequest)
+{
+    const std::string requests{"a = 1\nb = a + c\r\nc = 2\n\nresult\nundo 1\n"};
+    const std::string expectedResponses{"a = 1\n\nc = 2, b = 3\n\nreturn c = 2\ndelete c\n"};
+
+    for (std::size_t chunkSize = 1; chunkSize <= requests.size(); ++chunkSize) {
+        Server::Session session;
+        std::string responses;
+
+        for (std::size_t offset = 0; offset < requests.size(); offset += chunkSize) {
+            ASSERT_TRUE(session.receive(std::string_view{requests}.substr(offset, chunkSize)));
+
+            responses.append(session.getPendingOutput());
+            session.consumeOutput(session.getPendingOutput().size());
+        }
+
+        ASSERT_EQ(responses, expectedResponses) << "chunks of " << chunkSize;
+        ASSERT_TRUE(session.getPendingOutput().empty());
+    }
+}
+
+/**
+ * @brief Tests that the last request is answered when the client stops sending data,
+ * even without a line terminator
+ */
+TEST(SessionUnitTest, sessionAnswersUnterminatedLastRequest)
+{
+    Server::Session session;
+    ASSERT_TRUE(session.receive("a = 4\nb = a * 2"));
+    ASSERT_EQ(session.getPendingOutput(), "a = 4\n");
+
+    // Responses are kept until they are sent
+    session.consumeOutput(4);
+    session.finish();
+    ASSERT_EQ(session.getPendingOutput(), "4\nb = 8\n");
+}
+
+/**
+ * @brief Tests that rejected requests are answered with the reason and position of the rejection
+ */
+TEST(SessionUnitTest, sessionAnswersRejectedRequestsWithTheirError)
+{
+    Server::Session session;
+    ASSERT_TRUE(session.receive("a = 2 +\nresult\na = (1\nrestore x\na = 3\n"));
+    ASSERT_EQ(session.getPendingOutput(),
+              "error: Expression ends with an operator at offset 7\n"
+              "error: There is no result available yet at offset 0\n"
+              "error: Parenthesis do not match at offset 6\n"
+              "error: Unknown checkpoint at offset 8\n"
+              "a = 3\n");
+}
+
+/**
+ * @brief Tests that requests longer than the limit end the session
+ */
+TEST(SessionUnitTest, sessionRejectsOverlongRequests)
+{
+    Server::Session session;
+    const std::string request(Server::cMaxRequestLength / 2 + 1, ' ');
+
+    ASSERT_TRUE(session.receive(request));
+    ASSERT_FALSE(session.receive(request));
+}
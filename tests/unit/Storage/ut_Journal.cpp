@@ -0,0 +1,150 @@
+#include "gtest/gtest.h"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "storage/Journal.hpp"
+
+using namespace ::testing;
+
+/**
+ * @brief Test fixture for the Journal class, storing its data in a temporary directory
+ */
+class JournalUnitTest : public Test
+{
+protected:
+    void SetUp() override
+    {
+        mDirectory = "/tmp/ut_Journal." + std::to_string(getpid());
+        std::filesystem::remove_all(mDirectory);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(mDirectory);
+    }
+
+    /**
+     * @brief Processes instructions and records them in a journal
+     *
+     * @param[in,out] runner Calculator processing the instructions
+     * @param[in,out] journal Journal the instructions are recorded in
+     * @param[in] instructions Instructions to process
+     *
+     * @return Results of the last instruction
+     */
+    static std::vector<std::string> processInstructions(
+          Calculator::Runner& runner,
+          Storage::Journal& journal,
+          const std::vector<std::string>& instructions)
+    {
+        std::vector<std::string> results;
+        for (const auto& instruction : instructions) {
+            results = runner.processInstruction(instruction);
+            journal.record(instruction);
+        }
+
+        EXPECT_TRUE(journal.commit());
+        return results;
+    }
+
+protected:
+    /// Path of the data directory
+    std::string mDirectory;
+};
+
+/**
+ * @brief Tests that a restarted calculator recovers its state from the log alone
+ */
+TEST_F(JournalUnitTest, journalRecoversTheStateFromTheLog)
+{
+    {
+        Calculator::Runner runner;
+        auto journal = Storage::Journal::open(mDirectory, runner);
+        ASSERT_TRUE(journal);
+        ASSERT_EQ(journal->getReplayedCount(), 0U);
+
+        processInstructions(runner,
+                            *journal,
+                            {"a=1", "b=a+c", "checkpoint start", "c=2", "d=e*2", "x=1+", "f=3"});
+        processInstructions(runner, *journal, {"undo 1"});
+    }
+
+    Calculator::Runner runner;
+    auto journal = Storage::Journal::open(mDirectory, runner);
+    ASSERT_TRUE(journal);
+
+    // Instructions without effect are not logged
+    ASSERT_EQ(journal->getReplayedCount(), 7U);
+    ASSERT_EQ(runner.processInstruction("result"), std::vector<std::string>{"return c = 2"});
+    ASSERT_EQ(processInstructions(runner, *journal, {"e=3"}),
+              (std::vector<std::string>{"e = 3", "d = 6"}));
+    ASSERT_EQ(processInstructions(runner, *journal, {"restore start", "c=5"}),
+              (std::vector<std::string>{"c = 5", "b = 6"}));
+}
+
+/**
+ * @brief Tests that snapshots replace the log, and that only the log tail is replayed
+ */
+TEST_F(JournalUnitTest, journalReplaysTheLogTailAfterTheSnapshot)
+{
+    constexpr uint64_t cSnapshotInterval{10};
+
+    std::vector<std::string> results;
+    {
+        Calculator::Runner runner;
+        auto journal = Storage::Journal::open(mDirectory, runner, cSnapshotInterval);
+        ASSERT_TRUE(journal);
+
+        processInstructions(runner, *journal, {"total=x+y", "checkpoint empty"});
+        for (auto value = 0; value < 25; ++value) {
+            processInstructions(runner, *journal, {"x=" + std::to_string(value)});
+        }
+        results = processInstructions(runner, *journal, {"y=100"});
+        ASSERT_TRUE(std::filesystem::exists(mDirectory + "/snapshot"));
+    }
+
+    // 28 instructions: 20 are in the snapshot, 8 in the log
+    Calculator::Runner runner;
+    auto journal = Storage::Journal::open(mDirectory, runner, cSnapshotInterval);
+    ASSERT_TRUE(journal);
+    ASSERT_EQ(journal->getReplayedCount(), 8U);
+    ASSERT_EQ(results, (std::vector<std::string>{"y = 100", "total = 124"}));
+    ASSERT_EQ(runner.processInstruction("result"), std::vector<std::string>{"return y = 100"});
+
+    // The checkpoint survives the snapshot
+    ASSERT_EQ(processInstructions(runner, *journal, {"restore empty", "x=1", "y=2"}),
+              (std::vector<std::string>{"y = 2", "total = 3"}));
+
+    // An explicit snapshot empties the log
+    ASSERT_TRUE(journal->saveSnapshot());
+    Calculator::Runner restartedRunner;
+    auto restartedJournal = Storage::Journal::open(mDirectory, restartedRunner);
+    ASSERT_TRUE(restartedJournal);
+    ASSERT_EQ(restartedJournal->getReplayedCount(), 0U);
+    ASSERT_EQ(restartedRunner.processInstruction("result"),
+              std::vector<std::string>{"return y = 2"});
+}
+
+/**
+ * @brief Tests that a corrupted snapshot is reported instead of silently losing the state
+ */
+TEST_F(JournalUnitTest, journalRejectsCorruptedSnapshots)
+{
+    {
+        Calculator::Runner runner;
+        auto journal = Storage::Journal::open(mDirectory, runner);
+        ASSERT_TRUE(journal);
+        processInstructions(runner, *journal, {"a=1"});
+        ASSERT_TRUE(journal->saveSnapshot());
+    }
+
+    const auto snapshotPath = mDirectory + "/snapshot";
+    std::filesystem::resize_file(snapshotPath, std::filesystem::file_size(snapshotPath) - 1);
+
+    Calculator::Runner runner;
+    ASSERT_FALSE(Storage::Journal::open(mDirectory, runner));
+}
@@ -0,0 +1,145 @@
+#include "gtest/gtest.h"
+
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+#include "storage/WriteAheadLog.hpp"
+
+using namespace ::testing;
+
+/**
+ * @brief Test fixture for the WriteAheadLog class, logging to a temporary file
+ */
+class WriteAheadLogUnitTest : public Test
+{
+protected:
+    /// Alias representing the sequence number and the payload of a record
+    using Record = std::pair<uint64_t, std::string>;
+
+    void SetUp() override
+    {
+        mPath = "/tmp/ut_WriteAheadLog." + std::to_string(getpid()) + ".wal";
+        std::filesystem::remove(mPath);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove(mPath);
+    }
+
+    /**
+     * @brief Opens the log and reads its records back
+     *
+     * @param[out] records Records read back
+     *
+     * @return Opened log (empty on failure)
+     */
+    std::optional<Storage::WriteAheadLog> openLog(std::vector<Record>& records) const
+    {
+        records.clear();
+        return Storage::WriteAheadLog::open(
+              mPath, [&](const uint64_t sequence, const std::string_view payload) {
+                  records.emplace_back(sequence, payload);
+              });
+    }
+
+protected:
+    /// Path of the log file
+    std::string mPath;
+};
+
+/**
+ * @brief Tests that only committed records are read back, in order
+ */
+TEST_F(WriteAheadLogUnitTest, writeAheadLogReadsBackCommittedRecords)
+{
+    std::vector<Record> records;
+    {
+        auto log = openLog(records);
+        ASSERT_TRUE(log);
+        ASSERT_TRUE(records.empty());
+
+        log->append(1, "a=1");
+        log->append(2, "");
+        ASSERT_GT(log->getPendingSize(), 0U);
+        ASSERT_TRUE(log->commit());
+        ASSERT_EQ(log->getPendingSize(), 0U);
+
+        log->append(3, std::string(100'000, 'x'));
+        ASSERT_TRUE(log->commit());
+    }
+
+    auto log = openLog(records);
+    ASSERT_TRUE(log);
+    ASSERT_EQ(records,
+              (std::vector<Record>{{1, "a=1"}, {2, ""}, {3, std::string(100'000, 'x')}}));
+
+    // New records go after the existing ones, until the log is cleared
+    log->append(4, "b=2");
+    ASSERT_TRUE(log->commit());
+    ASSERT_TRUE(openLog(records));
+    ASSERT_EQ(records.size(), 4U);
+    ASSERT_EQ(records.back(), (Record{4, "b=2"}));
+
+    ASSERT_TRUE(log->clear());
+    log->append(5, "c=3");
+    ASSERT_TRUE(log->commit());
+    ASSERT_TRUE(openLog(records));
+    ASSERT_EQ(records, (std::vector<Record>{{5, "c=3"}}));
+}
+
+/**
+ * @brief Tests that a torn or corrupted tail is dropped, and that the log keeps going after it
+ */
+TEST_F(WriteAheadLogUnitTest, writeAheadLogDropsTornRecords)
+{
+    std::vector<Record> records;
+    {
+        auto log = openLog(records);
+        ASSERT_TRUE(log);
+        log->append(1, "a=1");
+        log->append(2, "b=2");
+        ASSERT_TRUE(log->commit());
+    }
+    const auto fullSize = std::filesystem::file_size(mPath);
+
+    // A crash in the middle of the last record
+    std::filesystem::resize_file(mPath, fullSize - 2);
+    {
+        auto log = openLog(records);
+        ASSERT_TRUE(log);
+        ASSERT_EQ(records, (std::vector<Record>{{1, "a=1"}}));
+
+        log->append(3, "c=3");
+        ASSERT_TRUE(log->commit());
+    }
+
+    ASSERT_TRUE(openLog(records));
+    ASSERT_EQ(records, (std::vector<Record>{{1, "a=1"}, {3, "c=3"}}));
+
+    // A flipped byte fails the checksum of its record
+    {
+        std::FILE* file = std::fopen(mPath.c_str(), "r+b");
+        ASSERT_NE(file, nullptr);
+        std::fseek(file, -1, SEEK_END);
+        std::fputc('x', file);
+        std::fclose(file);
+    }
+    ASSERT_TRUE(openLog(records));
+    ASSERT_EQ(records, (std::vector<Record>{{1, "a=1"}}));
+
+    // Files that are not logs are left alone
+    std::filesystem::resize_file(mPath, 0);
+    {
+        std::FILE* file = std::fopen(mPath.c_str(), "wb");
+        ASSERT_NE(file, nullptr);
+        std::fputs("not a log", file);
+        std::fclose(file);
+    }
+    ASSERT_FALSE(openLog(records));
+    ASSERT_EQ(std::filesystem::file_size(mPath), 9U);
+}